@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "core-alloc.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+static int hooked(const struct klvanc_allocator_s *a)
+{
+	return a && a->alloc;
+}
+
+int klvanc_mem_validate(const struct klvanc_allocator_s *a)
+{
+	if (!a)
+		return 0;
+
+	/* All or nothing, mixing libc and user hooks would end in tears. */
+	if (a->alloc && a->realloc && a->free)
+		return 0;
+	if (!a->alloc && !a->realloc && !a->free)
+		return 0;
+
+	return -EINVAL;
+}
+
+void *klvanc_mem_alloc(const struct klvanc_allocator_s *a, size_t size)
+{
+	if (hooked(a))
+		return a->alloc(a->opaque, size);
+
+	return malloc(size);
+}
+
+void *klvanc_mem_calloc(const struct klvanc_allocator_s *a, size_t nmemb, size_t size)
+{
+	if (!hooked(a))
+		return calloc(nmemb, size);
+
+	if (size && nmemb > SIZE_MAX / size)
+		return NULL;
+
+	void *p = a->alloc(a->opaque, nmemb * size);
+	if (p)
+		memset(p, 0, nmemb * size);
+
+	return p;
+}
+
+void *klvanc_mem_realloc(const struct klvanc_allocator_s *a, void *ptr, size_t size)
+{
+	if (hooked(a))
+		return a->realloc(a->opaque, ptr, size);
+
+	return realloc(ptr, size);
+}
+
+void klvanc_mem_free(const struct klvanc_allocator_s *a, void *ptr)
+{
+	if (!ptr)
+		return;
+
+	if (hooked(a))
+		a->free(a->opaque, ptr);
+	else
+		free(ptr);
+}
+
+/* Tracked allocations carry their size in a header, sized to preserve malloc alignment */
+#define HDR_SIZE 16
+
+struct counters_s
+{
+	uint64_t bytes;
+	uint64_t peak;
+	uint64_t allocs;
+	uint64_t frees;
+};
+
+struct bucket_s
+{
+	struct klvanc_allocator_s tracked;	/* Hooks below, opaque points back here */
+	struct klvanc_memaccount_s *acct;
+	struct counters_s c;
+};
+
+struct klvanc_memaccount_s
+{
+	struct klvanc_allocator_s user;
+	int refs;
+	struct bucket_s bucket[KLVANC_MEM_MAX];
+	struct counters_s total;
+};
+
+static void raise_peak(uint64_t *peak, uint64_t val)
+{
+	uint64_t cur = __atomic_load_n(peak, __ATOMIC_RELAXED);
+	while (val > cur) {
+		if (__atomic_compare_exchange_n(peak, &cur, val, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			break;
+	}
+}
+
+static void counters_add(struct counters_s *c, size_t size)
+{
+	uint64_t now = __atomic_add_fetch(&c->bytes, size, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&c->allocs, 1, __ATOMIC_RELAXED);
+	raise_peak(&c->peak, now);
+}
+
+static void counters_sub(struct counters_s *c, size_t size)
+{
+	__atomic_sub_fetch(&c->bytes, size, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&c->frees, 1, __ATOMIC_RELAXED);
+}
+
+static void account_put(struct klvanc_memaccount_s *acct)
+{
+	if (__atomic_sub_fetch(&acct->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+		struct klvanc_allocator_s user = acct->user;
+		klvanc_mem_free(&user, acct);
+	}
+}
+
+static void *tracked_alloc(void *opaque, size_t size)
+{
+	struct bucket_s *b = opaque;
+	struct klvanc_memaccount_s *acct = b->acct;
+
+	if (size > SIZE_MAX - HDR_SIZE)
+		return NULL;
+
+	uint8_t *p = klvanc_mem_alloc(&acct->user, size + HDR_SIZE);
+	if (!p)
+		return NULL;
+	*(size_t *)p = size;
+
+	__atomic_add_fetch(&acct->refs, 1, __ATOMIC_RELAXED);
+	counters_add(&b->c, size);
+	counters_add(&acct->total, size);
+
+	return p + HDR_SIZE;
+}
+
+static void tracked_free(void *opaque, void *ptr)
+{
+	struct bucket_s *b = opaque;
+	struct klvanc_memaccount_s *acct = b->acct;
+	uint8_t *p = (uint8_t *)ptr - HDR_SIZE;
+	size_t size = *(size_t *)p;
+
+	klvanc_mem_free(&acct->user, p);
+
+	counters_sub(&b->c, size);
+	counters_sub(&acct->total, size);
+	account_put(acct);
+}
+
+static void *tracked_realloc(void *opaque, void *ptr, size_t size)
+{
+	struct bucket_s *b = opaque;
+	struct klvanc_memaccount_s *acct = b->acct;
+
+	if (!ptr)
+		return tracked_alloc(opaque, size);
+	if (size > SIZE_MAX - HDR_SIZE)
+		return NULL;
+
+	uint8_t *p = (uint8_t *)ptr - HDR_SIZE;
+	size_t old = *(size_t *)p;
+
+	p = klvanc_mem_realloc(&acct->user, p, size + HDR_SIZE);
+	if (!p)
+		return NULL;
+	*(size_t *)p = size;
+
+	counters_sub(&b->c, old);
+	counters_sub(&acct->total, old);
+	counters_add(&b->c, size);
+	counters_add(&acct->total, size);
+
+	return p + HDR_SIZE;
+}
+
+struct klvanc_memaccount_s *klvanc_memaccount_alloc(const struct klvanc_allocator_s *a)
+{
+	struct klvanc_memaccount_s *acct = klvanc_mem_calloc(a, 1, sizeof(*acct));
+	if (!acct)
+		return NULL;
+
+	if (a)
+		acct->user = *a;
+	acct->refs = 1;
+	for (int i = 0; i < KLVANC_MEM_MAX; i++) {
+		struct bucket_s *b = &acct->bucket[i];
+		b->tracked.alloc = tracked_alloc;
+		b->tracked.realloc = tracked_realloc;
+		b->tracked.free = tracked_free;
+		b->tracked.opaque = b;
+		b->acct = acct;
+	}
+
+	return acct;
+}
+
+void klvanc_memaccount_retain(struct klvanc_memaccount_s *acct)
+{
+	__atomic_add_fetch(&acct->refs, 1, __ATOMIC_RELAXED);
+}
+
+void klvanc_memaccount_release(struct klvanc_memaccount_s *acct)
+{
+	if (acct)
+		account_put(acct);
+}
+
+const struct klvanc_allocator_s *klvanc_memaccount_allocator(struct klvanc_memaccount_s *acct,
+	enum klvanc_mem_subsystem_e subsystem)
+{
+	return &acct->bucket[subsystem].tracked;
+}
+
+void klvanc_memaccount_charge(struct klvanc_memaccount_s *acct, enum klvanc_mem_subsystem_e subsystem, size_t size)
+{
+	counters_add(&acct->bucket[subsystem].c, size);
+	counters_add(&acct->total, size);
+}
+
+void klvanc_memaccount_credit(struct klvanc_memaccount_s *acct, enum klvanc_mem_subsystem_e subsystem, size_t size)
+{
+	counters_sub(&acct->bucket[subsystem].c, size);
+	counters_sub(&acct->total, size);
+}
+
+static void counters_get(const struct counters_s *c, struct klvanc_memstats_subsystem_s *s)
+{
+	s->bytesOutstanding = __atomic_load_n(&c->bytes, __ATOMIC_RELAXED);
+	s->bytesPeak = __atomic_load_n(&c->peak, __ATOMIC_RELAXED);
+	s->allocCount = __atomic_load_n(&c->allocs, __ATOMIC_RELAXED);
+	s->freeCount = __atomic_load_n(&c->frees, __ATOMIC_RELAXED);
+}
+
+void klvanc_memaccount_get(struct klvanc_memaccount_s *acct, struct klvanc_memstats_s *stats)
+{
+	for (int i = 0; i < KLVANC_MEM_MAX; i++)
+		counters_get(&acct->bucket[i].c, &stats->subsystem[i]);
+	counters_get(&acct->total, &stats->total);
+}
+
+static void counters_reset(struct counters_s *c)
+{
+	__atomic_store_n(&c->allocs, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&c->frees, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&c->peak, __atomic_load_n(&c->bytes, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+}
+
+void klvanc_memaccount_reset(struct klvanc_memaccount_s *acct)
+{
+	for (int i = 0; i < KLVANC_MEM_MAX; i++)
+		counters_reset(&acct->bucket[i].c);
+	counters_reset(&acct->total);
+}
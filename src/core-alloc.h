@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* Not for inclusion by user applications */
+
+#ifndef _CORE_ALLOC_H
+#define _CORE_ALLOC_H
+
+#include <stddef.h>
+#include <libklvanc/allocator.h>
+
+/* All internal allocations go through these. A NULL allocator, or one
+ * without hooks, falls back to the C library.
+ */
+int   klvanc_mem_validate(const struct klvanc_allocator_s *a);
+void *klvanc_mem_alloc(const struct klvanc_allocator_s *a, size_t size);
+void *klvanc_mem_calloc(const struct klvanc_allocator_s *a, size_t nmemb, size_t size);
+void *klvanc_mem_realloc(const struct klvanc_allocator_s *a, void *ptr, size_t size);
+void  klvanc_mem_free(const struct klvanc_allocator_s *a, void *ptr);
+
+/* Memory accounting. An account wraps the user allocator with one tracking
+ * allocator per subsystem. It is reference counted by its owner and by every
+ * live allocation, so objects may be freed after the owning context is gone.
+ */
+struct klvanc_memaccount_s;
+
+struct klvanc_memaccount_s *klvanc_memaccount_alloc(const struct klvanc_allocator_s *a);
+void klvanc_memaccount_retain(struct klvanc_memaccount_s *acct);
+void klvanc_memaccount_release(struct klvanc_memaccount_s *acct);
+const struct klvanc_allocator_s *klvanc_memaccount_allocator(struct klvanc_memaccount_s *acct,
+	enum klvanc_mem_subsystem_e subsystem);
+
+/* For memory obtained outside the account, such as the sparse cache table */
+void klvanc_memaccount_charge(struct klvanc_memaccount_s *acct, enum klvanc_mem_subsystem_e subsystem, size_t size);
+void klvanc_memaccount_credit(struct klvanc_memaccount_s *acct, enum klvanc_mem_subsystem_e subsystem, size_t size);
+
+void klvanc_memaccount_get(struct klvanc_memaccount_s *acct, struct klvanc_memstats_s *stats);
+void klvanc_memaccount_reset(struct klvanc_memaccount_s *acct);
+
+#endif /* _CORE_ALLOC_H */
@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <libklvanc/vanc.h>
+
+#include "core-private.h"
+#include "klqueue.h"
+
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+/* The data count is a single byte, so a packet is at most 255 payload words plus
+ * seven header and checksum words, which is all parse() keeps in raw.
+ */
+#define ASYNC_MAX_PAYLOAD 255
+#define ASYNC_MAX_RAW (ASYNC_MAX_PAYLOAD + 7)
+
+/* Everything the consumer needs to rebuild the header, without the 64KB arrays */
+struct async_slot_s
+{
+	enum klvanc_packet_type_e type;
+	unsigned short adf[3];
+	unsigned short did;
+	unsigned short dbnsdid;
+	unsigned short checksum;
+	unsigned short payloadLengthWords;
+	unsigned short horizontalOffset;
+	unsigned int checksumValid;
+	unsigned int parityErrors;
+	unsigned int lineNr;
+	unsigned int rawLengthWords;
+	unsigned short payload[ASYNC_MAX_PAYLOAD];
+	unsigned short raw[ASYNC_MAX_RAW];
+};
+
+struct klvanc_async_s
+{
+	struct klvanc_async_params_s params;
+
+	/* Slots cycle between the free and filled queues */
+	struct async_slot_s *slots;
+	struct klqueue_s freeq;
+	struct klqueue_s filledq;
+	sem_t sem;		/* One post per packet queued */
+
+	/* Decode storage and callbacks for the dispatching thread */
+	struct klvanc_stream_s *consumer;
+
+	/* KLVANC_ASYNC_BLOCK, the producer sleeps here until a slot is returned */
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	int waiting;
+
+	struct klvanc_async_stats_s stats;
+};
+
+void klvanc_async_params_default(struct klvanc_async_params_s *params)
+{
+	params->queueDepth = 64;
+	params->policy = KLVANC_ASYNC_DROP_NEWEST;
+}
+
+static void async_free(struct klvanc_context_s *ctx, struct klvanc_async_s *a)
+{
+	klqueue_free(&a->filledq);
+	klqueue_free(&a->freeq);
+	sem_destroy(&a->sem);
+	pthread_cond_destroy(&a->cond);
+	pthread_mutex_destroy(&a->mutex);
+	if (a->consumer)
+		klvanc_stream_destroy(a->consumer);
+	klvanc_mem_free(getAllocator(ctx, KLVANC_MEM_CORE), a->slots);
+	klvanc_mem_free(getAllocator(ctx, KLVANC_MEM_CORE), a);
+}
+
+int klvanc_context_enable_async(struct klvanc_context_s *ctx, struct klvanc_async_params_s *params)
+{
+	VALIDATE(ctx);
+
+	struct vanc_context_private_s *priv = getPrivate(ctx);
+	if (priv->async)
+		return -EBUSY;
+
+	const struct klvanc_allocator_s *alloc = getAllocator(ctx, KLVANC_MEM_CORE);
+	struct klvanc_async_s *a = klvanc_mem_calloc(alloc, 1, sizeof(*a));
+	if (!a)
+		return -ENOMEM;
+
+	if (params)
+		a->params = *params;
+	else
+		klvanc_async_params_default(&a->params);
+	if (a->params.queueDepth == 0 || a->params.policy < KLVANC_ASYNC_DROP_NEWEST ||
+	    a->params.policy > KLVANC_ASYNC_BLOCK) {
+		klvanc_mem_free(alloc, a);
+		return -EINVAL;
+	}
+
+	pthread_mutex_init(&a->mutex, NULL);
+	pthread_cond_init(&a->cond, NULL);
+	if (sem_init(&a->sem, 0, 0) < 0) {
+		pthread_cond_destroy(&a->cond);
+		pthread_mutex_destroy(&a->mutex);
+		klvanc_mem_free(alloc, a);
+		return -ENOMEM;
+	}
+
+	a->slots = klvanc_mem_calloc(alloc, a->params.queueDepth, sizeof(*a->slots));
+	if (!a->slots ||
+	    klqueue_init(&a->freeq, a->params.queueDepth) < 0 ||
+	    klqueue_init(&a->filledq, a->params.queueDepth) < 0) {
+		async_free(ctx, a);
+		return -ENOMEM;
+	}
+	for (uint32_t i = 0; i < a->params.queueDepth; i++)
+		klqueue_push(&a->freeq, &a->slots[i]);
+
+	int ret = klvanc_stream_create(ctx, &a->consumer);
+	if (ret < 0) {
+		a->consumer = NULL;
+		async_free(ctx, a);
+		return ret;
+	}
+
+	priv->async = a;
+
+	return KLAPI_OK;
+}
+
+void klvanc_async_free(struct klvanc_context_s *ctx)
+{
+	struct vanc_context_private_s *priv = getPrivate(ctx);
+	if (!priv->async)
+		return;
+
+	async_free(ctx, priv->async);
+	priv->async = NULL;
+}
+
+int klvanc_context_disable_async(struct klvanc_context_s *ctx)
+{
+	VALIDATE(ctx);
+
+	klvanc_async_free(ctx);
+
+	return KLAPI_OK;
+}
+
+static void slot_release(struct klvanc_async_s *a, struct async_slot_s *s)
+{
+	klqueue_push(&a->freeq, s);
+
+	/* Pairs with the fence in slot_acquire_blocking() */
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&a->waiting, __ATOMIC_RELAXED)) {
+		pthread_mutex_lock(&a->mutex);
+		pthread_cond_broadcast(&a->cond);
+		pthread_mutex_unlock(&a->mutex);
+	}
+}
+
+static struct async_slot_s *slot_acquire_blocking(struct klvanc_async_s *a)
+{
+	struct async_slot_s *s;
+
+	pthread_mutex_lock(&a->mutex);
+	__atomic_store_n(&a->waiting, 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	while (!(s = klqueue_pop(&a->freeq)))
+		pthread_cond_wait(&a->cond, &a->mutex);
+	__atomic_store_n(&a->waiting, 0, __ATOMIC_RELAXED);
+	pthread_mutex_unlock(&a->mutex);
+
+	return s;
+}
+
+void klvanc_async_push(struct klvanc_context_s *ctx, const struct klvanc_packet_header_s *hdr)
+{
+	struct klvanc_async_s *a = getPrivate(ctx)->async;
+
+	struct async_slot_s *s = klqueue_pop(&a->freeq);
+	if (!s) {
+		switch (a->params.policy) {
+		case KLVANC_ASYNC_DROP_NEWEST:
+			__atomic_add_fetch(&a->stats.dropped, 1, __ATOMIC_RELAXED);
+			return;
+		case KLVANC_ASYNC_DROP_OLDEST:
+			if ((s = klqueue_pop(&a->filledq))) {
+				__atomic_add_fetch(&a->stats.dropped, 1, __ATOMIC_RELAXED);
+				break;
+			}
+			/* The consumer took the oldest first. Its slot comes back once the
+			 * header is copied out, look once more rather than spin while the
+			 * consumer holds it, then drop this packet instead.
+			 */
+			if ((s = klqueue_pop(&a->freeq)))
+				break;
+			__atomic_add_fetch(&a->stats.dropped, 1, __ATOMIC_RELAXED);
+			return;
+		case KLVANC_ASYNC_BLOCK:
+			__atomic_add_fetch(&a->stats.blocked, 1, __ATOMIC_RELAXED);
+			s = slot_acquire_blocking(a);
+			break;
+		}
+	}
+
+	s->type = hdr->type;
+	memcpy(s->adf, hdr->adf, sizeof(s->adf));
+	s->did = hdr->did;
+	s->dbnsdid = hdr->dbnsdid;
+	s->checksum = hdr->checksum;
+	/* parse() bounds both lengths to a single packet, the slot holds them whole */
+	s->payloadLengthWords = hdr->payloadLengthWords;
+	s->horizontalOffset = hdr->horizontalOffset;
+	s->checksumValid = hdr->checksumValid;
+	s->parityErrors = hdr->parityErrors;
+	s->lineNr = hdr->lineNr;
+	s->rawLengthWords = hdr->rawLengthWords;
+	memcpy(s->payload, hdr->payload, s->payloadLengthWords * sizeof(unsigned short));
+	memcpy(s->raw, hdr->raw, s->rawLengthWords * sizeof(unsigned short));
+
+	klqueue_push(&a->filledq, s);
+	__atomic_add_fetch(&a->stats.queued, 1, __ATOMIC_RELAXED);
+
+	uint32_t depth = klqueue_count(&a->filledq);
+	if (depth > a->stats.highWaterMark)
+		__atomic_store_n(&a->stats.highWaterMark, depth, __ATOMIC_RELAXED);
+
+	sem_post(&a->sem);
+}
+
+static int async_wait(struct klvanc_async_s *a, int timeoutMs)
+{
+	int ret;
+
+	if (timeoutMs == 0)
+		return sem_trywait(&a->sem);
+
+	if (timeoutMs < 0) {
+		while ((ret = sem_wait(&a->sem)) < 0 && errno == EINTR)
+			;
+		return ret;
+	}
+
+	struct timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	ts.tv_sec += timeoutMs / 1000;
+	ts.tv_nsec += (timeoutMs % 1000) * 1000000L;
+	if (ts.tv_nsec >= 1000000000L) {
+		ts.tv_sec++;
+		ts.tv_nsec -= 1000000000L;
+	}
+	while ((ret = sem_timedwait(&a->sem, &ts)) < 0 && errno == EINTR)
+		;
+	return ret;
+}
+
+int klvanc_async_dispatch(struct klvanc_context_s *ctx, unsigned int maxPackets, int timeoutMs)
+{
+	VALIDATE(ctx);
+
+	struct klvanc_async_s *a = getPrivate(ctx)->async;
+	if (!a)
+		return -ENOENT;
+
+	/* Pick up any configuration changes made since the last dispatch */
+	struct klvanc_context_s *c = klvanc_stream_get_context(a->consumer);
+	c->verbose = ctx->verbose;
+	c->callbacks = ctx->callbacks;
+	c->callback_context = ctx->callback_context;
+	c->warn_on_decode_failure = ctx->warn_on_decode_failure;
+	c->log_cb = ctx->log_cb;
+	c->log_level = ctx->log_level;
+
+	struct klvanc_packet_header_s *hdr = &getPrivate(c)->hdr;
+	unsigned int count = 0;
+
+	if (async_wait(a, timeoutMs) < 0)
+		return 0;
+
+	do {
+		/* A post can outlive its packet when KLVANC_ASYNC_DROP_OLDEST steals it */
+		struct async_slot_s *s = klqueue_pop(&a->filledq);
+		if (!s)
+			continue;
+
+		hdr->type = s->type;
+		memcpy(hdr->adf, s->adf, sizeof(hdr->adf));
+		hdr->did = s->did;
+		hdr->dbnsdid = s->dbnsdid;
+		hdr->checksum = s->checksum;
+		hdr->payloadLengthWords = s->payloadLengthWords;
+		hdr->horizontalOffset = s->horizontalOffset;
+		hdr->checksumValid = s->checksumValid;
+		hdr->parityErrors = s->parityErrors;
+		hdr->lineNr = s->lineNr;
+		hdr->rawLengthWords = s->rawLengthWords;
+		memcpy(hdr->payload, s->payload, s->payloadLengthWords * sizeof(unsigned short));
+		memset(&hdr->payload[s->payloadLengthWords], 0,
+		       (KLVANC_DECODE_PAYLOAD_WORDS - s->payloadLengthWords) * sizeof(unsigned short));
+		memcpy(hdr->raw, s->raw, s->rawLengthWords * sizeof(unsigned short));
+
+		/* The slot is no longer needed, give the producer room before the callbacks run */
+		slot_release(a, s);
+
+		klvanc_packet_deliver(c, hdr);
+		__atomic_add_fetch(&a->stats.dispatched, 1, __ATOMIC_RELAXED);
+		count++;
+	} while ((maxPackets == 0 || count < maxPackets) && sem_trywait(&a->sem) == 0);
+
+	return count;
+}
+
+int klvanc_context_get_async_stats(struct klvanc_context_s *ctx, struct klvanc_async_stats_s *stats)
+{
+	VALIDATE(ctx);
+	VALIDATE(stats);
+
+	struct klvanc_async_s *a = getPrivate(ctx)->async;
+	if (!a)
+		return -ENOENT;
+
+	stats->queued = __atomic_load_n(&a->stats.queued, __ATOMIC_RELAXED);
+	stats->dispatched = __atomic_load_n(&a->stats.dispatched, __ATOMIC_RELAXED);
+	stats->dropped = __atomic_load_n(&a->stats.dropped, __ATOMIC_RELAXED);
+	stats->blocked = __atomic_load_n(&a->stats.blocked, __ATOMIC_RELAXED);
+	stats->depth = klqueue_count(&a->filledq);
+	stats->highWaterMark = __atomic_load_n(&a->stats.highWaterMark, __ATOMIC_RELAXED);
+
+	return KLAPI_OK;
+}
@@ -21,6 +21,8 @@
 
 #include <libklvanc/vanc.h>
 
+#include "core-private.h"
+
 #include <stdint.h>
 #include <stdlib.h>
 #include <pthread.h>
@@ -31,11 +33,17 @@
 
 int klvanc_cache_alloc(struct klvanc_context_s *ctx)
 {
+	/* The table is sparse and relies on calloc() handing back lazily zeroed pages,
+	 * so it stays on the C library. Cached packets use the context allocator.
+	 */
 	ctx->cacheLines = calloc(0x10000, sizeof(struct klvanc_cache_s));
-    if (!ctx->cacheLines)
-        return -1;
+	if (!ctx->cacheLines)
+		return -1;
+
+	klvanc_memaccount_charge(getPrivate(ctx)->account, KLVANC_MEM_CACHE,
+				 0x10000 * sizeof(struct klvanc_cache_s));
 
-    return 0;
+	return 0;
 }
 
 void klvanc_cache_free(struct klvanc_context_s *ctx)
@@ -45,6 +53,8 @@ void klvanc_cache_free(struct klvanc_context_s *ctx)
 
     if (ctx->cacheLines) {
 	    free(ctx->cacheLines);
+	    klvanc_memaccount_credit(getPrivate(ctx)->account, KLVANC_MEM_CACHE,
+				     0x10000 * sizeof(struct klvanc_cache_s));
         ctx->cacheLines = 0;
     }
 }
@@ -87,10 +97,10 @@ int klvanc_cache_update(struct klvanc_context_s *ctx, struct klvanc_packet_heade
 
 	pthread_mutex_lock(&line->mutex);
 	if (line->pkt) {
-		klvanc_packet_free(line->pkt);
+		klvanc_packet_free_ctx(ctx, KLVANC_MEM_CACHE, line->pkt);
 		line->pkt = 0;
 	}
-	klvanc_packet_copy(&line->pkt, pkt);
+	klvanc_packet_copy_ctx(ctx, KLVANC_MEM_CACHE, &line->pkt, pkt);
 	pthread_mutex_unlock(&line->mutex);
 
 	line->count++;
@@ -123,7 +133,7 @@ void klvanc_cache_reset(struct klvanc_context_s *ctx)
 
 				pthread_mutex_lock(&line->mutex);
 				if (line->pkt) {
-					klvanc_packet_free(line->pkt);
+					klvanc_packet_free_ctx(ctx, KLVANC_MEM_CACHE, line->pkt);
 					line->pkt = 0;
 				}
 				pthread_mutex_unlock(&line->mutex);
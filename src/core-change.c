@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <libklvanc/vanc.h>
+
+#include "core-private.h"
+#include "core-hash.h"
+
+#include <string.h>
+
+struct change_rule_s
+{
+	uint16_t pair;
+	unsigned int heartbeatFrames;
+};
+
+struct change_state_s
+{
+	uint64_t hash;
+	uint64_t lastDelivered;	/* Frame number */
+};
+
+struct klvanc_change_s
+{
+	uint64_t enabled[0x10000 / 64];	/* Bit per DID/SDID, checked before anything else */
+	struct change_rule_s rules[KLVANC_CHANGE_DETECTION_MAX_RULES];
+	int ruleCount;
+
+	struct klvanc_keymap_s map;
+	struct change_state_s state[KLVANC_CHANGE_DETECTION_MAX_LINES];
+
+	uint64_t suppressed;
+};
+
+static struct change_rule_s *find_rule(struct klvanc_change_s *c, uint16_t pair)
+{
+	for (int i = 0; i < c->ruleCount; i++) {
+		if (c->rules[i].pair == pair)
+			return &c->rules[i];
+	}
+	return NULL;
+}
+
+int klvanc_context_enable_change_detection(struct klvanc_context_s *ctx, uint8_t did, uint8_t sdid,
+	unsigned int heartbeatFrames)
+{
+	VALIDATE(ctx);
+
+	const struct klvanc_allocator_s *a = getAllocator(ctx, KLVANC_MEM_CORE);
+	struct klvanc_change_s *c = getPrivate(ctx)->change;
+	if (!c) {
+		c = klvanc_mem_calloc(a, 1, sizeof(*c));
+		if (!c)
+			return -ENOMEM;
+		if (klvanc_keymap_alloc(&c->map, a, KLVANC_CHANGE_DETECTION_MAX_LINES) < 0) {
+			klvanc_mem_free(a, c);
+			return -ENOMEM;
+		}
+		getPrivate(ctx)->change = c;
+	}
+
+	uint16_t pair = (did << 8) | sdid;
+	struct change_rule_s *r = find_rule(c, pair);
+	if (!r) {
+		if (c->ruleCount == KLVANC_CHANGE_DETECTION_MAX_RULES)
+			return -ENOSPC;
+		r = &c->rules[c->ruleCount++];
+		r->pair = pair;
+	}
+	r->heartbeatFrames = heartbeatFrames;
+	c->enabled[pair / 64] |= 1ULL << (pair % 64);
+
+	return KLAPI_OK;
+}
+
+int klvanc_context_disable_change_detection(struct klvanc_context_s *ctx, uint8_t did, uint8_t sdid)
+{
+	VALIDATE(ctx);
+
+	struct klvanc_change_s *c = getPrivate(ctx)->change;
+	if (!c)
+		return KLAPI_OK;
+
+	uint16_t pair = (did << 8) | sdid;
+	struct change_rule_s *r = find_rule(c, pair);
+	if (r)
+		*r = c->rules[--c->ruleCount];
+	c->enabled[pair / 64] &= ~(1ULL << (pair % 64));
+
+	/* Lines already tracked keep their state, which is harmless */
+	return KLAPI_OK;
+}
+
+int klvanc_context_get_change_detection_suppressed(struct klvanc_context_s *ctx, uint64_t *count)
+{
+	VALIDATE(ctx);
+	VALIDATE(count);
+
+	*count = getPrivate(ctx)->change ? getPrivate(ctx)->change->suppressed : 0;
+
+	return KLAPI_OK;
+}
+
+void klvanc_change_free(struct klvanc_context_s *ctx)
+{
+	const struct klvanc_allocator_s *a = getAllocator(ctx, KLVANC_MEM_CORE);
+	struct klvanc_change_s *c = getPrivate(ctx)->change;
+	if (!c)
+		return;
+
+	klvanc_keymap_free(&c->map, a);
+	klvanc_mem_free(a, c);
+	getPrivate(ctx)->change = NULL;
+}
+
+int klvanc_change_suppress(struct klvanc_context_s *ctx, const struct klvanc_packet_header_s *hdr)
+{
+	struct vanc_context_private_s *priv = getPrivate(ctx);
+	struct klvanc_change_s *c = priv->change;
+
+	uint16_t pair = (hdr->did << 8) | hdr->dbnsdid;
+	if (!(c->enabled[pair / 64] & (1ULL << (pair % 64))))
+		return 0;
+
+	/* When the table is full the packet is simply delivered */
+	int inserted;
+	int idx = klvanc_keymap_find(&c->map, klvanc_keymap_key(hdr->did, hdr->dbnsdid, hdr->lineNr), 1, &inserted);
+	if (idx < 0)
+		return 0;
+
+	struct change_state_s *st = &c->state[idx];
+	uint64_t h = klvanc_hash_words(0, hdr->payload, hdr->payloadLengthWords);
+
+	if (!inserted && st->hash == h) {
+		const struct change_rule_s *r = find_rule(c, pair);
+		if (!r->heartbeatFrames || priv->frameNr - st->lastDelivered < r->heartbeatFrames) {
+			c->suppressed++;
+			return 1;
+		}
+	}
+
+	st->hash = h;
+	st->lastDelivered = priv->frameNr;
+
+	return 0;
+}
+
+int klvanc_change_inherit(struct klvanc_context_s *dst, struct klvanc_context_s *src)
+{
+	struct klvanc_change_s *from = getPrivate(src)->change;
+	if (!from)
+		return KLAPI_OK;
+
+	for (int i = 0; i < from->ruleCount; i++) {
+		const struct change_rule_s *r = &from->rules[i];
+		int ret = klvanc_context_enable_change_detection(dst, r->pair >> 8, r->pair & 0xff,
+			r->heartbeatFrames);
+		if (ret < 0)
+			return ret;
+	}
+
+	return KLAPI_OK;
+}
@@ -41,14 +41,14 @@
  */
 uint16_t klvanc_checksum_calculate(const uint16_t *words, int wordCount)
 {
-	uint16_t s = 0;
-	for (uint16_t i = 0; i < wordCount; i++) {
-		s += *(words + i);
-		s &= 0x01ff;
-	}
-	s |= ((~s & 0x0100) << 1);
+	/* Bit 9 only ever adds multiples of 512, so sum the whole words
+	 * and reduce once at the end. The loop vectorizes.
+	 */
+	uint32_t s = 0;
+	for (int i = 0; i < wordCount; i++)
+		s += words[i];
 
-	return s;
+	return klvanc_checksum_word(s);
 }
 
 /* For a given list of words, excludint the ADF, ending in a checksum,
@@ -63,20 +63,67 @@ uint16_t klvanc_checksum_calculate(const uint16_t *words, int wordCount)
  */
 int klvanc_checksum_is_valid(const uint16_t *words, int wordCount)
 {
-#define LOCAL_DEBUG 0
-#if 0
-	printf("%s(%p, %d): ", __func__, words, wordCount);
+	return klvanc_checksum_verify(words, wordCount, NULL);
+}
+
+/* Bits 8 and 9 a word with these low eight bits should carry: bit 8 is
+ * even parity over bits 0-7 and bit 9 is its inverse. Folding with shifts
+ * rather than a table lookup keeps the loops below vectorizable.
+ */
+static inline uint16_t parity_bits(uint16_t w)
+{
+	uint16_t p = w & 0xff;
+	p ^= p >> 4;
+	p ^= p >> 2;
+	p ^= p >> 1;
+	return 0x200 >> (p & 1);
+}
+
+int klvanc_parity_is_valid(uint16_t word)
+{
+	return (word & 0x300) == parity_bits(word);
+}
+
+int klvanc_parity_errors(const uint16_t *words, int wordCount)
+{
+	int bad = 0;
 	for (int i = 0; i < wordCount; i++)
-		printf("%04x ", *(words + i));
-	printf("\n");
-#endif
-	uint16_t sum = klvanc_checksum_calculate(words, wordCount - 1);
-	if (sum != *(words + (wordCount - 1))) {
-#if LOCAL_DEBUG
-		fprintf(stderr, "Checksum calculated as %04x, but passed as %04x\n", sum, *(words + (wordCount - 1)));
-#endif
+		bad += (words[i] & 0x300) != parity_bits(words[i]);
+
+	return bad;
+}
+
+int klvanc_checksum_verify(const uint16_t *words, int wordCount, unsigned int *parityErrors)
+{
+	if (wordCount < 1) {
+		if (parityErrors)
+			*parityErrors = 0;
 		return 0;
 	}
 
-	return 1;
+	uint32_t s = 0;
+	if (parityErrors) {
+		unsigned int bad = 0;
+		for (int i = 0; i < wordCount - 1; i++) {
+			s += words[i];
+			bad += (words[i] & 0x300) != parity_bits(words[i]);
+		}
+		*parityErrors = bad;
+	} else {
+		for (int i = 0; i < wordCount - 1; i++)
+			s += words[i];
+	}
+
+	return klvanc_checksum_word(s) == words[wordCount - 1];
+}
+
+uint32_t klvanc_parity_encode(uint16_t *dst, const uint8_t *src, int count, uint32_t sum)
+{
+	for (int i = 0; i < count; i++) {
+		uint16_t w = src[i] | parity_bits(src[i]);
+		dst[i] = w;
+		sum += w;
+	}
+
+	return sum;
 }
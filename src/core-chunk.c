@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <libklvanc/vanc.h>
+#include "core-private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ADF, DID, SDID, DC, 255 user data words, checksum */
+#define CARRY_MAX (7 + 255)
+
+struct klvanc_chunk_parser_s
+{
+	struct klvanc_context_s *ctx;
+	struct klvanc_allocator_s allocator;
+	struct klvanc_chunk_parser_stats_s stats;
+
+	/* The packet in flight, from its first ADF word */
+	uint16_t carry[CARRY_MAX];
+	unsigned int carryCount;
+	unsigned int carryLineNr;
+	unsigned int carryOffset;
+};
+
+/* Do the first count words (at most three checked) look like the start of an ADF? */
+static int adf_prefix(const uint16_t *w, unsigned int count)
+{
+	if (count > 0 && w[0] >= 3)
+		return 0;
+	if (count > 1 && (w[1] & 0x3fc) != 0x3fc)
+		return 0;
+	if (count > 2 && (w[2] & 0x3fc) != 0x3fc)
+		return 0;
+	return 1;
+}
+
+static unsigned int packet_words(const uint16_t *w)
+{
+	return sanitizeWord(w[5]) + 7;
+}
+
+/* Returns 1 when a packet was parsed, 0 when filtered or rejected. */
+static int deliver(struct klvanc_chunk_parser_s *p, unsigned int lineNr, unsigned int offset,
+		   const uint16_t *words, unsigned int count)
+{
+	int ret = klvanc_packet_parse_one(p->ctx, lineNr, offset, words, count);
+	if (ret == -ECANCELED) {
+		p->stats.filtered++;
+		return 0;
+	}
+	if (ret < 0) {
+		p->stats.skippedWords += count;
+		return 0;
+	}
+	p->stats.packets++;
+	return 1;
+}
+
+/* The carried words stopped looking like an ADF, drop words from the front
+ * until they do again, or nothing is left. next is the index in the current
+ * chunk just past the last carried word.
+ */
+static void carry_resync(struct klvanc_chunk_parser_s *p, unsigned int lineNr, unsigned int next)
+{
+	unsigned int skip = 1;
+	while (skip < p->carryCount && !adf_prefix(p->carry + skip, p->carryCount - skip))
+		skip++;
+
+	p->stats.skippedWords += skip;
+	p->carryCount -= skip;
+	memmove(p->carry, p->carry + skip, p->carryCount * sizeof(p->carry[0]));
+
+	/* The carry is a contiguous run of words ending at next. Once none of it
+	 * is left from an earlier chunk, the packet starts in this one.
+	 */
+	if (p->carryCount <= next) {
+		p->carryLineNr = lineNr;
+		p->carryOffset = next - p->carryCount;
+	} else
+		p->carryOffset += skip;
+}
+
+/* Feed up to count words from chunk[index] into the packet in flight. Returns
+ * the number of words consumed, sets *complete when the packet was finished
+ * (and delivered).
+ */
+static unsigned int carry_feed(struct klvanc_chunk_parser_s *p, unsigned int lineNr,
+			       const uint16_t *chunk, unsigned int index, unsigned int count, int *complete)
+{
+	const uint16_t *words = chunk + index;
+	unsigned int used = 0;
+
+	*complete = 0;
+
+	/* Word at a time until DC is known, checking the ADF as it arrives */
+	while (p->carryCount < 6 && used < count) {
+		p->carry[p->carryCount++] = words[used++];
+		while (p->carryCount && !adf_prefix(p->carry, p->carryCount))
+			carry_resync(p, lineNr, index + used);
+		if (p->carryCount == 0)
+			return used;
+	}
+	if (p->carryCount < 6)
+		return used;
+
+	unsigned int total = packet_words(p->carry);
+	unsigned int n = total - p->carryCount;
+	if (n > count - used)
+		n = count - used;
+	memcpy(p->carry + p->carryCount, words + used, n * sizeof(p->carry[0]));
+	p->carryCount += n;
+	used += n;
+
+	if (p->carryCount == total) {
+		*complete = deliver(p, p->carryLineNr, p->carryOffset, p->carry, total);
+		p->stats.carried++;
+		p->carryCount = 0;
+	}
+
+	return used;
+}
+
+int klvanc_chunk_parser_create(struct klvanc_context_s *ctx, struct klvanc_chunk_parser_s **parser)
+{
+	VALIDATE(ctx);
+	VALIDATE(parser);
+
+	const struct klvanc_allocator_s *allocator = getAllocator(ctx, KLVANC_MEM_CORE);
+	struct klvanc_chunk_parser_s *p = klvanc_mem_calloc(allocator, 1, sizeof(*p));
+	if (!p)
+		return -ENOMEM;
+
+	p->ctx = ctx;
+	p->allocator = *allocator;
+
+	*parser = p;
+	return KLAPI_OK;
+}
+
+void klvanc_chunk_parser_destroy(struct klvanc_chunk_parser_s *parser)
+{
+	if (!parser)
+		return;
+
+	struct klvanc_allocator_s allocator = parser->allocator;
+	klvanc_mem_free(&allocator, parser);
+}
+
+int klvanc_chunk_parser_push(struct klvanc_chunk_parser_s *parser, unsigned int lineNr,
+			     const uint16_t *words, unsigned int wordCount)
+{
+	VALIDATE(parser);
+	if (wordCount && !words)
+		return -EINVAL;
+
+	struct klvanc_chunk_parser_s *p = parser;
+	unsigned int i = 0;
+	int packets = 0;
+
+	p->stats.chunks++;
+
+	/* Finish the packet carried over from earlier chunks */
+	while (p->carryCount && i < wordCount) {
+		int complete;
+		i += carry_feed(p, lineNr, words, i, wordCount - i, &complete);
+		packets += complete;
+	}
+
+	/* Packets wholly inside this chunk are parsed in place */
+	while (i < wordCount) {
+		unsigned int avail = wordCount - i;
+
+		if (!adf_prefix(words + i, avail)) {
+			p->stats.skippedWords++;
+			i++;
+			continue;
+		}
+
+		if (avail >= 6 && packet_words(words + i) <= avail) {
+			unsigned int total = packet_words(words + i);
+			int ret = klvanc_packet_parse_one(p->ctx, lineNr, i, words + i, total);
+			if (ret == -ECANCELED) {
+				p->stats.filtered++;
+				i += total;
+			} else if (ret < 0) {
+				p->stats.skippedWords++;
+				i++;
+			} else {
+				p->stats.packets++;
+				packets++;
+				i += total;
+			}
+			continue;
+		}
+
+		/* Runs off the end of the chunk, this is the only copy we make */
+		p->carryLineNr = lineNr;
+		p->carryOffset = i;
+		p->carryCount = 0;
+		while (i < wordCount) {
+			int complete;
+			i += carry_feed(p, lineNr, words, i, wordCount - i, &complete);
+			packets += complete;
+		}
+	}
+
+	return packets;
+}
+
+int klvanc_chunk_parser_reset(struct klvanc_chunk_parser_s *parser)
+{
+	VALIDATE(parser);
+
+	if (!parser->carryCount)
+		return 0;
+
+	parser->carryCount = 0;
+	parser->stats.dropped++;
+	return 1;
+}
+
+int klvanc_chunk_parser_get_stats(struct klvanc_chunk_parser_s *parser,
+				  struct klvanc_chunk_parser_stats_s *stats)
+{
+	VALIDATE(parser);
+	VALIDATE(stats);
+
+	*stats = parser->stats;
+	return KLAPI_OK;
+}
@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <libklvanc/vanc.h>
+#include <libklvanc/vanc-lines.h>
+
+#include "core-private.h"
+
+#include <string.h>
+#include <pthread.h>
+
+struct compose_row_s
+{
+	uint8_t *dst;
+	uint32_t lineNr;
+	struct klvanc_line_s *line;	/* NULL when the row carries no packets */
+};
+
+struct klvanc_compose_s
+{
+	struct klvanc_context_s *ctx;
+	struct klvanc_line_set_s *set;
+	struct klvanc_line_cache_s *cache;
+
+	/* The frame being packed, read by every worker */
+	struct compose_row_s *rows;
+	uint32_t rowsAllocated;
+	uint32_t rowCount;
+	uint32_t width;		/* VANC words per line */
+	int luma;
+	uint32_t stride;
+	int blank;
+	int cached;
+	int recycled;
+	uint32_t next;		/* Next row to claim, atomic */
+
+	/* Helpers, the composing thread makes up the remainder */
+	pthread_t *threads;
+	uint32_t threadCount;
+	uint32_t threadsRequested;
+	pthread_mutex_t mutex;
+	pthread_cond_t start;
+	pthread_cond_t finished;
+	uint64_t generation;
+	uint32_t busy;
+	int shutdown;
+};
+
+void klvanc_compose_params_default(struct klvanc_compose_params_s *params)
+{
+	params->threads = 1;
+	params->blank = 1;
+	params->cache = 1;
+	params->recycled = 0;
+}
+
+static void compose_row(struct klvanc_compose_s *c, struct compose_row_s *row)
+{
+	int used = 0;
+
+	if (c->cached) {
+		if (klvanc_line_cache_pack(c->ctx, c->cache, row->lineNr, row->line, row->dst, c->width,
+					   c->luma, c->blank, c->stride, c->recycled, &used) == KLVANC_LINE_CACHE_SKIPPED)
+			return;
+	} else if (row->line)
+		used = klvanc_line_pack_v210(c->ctx, row->line, row->dst, c->width, c->luma, c->blank);
+	if (c->blank && (uint32_t)used < c->stride)
+		klvanc_v210_blank(row->dst + used, c->stride - used);
+}
+
+static void compose_run(struct klvanc_compose_s *c)
+{
+	uint32_t i;
+
+	while ((i = __atomic_fetch_add(&c->next, 1, __ATOMIC_RELAXED)) < c->rowCount)
+		compose_row(c, &c->rows[i]);
+}
+
+static void *compose_worker(void *p)
+{
+	struct klvanc_compose_s *c = p;
+	uint64_t seen = 0;
+
+	pthread_mutex_lock(&c->mutex);
+	while (1) {
+		while (c->generation == seen && !c->shutdown)
+			pthread_cond_wait(&c->start, &c->mutex);
+		if (c->shutdown)
+			break;
+		seen = c->generation;
+		pthread_mutex_unlock(&c->mutex);
+
+		compose_run(c);
+
+		pthread_mutex_lock(&c->mutex);
+		if (--c->busy == 0)
+			pthread_cond_signal(&c->finished);
+	}
+	pthread_mutex_unlock(&c->mutex);
+
+	return NULL;
+}
+
+static void compose_threads_stop(struct klvanc_compose_s *c)
+{
+	if (!c->threadCount)
+		return;
+
+	pthread_mutex_lock(&c->mutex);
+	c->shutdown = 1;
+	pthread_cond_broadcast(&c->start);
+	pthread_mutex_unlock(&c->mutex);
+
+	for (uint32_t i = 0; i < c->threadCount; i++)
+		pthread_join(c->threads[i], NULL);
+
+	klvanc_mem_free(getAllocator(c->ctx, KLVANC_MEM_LINES), c->threads);
+	c->threads = NULL;
+	c->threadCount = 0;
+	c->shutdown = 0;
+}
+
+/* Fewer helpers than asked for is not an error, the composing thread picks up the slack */
+static void compose_threads_start(struct klvanc_compose_s *c, uint32_t count)
+{
+	c->threads = klvanc_mem_calloc(getAllocator(c->ctx, KLVANC_MEM_LINES), count, sizeof(pthread_t));
+	if (!c->threads)
+		return;
+
+	for (uint32_t i = 0; i < count; i++) {
+		if (pthread_create(&c->threads[c->threadCount], NULL, compose_worker, c) != 0)
+			break;
+		c->threadCount++;
+	}
+}
+
+static struct klvanc_compose_s *compose_get(struct klvanc_context_s *ctx)
+{
+	struct vanc_context_private_s *priv = getPrivate(ctx);
+	struct klvanc_compose_s *c = priv->compose;
+
+	if (c)
+		return c;
+
+	c = klvanc_mem_calloc(getAllocator(ctx, KLVANC_MEM_LINES), 1, sizeof(*c));
+	if (!c)
+		return NULL;
+
+	c->ctx = ctx;
+	if (klvanc_line_set_create(ctx, &c->set, 0) < 0) {
+		klvanc_mem_free(getAllocator(ctx, KLVANC_MEM_LINES), c);
+		return NULL;
+	}
+	pthread_mutex_init(&c->mutex, NULL);
+	pthread_cond_init(&c->start, NULL);
+	pthread_cond_init(&c->finished, NULL);
+
+	priv->compose = c;
+	return c;
+}
+
+void klvanc_compose_free(struct klvanc_context_s *ctx)
+{
+	struct vanc_context_private_s *priv = getPrivate(ctx);
+	struct klvanc_compose_s *c = priv->compose;
+
+	if (!c)
+		return;
+
+	compose_threads_stop(c);
+	pthread_mutex_destroy(&c->mutex);
+	pthread_cond_destroy(&c->start);
+	pthread_cond_destroy(&c->finished);
+	klvanc_line_set_free(c->set);
+	klvanc_line_cache_free(c->cache);
+	klvanc_mem_free(getAllocator(ctx, KLVANC_MEM_LINES), c->rows);
+	klvanc_mem_free(getAllocator(ctx, KLVANC_MEM_LINES), c);
+	priv->compose = NULL;
+}
+
+/* Where a packet goes when the caller leaves it to us */
+static uint32_t placement_line(const struct klvanc_video_format_s *fmt, const struct klvanc_compose_packet_s *pkt)
+{
+	uint8_t did = pkt->words[3] & 0xff;
+	uint8_t sdid = pkt->words[4] & 0xff;
+
+	/* ST 12-2 carries its payload type, DBB1, in bit 3 of the first eight UDW */
+	if (klvanc_packet_type_lookup(did, sdid) == VANC_TYPE_SMPTE_S12_2 && pkt->wordCount >= 6 + 8) {
+		int dbb1 = 0;
+		for (int i = 0; i < 8; i++)
+			dbb1 |= ((pkt->words[6 + i] >> 3) & 0x01) << i;
+		int line = klvanc_video_format_timecode_line(fmt, dbb1);
+		if (line > 0)
+			return line;
+	}
+
+	return fmt->packetLine[0];
+}
+
+static int line_has_room(struct klvanc_line_set_s *set, uint32_t lineNr, int words, int width)
+{
+	struct klvanc_line_s *line = klvanc_line_set_find(set, lineNr);
+	int used = 0;
+
+	if (!line)
+		return words <= width;
+	if (line->num_entries == KLVANC_MAX_VANC_ENTRIES)
+		return 0;
+	for (int i = 0; i < line->num_entries; i++)
+		used += line->p_entries[i]->pixel_width;
+	return used + words <= width;
+}
+
+static int compose_place(struct klvanc_compose_s *c, const struct klvanc_video_format_s *fmt,
+			 const struct klvanc_compose_packet_s *pkt)
+{
+	if (!pkt->words || pkt->wordCount < 7)
+		return -EINVAL;
+
+	uint32_t lineNr = pkt->lineNr ? pkt->lineNr : placement_line(fmt, pkt);
+	if (klvanc_video_format_vanc_row(fmt, lineNr) < 0)
+		return -ERANGE;
+
+	/* Spill down the field rather than drop the packet */
+	const struct klvanc_video_format_range_s *field = &fmt->vanc[0];
+	if (lineNr < field->first || lineNr > field->last)
+		field = &fmt->vanc[1];
+
+	for (; lineNr <= field->last; lineNr++) {
+		if (line_has_room(c->set, lineNr, pkt->wordCount, klvanc_video_format_vanc_samples(fmt)))
+			return klvanc_line_insert(c->ctx, c->set, (uint16_t *)pkt->words, pkt->wordCount,
+						  lineNr, pkt->horizontalOffset);
+	}
+
+	return -ENOSPC;
+}
+
+int klvanc_frame_compose(struct klvanc_context_s *ctx, const struct klvanc_video_format_s *fmt,
+			 const struct klvanc_compose_packet_s *packets, unsigned int count,
+			 uint8_t *vanc, uint32_t stride, const struct klvanc_compose_params_s *params)
+{
+	struct klvanc_compose_params_s defaults;
+	struct klvanc_compose_s *c;
+	int dropped = 0;
+
+	if (!ctx || !fmt || !vanc || (count && !packets))
+		return -EINVAL;
+
+	uint32_t rows = klvanc_video_format_vanc_rows(fmt);
+	if (rows == 0 || fmt->width == 0)
+		return -EINVAL;
+
+	if (!params) {
+		klvanc_compose_params_default(&defaults);
+		params = &defaults;
+	}
+	if (!stride)
+		stride = klvanc_video_format_v210_stride(fmt);
+
+	c = compose_get(ctx);
+	if (!c)
+		return -ENOMEM;
+
+	if (rows > c->rowsAllocated) {
+		struct compose_row_s *r = klvanc_mem_calloc(getAllocator(ctx, KLVANC_MEM_LINES), rows, sizeof(*r));
+		if (!r)
+			return -ENOMEM;
+		klvanc_mem_free(getAllocator(ctx, KLVANC_MEM_LINES), c->rows);
+		c->rows = r;
+		c->rowsAllocated = rows;
+	}
+
+	klvanc_line_set_reset(c->set);
+	for (unsigned int i = 0; i < count; i++) {
+		if (compose_place(c, fmt, &packets[i]) < 0) {
+			PRINT_DEBUG("packet %d did not fit in the VANC region\n", i);
+			dropped++;
+		}
+	}
+
+	for (int f = 0, i = 0; f < 2; f++) {
+		for (uint32_t l = fmt->vanc[f].first; l && l <= fmt->vanc[f].last; l++, i++) {
+			c->rows[i].dst = vanc + (size_t)i * stride;
+			c->rows[i].lineNr = l;
+			c->rows[i].line = NULL;
+		}
+	}
+	for (int i = 0; i < c->set->num_lines; i++) {
+		struct klvanc_line_s *line = c->set->lines[i];
+		c->rows[klvanc_video_format_vanc_row(fmt, line->line_number)].line = line;
+	}
+
+	c->rowCount = rows;
+	c->width = klvanc_video_format_vanc_samples(fmt);
+	c->luma = klvanc_video_format_luma(fmt);
+	c->stride = stride;
+	c->blank = params->blank;
+	c->cached = 0;
+	c->recycled = params->recycled;
+	c->next = 0;
+
+	/* Slots are allocated here, workers only pack into them */
+	if (params->cache && !c->cache)
+		klvanc_line_cache_alloc(ctx, &c->cache);
+	if (params->cache && c->cache) {
+		c->cached = 1;
+		for (uint32_t i = 0; i < rows; i++)
+			klvanc_line_cache_prepare(c->cache, c->rows[i].lineNr, c->width);
+	}
+
+	uint32_t helpers = params->threads > 1 ? params->threads - 1 : 0;
+	if (helpers != c->threadsRequested) {
+		compose_threads_stop(c);
+		if (helpers)
+			compose_threads_start(c, helpers);
+		c->threadsRequested = helpers;
+	}
+
+	if (c->threadCount) {
+		pthread_mutex_lock(&c->mutex);
+		c->generation++;
+		c->busy = c->threadCount;
+		pthread_cond_broadcast(&c->start);
+		pthread_mutex_unlock(&c->mutex);
+
+		compose_run(c);
+
+		pthread_mutex_lock(&c->mutex);
+		while (c->busy)
+			pthread_cond_wait(&c->finished, &c->mutex);
+		pthread_mutex_unlock(&c->mutex);
+	} else
+		compose_run(c);
+
+	return dropped ? -ENOSPC : 0;
+}
@@ -0,0 +1,539 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#if defined(__linux__)
+#define _GNU_SOURCE /* pthread_attr_setaffinity_np() */
+#endif
+
+#include <libklvanc/vanc.h>
+
+#include "core-private.h"
+#include "klqueue.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+/* A channel is owned by at most one worker at a time, tracked by 'scheduled'.
+ * Whoever flips it from 0 to 1 queues the channel on a run queue, and only the
+ * worker servicing the channel clears it again. Each channel therefore sits on
+ * at most one run queue, so a run queue never needs more than maxChannels cells.
+ */
+
+struct engine_line_s
+{
+	unsigned int lineNr;
+	uint32_t offset;	/* Into the frame's words */
+	uint32_t wordCount;
+};
+
+struct engine_frame_s
+{
+	uint32_t lineCount;
+	struct engine_line_s *lines;
+	unsigned short *words;
+};
+
+struct klvanc_engine_channel_s
+{
+	struct klvanc_engine_s *engine;
+	struct klvanc_stream_s *stream;
+	uint32_t index;		/* In engine->channels */
+	uint32_t lastWorker;	/* Run queue the channel goes back on */
+
+	/* Preallocated frames, cycled between the free and filled queues */
+	struct engine_frame_s *frames;
+	struct engine_line_s *lineMem;
+	unsigned short *wordMem;
+	struct klqueue_s freeq;
+	struct klqueue_s filledq;
+
+	int scheduled;
+	uint64_t submitted;
+	uint64_t completed;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+};
+
+struct engine_worker_s
+{
+	struct klvanc_engine_s *engine;
+	uint32_t nr;
+	pthread_t thread;
+	struct klqueue_s runq;
+};
+
+struct klvanc_engine_s
+{
+	struct klvanc_engine_params_s params;
+	int *cpus;
+
+	struct engine_worker_s *workers;
+	uint32_t workersStarted;
+	sem_t sem;		/* One post per channel queued on any run queue */
+	int terminate;
+
+	pthread_mutex_t mutex;	/* Protects the channel table */
+	struct klvanc_engine_channel_s **channels;
+	uint32_t nextWorker;
+
+	struct klvanc_engine_stats_s stats;
+};
+
+void klvanc_engine_params_default(struct klvanc_engine_params_s *params)
+{
+	memset(params, 0, sizeof(*params));
+	params->workerCount = 4;
+	params->maxChannels = 64;
+	params->queueDepth = 8;
+	params->maxLinesPerFrame = 64;
+	params->maxWordsPerFrame = 32768;
+	params->batchFrames = 4;
+	params->pin = KLVANC_ENGINE_PIN_NONE;
+}
+
+static void channel_schedule(struct klvanc_engine_channel_s *ch)
+{
+	struct klvanc_engine_s *e = ch->engine;
+
+	klqueue_push(&e->workers[ch->lastWorker].runq, ch);
+	sem_post(&e->sem);
+}
+
+static void channel_run(struct engine_worker_s *w, struct klvanc_engine_channel_s *ch)
+{
+	struct klvanc_engine_s *e = w->engine;
+	uint32_t done = 0;
+
+	ch->lastWorker = w->nr;
+
+	while (done < e->params.batchFrames) {
+		struct engine_frame_s *f = klqueue_pop(&ch->filledq);
+		if (!f)
+			break;
+
+		for (uint32_t i = 0; i < f->lineCount; i++) {
+			const struct engine_line_s *l = &f->lines[i];
+			klvanc_stream_parse(ch->stream, l->lineNr, f->words + l->offset, l->wordCount);
+		}
+		klvanc_stream_frame_end(ch->stream);
+
+		klqueue_push(&ch->freeq, f);
+		done++;
+	}
+	__atomic_add_fetch(&e->stats.framesProcessed, done, __ATOMIC_RELAXED);
+
+	/* Release the channel, unless a frame arrived meanwhile. Pairs with the
+	 * fence in klvanc_engine_submit(), so one side always sees the other.
+	 */
+	pthread_mutex_lock(&ch->mutex);
+	__atomic_add_fetch(&ch->completed, done, __ATOMIC_RELAXED);
+	__atomic_store_n(&ch->scheduled, 0, __ATOMIC_RELEASE);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	int more = klqueue_count(&ch->filledq) > 0;
+	if (more) {
+		int expected = 0;
+		more = __atomic_compare_exchange_n(&ch->scheduled, &expected, 1, 0,
+						   __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+	}
+	pthread_cond_broadcast(&ch->cond);
+	pthread_mutex_unlock(&ch->mutex);
+
+	/* Back of our own queue, so other channels get a turn */
+	if (more)
+		channel_schedule(ch);
+}
+
+static struct klvanc_engine_channel_s *worker_next(struct engine_worker_s *w)
+{
+	struct klvanc_engine_s *e = w->engine;
+
+	struct klvanc_engine_channel_s *ch = klqueue_pop(&w->runq);
+	for (uint32_t i = 1; !ch && i < e->params.workerCount; i++) {
+		ch = klqueue_pop(&e->workers[(w->nr + i) % e->params.workerCount].runq);
+		if (ch)
+			__atomic_add_fetch(&e->stats.steals, 1, __ATOMIC_RELAXED);
+	}
+
+	return ch;
+}
+
+static void *worker_thread(void *p)
+{
+	struct engine_worker_s *w = p;
+	struct klvanc_engine_s *e = w->engine;
+
+	for (;;) {
+		while (sem_wait(&e->sem) < 0 && errno == EINTR)
+			;
+
+		/* Each post means a channel is queued somewhere, but a push can be
+		 * counted before it is visible, so retry until it shows up.
+		 */
+		struct klvanc_engine_channel_s *ch;
+		while (!(ch = worker_next(w))) {
+			if (__atomic_load_n(&e->terminate, __ATOMIC_ACQUIRE))
+				return NULL;
+			sched_yield();
+		}
+
+		channel_run(w, ch);
+	}
+
+	return NULL;
+}
+
+static int worker_start(struct klvanc_engine_s *e, struct engine_worker_s *w)
+{
+	pthread_attr_t attr;
+	int ret;
+
+	pthread_attr_init(&attr);
+
+	if (e->params.pin != KLVANC_ENGINE_PIN_NONE) {
+#if defined(__linux__)
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		if (e->params.pin == KLVANC_ENGINE_PIN_EACH)
+			CPU_SET(e->cpus[w->nr % e->params.cpuCount], &set);
+		else {
+			for (uint32_t i = 0; i < e->params.cpuCount; i++)
+				CPU_SET(e->cpus[i], &set);
+		}
+		ret = pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+		if (ret != 0) {
+			pthread_attr_destroy(&attr);
+			return -ret;
+		}
+#else
+		pthread_attr_destroy(&attr);
+		return -ENOTSUP;
+#endif
+	}
+
+	ret = pthread_create(&w->thread, &attr, worker_thread, w);
+	pthread_attr_destroy(&attr);
+
+	return -ret;
+}
+
+static void engine_stop(struct klvanc_engine_s *e)
+{
+	__atomic_store_n(&e->terminate, 1, __ATOMIC_RELEASE);
+	for (uint32_t i = 0; i < e->workersStarted; i++)
+		sem_post(&e->sem);
+	for (uint32_t i = 0; i < e->workersStarted; i++)
+		pthread_join(e->workers[i].thread, NULL);
+	e->workersStarted = 0;
+}
+
+static void engine_release(struct klvanc_engine_s *e)
+{
+	if (e->workers) {
+		for (uint32_t i = 0; i < e->params.workerCount; i++)
+			klqueue_free(&e->workers[i].runq);
+	}
+	sem_destroy(&e->sem);
+	pthread_mutex_destroy(&e->mutex);
+	free(e->workers);
+	free(e->channels);
+	free(e->cpus);
+	free(e);
+}
+
+int klvanc_engine_alloc(struct klvanc_engine_s **engine, struct klvanc_engine_params_s *params)
+{
+	if (!engine)
+		return -EINVAL;
+
+	struct klvanc_engine_s *e = calloc(1, sizeof(*e));
+	if (!e)
+		return -ENOMEM;
+
+	if (params)
+		e->params = *params;
+	else
+		klvanc_engine_params_default(&e->params);
+
+	struct klvanc_engine_params_s *p = &e->params;
+	if (p->workerCount == 0 || p->maxChannels == 0 || p->queueDepth == 0 ||
+	    p->maxLinesPerFrame == 0 || p->maxWordsPerFrame == 0 || p->batchFrames == 0 ||
+	    (p->pin != KLVANC_ENGINE_PIN_NONE && (!p->cpus || p->cpuCount == 0))) {
+		free(e);
+		return -EINVAL;
+	}
+
+	if (p->pin != KLVANC_ENGINE_PIN_NONE) {
+		e->cpus = calloc(p->cpuCount, sizeof(int));
+		if (!e->cpus) {
+			free(e);
+			return -ENOMEM;
+		}
+		memcpy(e->cpus, p->cpus, p->cpuCount * sizeof(int));
+		for (uint32_t i = 0; i < p->cpuCount; i++) {
+			if (e->cpus[i] < 0 || e->cpus[i] >= CPU_SETSIZE) {
+				free(e->cpus);
+				free(e);
+				return -EINVAL;
+			}
+		}
+	}
+	p->cpus = NULL;
+
+	pthread_mutex_init(&e->mutex, NULL);
+	if (sem_init(&e->sem, 0, 0) < 0) {
+		pthread_mutex_destroy(&e->mutex);
+		free(e->cpus);
+		free(e);
+		return -ENOMEM;
+	}
+
+	e->channels = calloc(p->maxChannels, sizeof(*e->channels));
+	e->workers = calloc(p->workerCount, sizeof(*e->workers));
+	if (!e->channels || !e->workers) {
+		engine_release(e);
+		return -ENOMEM;
+	}
+
+	for (uint32_t i = 0; i < p->workerCount; i++) {
+		struct engine_worker_s *w = &e->workers[i];
+		w->engine = e;
+		w->nr = i;
+		if (klqueue_init(&w->runq, p->maxChannels) < 0) {
+			engine_release(e);
+			return -ENOMEM;
+		}
+	}
+
+	for (uint32_t i = 0; i < p->workerCount; i++) {
+		int ret = worker_start(e, &e->workers[i]);
+		if (ret < 0) {
+			engine_stop(e);
+			engine_release(e);
+			return ret;
+		}
+		e->workersStarted++;
+	}
+
+	*engine = e;
+	return 0;
+}
+
+void klvanc_engine_free(struct klvanc_engine_s *engine)
+{
+	if (!engine)
+		return;
+
+	for (uint32_t i = 0; i < engine->params.maxChannels; i++) {
+		if (engine->channels[i])
+			klvanc_engine_channel_remove(engine->channels[i]);
+	}
+
+	engine_stop(engine);
+	engine_release(engine);
+}
+
+static void channel_release(struct klvanc_engine_channel_s *ch)
+{
+	const struct klvanc_allocator_s *a = NULL;
+
+	if (ch->stream)
+		a = getAllocator(klvanc_stream_get_context(ch->stream), KLVANC_MEM_CORE);
+
+	klqueue_free(&ch->freeq);
+	klqueue_free(&ch->filledq);
+	klvanc_mem_free(a, ch->frames);
+	klvanc_mem_free(a, ch->lineMem);
+	klvanc_mem_free(a, ch->wordMem);
+	pthread_cond_destroy(&ch->cond);
+	pthread_mutex_destroy(&ch->mutex);
+
+	if (ch->stream)
+		klvanc_stream_destroy(ch->stream);
+	free(ch);
+}
+
+int klvanc_engine_channel_add(struct klvanc_engine_s *engine, struct klvanc_context_s *ctx,
+	void *callback_context, struct klvanc_engine_channel_s **channel)
+{
+	if (!engine || !ctx || !channel)
+		return -EINVAL;
+
+	const struct klvanc_engine_params_s *p = &engine->params;
+
+	struct klvanc_engine_channel_s *ch = calloc(1, sizeof(*ch));
+	if (!ch)
+		return -ENOMEM;
+	ch->engine = engine;
+	pthread_mutex_init(&ch->mutex, NULL);
+	pthread_cond_init(&ch->cond, NULL);
+
+	int ret = klvanc_stream_create(ctx, &ch->stream);
+	if (ret < 0) {
+		channel_release(ch);
+		return ret;
+	}
+	if (callback_context)
+		klvanc_stream_get_context(ch->stream)->callback_context = callback_context;
+
+	/* Frame memory is charged to the context's account */
+	const struct klvanc_allocator_s *a = getAllocator(klvanc_stream_get_context(ch->stream), KLVANC_MEM_CORE);
+	ch->frames = klvanc_mem_calloc(a, p->queueDepth, sizeof(*ch->frames));
+	ch->lineMem = klvanc_mem_calloc(a, (size_t)p->queueDepth * p->maxLinesPerFrame, sizeof(*ch->lineMem));
+	ch->wordMem = klvanc_mem_calloc(a, (size_t)p->queueDepth * p->maxWordsPerFrame, sizeof(*ch->wordMem));
+	if (!ch->frames || !ch->lineMem || !ch->wordMem ||
+	    klqueue_init(&ch->freeq, p->queueDepth) < 0 ||
+	    klqueue_init(&ch->filledq, p->queueDepth) < 0) {
+		channel_release(ch);
+		return -ENOMEM;
+	}
+
+	for (uint32_t i = 0; i < p->queueDepth; i++) {
+		struct engine_frame_s *f = &ch->frames[i];
+		f->lines = ch->lineMem + ((size_t)i * p->maxLinesPerFrame);
+		f->words = ch->wordMem + ((size_t)i * p->maxWordsPerFrame);
+		klqueue_push(&ch->freeq, f);
+	}
+
+	pthread_mutex_lock(&engine->mutex);
+	uint32_t i;
+	for (i = 0; i < p->maxChannels; i++) {
+		if (!engine->channels[i])
+			break;
+	}
+	if (i == p->maxChannels) {
+		pthread_mutex_unlock(&engine->mutex);
+		channel_release(ch);
+		return -ENOSPC;
+	}
+	ch->index = i;
+	ch->lastWorker = engine->nextWorker++ % p->workerCount;
+	engine->channels[i] = ch;
+	pthread_mutex_unlock(&engine->mutex);
+
+	*channel = ch;
+	return 0;
+}
+
+int klvanc_engine_channel_remove(struct klvanc_engine_channel_s *channel)
+{
+	if (!channel)
+		return -EINVAL;
+
+	struct klvanc_engine_s *e = channel->engine;
+
+	/* Once idle, no worker can reach the channel again */
+	pthread_mutex_lock(&channel->mutex);
+	while (__atomic_load_n(&channel->scheduled, __ATOMIC_ACQUIRE) ||
+	       __atomic_load_n(&channel->completed, __ATOMIC_RELAXED) != channel->submitted)
+		pthread_cond_wait(&channel->cond, &channel->mutex);
+	pthread_mutex_unlock(&channel->mutex);
+
+	pthread_mutex_lock(&e->mutex);
+	e->channels[channel->index] = NULL;
+	pthread_mutex_unlock(&e->mutex);
+
+	channel_release(channel);
+
+	return 0;
+}
+
+struct klvanc_stream_s *klvanc_engine_channel_get_stream(struct klvanc_engine_channel_s *channel)
+{
+	return channel ? channel->stream : NULL;
+}
+
+int klvanc_engine_submit(struct klvanc_engine_channel_s *channel, const struct klvanc_engine_line_s *lines,
+	unsigned int lineCount)
+{
+	if (!channel || (!lines && lineCount))
+		return -EINVAL;
+
+	struct klvanc_engine_s *e = channel->engine;
+	if (lineCount > e->params.maxLinesPerFrame)
+		return -EINVAL;
+
+	uint64_t words = 0;
+	for (unsigned int i = 0; i < lineCount; i++) {
+		if (!lines[i].words && lines[i].wordCount)
+			return -EINVAL;
+		words += lines[i].wordCount;
+	}
+	if (words > e->params.maxWordsPerFrame)
+		return -EINVAL;
+
+	struct engine_frame_s *f = klqueue_pop(&channel->freeq);
+	if (!f) {
+		__atomic_add_fetch(&e->stats.framesRejected, 1, __ATOMIC_RELAXED);
+		return -EAGAIN;
+	}
+
+	uint32_t offset = 0;
+	for (unsigned int i = 0; i < lineCount; i++) {
+		f->lines[i].lineNr = lines[i].lineNr;
+		f->lines[i].offset = offset;
+		f->lines[i].wordCount = lines[i].wordCount;
+		memcpy(f->words + offset, lines[i].words, lines[i].wordCount * sizeof(unsigned short));
+		offset += lines[i].wordCount;
+	}
+	f->lineCount = lineCount;
+
+	__atomic_add_fetch(&channel->submitted, 1, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&e->stats.framesSubmitted, 1, __ATOMIC_RELAXED);
+	klqueue_push(&channel->filledq, f);
+
+	/* Pairs with the fence in channel_run() */
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	int expected = 0;
+	if (__atomic_compare_exchange_n(&channel->scheduled, &expected, 1, 0,
+					__ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+		channel_schedule(channel);
+
+	return 0;
+}
+
+int klvanc_engine_channel_flush(struct klvanc_engine_channel_s *channel)
+{
+	if (!channel)
+		return -EINVAL;
+
+	uint64_t target = __atomic_load_n(&channel->submitted, __ATOMIC_RELAXED);
+
+	pthread_mutex_lock(&channel->mutex);
+	while (__atomic_load_n(&channel->completed, __ATOMIC_RELAXED) < target)
+		pthread_cond_wait(&channel->cond, &channel->mutex);
+	pthread_mutex_unlock(&channel->mutex);
+
+	return 0;
+}
+
+void klvanc_engine_get_stats(struct klvanc_engine_s *engine, struct klvanc_engine_stats_s *stats)
+{
+	if (!engine || !stats)
+		return;
+
+	stats->framesSubmitted = __atomic_load_n(&engine->stats.framesSubmitted, __ATOMIC_RELAXED);
+	stats->framesRejected = __atomic_load_n(&engine->stats.framesRejected, __ATOMIC_RELAXED);
+	stats->framesProcessed = __atomic_load_n(&engine->stats.framesProcessed, __ATOMIC_RELAXED);
+	stats->steals = __atomic_load_n(&engine->stats.steals, __ATOMIC_RELAXED);
+}
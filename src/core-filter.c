@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <libklvanc/vanc.h>
+
+#include "core-private.h"
+
+#include <string.h>
+
+struct klvanc_filter_s
+{
+	enum klvanc_filter_mode_e mode;
+	uint64_t listed[0x10000 / 64];	/* Bit per DID/SDID */
+	uint32_t drops[0x10000];
+	uint64_t dropsTotal;
+};
+
+static struct klvanc_filter_s *filter_get(struct klvanc_context_s *ctx)
+{
+	struct vanc_context_private_s *priv = getPrivate(ctx);
+
+	if (!priv->filter)
+		priv->filter = klvanc_mem_calloc(getAllocator(ctx, KLVANC_MEM_CORE), 1, sizeof(*priv->filter));
+
+	return priv->filter;
+}
+
+void klvanc_filter_free(struct klvanc_context_s *ctx)
+{
+	struct vanc_context_private_s *priv = getPrivate(ctx);
+	if (!priv->filter)
+		return;
+
+	klvanc_mem_free(getAllocator(ctx, KLVANC_MEM_CORE), priv->filter);
+	priv->filter = NULL;
+}
+
+int klvanc_context_set_filter_mode(struct klvanc_context_s *ctx, enum klvanc_filter_mode_e mode)
+{
+	VALIDATE(ctx);
+	if (mode != KLVANC_FILTER_NONE && mode != KLVANC_FILTER_ALLOW && mode != KLVANC_FILTER_DENY)
+		return -EINVAL;
+
+	struct klvanc_filter_s *f = filter_get(ctx);
+	if (!f)
+		return -ENOMEM;
+	f->mode = mode;
+
+	return KLAPI_OK;
+}
+
+int klvanc_context_filter_add(struct klvanc_context_s *ctx, uint8_t did, uint8_t sdid)
+{
+	VALIDATE(ctx);
+
+	struct klvanc_filter_s *f = filter_get(ctx);
+	if (!f)
+		return -ENOMEM;
+
+	uint16_t pair = (did << 8) | sdid;
+	f->listed[pair / 64] |= 1ULL << (pair % 64);
+
+	return KLAPI_OK;
+}
+
+int klvanc_context_filter_remove(struct klvanc_context_s *ctx, uint8_t did, uint8_t sdid)
+{
+	VALIDATE(ctx);
+
+	struct klvanc_filter_s *f = getPrivate(ctx)->filter;
+	if (f) {
+		uint16_t pair = (did << 8) | sdid;
+		f->listed[pair / 64] &= ~(1ULL << (pair % 64));
+	}
+
+	return KLAPI_OK;
+}
+
+int klvanc_context_filter_clear(struct klvanc_context_s *ctx)
+{
+	VALIDATE(ctx);
+
+	struct klvanc_filter_s *f = getPrivate(ctx)->filter;
+	if (f) {
+		memset(f->listed, 0, sizeof(f->listed));
+		memset(f->drops, 0, sizeof(f->drops));
+		f->dropsTotal = 0;
+	}
+
+	return KLAPI_OK;
+}
+
+int klvanc_context_get_filter_drops(struct klvanc_context_s *ctx, uint8_t did, uint8_t sdid, uint64_t *count)
+{
+	VALIDATE(ctx);
+	VALIDATE(count);
+
+	struct klvanc_filter_s *f = getPrivate(ctx)->filter;
+	*count = f ? f->drops[(did << 8) | sdid] : 0;
+
+	return KLAPI_OK;
+}
+
+int klvanc_context_get_filter_drops_total(struct klvanc_context_s *ctx, uint64_t *count)
+{
+	VALIDATE(ctx);
+	VALIDATE(count);
+
+	struct klvanc_filter_s *f = getPrivate(ctx)->filter;
+	*count = f ? f->dropsTotal : 0;
+
+	return KLAPI_OK;
+}
+
+int klvanc_filter_drop(struct klvanc_context_s *ctx, uint8_t did, uint8_t sdid)
+{
+	struct klvanc_filter_s *f = getPrivate(ctx)->filter;
+	if (f->mode == KLVANC_FILTER_NONE)
+		return 0;
+
+	uint16_t pair = (did << 8) | sdid;
+	int listed = (f->listed[pair / 64] >> (pair % 64)) & 1;
+	if (listed == (f->mode == KLVANC_FILTER_ALLOW))
+		return 0;
+
+	f->drops[pair]++;
+	f->dropsTotal++;
+
+	return 1;
+}
+
+int klvanc_filter_inherit(struct klvanc_context_s *dst, struct klvanc_context_s *src)
+{
+	struct klvanc_filter_s *from = getPrivate(src)->filter;
+	if (!from)
+		return KLAPI_OK;
+
+	struct klvanc_filter_s *f = filter_get(dst);
+	if (!f)
+		return -ENOMEM;
+	f->mode = from->mode;
+	memcpy(f->listed, from->listed, sizeof(f->listed));
+
+	return KLAPI_OK;
+}
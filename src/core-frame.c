@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <libklvanc/vanc.h>
+
+#include "core-private.h"
+
+/* The data count is one byte, so every packet fits a 255 byte slice of the arena */
+#define FRAME_MAX_PAYLOAD 255
+
+struct klvanc_frame_collect_s
+{
+	unsigned int packetCount;
+	unsigned int droppedPackets;
+	struct klvanc_frame_packet_s packets[KLVANC_FRAME_MAX_PACKETS];
+	uint8_t payload[KLVANC_FRAME_MAX_PACKETS][FRAME_MAX_PAYLOAD];
+};
+
+void klvanc_frame_collect(struct klvanc_context_s *ctx, const struct klvanc_packet_header_s *hdr)
+{
+	struct vanc_context_private_s *priv = getPrivate(ctx);
+
+	if (!priv->frame) {
+		priv->frame = klvanc_mem_calloc(getAllocator(ctx, KLVANC_MEM_CORE), 1, sizeof(*priv->frame));
+		if (!priv->frame)
+			return;
+	}
+
+	struct klvanc_frame_collect_s *f = priv->frame;
+	if (f->packetCount == KLVANC_FRAME_MAX_PACKETS) {
+		f->droppedPackets++;
+		return;
+	}
+
+	unsigned int i = f->packetCount++;
+	struct klvanc_frame_packet_s *p = &f->packets[i];
+	p->type = hdr->type;
+	p->did = hdr->did;
+	p->sdid = hdr->dbnsdid;
+	p->checksumValid = hdr->checksumValid;
+	p->payloadLength = hdr->payloadLengthWords > FRAME_MAX_PAYLOAD ? FRAME_MAX_PAYLOAD : hdr->payloadLengthWords;
+	p->lineNr = hdr->lineNr;
+	p->horizontalOffset = hdr->horizontalOffset;
+	p->payload = f->payload[i];
+	for (int j = 0; j < p->payloadLength; j++)
+		f->payload[i][j] = sanitizeWord(hdr->payload[j]);
+}
+
+void klvanc_frame_deliver(struct klvanc_context_s *ctx)
+{
+	struct vanc_context_private_s *priv = getPrivate(ctx);
+	struct klvanc_frame_collect_s *f = priv->frame;
+	struct klvanc_frame_s frame;
+
+	frame.frameNr = priv->frameNr;
+	frame.packetCount = f ? f->packetCount : 0;
+	frame.droppedPackets = f ? f->droppedPackets : 0;
+	frame.packets = f ? f->packets : NULL;
+
+	PERF_CALLBACK(ctx->callbacks->frame(ctx->callback_context, ctx, &frame));
+
+	if (f) {
+		f->packetCount = 0;
+		f->droppedPackets = 0;
+	}
+}
+
+void klvanc_frame_free(struct klvanc_context_s *ctx)
+{
+	struct vanc_context_private_s *priv = getPrivate(ctx);
+	if (!priv->frame)
+		return;
+
+	klvanc_mem_free(getAllocator(ctx, KLVANC_MEM_CORE), priv->frame);
+	priv->frame = NULL;
+}
+
+int klvanc_frame_parse(struct klvanc_context_s *ctx, const struct klvanc_frame_line_s *lines,
+	unsigned int lineCount)
+{
+	VALIDATE(ctx);
+	if (!lines && lineCount)
+		return -EINVAL;
+
+	int found = 0;
+	for (unsigned int i = 0; i < lineCount; i++) {
+		if (lines[i].wordCount == 0)
+			continue;
+		int ret = klvanc_packet_parse(ctx, lines[i].lineNr, lines[i].words, lines[i].wordCount);
+		if (ret > 0)
+			found += ret;
+	}
+
+	int ret = klvanc_frame_end(ctx);
+	if (ret < 0)
+		return ret;
+
+	return found;
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+/* Not for inclusion by user applications */
+
+#ifndef _CORE_HASH_H
+#define _CORE_HASH_H
+
+#include <stdint.h>
+
+/* xxHash64 style, reading four words per round. Pass the previous result as
+ * the seed to hash several buffers as one.
+ */
+#define KLVANC_HASH_PRIME64_1 0x9E3779B185EBCA87ULL
+#define KLVANC_HASH_PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define KLVANC_HASH_PRIME64_3 0x165667B19E3779F9ULL
+#define KLVANC_HASH_PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define KLVANC_HASH_PRIME64_5 0x27D4EB2F165667C5ULL
+
+static __inline__ uint64_t klvanc_hash_rotl64(uint64_t x, int r)
+{
+	return (x << r) | (x >> (64 - r));
+}
+
+static __inline__ uint64_t klvanc_hash_words(uint64_t seed, const unsigned short *w, int count)
+{
+	uint64_t h = seed + KLVANC_HASH_PRIME64_5 + (uint64_t)count;
+	int i = 0;
+
+	for (; i + 4 <= count; i += 4) {
+		uint64_t k = (uint64_t)w[i] | ((uint64_t)w[i + 1] << 16) |
+			     ((uint64_t)w[i + 2] << 32) | ((uint64_t)w[i + 3] << 48);
+		k *= KLVANC_HASH_PRIME64_2;
+		k = klvanc_hash_rotl64(k, 31);
+		k *= KLVANC_HASH_PRIME64_1;
+		h ^= k;
+		h = klvanc_hash_rotl64(h, 27) * KLVANC_HASH_PRIME64_1 + KLVANC_HASH_PRIME64_4;
+	}
+	for (; i < count; i++) {
+		h ^= w[i] * KLVANC_HASH_PRIME64_5;
+		h = klvanc_hash_rotl64(h, 11) * KLVANC_HASH_PRIME64_1;
+	}
+
+	h ^= h >> 33;
+	h *= KLVANC_HASH_PRIME64_2;
+	h ^= h >> 29;
+	h *= KLVANC_HASH_PRIME64_3;
+	h ^= h >> 32;
+
+	return h;
+}
+
+#endif /* _CORE_HASH_H */
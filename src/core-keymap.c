@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "core-keymap.h"
+#include "core-alloc.h"
+
+#include <string.h>
+#include <errno.h>
+
+int klvanc_keymap_alloc(struct klvanc_keymap_s *map, const struct klvanc_allocator_s *a, uint32_t maxEntries)
+{
+	if (maxEntries == 0 || maxEntries > KLVANC_KEYMAP_MAX_ENTRIES)
+		return -EINVAL;
+
+	uint32_t hashSize = 1;
+	while (hashSize < maxEntries * 2)
+		hashSize <<= 1;
+
+	memset(map, 0, sizeof(*map));
+	map->keys = klvanc_mem_calloc(a, maxEntries, sizeof(uint32_t));
+	map->hash = klvanc_mem_calloc(a, hashSize, sizeof(uint16_t));
+	if (!map->keys || !map->hash) {
+		klvanc_keymap_free(map, a);
+		return -ENOMEM;
+	}
+	map->mask = hashSize - 1;
+	map->max = maxEntries;
+
+	return 0;
+}
+
+void klvanc_keymap_free(struct klvanc_keymap_s *map, const struct klvanc_allocator_s *a)
+{
+	klvanc_mem_free(a, map->keys);
+	klvanc_mem_free(a, map->hash);
+	memset(map, 0, sizeof(*map));
+}
+
+void klvanc_keymap_reset(struct klvanc_keymap_s *map)
+{
+	memset(map->hash, 0, (map->mask + 1) * sizeof(uint16_t));
+	map->count = 0;
+}
+
+int klvanc_keymap_find(struct klvanc_keymap_s *map, uint32_t key, int insert, int *inserted)
+{
+	/* The table is at least twice the capacity, so probing always ends */
+	uint32_t h = (key * 2654435761U) & map->mask;
+
+	if (inserted)
+		*inserted = 0;
+
+	while (map->hash[h]) {
+		if (map->keys[map->hash[h] - 1] == key)
+			return map->hash[h] - 1;
+		h = (h + 1) & map->mask;
+	}
+
+	if (!insert || map->count == map->max)
+		return -1;
+
+	map->keys[map->count] = key;
+	map->hash[h] = ++map->count;
+	if (inserted)
+		*inserted = 1;
+
+	return map->count - 1;
+}
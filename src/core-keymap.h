@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* Not for inclusion by user applications */
+
+#ifndef _CORE_KEYMAP_H
+#define _CORE_KEYMAP_H
+
+#include <stdint.h>
+#include <libklvanc/allocator.h>
+
+/* Fixed capacity map from a DID/SDID/line key to a dense index, assigned in
+ * first seen order. Callers keep their per entry state in arrays indexed by it.
+ */
+struct klvanc_keymap_s
+{
+	uint32_t *keys;
+	uint16_t *hash;		/* Index plus one, zero is empty */
+	uint32_t mask;
+	uint32_t count;
+	uint32_t max;
+};
+
+#define KLVANC_KEYMAP_MAX_ENTRIES 65535
+
+/* Every line number keeps its own key, emptiness is tracked in the hash table not the keys */
+static __inline__ uint32_t klvanc_keymap_key(uint16_t did, uint16_t sdid, uint16_t lineNr)
+{
+	return ((uint32_t)(did & 0xff) << 24) | ((uint32_t)(sdid & 0xff) << 16) | lineNr;
+}
+
+int  klvanc_keymap_alloc(struct klvanc_keymap_s *map, const struct klvanc_allocator_s *a, uint32_t maxEntries);
+void klvanc_keymap_free(struct klvanc_keymap_s *map, const struct klvanc_allocator_s *a);
+void klvanc_keymap_reset(struct klvanc_keymap_s *map);
+
+/* Returns the index of key, adding it when insert is set and there is room.
+ * *inserted, when not NULL, reports whether the key was added. -1 if absent.
+ */
+int  klvanc_keymap_find(struct klvanc_keymap_s *map, uint32_t key, int insert, int *inserted);
+
+#endif /* _CORE_KEYMAP_H */
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <libklvanc/vanc.h>
+#include <libklvanc/vanc-lines.h>
+
+#include "core-private.h"
+#include "core-hash.h"
+
+#include <string.h>
+
+struct line_cache_slot_s
+{
+	uint64_t hash;
+	int valid;
+	int bytes;
+	int capacity;
+	uint8_t data[];
+};
+
+struct klvanc_line_cache_s
+{
+	struct klvanc_allocator_s allocator;
+	struct line_cache_slot_s *slots[KLVANC_LINE_SET_MAX_LINE_NUMBER];
+	struct klvanc_line_cache_stats_s stats;
+};
+
+/* Most bytes a line of this width packs to, HD packing being the denser */
+static int packed_bytes(int line_pixel_width)
+{
+	return ((line_pixel_width + 5) / 6) * 16;
+}
+
+int klvanc_line_cache_alloc(struct klvanc_context_s *ctx, struct klvanc_line_cache_s **cache)
+{
+	if (!ctx || !cache)
+		return -EINVAL;
+
+	const struct klvanc_allocator_s *allocator = getAllocator(ctx, KLVANC_MEM_LINES);
+	struct klvanc_line_cache_s *c = klvanc_mem_calloc(allocator, 1, sizeof(*c));
+	if (!c)
+		return -ENOMEM;
+
+	c->allocator = *allocator;
+	*cache = c;
+	return 0;
+}
+
+void klvanc_line_cache_free(struct klvanc_line_cache_s *cache)
+{
+	if (!cache)
+		return;
+
+	struct klvanc_allocator_s allocator = cache->allocator;
+	for (int i = 0; i < KLVANC_LINE_SET_MAX_LINE_NUMBER; i++)
+		klvanc_mem_free(&allocator, cache->slots[i]);
+	klvanc_mem_free(&allocator, cache);
+}
+
+void klvanc_line_cache_invalidate(struct klvanc_line_cache_s *cache)
+{
+	if (!cache)
+		return;
+
+	for (int i = 0; i < KLVANC_LINE_SET_MAX_LINE_NUMBER; i++) {
+		if (cache->slots[i])
+			cache->slots[i]->valid = 0;
+	}
+}
+
+int klvanc_line_cache_get_stats(struct klvanc_line_cache_s *cache, struct klvanc_line_cache_stats_s *stats)
+{
+	if (!cache || !stats)
+		return -EINVAL;
+
+	stats->generated = __atomic_load_n(&cache->stats.generated, __ATOMIC_RELAXED);
+	stats->copied = __atomic_load_n(&cache->stats.copied, __ATOMIC_RELAXED);
+	stats->skipped = __atomic_load_n(&cache->stats.skipped, __ATOMIC_RELAXED);
+	return 0;
+}
+
+int klvanc_line_cache_prepare(struct klvanc_line_cache_s *cache, int lineNr, int line_pixel_width)
+{
+	if (lineNr < 0 || lineNr >= KLVANC_LINE_SET_MAX_LINE_NUMBER)
+		return -EINVAL;
+
+	int need = packed_bytes(line_pixel_width);
+	struct line_cache_slot_s *slot = cache->slots[lineNr];
+	if (slot && slot->capacity >= need)
+		return 0;
+
+	klvanc_mem_free(&cache->allocator, slot);
+	slot = klvanc_mem_calloc(&cache->allocator, 1, sizeof(*slot) + need);
+	cache->slots[lineNr] = slot;
+	if (!slot)
+		return -ENOMEM;
+
+	slot->capacity = need;
+	return 0;
+}
+
+static uint64_t line_hash(const struct klvanc_line_s *line, int line_pixel_width, int luma, int blank,
+			  uint32_t stride)
+{
+	uint64_t h = (uint64_t)line_pixel_width | ((uint64_t)blank << 16) | ((uint64_t)luma << 17) |
+		     ((uint64_t)stride << 32);
+
+	h = klvanc_hash_words(h, NULL, 0);
+	for (int i = 0; line && i < line->num_entries; i++)
+		h = klvanc_hash_words(h, line->p_entries[i]->payload, line->p_entries[i]->pixel_width);
+
+	return h;
+}
+
+int klvanc_line_cache_pack(struct klvanc_context_s *ctx, struct klvanc_line_cache_s *cache,
+			   int lineNr, struct klvanc_line_s *line, uint8_t *out_buf,
+			   int line_pixel_width, int luma, int blank, uint32_t stride, int recycled, int *bytes)
+{
+	struct line_cache_slot_s *slot = NULL;
+
+	if (lineNr >= 0 && lineNr < KLVANC_LINE_SET_MAX_LINE_NUMBER)
+		slot = cache->slots[lineNr];
+	if (slot && slot->capacity < packed_bytes(line_pixel_width))
+		slot = NULL;
+
+	uint64_t h = line_hash(line, line_pixel_width, luma, blank, stride);
+	if (slot && slot->valid && slot->hash == h) {
+		*bytes = slot->bytes;
+		if (recycled) {
+			__atomic_add_fetch(&cache->stats.skipped, 1, __ATOMIC_RELAXED);
+			return KLVANC_LINE_CACHE_SKIPPED;
+		}
+		memcpy(out_buf, slot->data, slot->bytes);
+		__atomic_add_fetch(&cache->stats.copied, 1, __ATOMIC_RELAXED);
+		return KLVANC_LINE_CACHE_COPIED;
+	}
+
+	*bytes = line ? klvanc_line_pack_v210(ctx, line, out_buf, line_pixel_width, luma, blank) : 0;
+	if (slot) {
+		memcpy(slot->data, out_buf, *bytes);
+		slot->bytes = *bytes;
+		slot->hash = h;
+		slot->valid = 1;
+	}
+	__atomic_add_fetch(&cache->stats.generated, 1, __ATOMIC_RELAXED);
+
+	return KLVANC_LINE_CACHE_GENERATED;
+}
+
+int klvanc_generate_vanc_line_v210_cached(struct klvanc_context_s *ctx, struct klvanc_line_cache_s *cache,
+					  struct klvanc_line_s *line, uint8_t *out_buf, int line_pixel_width,
+					  int recycled)
+{
+	int bytes;
+
+	if (!cache || !line || !out_buf)
+		return -EINVAL;
+
+	/* Without a slot the line is still generated, just not remembered */
+	klvanc_line_cache_prepare(cache, line->line_number, line_pixel_width);
+
+	return klvanc_line_cache_pack(ctx, cache, line->line_number, line, out_buf, line_pixel_width,
+				      line_pixel_width > 720, 1, 0, recycled, &bytes);
+}
+
+int klvanc_generate_vanc_line_v210_cached_format(struct klvanc_context_s *ctx, struct klvanc_line_cache_s *cache,
+						 struct klvanc_line_s *line, uint8_t *out_buf,
+						 const struct klvanc_video_format_s *fmt, int recycled)
+{
+	int bytes;
+
+	if (!cache || !line || !out_buf || !fmt)
+		return -EINVAL;
+
+	int samples = klvanc_video_format_vanc_samples(fmt);
+	klvanc_line_cache_prepare(cache, line->line_number, samples);
+
+	return klvanc_line_cache_pack(ctx, cache, line->line_number, line, out_buf, samples,
+				      klvanc_video_format_luma(fmt), 1, 0, recycled, &bytes);
+}
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <libklvanc/vanc.h>
+
+#include "core-private.h"
+
+#include <string.h>
+
+struct linemap_line_s
+{
+	uint8_t learned;
+	uint16_t offset;	/* Lowest horizontal offset a packet was seen at */
+	uint64_t lastSeen;	/* Frame number */
+};
+
+/* A learned line is forgotten by a probe after this many empty re-probe intervals,
+ * so services that only send occasionally, such as SCTE-104, are not dropped.
+ */
+#define LINEMAP_FORGET_INTERVALS 4
+
+struct klvanc_linemap_s
+{
+	unsigned int warmupFrames;
+	unsigned int reprobeFrames;
+	uint64_t warmupEnd;	/* Frame number */
+
+	struct linemap_line_s lines[KLVANC_LINE_MAP_MAX_LINES];
+
+	struct klvanc_line_map_stats_s stats;
+};
+
+enum linemap_action_e
+{
+	LINEMAP_SKIP,
+	LINEMAP_SCAN,
+	LINEMAP_PROBE,
+};
+
+static enum linemap_action_e linemap_action(struct vanc_context_private_s *priv, unsigned int lineNr)
+{
+	struct klvanc_linemap_s *m = priv->linemap;
+
+	if (lineNr >= KLVANC_LINE_MAP_MAX_LINES || priv->frameNr < m->warmupEnd)
+		return LINEMAP_PROBE;
+
+	/* Offset by line so re-probes are spread across frames */
+	if ((priv->frameNr + lineNr) % m->reprobeFrames == 0)
+		return LINEMAP_PROBE;
+
+	return m->lines[lineNr].learned ? LINEMAP_SCAN : LINEMAP_SKIP;
+}
+
+int klvanc_context_enable_line_map(struct klvanc_context_s *ctx, unsigned int warmupFrames,
+	unsigned int reprobeFrames)
+{
+	VALIDATE(ctx);
+	if (warmupFrames == 0 || reprobeFrames == 0)
+		return -EINVAL;
+
+	struct vanc_context_private_s *priv = getPrivate(ctx);
+	struct klvanc_linemap_s *m = priv->linemap;
+	if (!m) {
+		m = klvanc_mem_calloc(getAllocator(ctx, KLVANC_MEM_CORE), 1, sizeof(*m));
+		if (!m)
+			return -ENOMEM;
+		priv->linemap = m;
+	} else
+		memset(m, 0, sizeof(*m));
+
+	m->warmupFrames = warmupFrames;
+	m->reprobeFrames = reprobeFrames;
+	m->warmupEnd = priv->frameNr + warmupFrames;
+
+	return KLAPI_OK;
+}
+
+void klvanc_linemap_free(struct klvanc_context_s *ctx)
+{
+	struct vanc_context_private_s *priv = getPrivate(ctx);
+	if (!priv->linemap)
+		return;
+
+	klvanc_mem_free(getAllocator(ctx, KLVANC_MEM_CORE), priv->linemap);
+	priv->linemap = NULL;
+}
+
+int klvanc_context_disable_line_map(struct klvanc_context_s *ctx)
+{
+	VALIDATE(ctx);
+
+	klvanc_linemap_free(ctx);
+
+	return KLAPI_OK;
+}
+
+int klvanc_line_map_wants_line(struct klvanc_context_s *ctx, unsigned int lineNr)
+{
+	if (!ctx || !getPrivate(ctx)->linemap)
+		return 1;
+
+	return linemap_action(getPrivate(ctx), lineNr) != LINEMAP_SKIP;
+}
+
+int klvanc_context_get_line_map_stats(struct klvanc_context_s *ctx, struct klvanc_line_map_stats_s *stats)
+{
+	VALIDATE(ctx);
+	VALIDATE(stats);
+
+	struct vanc_context_private_s *priv = getPrivate(ctx);
+	struct klvanc_linemap_s *m = priv->linemap;
+	if (!m)
+		return -ENOENT;
+
+	*stats = m->stats;
+	stats->learnedLines = 0;
+	for (int i = 0; i < KLVANC_LINE_MAP_MAX_LINES; i++)
+		stats->learnedLines += m->lines[i].learned;
+	stats->warmingUp = priv->frameNr < m->warmupEnd;
+
+	return KLAPI_OK;
+}
+
+int klvanc_linemap_begin(struct klvanc_context_s *ctx, unsigned int lineNr, unsigned int *offset)
+{
+	struct klvanc_linemap_s *m = getPrivate(ctx)->linemap;
+
+	switch (linemap_action(getPrivate(ctx), lineNr)) {
+	case LINEMAP_SKIP:
+		m->stats.linesSkipped++;
+		return 0;
+	case LINEMAP_SCAN:
+		m->stats.linesScanned++;
+		*offset = m->lines[lineNr].offset;
+		return 1;
+	default:
+		m->stats.linesProbed++;
+		*offset = 0;
+		return 1;
+	}
+}
+
+void klvanc_linemap_end(struct klvanc_context_s *ctx, unsigned int lineNr, unsigned int offset,
+	int firstOffset)
+{
+	struct vanc_context_private_s *priv = getPrivate(ctx);
+	struct klvanc_linemap_s *m = priv->linemap;
+
+	if (lineNr >= KLVANC_LINE_MAP_MAX_LINES)
+		return;
+
+	struct linemap_line_s *l = &m->lines[lineNr];
+	if (firstOffset >= 0) {
+		if (!l->learned || firstOffset < l->offset)
+			l->offset = firstOffset;
+		l->learned = 1;
+		l->lastSeen = priv->frameNr;
+	} else if (l->learned && offset == 0 &&
+		   priv->frameNr - l->lastSeen >= (uint64_t)m->reprobeFrames * LINEMAP_FORGET_INTERVALS) {
+		l->learned = 0;
+	}
+}
+
+int klvanc_linemap_inherit(struct klvanc_context_s *dst, struct klvanc_context_s *src)
+{
+	struct klvanc_linemap_s *from = getPrivate(src)->linemap;
+	if (!from)
+		return KLAPI_OK;
+
+	return klvanc_context_enable_line_map(dst, from->warmupFrames, from->reprobeFrames);
+}
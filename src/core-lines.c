@@ -28,26 +28,179 @@
 #include <stdlib.h>
 #include <string.h>
 
-struct klvanc_line_s *klvanc_line_create(int line_number)
+/* Backing store for a pooled line set. Everything a frame needs lives in one
+ * allocation; reset only walks the lines actually used.
+ */
+struct klvanc_line_pool_s
+{
+	struct klvanc_line_set_s set;
+	struct klvanc_allocator_s allocator;
+	struct klvanc_line_s *index[KLVANC_LINE_SET_MAX_LINE_NUMBER];
+	struct klvanc_line_s lines[KLVANC_MAX_VANC_LINES];
+	struct klvanc_entry_s entries[KLVANC_MAX_VANC_LINES * KLVANC_MAX_VANC_ENTRIES];
+	unsigned int entriesUsed;
+	unsigned int arenaWords;
+	unsigned int arenaUsed;
+	uint16_t arena[];
+};
+
+int klvanc_line_set_create(struct klvanc_context_s *ctx, struct klvanc_line_set_s **set,
+			   unsigned int arenaWords)
+{
+	if (!ctx || !set)
+		return -EINVAL;
+
+	if (arenaWords == 0)
+		arenaWords = KLVANC_LINE_SET_DEFAULT_ARENA_WORDS;
+
+	const struct klvanc_allocator_s *allocator = getAllocator(ctx, KLVANC_MEM_LINES);
+	struct klvanc_line_pool_s *pool = klvanc_mem_calloc(allocator, 1,
+		sizeof(*pool) + arenaWords * sizeof(uint16_t));
+	if (!pool)
+		return -ENOMEM;
+
+	pool->allocator = *allocator;
+	pool->arenaWords = arenaWords;
+	for (int i = 0; i < KLVANC_MAX_VANC_LINES; i++)
+		pool->lines[i].pooled = 1;
+	pool->set.pool = pool;
+
+	*set = &pool->set;
+	return 0;
+}
+
+void klvanc_line_set_reset(struct klvanc_line_set_s *set)
+{
+	struct klvanc_line_pool_s *pool;
+
+	if (!set || !(pool = set->pool))
+		return;
+
+	for (int i = 0; i < set->num_lines; i++) {
+		struct klvanc_line_s *line = set->lines[i];
+		pool->index[line->line_number] = NULL;
+		memset(line->p_entries, 0, line->num_entries * sizeof(line->p_entries[0]));
+		line->num_entries = 0;
+		set->lines[i] = NULL;
+	}
+	set->num_lines = 0;
+	pool->entriesUsed = 0;
+	pool->arenaUsed = 0;
+}
+
+void klvanc_line_set_free(struct klvanc_line_set_s *set)
+{
+	struct klvanc_line_pool_s *pool;
+
+	if (!set || !(pool = set->pool))
+		return;
+
+	struct klvanc_allocator_s allocator = pool->allocator;
+	klvanc_mem_free(&allocator, pool);
+}
+
+/* Keep entries ordered by horizontal offset as they arrive, ties in insertion
+ * order, so the generators can pack them in a single pass without sorting.
+ */
+static void line_add_entry(struct klvanc_line_s *line, struct klvanc_entry_s *entry)
+{
+	int i = line->num_entries++;
+	while (i > 0 && line->p_entries[i - 1]->h_offset > entry->h_offset) {
+		line->p_entries[i] = line->p_entries[i - 1];
+		i--;
+	}
+	line->p_entries[i] = entry;
+}
+
+struct klvanc_line_s *klvanc_line_set_find(struct klvanc_line_set_s *set, int line_number)
+{
+	if (set->pool) {
+		if (line_number < 0 || line_number >= KLVANC_LINE_SET_MAX_LINE_NUMBER)
+			return NULL;
+		return set->pool->index[line_number];
+	}
+
+	for (int i = 0; i < set->num_lines; i++) {
+		if (set->lines[i] && set->lines[i]->line_number == line_number)
+			return set->lines[i];
+	}
+	return NULL;
+}
+
+static int line_insert_pooled(struct klvanc_context_s *ctx, struct klvanc_line_pool_s *pool,
+			      uint16_t *pixels, int pixel_width,
+			      int line_number, int horizontal_offset)
+{
+	struct klvanc_line_set_s *set = &pool->set;
+
+	if (line_number < 0 || line_number >= KLVANC_LINE_SET_MAX_LINE_NUMBER || pixel_width < 0)
+		return -EINVAL;
+
+	struct klvanc_line_s *line = pool->index[line_number];
+	if (line == NULL) {
+		if (set->num_lines == KLVANC_MAX_VANC_LINES) {
+			PRINT_DEBUG("array of lines is full!\n");
+			return -ENOMEM;
+		}
+		/* Lines are handed out in order, so slot n always backs set->lines[n] */
+		line = &pool->lines[set->num_lines];
+		line->line_number = line_number;
+		set->lines[set->num_lines++] = line;
+		pool->index[line_number] = line;
+	}
+
+	if (line->num_entries == KLVANC_MAX_VANC_ENTRIES) {
+		PRINT_DEBUG("line is full!\n");
+		return -ENOMEM;
+	}
+
+	if ((unsigned int)pixel_width > pool->arenaWords - pool->arenaUsed) {
+		PRINT_DEBUG("line set arena is full!\n");
+		return -ENOMEM;
+	}
+
+	struct klvanc_entry_s *entry = &pool->entries[pool->entriesUsed++];
+	entry->payload = &pool->arena[pool->arenaUsed];
+	pool->arenaUsed += pixel_width;
+	memcpy(entry->payload, pixels, pixel_width * sizeof(uint16_t));
+	entry->h_offset = horizontal_offset;
+	entry->pixel_width = pixel_width;
+
+	line_add_entry(line, entry);
+	return 0;
+}
+
+static struct klvanc_line_s *line_create(const struct klvanc_allocator_s *allocator, int line_number)
 {
 	struct klvanc_line_s *new_line = NULL;
-	new_line = (struct klvanc_line_s *)malloc(sizeof(struct klvanc_line_s));
+	new_line = (struct klvanc_line_s *)klvanc_mem_calloc(allocator, 1, sizeof(struct klvanc_line_s));
 	if (new_line == NULL)
 		return NULL;
-	memset(new_line, 0, sizeof(struct klvanc_line_s));
 	new_line->line_number = line_number;
+	if (allocator)
+		new_line->allocator = *allocator;
 	return new_line;
 }
 
+struct klvanc_line_s *klvanc_line_create(int line_number)
+{
+	return line_create(NULL, line_number);
+}
+
 void klvanc_line_free(struct klvanc_line_s *line)
 {
+	if (line->pooled)
+		return;
+
+	struct klvanc_allocator_s allocator = line->allocator;
+
 	for (int i = 0; i < KLVANC_MAX_VANC_ENTRIES; i++) {
 		if (line->p_entries[i] != NULL) {
-			free(line->p_entries[i]->payload);
-			free(line->p_entries[i]);
+			klvanc_mem_free(&allocator, line->p_entries[i]->payload);
+			klvanc_mem_free(&allocator, line->p_entries[i]);
 		}
 	}
-	free(line);
+	klvanc_mem_free(&allocator, line);
 }
 
 int klvanc_line_insert(struct klvanc_context_s *ctx, struct klvanc_line_set_s *vanc_lines,
@@ -55,25 +208,17 @@ int klvanc_line_insert(struct klvanc_context_s *ctx, struct klvanc_line_set_s *v
 {
 	int i;
 	struct klvanc_line_s *line = vanc_lines->lines[0];
-	struct klvanc_entry_s *new_entry =
-	    (struct klvanc_entry_s *)malloc(sizeof(struct klvanc_entry_s));
-	if (new_entry == NULL)
-		return -ENOMEM;
 
-	new_entry->payload =
-	    (uint16_t *) malloc(pixel_width * sizeof(uint16_t));
-	if (new_entry->payload == NULL) {
-		free(new_entry);
-		return -ENOMEM;
-	}
-	memcpy(new_entry->payload, pixels, pixel_width * sizeof(uint16_t));
-	new_entry->h_offset = horizontal_offset;
-	new_entry->pixel_width = pixel_width;
+	if (vanc_lines->pool)
+		return line_insert_pooled(ctx, vanc_lines->pool, pixels, pixel_width, line_number,
+					  horizontal_offset);
 
 	/* See if there is already a line allocated for the target line, if not, create one */
 	for (i = 0; i < KLVANC_MAX_VANC_LINES; i++) {
 		if (vanc_lines->lines[i] == NULL) {
-			line = klvanc_line_create(line_number);
+			line = line_create(getAllocator(ctx, KLVANC_MEM_LINES), line_number);
+			if (line == NULL)
+				return -ENOMEM;
 			vanc_lines->lines[i] = line;
 			vanc_lines->num_lines++;
 			break;
@@ -87,8 +232,6 @@ int klvanc_line_insert(struct klvanc_context_s *ctx, struct klvanc_line_set_s *v
 	if (i == KLVANC_MAX_VANC_LINES) {
 		/* Array is full */
 		PRINT_DEBUG("array of lines is full!\n");
-		free(new_entry->payload);
-		free(new_entry);
 		return -ENOMEM;
 	}
 
@@ -96,12 +239,26 @@ int klvanc_line_insert(struct klvanc_context_s *ctx, struct klvanc_line_set_s *v
 	if (line->num_entries == KLVANC_MAX_VANC_ENTRIES) {
 		/* Array is full */
 		PRINT_DEBUG("line is full!\n");
-		free(new_entry->payload);
-		free(new_entry);
 		return -ENOMEM;
 	}
 
-	line->p_entries[line->num_entries++] = new_entry;
+	/* Entries are released by klvanc_line_free(), so they must come from the line's allocator */
+	struct klvanc_entry_s *new_entry =
+	    (struct klvanc_entry_s *)klvanc_mem_alloc(&line->allocator, sizeof(struct klvanc_entry_s));
+	if (new_entry == NULL)
+		return -ENOMEM;
+
+	new_entry->payload =
+	    (uint16_t *) klvanc_mem_alloc(&line->allocator, pixel_width * sizeof(uint16_t));
+	if (new_entry->payload == NULL) {
+		klvanc_mem_free(&line->allocator, new_entry);
+		return -ENOMEM;
+	}
+	memcpy(new_entry->payload, pixels, pixel_width * sizeof(uint16_t));
+	new_entry->h_offset = horizontal_offset;
+	new_entry->pixel_width = pixel_width;
+
+	line_add_entry(line, new_entry);
 	return 0;
 }
 
@@ -193,27 +350,178 @@ int klvanc_generate_vanc_line(struct klvanc_context_s *ctx, struct klvanc_line_s
 	return 0;
 }
 
+/* Check all words after the VANC start words for illegal values */
+static int entry_payload_valid(struct klvanc_context_s *ctx, const struct klvanc_line_s *line,
+			       const struct klvanc_entry_s *entry)
+{
+	for (int j = 3; j < entry->pixel_width; j++) {
+		if (entry->payload[j] <= 0x0003 || entry->payload[j] >= 0x03FC) {
+			PRINT_DEBUG("VANC line %d has entry with illegal payload at offset %d. Skipping.  len=%d\n",
+				    line->line_number, j, entry->pixel_width);
+			return 0;
+		}
+	}
+	return 1;
+}
+
+int klvanc_generate_vanc_line_inplace(struct klvanc_context_s *ctx, struct klvanc_line_s *line,
+				      uint16_t *out_buf, int *out_len, int line_pixel_width)
+{
+	int pixels_used = 0;
+
+	if (!line || !out_buf || !out_len)
+		return -EINVAL;
+
+	/* Entries are already in offset order, pack them back to back. Each entry is
+	 * validated as it is copied; a rejected entry is simply overwritten by the next.
+	 */
+	for (int i = 0; i < line->num_entries; i++) {
+		const struct klvanc_entry_s *entry = line->p_entries[i];
+		const uint16_t *src = entry->payload;
+		uint16_t *dst = out_buf + pixels_used;
+		int n = entry->pixel_width;
+		int j;
+
+		if (pixels_used + n > line_pixel_width) {
+			PRINT_DEBUG("VANC line %d would overflow thus skipping.  offset=%d len=%d\n",
+				    line->line_number, pixels_used, n);
+			continue;
+		}
+
+		for (j = 0; j < n && j < 3; j++)
+			dst[j] = src[j];
+		for (; j < n; j++) {
+			if (src[j] <= 0x0003 || src[j] >= 0x03FC)
+				break;
+			dst[j] = src[j];
+		}
+		if (j < n) {
+			PRINT_DEBUG("VANC line %d has entry with illegal payload at offset %d. Skipping.  len=%d\n",
+				    line->line_number, j, n);
+			continue;
+		}
+
+		pixels_used += n;
+	}
+
+	*out_len = pixels_used;
+	return 0;
+}
+
+/* Packs words into v210 as they are produced. Full groups go straight from the
+ * entry payload to the output, only the words straddling a group boundary are
+ * staged. The result is identical to converting the assembled line in one go.
+ */
+struct v210_sink_s
+{
+	uint8_t *dst;
+	void (*pack)(uint16_t *src, uint8_t *dst, int width);
+	int group;		/* Samples per 16 bytes of v210 */
+	int fill;
+	uint16_t win[12];
+};
+
+static void v210_sink_put(struct v210_sink_s *s, uint16_t *src, int n)
+{
+	if (s->fill) {
+		int k = s->group - s->fill;
+		if (k > n)
+			k = n;
+		memcpy(s->win + s->fill, src, k * sizeof(uint16_t));
+		s->fill += k;
+		src += k;
+		n -= k;
+		if (s->fill < s->group)
+			return;
+		s->pack(s->win, s->dst, s->group);
+		s->dst += 16;
+		s->fill = 0;
+	}
+
+	int bulk = n - (n % s->group);
+	if (bulk) {
+		s->pack(src, s->dst, bulk);
+		s->dst += (bulk / s->group) * 16;
+		src += bulk;
+		n -= bulk;
+	}
+
+	memcpy(s->win, src, n * sizeof(uint16_t));
+	s->fill = n;
+}
+
+void klvanc_v210_blank(uint8_t *dst, size_t bytes)
+{
+	/* Black in both packings: Cb/Cr 0x200 and Y 0x040 alternating */
+	static const uint32_t black[4] = { 0x20010200, 0x04080040, 0x20010200, 0x04080040 };
+
+	while (bytes >= sizeof(black)) {
+		memcpy(dst, black, sizeof(black));
+		dst += sizeof(black);
+		bytes -= sizeof(black);
+	}
+	memcpy(dst, black, bytes);
+}
+
+int klvanc_line_pack_v210(struct klvanc_context_s *ctx, struct klvanc_line_s *line,
+			  uint8_t *out_buf, int line_pixel_width, int luma, int blank)
+{
+	struct v210_sink_s sink = { .dst = out_buf };
+	int pixels_used = 0;
+
+	if (luma) {
+		sink.pack = klvanc_y10_to_v210;
+		sink.group = 6;
+	} else {
+		sink.pack = klvanc_uyvy_to_v210;
+		sink.group = 12;
+	}
+
+	/* Entries are already in offset order, so they are packed back to back in one pass */
+	for (int i = 0; i < line->num_entries; i++) {
+		struct klvanc_entry_s *entry = line->p_entries[i];
+
+		if (pixels_used + entry->pixel_width > line_pixel_width) {
+			PRINT_DEBUG("VANC line %d would overflow thus skipping.  offset=%d len=%d\n",
+				    line->line_number, pixels_used, entry->pixel_width);
+			continue;
+		}
+		if (!entry_payload_valid(ctx, line, entry))
+			continue;
+
+		v210_sink_put(&sink, entry->payload, entry->pixel_width);
+		pixels_used += entry->pixel_width;
+	}
+
+	/* A partial group only writes the words it needs, blank the rest of it first */
+	if (sink.fill) {
+		if (blank)
+			klvanc_v210_blank(sink.dst, 16);
+		sink.pack(sink.win, sink.dst, sink.fill);
+		sink.dst += 16;
+	}
+
+	return sink.dst - out_buf;
+}
+
 int klvanc_generate_vanc_line_v210(struct klvanc_context_s *ctx,
                                    struct klvanc_line_s *line,
                                    uint8_t *out_buf, int line_pixel_width)
 {
-	uint16_t *out_line;
-	int out_len;
-	int result;
+	if (!line || !out_buf)
+		return -EINVAL;
 
-	/* Generate the full line taking into account all VANC packets on that line */
-	result = klvanc_generate_vanc_line(ctx, line, &out_line, &out_len,
-					   line_pixel_width);
-	if (result != 0) {
-		return -ENOMEM;
-	}
+	klvanc_line_pack_v210(ctx, line, out_buf, line_pixel_width, line_pixel_width > 720, 0);
+	return 0;
+}
 
-	/* Repack the 16-bit ints into 10-bit, and push into final buffer */
-	if (line_pixel_width > 720)
-		klvanc_y10_to_v210(out_line, out_buf, out_len);
-	else
-		klvanc_uyvy_to_v210(out_line, out_buf, out_len);
+int klvanc_generate_vanc_line_v210_format(struct klvanc_context_s *ctx, struct klvanc_line_s *line,
+					  uint8_t *out_buf, const struct klvanc_video_format_s *fmt)
+{
+	if (!line || !out_buf || !fmt)
+		return -EINVAL;
 
-	free(out_line);
+	klvanc_line_pack_v210(ctx, line, out_buf, klvanc_video_format_vanc_samples(fmt),
+			      klvanc_video_format_luma(fmt), 0);
 	return 0;
 }
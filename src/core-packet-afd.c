@@ -85,8 +85,7 @@ const char *klvanc_barFlags_to_string(enum klvanc_payload_afd_barflags flags)
 
 int klvanc_dump_AFD(struct klvanc_context_s *ctx, void *p)
 {
-	if (ctx->verbose)
-		PRINT_DEBUG("%s()\n", __func__);
+	PRINT_TRACE("%s()\n", __func__);
 
 	struct klvanc_packet_afd_s *pkt = p;
 
@@ -131,14 +130,12 @@ int parse_AFD(struct klvanc_context_s *ctx,
 	if (ctx->callbacks == NULL || ctx->callbacks->afd == NULL)
 		return KLAPI_OK;
 
-	if (ctx->verbose)
-		PRINT_DEBUG("%s()\n", __func__);
+	PRINT_TRACE("%s()\n", __func__);
 
-	struct klvanc_packet_afd_s *pkt = calloc(1, sizeof(*pkt));
-	if (!pkt)
-		return -ENOMEM;
+	struct klvanc_packet_afd_s *pkt = &getPrivate(ctx)->afd;
+	memset(pkt, 0, sizeof(*pkt));
 
-	memcpy(&pkt->hdr, hdr, sizeof(*hdr));
+	pkt->hdr = hdr;
 	unsigned char afd = (sanitizeWord(hdr->payload[0]) >> 3) & 0x0f;
 
 	pkt->afd = afd;
@@ -161,7 +158,7 @@ int parse_AFD(struct klvanc_context_s *ctx,
 		pkt->right |= sanitizeWord(hdr->payload[7]);
 	}
 
-	ctx->callbacks->afd(ctx->callback_context, ctx, pkt);
+	PERF_CALLBACK(ctx->callbacks->afd(ctx->callback_context, ctx, pkt));
 
 	*pp = pkt;
 	return KLAPI_OK;
@@ -211,26 +208,13 @@ int klvanc_set_AFD_val(struct klvanc_packet_afd_s *pkt, unsigned char val)
 	return 0;
 }
 
-int klvanc_convert_AFD_to_packetBytes(struct klvanc_packet_afd_s *pkt, uint8_t **bytes, uint16_t *byteCount)
+/* Serialize the AFD struct into a binary blob of at most 255 bytes */
+static void afd_write_bytes(const struct klvanc_packet_afd_s *pkt, uint8_t *buf, uint16_t *byteCount)
 {
+	struct klbs_context_s bsctx, *bs = &bsctx;
 	unsigned char afd;
 
-	if (!pkt || !bytes) {
-		return -1;
-	}
-
-	struct klbs_context_s *bs = klbs_alloc();
-	if (bs == NULL)
-		return -ENOMEM;
-
-	*bytes = malloc(255);
-	if (*bytes == NULL) {
-		klbs_free(bs);
-		return -ENOMEM;
-	}
-
-	/* Serialize the AFD struct into a binary blob */
-	klbs_write_set_buffer(bs, *bytes, 255);
+	klbs_write_set_buffer(bs, buf, 255);
 
 	afd = pkt->afd << 3;
 	if (pkt->aspectRatio == ASPECT_16x9)
@@ -253,26 +237,36 @@ int klvanc_convert_AFD_to_packetBytes(struct klvanc_packet_afd_s *pkt, uint8_t *
 	klbs_write_buffer_complete(bs);
 
 	*byteCount = klbs_get_byte_count(bs);
-	klbs_free(bs);
+}
+
+int klvanc_convert_AFD_to_packetBytes(struct klvanc_packet_afd_s *pkt, uint8_t **bytes, uint16_t *byteCount)
+{
+	if (!pkt || !bytes) {
+		return -1;
+	}
+
+	*bytes = malloc(255);
+	if (*bytes == NULL)
+		return -ENOMEM;
 
+	afd_write_bytes(pkt, *bytes, byteCount);
 	return 0;
 }
 
-int klvanc_convert_AFD_to_words(struct klvanc_packet_afd_s *pkt, uint16_t **words, uint16_t *wordCount)
+int serialize_AFD(struct klvanc_context_s *ctx, const void *p, uint16_t *words, unsigned int wordCapacity)
 {
-	uint8_t *buf;
+	uint8_t buf[255];
 	uint16_t byteCount;
-	int ret;
 
-	ret = klvanc_convert_AFD_to_packetBytes(pkt, &buf, &byteCount);
-	if (ret != 0)
-		return ret;
+	afd_write_bytes(p, buf, &byteCount);
+	return klvanc_sdi_write_payload(0x05, 0x41, buf, byteCount, words, wordCapacity);
+}
 
-	/* Create the final array of VANC bytes (with correct DID/SDID,
-	   checksum, etc) */
-	klvanc_sdi_create_payload(0x05, 0x41, buf, byteCount, words, wordCount, 10);
 
-	free(buf);
+int klvanc_convert_AFD_to_words(struct klvanc_packet_afd_s *pkt, uint16_t **words, uint16_t *wordCount)
+{
+	if (!pkt || !words || !wordCount)
+		return -1;
 
-	return 0;
+	return klvanc_serialize_alloc(NULL, serialize_AFD, pkt, words, wordCount);
 }
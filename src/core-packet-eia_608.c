@@ -31,8 +31,7 @@ int klvanc_dump_EIA_608(struct klvanc_context_s *ctx, void *p)
 {
 	struct klvanc_packet_eia_608_s *pkt = p;
 
-	if (ctx->verbose)
-		PRINT_DEBUG("%s() %p\n", __func__, (void *)pkt);
+	PRINT_TRACE("%s() %p\n", __func__, (void *)pkt);
 
 	PRINT_DEBUG("%s() EIA608: %02x %02x %02x : field %d line_offset %d cc_data_1 %02x cc_data_2 %02x\n",
 		    __func__,
@@ -53,14 +52,12 @@ int parse_EIA_608(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *h
 	if (ctx->callbacks == NULL || ctx->callbacks->eia_608 == NULL)
 		return KLAPI_OK;
 
-	if (ctx->verbose)
-		PRINT_DEBUG("%s()\n", __func__);
+	PRINT_TRACE("%s()\n", __func__);
 
-	struct klvanc_packet_eia_608_s *pkt = calloc(1, sizeof(*pkt));
-	if (!pkt)
-		return -ENOMEM;
+	struct klvanc_packet_eia_608_s *pkt = &getPrivate(ctx)->eia_608;
+	memset(pkt, 0, sizeof(*pkt));
 
-	memcpy(&pkt->hdr, hdr, sizeof(*hdr));
+	pkt->hdr = hdr;
 
         /* Parsed */
 	pkt->payload[0] = hdr->payload[0];
@@ -76,7 +73,7 @@ int parse_EIA_608(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *h
 	pkt->cc_data_1 = pkt->payload[1];
 	pkt->cc_data_2 = pkt->payload[2];
 
-	ctx->callbacks->eia_608(ctx->callback_context, ctx, pkt);
+	PERF_CALLBACK(ctx->callbacks->eia_608(ctx->callback_context, ctx, pkt));
 
 	*pp = pkt;
 	return KLAPI_OK;
@@ -97,24 +94,12 @@ void klvanc_destroy_EIA_608(struct klvanc_packet_eia_608_s *pkt)
 	free(pkt);
 }
 
-int klvanc_convert_EIA_608_to_packetBytes(struct klvanc_packet_eia_608_s *pkt, uint8_t **bytes, uint16_t *byteCount)
+/* Serialize the struct into a binary blob of at most 255 bytes */
+static void eia_608_write_bytes(const struct klvanc_packet_eia_608_s *pkt, uint8_t *buf, uint16_t *byteCount)
 {
-	if (!pkt || !bytes) {
-		return -1;
-	}
-
-	struct klbs_context_s *bs = klbs_alloc();
-	if (bs == NULL)
-		return -ENOMEM;
+	struct klbs_context_s bsctx, *bs = &bsctx;
 
-	*bytes = malloc(255);
-	if (*bytes == NULL) {
-		klbs_free(bs);
-		return -ENOMEM;
-	}
-
-	/* Serialize the struct into a binary blob */
-	klbs_write_set_buffer(bs, *bytes, 255);
+	klbs_write_set_buffer(bs, buf, 255);
 
 	if (pkt->field == 0)
 		klbs_write_bits(bs, 1, 1);
@@ -132,26 +117,36 @@ int klvanc_convert_EIA_608_to_packetBytes(struct klvanc_packet_eia_608_s *pkt, u
 	klbs_write_buffer_complete(bs);
 
 	*byteCount = klbs_get_byte_count(bs);
-	klbs_free(bs);
+}
 
+int klvanc_convert_EIA_608_to_packetBytes(struct klvanc_packet_eia_608_s *pkt, uint8_t **bytes, uint16_t *byteCount)
+{
+	if (!pkt || !bytes) {
+		return -1;
+	}
+
+	*bytes = malloc(255);
+	if (*bytes == NULL)
+		return -ENOMEM;
+
+	eia_608_write_bytes(pkt, *bytes, byteCount);
 	return 0;
 }
 
-int klvanc_convert_EIA_608_to_words(struct klvanc_packet_eia_608_s *pkt, uint16_t **words, uint16_t *wordCount)
+int serialize_EIA_608(struct klvanc_context_s *ctx, const void *p, uint16_t *words, unsigned int wordCapacity)
 {
-	uint8_t *buf;
+	uint8_t buf[255];
 	uint16_t byteCount;
-	int ret;
 
-	ret = klvanc_convert_EIA_608_to_packetBytes(pkt, &buf, &byteCount);
-	if (ret != 0)
-		return ret;
+	eia_608_write_bytes(p, buf, &byteCount);
+	return klvanc_sdi_write_payload(0x02, 0x61, buf, byteCount, words, wordCapacity);
+}
 
-	/* Create the final array of VANC bytes (with correct DID/SDID,
-	   checksum, etc) */
-	klvanc_sdi_create_payload(0x02, 0x61, buf, byteCount, words, wordCount, 10);
 
-	free(buf);
+int klvanc_convert_EIA_608_to_words(struct klvanc_packet_eia_608_s *pkt, uint16_t **words, uint16_t *wordCount)
+{
+	if (!pkt || !words || !wordCount)
+		return -1;
 
-	return 0;
+	return klvanc_serialize_alloc(NULL, serialize_EIA_608, pkt, words, wordCount);
 }
@@ -118,8 +118,7 @@ int klvanc_dump_EIA_708B(struct klvanc_context_s *ctx, void *p)
 {
 	struct klvanc_packet_eia_708b_s *pkt = p;
 
-	if (ctx->verbose)
-		PRINT_DEBUG("%s() %p\n", __func__, (void *)pkt);
+	PRINT_TRACE("%s() %p\n", __func__, (void *)pkt);
 
 	PRINT_DEBUG(" pkt->header.cdp_identifier = 0x%04x (%s)\n",
 		    pkt->header.cdp_identifier,
@@ -222,26 +221,18 @@ int klvanc_dump_EIA_708B(struct klvanc_context_s *ctx, void *p)
 
 int parse_EIA_708B(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *hdr, void **pp)
 {
-	struct klbs_context_s *bs;
+	struct klbs_context_s bsctx, *bs = &bsctx;
 	uint8_t next_section_id;
 
 	if (ctx->callbacks == NULL || ctx->callbacks->eia_708b == NULL)
 		return KLAPI_OK;
 
-	bs = klbs_alloc();
-	if (bs == NULL)
-		return -ENOMEM;
-
-	if (ctx->verbose)
-		PRINT_DEBUG("%s()\n", __func__);
+	PRINT_TRACE("%s()\n", __func__);
 
-	struct klvanc_packet_eia_708b_s *pkt = calloc(1, sizeof(*pkt));
-	if (!pkt) {
-		klbs_free(bs);
-		return -ENOMEM;
-	}
+	struct klvanc_packet_eia_708b_s *pkt = &getPrivate(ctx)->eia_708b;
+	memset(pkt, 0, sizeof(*pkt));
 
-	memcpy(&pkt->hdr, hdr, sizeof(*hdr));
+	pkt->hdr = hdr;
 	/* Extract the 8-bit bitstream from the 10-bit payload */
 	for (int i = 0; i < 256; i++)
 		pkt->payload[i] = hdr->payload[i];
@@ -252,8 +243,6 @@ int parse_EIA_708B(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *
 
 	/* CDP Header (Sec 11.2.2) */
 	if (klbs_get_byte_count_free(bs) < 7) {
-		free(pkt);
-		klbs_free(bs);
 		return -ENOMEM;
 	}
 	pkt->header.cdp_identifier = klbs_read_bits(bs, 16);
@@ -271,16 +260,12 @@ int parse_EIA_708B(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *
 	pkt->header.cdp_hdr_sequence_cntr = klbs_read_bits(bs, 16);
 
 	if (klbs_get_byte_count_free(bs) < 1) {
-		free(pkt);
-		klbs_free(bs);
 		return -ENOMEM;
 	}
 	next_section_id = klbs_read_bits(bs, 8);
 
 	if (next_section_id == 0x71) {
 		if (klbs_get_byte_count_free(bs) < 5) {
-			free(pkt);
-			klbs_free(bs);
 			return -ENOMEM;
 		}
 		/* timecode_section (Sec 11.2.3) */
@@ -305,8 +290,6 @@ int parse_EIA_708B(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *
 
 	if (next_section_id == 0x72) {
 		if (klbs_get_byte_count_free(bs) < 2) {
-			free(pkt);
-			klbs_free(bs);
 			return -ENOMEM;
 		}
 		/* cc_data_section (Sec 11.2.4) */
@@ -315,8 +298,6 @@ int parse_EIA_708B(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *
 		pkt->ccdata.cc_count = klbs_read_bits(bs, 5);
 
 		if (klbs_get_byte_count_free(bs) < (pkt->ccdata.cc_count * 3)) {
-			free(pkt);
-			klbs_free(bs);
 			return -ENOMEM;
 		}
 		for (int i = 0; i < pkt->ccdata.cc_count; i++) {
@@ -331,8 +312,6 @@ int parse_EIA_708B(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *
 
 	if (next_section_id == 0x73) {
 		if (klbs_get_byte_count_free(bs) < 3) {
-			free(pkt);
-			klbs_free(bs);
 			return -ENOMEM;
 		}
 		/* ccsvcinfo_section (Sec 11.2.5) */
@@ -345,8 +324,6 @@ int parse_EIA_708B(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *
 
 		/* Abort the parse if we don't have enough data in the bitstream. */
 		if (klbs_get_byte_count_free(bs) < pkt->ccsvc.svc_count * 7) {
-			free(pkt);
-			klbs_free(bs);
 			return -ENOMEM;
 		}
 
@@ -379,8 +356,6 @@ int parse_EIA_708B(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *
 	if (next_section_id == 0x74) {
 		/* cdp_footer section (Sec 11.2.6) */
 		if (klbs_get_byte_count_free(bs) < 3) {
-			free(pkt);
-			klbs_free(bs);
 			return -ENOMEM;
 		}
 		pkt->footer.cdp_footer_id = next_section_id;
@@ -398,9 +373,7 @@ int parse_EIA_708B(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *
 	else
 		pkt->checksum_valid = 0;
 
-	ctx->callbacks->eia_708b(ctx->callback_context, ctx, pkt);
-
-	klbs_free(bs);
+	PERF_CALLBACK(ctx->callbacks->eia_708b(ctx->callback_context, ctx, pkt));
 
 	*pp = pkt;
 	return KLAPI_OK;
@@ -412,24 +385,12 @@ void klvanc_finalize_EIA_708B(struct klvanc_packet_eia_708b_s *pkt, uint16_t seq
 	pkt->footer.cdp_ftr_sequence_cntr = seqNum;
 }
 
-int klvanc_convert_EIA_708B_to_packetBytes(struct klvanc_packet_eia_708b_s *pkt, uint8_t **bytes, uint16_t *byteCount)
+/* Serialize the EIA-708 struct into a binary blob of at most 255 bytes */
+static void eia_708b_write_bytes(const struct klvanc_packet_eia_708b_s *pkt, uint8_t *buf, uint16_t *byteCount)
 {
-	if (!pkt || !bytes) {
-		return -1;
-	}
-
-	struct klbs_context_s *bs = klbs_alloc();
-	if (bs == NULL)
-		return -ENOMEM;
-
-	*bytes = malloc(255);
-	if (*bytes == NULL) {
-		klbs_free(bs);
-		return -ENOMEM;
-	}
+	struct klbs_context_s bsctx, *bs = &bsctx;
 
-	/* Serialize the EIA-708 struct into a binary blob */
-	klbs_write_set_buffer(bs, *bytes, 255);
+	klbs_write_set_buffer(bs, buf, 255);
 
 	/* CDP Header (Sec 11.2.2) */
 	klbs_write_bits(bs, pkt->header.cdp_identifier, 16);
@@ -502,36 +463,46 @@ int klvanc_convert_EIA_708B_to_packetBytes(struct klvanc_packet_eia_708b_s *pkt,
 	klbs_write_buffer_complete(bs);
 
 	/* Set length */
-	(*bytes)[2] = klbs_get_byte_count(bs);
+	buf[2] = klbs_get_byte_count(bs);
 
 	/* Compute CDP checksum as last byte */
 	uint8_t sum = 0;
 	for (int i = 0; i < klbs_get_byte_count(bs) - 1; i++) {
-		sum += (*bytes)[i];
+		sum += buf[i];
 	}
-	(*bytes)[klbs_get_byte_count(bs) - 1] = ~sum + 1;
+	buf[klbs_get_byte_count(bs) - 1] = ~sum + 1;
 
 	*byteCount = klbs_get_byte_count(bs);
-	klbs_free(bs);
+}
 
+int klvanc_convert_EIA_708B_to_packetBytes(struct klvanc_packet_eia_708b_s *pkt, uint8_t **bytes, uint16_t *byteCount)
+{
+	if (!pkt || !bytes) {
+		return -1;
+	}
+
+	*bytes = malloc(255);
+	if (*bytes == NULL)
+		return -ENOMEM;
+
+	eia_708b_write_bytes(pkt, *bytes, byteCount);
 	return 0;
 }
 
-int klvanc_convert_EIA_708B_to_words(struct klvanc_packet_eia_708b_s *pkt, uint16_t **words, uint16_t *wordCount)
+int serialize_EIA_708B(struct klvanc_context_s *ctx, const void *p, uint16_t *words, unsigned int wordCapacity)
 {
-	uint8_t *buf;
+	uint8_t buf[255];
 	uint16_t byteCount;
-	int ret;
 
-	ret = klvanc_convert_EIA_708B_to_packetBytes(pkt, &buf, &byteCount);
-	if (ret != 0)
-		return ret;
+	eia_708b_write_bytes(p, buf, &byteCount);
+	return klvanc_sdi_write_payload(0x01, 0x61, buf, byteCount, words, wordCapacity);
+}
 
-	/* Create the final array of VANC bytes (with correct DID/SDID,
-	   checksum, etc) */
-	klvanc_sdi_create_payload(0x01, 0x61, buf, byteCount, words, wordCount, 10);
 
-	free(buf);
+int klvanc_convert_EIA_708B_to_words(struct klvanc_packet_eia_708b_s *pkt, uint16_t **words, uint16_t *wordCount)
+{
+	if (!pkt || !words || !wordCount)
+		return -1;
 
-	return 0;
+	return klvanc_serialize_alloc(NULL, serialize_EIA_708B, pkt, words, wordCount);
 }
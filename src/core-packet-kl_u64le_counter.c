@@ -40,8 +40,7 @@ int klvanc_create_KL_U64LE_COUNTER(struct klvanc_packet_kl_u64le_counter_s **pkt
 
 int klvanc_dump_KL_U64LE_COUNTER(struct klvanc_context_s *ctx, void *p)
 {
-	if (ctx->verbose)
-		PRINT_DEBUG("%s()\n", __func__);
+	PRINT_TRACE("%s()\n", __func__);
 
 	struct klvanc_packet_kl_u64le_counter_s *pkt = p;
 
@@ -55,14 +54,12 @@ int parse_KL_U64LE_COUNTER(struct klvanc_context_s *ctx, struct klvanc_packet_he
 	if (ctx->callbacks == NULL || ctx->callbacks->kl_i64le_counter == NULL)
 		return KLAPI_OK;
 
-	if (ctx->verbose)
-		PRINT_DEBUG("%s()\n", __func__);
+	PRINT_TRACE("%s()\n", __func__);
 
-	struct klvanc_packet_kl_u64le_counter_s *pkt = calloc(1, sizeof(*pkt));
-	if (!pkt)
-		return -ENOMEM;
+	struct klvanc_packet_kl_u64le_counter_s *pkt = &getPrivate(ctx)->kl_u64le_counter;
+	memset(pkt, 0, sizeof(*pkt));
 
-	memcpy(&pkt->hdr, hdr, sizeof(*hdr));
+	pkt->hdr = hdr;
 
 	pkt->counter = 0;
 	pkt->counter |= (uint64_t)sanitizeWord(hdr->payload[0]) << 56;
@@ -74,15 +71,16 @@ int parse_KL_U64LE_COUNTER(struct klvanc_context_s *ctx, struct klvanc_packet_he
 	pkt->counter |= (uint64_t)sanitizeWord(hdr->payload[6]) <<  8;
 	pkt->counter |= (uint64_t)sanitizeWord(hdr->payload[7]);
 
-	ctx->callbacks->kl_i64le_counter(ctx->callback_context, ctx, pkt);
+	PERF_CALLBACK(ctx->callbacks->kl_i64le_counter(ctx->callback_context, ctx, pkt));
 
 	*pp = pkt;
 	return KLAPI_OK;
 }
 
-int klvanc_convert_KL_U64LE_COUNTER_to_words(struct klvanc_packet_kl_u64le_counter_s *pkt,
-					     uint16_t **words, uint16_t *wordCount)
+int serialize_KL_U64LE_COUNTER(struct klvanc_context_s *ctx, const void *p, uint16_t *words,
+			       unsigned int wordCapacity)
 {
+	const struct klvanc_packet_kl_u64le_counter_s *pkt = p;
 	uint8_t buf[8];
 	buf[0] = pkt->counter >> 56;
 	buf[1] = pkt->counter >> 48;
@@ -95,7 +93,14 @@ int klvanc_convert_KL_U64LE_COUNTER_to_words(struct klvanc_packet_kl_u64le_count
 
 	/* Create the final array of VANC bytes (with correct DID/SDID,
 	   checksum, etc) */
-	klvanc_sdi_create_payload(0xfe, 0x40, buf, sizeof(buf), words, wordCount, 10);
+	return klvanc_sdi_write_payload(0xfe, 0x40, buf, sizeof(buf), words, wordCapacity);
+}
 
-	return 0;
+int klvanc_convert_KL_U64LE_COUNTER_to_words(struct klvanc_packet_kl_u64le_counter_s *pkt,
+					     uint16_t **words, uint16_t *wordCount)
+{
+	if (!pkt || !words || !wordCount)
+		return -1;
+
+	return klvanc_serialize_alloc(NULL, serialize_KL_U64LE_COUNTER, pkt, words, wordCount);
 }
@@ -269,24 +269,9 @@ static unsigned char *parse_splice_request_data(struct klvanc_context_s *ctx, un
 	return p;
 }
 
-#define MAX_DESC_SIZE 255
-static int gen_splice_request_data(const struct klvanc_splice_request_data *d,
-				   unsigned char **outBuf, uint16_t *outSize)
+static void gen_splice_request_data(const struct klvanc_splice_request_data *d,
+				    struct klbs_context_s *bs)
 {
-	unsigned char *buf;
-	struct klbs_context_s *bs = klbs_alloc();
-	if (bs == NULL)
-		return -1;
-
-	buf = (unsigned char *) malloc(MAX_DESC_SIZE);
-	if (buf == NULL) {
-		klbs_free(bs);
-		return -1;
-	}
-
-	/* Serialize the SCTE 104 into a binary blob */
-	klbs_write_set_buffer(bs, buf, MAX_DESC_SIZE);
-
 	klbs_write_bits(bs, d->splice_insert_type, 8);
 	klbs_write_bits(bs, d->splice_event_id, 32);
 	klbs_write_bits(bs, d->unique_program_id, 16);
@@ -295,31 +280,6 @@ static int gen_splice_request_data(const struct klvanc_splice_request_data *d,
 	klbs_write_bits(bs, d->avail_num, 8);
 	klbs_write_bits(bs, d->avails_expected, 8);
 	klbs_write_bits(bs, d->auto_return_flag, 8);
-
-	klbs_write_buffer_complete(bs);
-
-	*outBuf = buf;
-	*outSize = klbs_get_byte_count(bs);
-	klbs_free(bs);
-
-	return 0;
-}
-
-static int gen_splice_null_request_data(unsigned char **outBuf, uint16_t *outSize)
-{
-	unsigned char *buf;
-
-	buf = (unsigned char *) malloc(MAX_DESC_SIZE);
-	if (buf == NULL)
-		return -1;
-
-	/* splice_null_request has no actual body, so nothing to do but return an
-	   empty buffer */
-
-	*outBuf = buf;
-	*outSize = 0;
-
-	return 0;
 }
 
 static unsigned char *parse_time_signal_request_data(unsigned char *p,
@@ -330,32 +290,10 @@ static unsigned char *parse_time_signal_request_data(unsigned char *p,
 	return p;
 }
 
-static int gen_time_signal_request_data(const struct klvanc_time_signal_request_data *d,
-					unsigned char **outBuf, uint16_t *outSize)
+static void gen_time_signal_request_data(const struct klvanc_time_signal_request_data *d,
+					 struct klbs_context_s *bs)
 {
-	unsigned char *buf;
-	struct klbs_context_s *bs = klbs_alloc();
-	if (bs == NULL)
-		return -1;
-
-	buf = (unsigned char *) malloc(MAX_DESC_SIZE);
-	if (buf == NULL) {
-		klbs_free(bs);
-		return -1;
-	}
-
-	/* Serialize the SCTE 104 request into a binary blob */
-	klbs_write_set_buffer(bs, buf, MAX_DESC_SIZE);
-
 	klbs_write_bits(bs, d->pre_roll_time, 16);
-
-	klbs_write_buffer_complete(bs);
-
-	*outBuf = buf;
-	*outSize = klbs_get_byte_count(bs);
-	klbs_free(bs);
-
-	return 0;
 }
 
 static unsigned char *parse_descriptor_request_data(unsigned char *p,
@@ -374,34 +312,12 @@ static unsigned char *parse_descriptor_request_data(unsigned char *p,
 	return p;
 }
 
-static int gen_descriptor_request_data(const struct klvanc_insert_descriptor_request_data *d,
-				       unsigned char **outBuf, uint16_t *outSize)
+static void gen_descriptor_request_data(const struct klvanc_insert_descriptor_request_data *d,
+					struct klbs_context_s *bs)
 {
-	unsigned char *buf;
-	struct klbs_context_s *bs = klbs_alloc();
-	if (bs == NULL)
-		return -1;
-
-	buf = (unsigned char *) malloc(MAX_DESC_SIZE);
-	if (buf == NULL) {
-		klbs_free(bs);
-		return -1;
-	}
-
-	/* Serialize the SCTE 104 request into a binary blob */
-	klbs_write_set_buffer(bs, buf, MAX_DESC_SIZE);
-
 	klbs_write_bits(bs, d->descriptor_count, 8);
 	for (int i = 0; i < d->total_length; i++)
 		klbs_write_bits(bs, d->descriptor_bytes[i], 8);
-
-	klbs_write_buffer_complete(bs);
-
-	*outBuf = buf;
-	*outSize = klbs_get_byte_count(bs);
-	klbs_free(bs);
-
-	return 0;
 }
 
 
@@ -419,35 +335,13 @@ static unsigned char *parse_dtmf_request_data(unsigned char *p,
 	return p;
 }
 
-static int gen_dtmf_request_data(const struct klvanc_dtmf_descriptor_request_data *d,
-				 unsigned char **outBuf, uint16_t *outSize)
+static void gen_dtmf_request_data(const struct klvanc_dtmf_descriptor_request_data *d,
+				  struct klbs_context_s *bs)
 {
-	unsigned char *buf;
-	struct klbs_context_s *bs = klbs_alloc();
-	if (bs == NULL)
-		return -1;
-
-	buf = (unsigned char *) malloc(MAX_DESC_SIZE);
-	if (buf == NULL) {
-		klbs_free(bs);
-		return -1;
-	}
-
-	/* Serialize the SCTE 104 request into a binary blob */
-	klbs_write_set_buffer(bs, buf, MAX_DESC_SIZE);
-
 	klbs_write_bits(bs, d->pre_roll_time, 8);
 	klbs_write_bits(bs, d->dtmf_length, 8);
 	for (int i = 0; i < d->dtmf_length; i++)
 		klbs_write_bits(bs, d->dtmf_char[i], 8);
-
-	klbs_write_buffer_complete(bs);
-
-	*outBuf = buf;
-	*outSize = klbs_get_byte_count(bs);
-	klbs_free(bs);
-
-	return 0;
 }
 
 static unsigned char *parse_avail_request_data(unsigned char *p,
@@ -463,33 +357,12 @@ static unsigned char *parse_avail_request_data(unsigned char *p,
 	return p;
 }
 
-static int gen_avail_request_data(const struct klvanc_avail_descriptor_request_data *d,
-				  unsigned char **outBuf, uint16_t *outSize)
+static void gen_avail_request_data(const struct klvanc_avail_descriptor_request_data *d,
+				   struct klbs_context_s *bs)
 {
-	unsigned char *buf;
-	struct klbs_context_s *bs = klbs_alloc();
-	if (bs == NULL)
-		return -1;
-
-	buf = (unsigned char *) malloc(MAX_DESC_SIZE);
-	if (buf == NULL) {
-		klbs_free(bs);
-		return -1;
-	}
-
-	/* Serialize the SCTE 104 request into a binary blob */
-	klbs_write_set_buffer(bs, buf, MAX_DESC_SIZE);
 	klbs_write_bits(bs, d->num_provider_avails, 8);
 	for (int i = 0; i < d->num_provider_avails; i++)
 		klbs_write_bits(bs, d->provider_avail_id[i], 32);
-
-	klbs_write_buffer_complete(bs);
-
-	*outBuf = buf;
-	*outSize = klbs_get_byte_count(bs);
-	klbs_free(bs);
-
-	return 0;
 }
 
 static unsigned char *parse_segmentation_request_data(unsigned char *p,
@@ -521,23 +394,9 @@ static unsigned char *parse_segmentation_request_data(unsigned char *p,
 	return p;
 }
 
-static int gen_segmentation_request_data(const struct klvanc_segmentation_descriptor_request_data *d,
-					 unsigned char **outBuf, uint16_t *outSize)
+static void gen_segmentation_request_data(const struct klvanc_segmentation_descriptor_request_data *d,
+					  struct klbs_context_s *bs)
 {
-	unsigned char *buf;
-	struct klbs_context_s *bs = klbs_alloc();
-	if (bs == NULL)
-		return -1;
-
-	buf = (unsigned char *) malloc(MAX_DESC_SIZE);
-	if (buf == NULL) {
-		klbs_free(bs);
-		return -1;
-	}
-
-	/* Serialize the SCTE 104 request into a binary blob */
-	klbs_write_set_buffer(bs, buf, MAX_DESC_SIZE);
-
 	klbs_write_bits(bs, d->event_id, 32);
 	klbs_write_bits(bs, d->event_cancel_indicator, 8);
 	klbs_write_bits(bs, d->duration, 16);
@@ -556,14 +415,6 @@ static int gen_segmentation_request_data(const struct klvanc_segmentation_descri
 	klbs_write_bits(bs, d->no_regional_blackout_flag, 8);
 	klbs_write_bits(bs, d->archive_allowed_flag, 8);
 	klbs_write_bits(bs, d->device_restrictions, 8);
-
-	klbs_write_buffer_complete(bs);
-
-	*outBuf = buf;
-	*outSize = klbs_get_byte_count(bs);
-	klbs_free(bs);
-
-	return 0;
 }
 
 static unsigned char *parse_proprietary_command_request_data(unsigned char *p,
@@ -582,36 +433,14 @@ static unsigned char *parse_proprietary_command_request_data(unsigned char *p,
 	return p;
 }
 
-static int gen_proprietary_command_request_data(const struct klvanc_proprietary_command_request_data *d,
-						unsigned char **outBuf, uint16_t *outSize)
+static void gen_proprietary_command_request_data(const struct klvanc_proprietary_command_request_data *d,
+						 struct klbs_context_s *bs)
 {
-	unsigned char *buf;
-	struct klbs_context_s *bs = klbs_alloc();
-	if (bs == NULL)
-		return -1;
-
-	buf = (unsigned char *) malloc(MAX_DESC_SIZE);
-	if (buf == NULL) {
-		klbs_free(bs);
-		return -1;
-	}
-
-	/* Serialize the SCTE 104 request into a binary blob */
-	klbs_write_set_buffer(bs, buf, MAX_DESC_SIZE);
-
 	klbs_write_bits(bs, d->proprietary_id, 32);
 	klbs_write_bits(bs, d->proprietary_command, 8);
 
 	for (int i = 0; i < d->data_length; i++)
 		klbs_write_bits(bs, d->proprietary_data[i], 8);
-
-	klbs_write_buffer_complete(bs);
-
-	*outBuf = buf;
-	*outSize = klbs_get_byte_count(bs);
-	klbs_free(bs);
-
-	return 0;
 }
 
 static unsigned char *parse_tier_data(unsigned char *p, struct klvanc_tier_data *d)
@@ -624,79 +453,32 @@ static unsigned char *parse_tier_data(unsigned char *p, struct klvanc_tier_data
 	return p;
 }
 
-static int gen_tier_data(const struct klvanc_tier_data *d, unsigned char **outBuf, uint16_t *outSize)
+static void gen_tier_data(const struct klvanc_tier_data *d,
+			  struct klbs_context_s *bs)
 {
-	unsigned char *buf;
-	struct klbs_context_s *bs = klbs_alloc();
-	if (bs == NULL)
-		return -1;
-
-	buf = (unsigned char *) malloc(MAX_DESC_SIZE);
-	if (buf == NULL) {
-		klbs_free(bs);
-		return -1;
-	}
-
-	/* Serialize the SCTE 104 request into a binary blob */
-	klbs_write_set_buffer(bs, buf, MAX_DESC_SIZE);
-
 	/* SCTE 104:2015 Sec 9.8.9.1 says the top four bits must be zero */
 	klbs_write_bits(bs, d->tier_data & 0x0fff, 16);
-
-	klbs_write_buffer_complete(bs);
-
-	*outBuf = buf;
-	*outSize = klbs_get_byte_count(bs);
-	klbs_free(bs);
-
-	return 0;
 }
 
 static unsigned char *parse_time_descriptor(unsigned char *p, struct klvanc_time_descriptor_data *d)
 {
-	struct klbs_context_s *bs = klbs_alloc();
-	if (bs == NULL)
-		return NULL;
+	struct klbs_context_s bs;
 
-	klbs_read_set_buffer(bs, p, 12);
+	klbs_read_set_buffer(&bs, p, 12);
 
-	d->TAI_seconds = klbs_read_bits(bs, 48);
-	d->TAI_ns = klbs_read_bits(bs, 32);
-	d->UTC_offset = klbs_read_bits(bs, 16);
-
-	klbs_free(bs);
+	d->TAI_seconds = klbs_read_bits(&bs, 48);
+	d->TAI_ns = klbs_read_bits(&bs, 32);
+	d->UTC_offset = klbs_read_bits(&bs, 16);
 
 	return p;
 }
 
-static int gen_time_descriptor(const struct klvanc_time_descriptor_data *d,
-			       unsigned char **outBuf, uint16_t *outSize)
+static void gen_time_descriptor(const struct klvanc_time_descriptor_data *d,
+				struct klbs_context_s *bs)
 {
-	unsigned char *buf;
-	struct klbs_context_s *bs = klbs_alloc();
-	if (bs == NULL)
-		return -1;
-
-	buf = (unsigned char *) malloc(MAX_DESC_SIZE);
-	if (buf == NULL) {
-		klbs_free(bs);
-		return -1;
-	}
-
-	/* Serialize the SCTE 104 request into a binary blob */
-	klbs_write_set_buffer(bs, buf, MAX_DESC_SIZE);
-
 	klbs_write_bits(bs, d->TAI_seconds, 48);
 	klbs_write_bits(bs, d->TAI_ns, 32);
 	klbs_write_bits(bs, d->UTC_offset, 16);
-
-	klbs_write_buffer_complete(bs);
-
-	*outBuf = buf;
-	*outSize = klbs_get_byte_count(bs);
-	klbs_free(bs);
-
-	return 0;
 }
 
 static unsigned char *parse_mom_timestamp(struct klvanc_context_s *ctx, unsigned char *p,
@@ -900,8 +682,7 @@ int klvanc_dump_SCTE_104(struct klvanc_context_s *ctx, void *p)
 {
 	struct klvanc_packet_scte_104_s *pkt = p;
 
-	if (ctx->verbose)
-		PRINT_DEBUG("%s() %p\n", __func__, (void *)pkt);
+	PRINT_TRACE("%s() %p\n", __func__, (void *)pkt);
 
 	if (pkt->so_msg.opID == SO_INIT_REQUEST_DATA)
 		return dump_som(ctx, pkt);
@@ -909,9 +690,8 @@ int klvanc_dump_SCTE_104(struct klvanc_context_s *ctx, void *p)
 	return dump_mom(ctx, pkt);
 }
 
-void klvanc_free_SCTE_104(void *p)
+static void free_mom_ops(const struct klvanc_allocator_s *a, struct klvanc_packet_scte_104_s *pkt)
 {
-	struct klvanc_packet_scte_104_s *pkt = p;
 	struct klvanc_multiple_operation_message *m;
 
 	if (pkt == NULL)
@@ -919,11 +699,22 @@ void klvanc_free_SCTE_104(void *p)
 
 	m = &pkt->mo_msg;
 	for (int i = 0; i < m->num_ops; i++) {
-		free(m->ops[i].data);
+		klvanc_mem_free(a, m->ops[i].data);
 	}
-	free(m->ops);
+	klvanc_mem_free(a, m->ops);
+	m->ops = NULL;
+	m->num_ops = 0;
+}
 
-	free(pkt);
+void release_SCTE_104(struct klvanc_context_s *ctx, void *p)
+{
+	free_mom_ops(getAllocator(ctx, KLVANC_MEM_SCTE104), p);
+}
+
+void klvanc_free_SCTE_104(void *p)
+{
+	free_mom_ops(NULL, p);
+	free(p);
 }
 
 /* TODO: If we find another VANC case where packets are fragmented, lift this code
@@ -931,10 +722,9 @@ void klvanc_free_SCTE_104(void *p)
  */
 static int messageFragmentAppend(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *hdr)
 {
-	if (ctx->verbose)
-		PRINT_DEBUG("%s()\n", __func__);
+	PRINT_TRACE("%s()\n", __func__);
 
-	int ret = klvanc_packet_copy(&ctx->scte104_fragments[ctx->scte104_fragment_count], hdr);
+	int ret = klvanc_packet_copy_ctx(ctx, KLVANC_MEM_SCTE104, &ctx->scte104_fragments[ctx->scte104_fragment_count], hdr);
 	if (ret < 0) {
 		return -1;
 	}
@@ -947,11 +737,10 @@ static int messageFragmentAppend(struct klvanc_context_s *ctx, struct klvanc_pac
 
 static void messageFragmentReset(struct klvanc_context_s *ctx)
 {
-	if (ctx->verbose)
-		PRINT_DEBUG("%s()\n", __func__);
+	PRINT_TRACE("%s()\n", __func__);
 
 	for (int i = 0; i < ctx->scte104_fragment_count; i++) {
-		klvanc_packet_free(ctx->scte104_fragments[i]);
+		klvanc_packet_free_ctx(ctx, KLVANC_MEM_SCTE104, ctx->scte104_fragments[i]);
 		ctx->scte104_fragments[i] = NULL;
 	}
 	ctx->scte104_fragment_count = 0;
@@ -964,8 +753,7 @@ void cleanup_SCTE_104(struct klvanc_context_s *ctx)
 
 static int messageFragmentContinued(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *hdr)
 {
-	if (ctx->verbose)
-		PRINT_DEBUG("%s()\n", __func__);
+	PRINT_TRACE("%s()\n", __func__);
 
 	/* State machine has been reset before entering here.
 	 * Go ahead and append the first header into the fragment list.
@@ -975,8 +763,7 @@ static int messageFragmentContinued(struct klvanc_context_s *ctx, struct klvanc_
 
 static int messageFragmentFollowing(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *hdr)
 {
-	if (ctx->verbose)
-		PRINT_DEBUG("%s()\n", __func__);
+	PRINT_TRACE("%s()\n", __func__);
 
 	/* A following packet must have been proceeded with one or more previous packets. */
 	if (ctx->scte104_fragment_count == 0) {
@@ -999,8 +786,7 @@ static int messageFragmentFollowing(struct klvanc_context_s *ctx, struct klvanc_
 
 static int messageFragmentFinal(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *hdr, struct klvanc_packet_header_s **complete)
 {
-	if (ctx->verbose)
-		PRINT_DEBUG("%s()\n", __func__);
+	PRINT_TRACE("%s()\n", __func__);
 
 	/* A final packet must have been proceeded with one or more previous packets. */
 	if (ctx->scte104_fragment_count == 0) {
@@ -1026,7 +812,7 @@ static int messageFragmentFinal(struct klvanc_context_s *ctx, struct klvanc_pack
 	 * to incoude al the fragments.
 	 */
 	struct klvanc_packet_header_s *dst;
-	if (klvanc_packet_copy(&dst, hdr) < 0) {
+	if (klvanc_packet_copy_ctx(ctx, KLVANC_MEM_SCTE104, &dst, hdr) < 0) {
 		messageFragmentReset(ctx);
 		return -1;
 	}
@@ -1052,6 +838,7 @@ static int messageFragmentFinal(struct klvanc_context_s *ctx, struct klvanc_pack
 		}
 
 		if (klvanc_packet_payload_append(dst, ctx->scte104_fragments[i], offset) < 0) {
+			klvanc_packet_free_ctx(ctx, KLVANC_MEM_SCTE104, dst);
 			messageFragmentReset(ctx);
 			return -1;
 		}
@@ -1060,10 +847,10 @@ static int messageFragmentFinal(struct klvanc_context_s *ctx, struct klvanc_pack
 	/* We're done, free any cached fragments.*/
 	messageFragmentReset(ctx);
 
-	if (ctx->verbose)
+	if (TRACE_ENABLED()) {
 		PRINT_DEBUG("%s() Dumping fully assembled fragment packet\n", __func__);
-
-	klvanc_dump_packet_console(ctx, dst);
+		klvanc_dump_packet_console(ctx, dst);
+	}
 
 	*complete = dst;
 	return 0; /* Success */
@@ -1075,14 +862,12 @@ int parse_SCTE_104(struct klvanc_context_s *ctx,
 	if (ctx->callbacks == NULL || ctx->callbacks->scte_104 == NULL)
 		return KLAPI_OK;
 
-	if (ctx->verbose)
-		PRINT_DEBUG("%s()\n", __func__);
+	PRINT_TRACE("%s()\n", __func__);
 
-	struct klvanc_packet_scte_104_s *pkt = calloc(1, sizeof(*pkt));
-	if (!pkt)
-		return -ENOMEM;
+	struct klvanc_packet_scte_104_s *pkt = &getPrivate(ctx)->scte_104;
+	memset(pkt, 0, sizeof(*pkt));
 
-	memcpy(&pkt->hdr, hdr, sizeof(*hdr));
+	pkt->hdr = hdr;
 
 	/* See See ST2010-2008 Section 5.1 UDW Format */
 	pkt->payloadDescriptorByte = hdr->payload[0];
@@ -1093,7 +878,6 @@ int parse_SCTE_104(struct klvanc_context_s *ctx,
 
 	if (pkt->duplicate_msg) {
 		printf("%s() pkt->duplicate_msg is unsupported, parse aborted.\n", __func__);
-		free(pkt);
 		return -1;
 	}
 
@@ -1110,31 +894,27 @@ int parse_SCTE_104(struct klvanc_context_s *ctx,
 			 */
 			messageFragmentReset(ctx);
 			messageFragmentContinued(ctx, hdr);
-			free(pkt);
 			return -1; /* Signal upper layers we're not happy. In reality we're collecting. */
 		} else
 		if (pkt->continued_pkt && pkt->following_pkt) {
 			/* Intermediate packet */
 			messageFragmentFollowing(ctx, hdr);
-			free(pkt);
 			return -1; /* Signal upper layers we're not happy. In reality we're collecting. */
 		} else
 		if (pkt->continued_pkt == 0 && pkt->following_pkt) {
 			/* Final packet */
 			if (messageFragmentFinal(ctx, hdr, &fullhdr) < 0) {
 				printf("%s() unable to assemble fragments, skipping.\n", __func__);
-				free(pkt);
 				return -1;
 			}
 			/* Use the complete defragged header, not the final fragment header
 			 * in all the following parsing.
 			 */
 			hdr = fullhdr;
-			memcpy(&pkt->hdr, hdr, sizeof(*hdr));
+			pkt->hdr = hdr;
 
 		} else {
 			printf("%s() pkt->payloadDescriptorByte != 0x08 (0x%x)\n", __func__, pkt->payloadDescriptorByte);
-			free(pkt);
 			return -1;
 		}
 	} else {
@@ -1212,7 +992,6 @@ int parse_SCTE_104(struct klvanc_context_s *ctx,
 		default:
 			/* We don't support this splice command */
 			PRINT_ERR("%s() splice_insert_type 0x%x, error.\n", __func__, d->splice_insert_type);
-			free(pkt);
 			return -1;
 		}
 	} else
@@ -1220,7 +999,6 @@ int parse_SCTE_104(struct klvanc_context_s *ctx,
 	if (m->opID == 0xFFFF /* Multiple Operation Message */) {
 		if (pkt->payloadLengthBytes < 10) {
 			PRINT_ERR("%s() packet too short size=%d\n", __func__, pkt->payloadLengthBytes);
-			free(pkt);
 			return -1;
 		}
 
@@ -1234,7 +1012,6 @@ int parse_SCTE_104(struct klvanc_context_s *ctx,
 
 		if (mom->messageSize > pkt->payloadLengthBytes) {
 			PRINT_ERR("%s() MOM packet too short MOM=%d pkt=%d\n", __func__, mom->messageSize, pkt->payloadLengthBytes);
-			free(pkt);
 			return -1;
 		}
 
@@ -1242,10 +1019,9 @@ int parse_SCTE_104(struct klvanc_context_s *ctx,
 		p = parse_mom_timestamp(ctx, p, &mom->timestamp);
 		
 		mom->num_ops = *(p++);
-		mom->ops = calloc(mom->num_ops, sizeof(struct klvanc_multiple_operation_message_operation));
+		mom->ops = klvanc_mem_calloc(getAllocator(ctx, KLVANC_MEM_SCTE104), mom->num_ops, sizeof(struct klvanc_multiple_operation_message_operation));
 		if (!mom->ops) {
 			PRINT_ERR("%s() unable to allocate momo ram, error.\n", __func__);
-			free(pkt);
 			return -1;
 		}
 
@@ -1257,18 +1033,16 @@ int parse_SCTE_104(struct klvanc_context_s *ctx,
 				PRINT_ERR("%s() Not enough data remaining to process op. op=%d len=%d\n",
 					  __func__, i, o->data_length);
 				for (int j = 0; j < i; j++)
-					free(mom->ops[j].data);
-				free(mom->ops);
-				free(pkt);
+					klvanc_mem_free(getAllocator(ctx, KLVANC_MEM_SCTE104), mom->ops[j].data);
+				klvanc_mem_free(getAllocator(ctx, KLVANC_MEM_SCTE104), mom->ops);
 				return -1;
 			}
-			o->data = malloc(o->data_length);
+			o->data = klvanc_mem_alloc(getAllocator(ctx, KLVANC_MEM_SCTE104), o->data_length);
 			if (!o->data) {
 				PRINT_ERR("%s() Unable to allocate memory for mom op, error.\n", __func__);
 				for (int j = 0; j < i; j++)
-					free(mom->ops[j].data);
-				free(mom->ops);
-				free(pkt);
+					klvanc_mem_free(getAllocator(ctx, KLVANC_MEM_SCTE104), mom->ops[j].data);
+				klvanc_mem_free(getAllocator(ctx, KLVANC_MEM_SCTE104), mom->ops);
 				return -1;
 			} else {
 				memcpy(o->data, p + 4, o->data_length);
@@ -1310,77 +1084,104 @@ int parse_SCTE_104(struct klvanc_context_s *ctx,
 	}
 	else {
 		PRINT_ERR("%s() Unsupported opID = %x, error.\n", __func__, m->opID);
-		free(pkt);
 		return -1;
 	}
 
-	ctx->callbacks->scte_104(ctx->callback_context, ctx, pkt);
+	PERF_CALLBACK(ctx->callbacks->scte_104(ctx->callback_context, ctx, pkt));
 
-	if (fullhdr)
-		klvanc_packet_free(fullhdr);
+	if (fullhdr) {
+		/* The decoded packet must not outlive the defragmented header */
+		klvanc_packet_free_ctx(ctx, KLVANC_MEM_SCTE104, fullhdr);
+		pkt->hdr = NULL;
+	}
 
 	*pp = pkt;
 	return KLAPI_OK;
 }
 
-int klvanc_convert_SCTE_104_to_packetBytes(struct klvanc_context_s *ctx,
-					   const struct klvanc_packet_scte_104_s *pkt,
-					   uint8_t **bytes, uint16_t *byteCount)
+/* Bytes gen_*() will write for an operation's data, or -1 if its lengths overrun the struct */
+static int mom_operation_size(const struct klvanc_multiple_operation_message_operation *o)
 {
-	const struct klvanc_multiple_operation_message *m;
-
-	if (!pkt || !bytes) {
+	switch (o->opID) {
+	case MO_SPLICE_REQUEST_DATA:
+		return 14;
+	case MO_SPLICE_NULL_REQUEST_DATA:
+		return 0;
+	case MO_TIME_SIGNAL_REQUEST_DATA:
+		return 2;
+	case MO_INSERT_DESCRIPTOR_REQUEST_DATA:
+		if (o->descriptor_data.total_length > sizeof(o->descriptor_data.descriptor_bytes))
+			return -1;
+		return 1 + o->descriptor_data.total_length;
+	case MO_INSERT_DTMF_REQUEST_DATA:
+		if (o->dtmf_data.dtmf_length > sizeof(o->dtmf_data.dtmf_char))
+			return -1;
+		return 2 + o->dtmf_data.dtmf_length;
+	case MO_INSERT_AVAIL_DESCRIPTOR_REQUEST_DATA:
+		if (o->avail_descriptor_data.num_provider_avails > 255)
+			return -1;
+		return 1 + (o->avail_descriptor_data.num_provider_avails * 4);
+	case MO_INSERT_SEGMENTATION_REQUEST_DATA:
+		if (o->segmentation_data.upid_length > sizeof(o->segmentation_data.upid))
+			return -1;
+		return 18 + o->segmentation_data.upid_length;
+	case MO_PROPRIETARY_COMMAND_REQUEST_DATA:
+		if (o->proprietary_data.data_length > sizeof(o->proprietary_data.proprietary_data))
+			return -1;
+		return 5 + o->proprietary_data.data_length;
+	case MO_INSERT_TIER_DATA:
+		return 2;
+	case MO_INSERT_TIME_DESCRIPTOR:
+		return 12;
+	default:
 		return -1;
 	}
+}
+
+/* Serialize a Multiple Operation Message into buf, returns the byte count or < 0 if it won't fit */
+static int scte104_write_mom(struct klvanc_context_s *ctx, const struct klvanc_packet_scte_104_s *pkt,
+			     uint8_t *buf, uint32_t bufSize)
+{
+	const struct klvanc_multiple_operation_message *m = &pkt->mo_msg;
+	struct klbs_context_s bs;
 
 	if (pkt->so_msg.opID != 0xffff) {
 		/* We don't currently support anything but Multiple Operation
 		   Messages */
 		PRINT_ERR("msg opid not 0xffff.  Provided=0x%x\n", pkt->so_msg.opID);
-		return -1;
+		return -EINVAL;
 	}
 
-	struct klbs_context_s *bs = klbs_alloc();
-	if (bs == NULL)
-		return -1;
-
-	int blen = 2000;
-	*bytes = malloc(blen);
-	if (*bytes == NULL) {
-		klbs_free(bs);
-		return -1;
-	}
-
-	m = &pkt->mo_msg;
-
-	/* Serialize the SCTE 104 into a binary blob */
-	klbs_write_set_buffer(bs, *bytes, blen);
+	/* Serialize the SCTE 104 into a binary blob, the fixed header is at most 18 bytes */
+	if (bufSize < 18)
+		return -ENOSPC;
+	klbs_write_set_buffer(&bs, buf, bufSize);
 
-	klbs_write_bits(bs, 0xffff, 16); /* reserved */
+	klbs_write_bits(&bs, 0xffff, 16); /* reserved */
 
-	klbs_write_bits(bs, m->messageSize, 16);
-	klbs_write_bits(bs, m->protocol_version, 8);
-	klbs_write_bits(bs, m->AS_index, 8);
-	klbs_write_bits(bs, m->message_number, 8);
-	klbs_write_bits(bs, m->DPI_PID_index, 16);
-	klbs_write_bits(bs, m->SCTE35_protocol_version, 8);
-	klbs_write_bits(bs, m->timestamp.time_type, 8);
+	klbs_write_bits(&bs, m->messageSize, 16);
+	klbs_write_bits(&bs, m->protocol_version, 8);
+	klbs_write_bits(&bs, m->AS_index, 8);
+	klbs_write_bits(&bs, m->message_number, 8);
+	klbs_write_bits(&bs, m->DPI_PID_index, 16);
+	klbs_write_bits(&bs, m->SCTE35_protocol_version, 8);
+	klbs_write_bits(&bs, m->timestamp.time_type, 8);
 
 	const struct klvanc_multiple_operation_message_timestamp *ts = &m->timestamp;
 	switch(ts->time_type) {
 	case 1:
-		klbs_write_bits(bs, ts->time_type_1.UTC_seconds, 32);
-		klbs_write_bits(bs, ts->time_type_1.UTC_microseconds, 16);
+		klbs_write_bits(&bs, ts->time_type_1.UTC_seconds, 32);
+		klbs_write_bits(&bs, ts->time_type_1.UTC_microseconds, 16);
 		break;
 	case 2:
-		klbs_write_bits(bs, ts->time_type_2.hours, 8);
-		klbs_write_bits(bs, ts->time_type_2.minutes, 8);
-		klbs_write_bits(bs, ts->time_type_2.seconds, 8);
-		klbs_write_bits(bs, ts->time_type_2.frames, 8);
+		klbs_write_bits(&bs, ts->time_type_2.hours, 8);
+		klbs_write_bits(&bs, ts->time_type_2.minutes, 8);
+		klbs_write_bits(&bs, ts->time_type_2.seconds, 8);
+		klbs_write_bits(&bs, ts->time_type_2.frames, 8);
 		break;
 	case 3:
-		klbs_write_bits(bs, ts->time_type_3.GPI_number, 8);
-		klbs_write_bits(bs, ts->time_type_3.GPI_edge, 8);
+		klbs_write_bits(&bs, ts->time_type_3.GPI_number, 8);
+		klbs_write_bits(&bs, ts->time_type_3.GPI_edge, 8);
 		break;
 	case 0:
 		/* No time standard defined */
@@ -1391,75 +1192,85 @@ int klvanc_convert_SCTE_104_to_packetBytes(struct klvanc_context_s *ctx,
 		break;
 	}
 
-	klbs_write_bits(bs, m->num_ops, 8);
+	klbs_write_bits(&bs, m->num_ops, 8);
 	for (int i = 0; i < m->num_ops; i++) {
-		unsigned char *outBuf = NULL;
-		uint16_t outSize = 0;
 		const struct klvanc_multiple_operation_message_operation *o = &m->ops[i];
+		int size = mom_operation_size(o);
+		if (size < 0) {
+			PRINT_ERR("Unknown operation type 0x%04x\n", o->opID);
+			continue;
+		}
+		if (4 + size > klbs_get_byte_count_free(&bs))
+			return -ENOSPC;
+
+		/* The operations go straight into the message, their size is known up front */
+		klbs_write_bits(&bs, o->opID, 16);
+		klbs_write_bits(&bs, size, 16);
 		switch (o->opID) {
 		case MO_SPLICE_REQUEST_DATA:
-			gen_splice_request_data(&o->sr_data, &outBuf, &outSize);
+			gen_splice_request_data(&o->sr_data, &bs);
 			break;
 		case MO_SPLICE_NULL_REQUEST_DATA:
-			gen_splice_null_request_data(&outBuf, &outSize);
+			/* splice_null_request has no actual body */
 			break;
 		case MO_TIME_SIGNAL_REQUEST_DATA:
-			gen_time_signal_request_data(&o->timesignal_data, &outBuf, &outSize);
+			gen_time_signal_request_data(&o->timesignal_data, &bs);
 			break;
 		case MO_INSERT_DESCRIPTOR_REQUEST_DATA:
-			gen_descriptor_request_data(&o->descriptor_data, &outBuf, &outSize);
+			gen_descriptor_request_data(&o->descriptor_data, &bs);
 			break;
 		case MO_INSERT_DTMF_REQUEST_DATA:
-			gen_dtmf_request_data(&o->dtmf_data, &outBuf, &outSize);
+			gen_dtmf_request_data(&o->dtmf_data, &bs);
 			break;
 		case MO_INSERT_AVAIL_DESCRIPTOR_REQUEST_DATA:
-			gen_avail_request_data(&o->avail_descriptor_data, &outBuf, &outSize);
+			gen_avail_request_data(&o->avail_descriptor_data, &bs);
 			break;
 		case MO_INSERT_SEGMENTATION_REQUEST_DATA:
-			gen_segmentation_request_data(&o->segmentation_data, &outBuf, &outSize);
+			gen_segmentation_request_data(&o->segmentation_data, &bs);
 			break;
 		case MO_PROPRIETARY_COMMAND_REQUEST_DATA:
-			gen_proprietary_command_request_data(&o->proprietary_data, &outBuf, &outSize);
+			gen_proprietary_command_request_data(&o->proprietary_data, &bs);
 			break;
 		case MO_INSERT_TIER_DATA:
-			gen_tier_data(&o->tier_data, &outBuf, &outSize);
+			gen_tier_data(&o->tier_data, &bs);
 			break;
 		case MO_INSERT_TIME_DESCRIPTOR:
-			gen_time_descriptor(&o->time_data, &outBuf, &outSize);
+			gen_time_descriptor(&o->time_data, &bs);
 			break;
-		default:
-			PRINT_ERR("Unknown operation type 0x%04x\n", o->opID);
-			continue;
-		}
-		/* FIXME */
-
-		klbs_write_bits(bs, o->opID, 16);
-		klbs_write_bits(bs, outSize, 16);
-		for (int j = 0; j < outSize; j++) {
-			klbs_write_bits(bs, outBuf[j], 8);
 		}
-		free(outBuf);
 	}
-	klbs_write_buffer_complete(bs);
+	klbs_write_buffer_complete(&bs);
 
 	/* Recompute the total message size now that everything has been serialized to
 	   a single buffer. */
-	uint16_t buffer_size = klbs_get_byte_count(bs);
-	(*bytes)[2] = buffer_size >> 8;
-	(*bytes)[3] = buffer_size & 0xff;
+	uint16_t buffer_size = klbs_get_byte_count(&bs);
+	buf[2] = buffer_size >> 8;
+	buf[3] = buffer_size & 0xff;
 
-#if 0
-	PRINT_DEBUG("Resulting buffer size=%d\n", klbs_get_byte_count(bs));
-	PRINT_DEBUG(" ->payload  = ");
-	for (int i = 0; i < klbs_get_byte_count(bs); i++) {
-		PRINT_DEBUG("%02x ", (*bytes)[i]);
+	return buffer_size;
+}
+
+int klvanc_convert_SCTE_104_to_packetBytes(struct klvanc_context_s *ctx,
+					   const struct klvanc_packet_scte_104_s *pkt,
+					   uint8_t **bytes, uint16_t *byteCount)
+{
+	if (!pkt || !bytes) {
+		return -1;
 	}
-	PRINT_DEBUG("\n");
-#endif
 
-	*byteCount = klbs_get_byte_count(bs);
-	klbs_free(bs);
+	int blen = 2000;
+	*bytes = malloc(blen);
+	if (*bytes == NULL)
+		return -1;
 
+	int count = scte104_write_mom(ctx, pkt, *bytes, blen);
+	if (count < 0) {
+		free(*bytes);
+		*bytes = NULL;
+		return -1;
+	}
+
+	*byteCount = count;
 	return 0;
 }
 
@@ -1494,32 +1305,57 @@ int klvanc_convert_SCTE_104_packetbytes_to_SMPTE_2010(struct klvanc_context_s *c
 	return 0;
 }
 
+/* Build the standalone SMPTE 2010 packet (see klvanc_convert_SCTE_104_packetbytes_to_SMPTE_2010())
+ * on the stack, ST 2010:2008 Sec 5.4 caps the message at 254 bytes.
+ */
+static int scte104_write_2010(struct klvanc_context_s *ctx, const struct klvanc_packet_scte_104_s *pkt,
+			      uint8_t s2010Packet[255])
+{
+	int count = scte104_write_mom(ctx, pkt, &s2010Packet[1], 254);
+	if (count < 0)
+		return count;
+
+	s2010Packet[0] = 0x08; /* SMPTE 2010 Payload Descriptor */
+	return count + 1;
+}
+
+int serialize_SCTE_104(struct klvanc_context_s *ctx, const void *p, uint16_t *words, unsigned int wordCapacity)
+{
+	uint8_t s2010Packet[255];
+
+	int byteCount = scte104_write_2010(ctx, p, s2010Packet);
+	if (byteCount < 0)
+		return -EINVAL;
+
+	/* Create the final array of VANC bytes (with correct DID/SDID,
+	   checksum, etc) */
+	return klvanc_sdi_write_payload(0x07, 0x41, s2010Packet, byteCount, words, wordCapacity);
+}
+
 int klvanc_convert_SCTE_104_to_words(struct klvanc_context_s *ctx,
 				     struct klvanc_packet_scte_104_s *pkt,
 				     uint16_t **words, uint16_t *wordCount)
 {
-	uint8_t *buf;
-	uint16_t byteCount;
-	uint8_t *s2010Packet;
-	uint16_t s2010Count;
-	int ret;
-
-	ret = klvanc_convert_SCTE_104_to_packetBytes(ctx, pkt, &buf, &byteCount);
-	if (ret != 0)
+	uint8_t s2010Packet[255];
+
+	if (!pkt || !words || !wordCount)
 		return -1;
 
-	ret = klvanc_convert_SCTE_104_packetbytes_to_SMPTE_2010(ctx, buf, byteCount,
-								&s2010Packet, &s2010Count);
-	free(buf);
-	if (ret != 0) {
+	/* Serialize once, the word count follows from the byte count */
+	int byteCount = scte104_write_2010(ctx, pkt, s2010Packet);
+	if (byteCount < 0)
 		return -1;
-	}
 
-	/* Create the final array of VANC bytes (with correct DID/SDID,
-	   checksum, etc) */
-	klvanc_sdi_create_payload(0x07, 0x41, s2010Packet, s2010Count, words, wordCount, 10);
-	free(s2010Packet);
+	int count = klvanc_sdi_write_payload(0x07, 0x41, s2010Packet, byteCount, NULL, 0);
+	if (count < 0)
+		return -1;
+
+	uint16_t *arr = malloc(count * sizeof(uint16_t));
+	if (!arr)
+		return -ENOMEM;
 
+	*wordCount = klvanc_sdi_write_payload(0x07, 0x41, s2010Packet, byteCount, arr, count);
+	*words = arr;
 	return 0;
 }
 
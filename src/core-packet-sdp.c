@@ -11,8 +11,7 @@
 
 int klvanc_dump_SDP(struct klvanc_context_s *ctx, void *p)
 {
-	if (ctx->verbose)
-		PRINT_DEBUG("%s()\n", __func__);
+	PRINT_TRACE("%s()\n", __func__);
 
 	struct klvanc_packet_sdp_s *pkt = p;
 	PRINT_DEBUG("Subtitle Description Packet struct\n");
@@ -43,8 +42,7 @@ int parse_SDP(struct klvanc_context_s *ctx,
 	if (ctx->callbacks == NULL || ctx->callbacks->sdp == NULL)
 		return KLAPI_OK;
 
-	if (ctx->verbose)
-		PRINT_DEBUG("%s()\n", __func__);
+	PRINT_TRACE("%s()\n", __func__);
 
 	if (((hdr->payload[0] & 0x0ff) != 0x51)
 	    || ((hdr->payload[1] & 0x0ff) != 0x15)) {
@@ -55,11 +53,10 @@ int parse_SDP(struct klvanc_context_s *ctx,
 		return -EINVAL;
 	}
 
-	struct klvanc_packet_sdp_s *pkt = calloc(1, sizeof(*pkt));
-	if (!pkt)
-		return -ENOMEM;
+	struct klvanc_packet_sdp_s *pkt = &getPrivate(ctx)->sdp;
+	memset(pkt, 0, sizeof(*pkt));
 
-	memcpy(&pkt->hdr, hdr, sizeof(*hdr));
+	pkt->hdr = hdr;
 	uint8_t length = hdr->payload[2] & 0x00ff;
 
 	pkt->identifier =
@@ -82,7 +79,7 @@ int parse_SDP(struct klvanc_context_s *ctx,
 	    ((uint16_t) (hdr->payload[9 + (45 * payloadBIndex) + 1] & 0xff) <<
 	     8) | (hdr->payload[9 + (45 * payloadBIndex) + 2] & 0xff);
 
-	ctx->callbacks->sdp(ctx->callback_context, ctx, pkt);
+	PERF_CALLBACK(ctx->callbacks->sdp(ctx->callback_context, ctx, pkt));
 
 	*pp = pkt;
 	return KLAPI_OK;
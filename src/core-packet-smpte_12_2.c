@@ -154,17 +154,15 @@ int parse_SMPTE_12_2(struct klvanc_context_s *ctx,
 	if (ctx->callbacks == NULL || ctx->callbacks->smpte_12_2 == NULL)
 		return KLAPI_OK;
 
-	if (ctx->verbose)
-		PRINT_DEBUG("%s()\n", __func__);
+	PRINT_TRACE("%s()\n", __func__);
 
 	if (hdr->payloadLengthWords != 0x10)
 		return -EINVAL;
 
-	struct klvanc_packet_smpte_12_2_s *pkt = calloc(1, sizeof(*pkt));
-	if (!pkt)
-		return -ENOMEM;
+	struct klvanc_packet_smpte_12_2_s *pkt = &getPrivate(ctx)->smpte_12_2;
+	memset(pkt, 0, sizeof(*pkt));
 
-	memcpy(&pkt->hdr, hdr, sizeof(*hdr));
+	pkt->hdr = hdr;
 
 	/* DBB1 Payload Type (SMPTE 12-2:2014 Sec 6.2.1) */
 	for (int i = 0; i < 8; i++) {
@@ -226,7 +224,7 @@ int parse_SMPTE_12_2(struct klvanc_context_s *ctx,
 			pkt->dbb1);
 	}
 
-	ctx->callbacks->smpte_12_2(ctx->callback_context, ctx, pkt);
+	PERF_CALLBACK(ctx->callbacks->smpte_12_2(ctx->callback_context, ctx, pkt));
 
 	*pp = pkt;
 	return KLAPI_OK;
@@ -236,8 +234,7 @@ int klvanc_dump_SMPTE_12_2(struct klvanc_context_s *ctx, void *p)
 {
 	struct klvanc_packet_smpte_12_2_s *pkt = p;
 
-	if (ctx->verbose)
-		PRINT_DEBUG("%s() %p\n", __func__, (void *)pkt);
+	PRINT_TRACE("%s() %p\n", __func__, (void *)pkt);
 
 	PRINT_DEBUG(" DBB1 = %02x (%s)\n", pkt->dbb1, dbb1_types(pkt->dbb1));
 	PRINT_DEBUG(" DBB2 = %02x\n", pkt->dbb2);
@@ -252,28 +249,13 @@ int klvanc_dump_SMPTE_12_2(struct klvanc_context_s *ctx, void *p)
 	return 0;
 }
 
-int klvanc_convert_SMPTE_12_2_to_packetBytes(struct klvanc_context_s *ctx,
-					   const struct klvanc_packet_smpte_12_2_s *pkt,
-					   uint8_t **bytes, uint16_t *byteCount)
+/* Serialize the Timecode into a binary blob of 16 bytes conforming to SMPTE 12-1 */
+static void smpte_12_2_write_bytes(struct klvanc_context_s *ctx, const struct klvanc_packet_smpte_12_2_s *pkt,
+				   uint8_t *buf, uint16_t *byteCount)
 {
+	struct klbs_context_s bsctx, *bs = &bsctx;
 	uint8_t dbb2;
-	uint8_t *buf;
-
-	if (!pkt || !bytes) {
-		return -1;
-	}
-
-	struct klbs_context_s *bs = klbs_alloc();
-	if (bs == NULL)
-		return -1;
 
-	buf = malloc(16);
-	if (buf == NULL) {
-		klbs_free(bs);
-		return -1;
-	}
-
-	/* Serialize the Timecode into a binary blob conforming to SMPTE 12-1 */
 	klbs_write_set_buffer(bs, buf, 16);
 
         /* FIXME: Assumes VITC code */
@@ -371,69 +353,52 @@ int klvanc_convert_SMPTE_12_2_to_packetBytes(struct klvanc_context_s *ctx,
 	PRINT_DEBUG("\n");
 #endif
 
-	*bytes = buf;
 	*byteCount = klbs_get_byte_count(bs);
-	klbs_free(bs);
+}
 
+int klvanc_convert_SMPTE_12_2_to_packetBytes(struct klvanc_context_s *ctx,
+					   const struct klvanc_packet_smpte_12_2_s *pkt,
+					   uint8_t **bytes, uint16_t *byteCount)
+{
+	if (!pkt || !bytes) {
+		return -1;
+	}
+
+	*bytes = malloc(16);
+	if (*bytes == NULL)
+		return -1;
+
+	smpte_12_2_write_bytes(ctx, pkt, *bytes, byteCount);
 	return 0;
 }
 
+int serialize_SMPTE_12_2(struct klvanc_context_s *ctx, const void *p, uint16_t *words, unsigned int wordCapacity)
+{
+	uint8_t buf[16];
+	uint16_t byteCount;
+
+	smpte_12_2_write_bytes(ctx, p, buf, &byteCount);
+	return klvanc_sdi_write_payload(0x60, 0x60, buf, byteCount, words, wordCapacity);
+}
+
 int klvanc_convert_SMPTE_12_2_to_words(struct klvanc_context_s *ctx,
 				     struct klvanc_packet_smpte_12_2_s *pkt,
 				     uint16_t **words, uint16_t *wordCount)
 {
-	uint8_t *buf;
-	uint16_t byteCount;
-	int ret;
-
-	ret = klvanc_convert_SMPTE_12_2_to_packetBytes(ctx, pkt, &buf, &byteCount);
-	if (ret != 0)
+	if (!pkt || !words || !wordCount)
 		return -1;
 
-	/* Create the final array of VANC bytes (with correct DID/SDID,
-	   checksum, etc) */
-	klvanc_sdi_create_payload(0x60, 0x60, buf, byteCount, words, wordCount, 10);
-
-	free(buf);
-
-	return 0;
+	return klvanc_serialize_alloc(ctx, serialize_SMPTE_12_2, pkt, words, wordCount) < 0 ? -1 : 0;
 }
 
-struct s12_lines {
-	int payload_type;
-	int linecount;
-	int interlaced;
-	int preferred_line;
-};
-
 int klvanc_SMPTE_12_2_preferred_line(int dbb1, int lineCount, int interlaced)
 {
-    /* The table below is constructed by using ST 12-2:2014 Sec 8.2.1 for HD
-       resolutions, and Sec 8.2.2 for SD (which says as early as posssible
-       after second line of switching point as defined in SMPTE RP-168) */
-
-    struct s12_lines lines[] = {
-        {KLVANC_ATC_VITC1, 1080, 1, 9},
-        {KLVANC_ATC_VITC1, 1080, 0, 9},
-        {KLVANC_ATC_VITC1, 720, 0, 9},
-        {KLVANC_ATC_VITC1, 486, 1, 12},
-        {KLVANC_ATC_VITC1, 576, 1, 8},
-        {KLVANC_ATC_VITC2, 1080, 1, 571},
-        {KLVANC_ATC_VITC2, 1080, 0, 9},
-        {KLVANC_ATC_VITC2, 720, 0, 9},
-        {KLVANC_ATC_VITC2, 486, 1, 275},
-        {KLVANC_ATC_VITC2, 576, 1, 321},
-    };
-
-    for (int i = 0; i < (sizeof(lines)/sizeof(struct s12_lines)); i++) {
-	    if (dbb1 == lines[i].payload_type &&
-		lineCount == lines[i].linecount &&
-		interlaced == lines[i].interlaced) {
-		    return lines[i].preferred_line;
-	    }
-    }
+    /* The lines come from the format registry, see klvanc_video_format_timecode_line() */
+    const struct klvanc_video_format_s *fmt = klvanc_video_format_find(lineCount, interlaced);
+    if (fmt)
+	    return klvanc_video_format_timecode_line(fmt, dbb1);
 
-    if (dbb1 != KLVANC_ATC_VITC1 && dbb1 != KLVANC_ATC_VITC1 &&
+    if (dbb1 != KLVANC_ATC_VITC1 && dbb1 != KLVANC_ATC_VITC2 &&
         dbb1 != KLVANC_ATC_LTC) {
 	    /* Table 7 says any line except 9, 10, and 571, so we choose
 	       line 11 */
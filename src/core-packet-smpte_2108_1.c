@@ -44,8 +44,7 @@ int klvanc_dump_SMPTE_2108_1(struct klvanc_context_s *ctx, void *p)
 	struct klvanc_packet_smpte_2108_1_s *pkt = p;
 	char *colorchan = "GBR";
 
-	if (ctx->verbose)
-		PRINT_DEBUG("%s() %p\n", __func__, (void *)pkt);
+	PRINT_TRACE("%s() %p\n", __func__, (void *)pkt);
 
 	for (int n = 0; n < pkt->num_frames; n++) {
 		struct klvanc_s2108_1_frame *frame = &pkt->frames[n];
@@ -81,25 +80,17 @@ int klvanc_dump_SMPTE_2108_1(struct klvanc_context_s *ctx, void *p)
 
 int parse_SMPTE_2108_1(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *hdr, void **pp)
 {
-	struct klbs_context_s *bs;
+	struct klbs_context_s bsctx, *bs = &bsctx;
 
 	if (ctx->callbacks == NULL || ctx->callbacks->smpte_2108_1 == NULL)
 		return KLAPI_OK;
 
-	bs = klbs_alloc();
-	if (bs == NULL)
-		return -ENOMEM;
+	PRINT_TRACE("%s()\n", __func__);
 
-	if (ctx->verbose)
-		PRINT_DEBUG("%s()\n", __func__);
+	struct klvanc_packet_smpte_2108_1_s *pkt = &getPrivate(ctx)->smpte_2108_1;
+	memset(pkt, 0, sizeof(*pkt));
 
-	struct klvanc_packet_smpte_2108_1_s *pkt = calloc(1, sizeof(*pkt));
-	if (!pkt) {
-		klbs_free(bs);
-		return -ENOMEM;
-        }
-
-	memcpy(&pkt->hdr, hdr, sizeof(*hdr));
+	pkt->hdr = hdr;
 
 	/* Extract the 8-bit bitstream from the 10-bit payload */
 	for (int i = 0; i < hdr->payloadLengthWords; i++) {
@@ -146,9 +137,7 @@ int parse_SMPTE_2108_1(struct klvanc_context_s *ctx, struct klvanc_packet_header
 		pkt->num_frames++;
 	}
 
-	ctx->callbacks->smpte_2108_1(ctx->callback_context, ctx, pkt);
-
-	klbs_free(bs);
+	PERF_CALLBACK(ctx->callbacks->smpte_2108_1(ctx->callback_context, ctx, pkt));
 
 	*pp = pkt;
 	return KLAPI_OK;
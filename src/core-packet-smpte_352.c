@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <libklvanc/vanc.h>
+
+#include "core-private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const struct klvanc_video_format_s *klvanc_SMPTE_352_video_format(const struct klvanc_packet_smpte_352_s *pkt)
+{
+	if (!pkt || !pkt->version)
+		return NULL;
+
+	switch (pkt->standard) {
+	case 0x81: /* 483/576-line on 270 and 360 Mb/s */
+	case 0x82: /* 483/576-line extended */
+	case 0x83: /* 483/576-line on 540 Mb/s */
+	case 0x86: /* 483/576-line on 1.5 Gb/s */
+		if (pkt->pictureRate == KLVANC_ST352_RATE_25 || pkt->pictureRate == KLVANC_ST352_RATE_50)
+			return klvanc_video_format_get(KLVANC_VIDEO_FORMAT_625I);
+		return klvanc_video_format_get(KLVANC_VIDEO_FORMAT_525I);
+	case 0x84: /* 720-line on 1.5 Gb/s */
+	case 0x88: /* 720-line on 3 Gb/s level A */
+	case 0x8b: /* 720-line on 3 Gb/s level B */
+		return klvanc_video_format_get(KLVANC_VIDEO_FORMAT_720P);
+	case 0x85: /* 1080-line on 1.5 Gb/s */
+	case 0x87: /* 1080-line on dual link 1.5 Gb/s */
+	case 0x89: /* 1080-line on 3 Gb/s level A */
+	case 0x8a: /* 1080-line on 3 Gb/s level B dual link */
+	case 0x8c: /* 1080-line on 3 Gb/s level B dual stream */
+		return klvanc_video_format_get(pkt->transportProgressive ? KLVANC_VIDEO_FORMAT_1080P :
+					       KLVANC_VIDEO_FORMAT_1080I);
+	case 0xc0: /* 2160-line on 6 Gb/s */
+	case 0xce: /* 2160-line on 12 Gb/s */
+		return klvanc_video_format_get(KLVANC_VIDEO_FORMAT_2160P);
+	}
+
+	return NULL;
+}
+
+int klvanc_dump_SMPTE_352(struct klvanc_context_s *ctx, void *p)
+{
+	struct klvanc_packet_smpte_352_s *pkt = p;
+
+	PRINT_TRACE("%s() %p\n", __func__, (void *)pkt);
+	PRINT_DEBUG(" payload = %02x %02x %02x %02x\n", pkt->payload[0], pkt->payload[1],
+		    pkt->payload[2], pkt->payload[3]);
+	PRINT_DEBUG(" version = %d\n", pkt->version);
+	PRINT_DEBUG(" standard = 0x%02x\n", pkt->standard);
+	PRINT_DEBUG(" transport = %s\n", pkt->transportProgressive ? "progressive" : "interlaced");
+	PRINT_DEBUG(" picture = %s\n", pkt->pictureProgressive ? "progressive" : "interlaced");
+	PRINT_DEBUG(" pictureRate = 0x%x\n", pkt->pictureRate);
+	PRINT_DEBUG(" aspectRatio16x9 = %d\n", pkt->aspectRatio16x9);
+	PRINT_DEBUG(" samplingStructure = 0x%x\n", pkt->samplingStructure);
+	PRINT_DEBUG(" bitDepth = 0x%x\n", pkt->bitDepth);
+	PRINT_DEBUG(" format = %s\n", pkt->format ? pkt->format->name : "unknown");
+
+	return KLAPI_OK;
+}
+
+static void decode(struct klvanc_packet_smpte_352_s *pkt, const unsigned short *payload)
+{
+	memset(pkt, 0, sizeof(*pkt));
+
+	for (int i = 0; i < 4; i++)
+		pkt->payload[i] = sanitizeWord(payload[i]);
+
+	pkt->version = (pkt->payload[0] >> 7) & 0x01;
+	pkt->standard = pkt->payload[0];
+	pkt->transportProgressive = (pkt->payload[1] >> 7) & 0x01;
+	pkt->pictureProgressive = (pkt->payload[1] >> 6) & 0x01;
+	pkt->pictureRate = pkt->payload[1] & 0x0f;
+	pkt->aspectRatio16x9 = (pkt->payload[2] >> 7) & 0x01;
+	pkt->samplingStructure = pkt->payload[2] & 0x0f;
+	pkt->bitDepth = pkt->payload[3] & 0x03;
+	pkt->format = klvanc_SMPTE_352_video_format(pkt);
+}
+
+const struct klvanc_video_format_s *klvanc_SMPTE_352_detect(const uint16_t *words, int wordCount)
+{
+	struct klvanc_packet_location_s loc;
+	struct klvanc_packet_smpte_352_s pkt;
+
+	if (klvanc_words_find_packet(words, wordCount, 0x41, 0x01, &loc) < 0 || loc.dataCount < 4)
+		return NULL;
+
+	/* DID through checksum, a corrupt identifier must not pick the geometry */
+	if (!klvanc_checksum_verify(words + loc.offset + 3, loc.dataCount + 4, NULL))
+		return NULL;
+
+	decode(&pkt, words + loc.offset + 6);
+	return pkt.format;
+}
+
+int parse_SMPTE_352(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *hdr, void **pp)
+{
+	struct vanc_context_private_s *priv = getPrivate(ctx);
+	int callback = ctx->callbacks && ctx->callbacks->smpte_352;
+
+	/* Format detection needs the decode even without a callback */
+	if (!callback && !priv->formatDetect)
+		return KLAPI_OK;
+
+	PRINT_TRACE("%s()\n", __func__);
+
+	if (hdr->payloadLengthWords < 4) {
+		PRINT_ERR("ST 352 payload identifier too short, %d words\n", hdr->payloadLengthWords);
+		return -EINVAL;
+	}
+
+	struct klvanc_packet_smpte_352_s *pkt = &priv->smpte_352;
+	decode(pkt, hdr->payload);
+	pkt->hdr = hdr;
+
+	/* The first identifier the registry knows sets the parse geometry */
+	if (priv->formatDetect && !priv->format && pkt->format) {
+		PRINT_DEBUG("%s() detected %s from line %d\n", __func__, pkt->format->name, hdr->lineNr);
+		priv->format = pkt->format;
+	}
+
+	if (callback)
+		PERF_CALLBACK(ctx->callbacks->smpte_352(ctx->callback_context, ctx, pkt));
+
+	*pp = pkt;
+	return KLAPI_OK;
+}
+
+int serialize_SMPTE_352(struct klvanc_context_s *ctx, const void *p, uint16_t *words, unsigned int wordCapacity)
+{
+	const struct klvanc_packet_smpte_352_s *pkt = p;
+	uint8_t buf[4];
+
+	buf[0] = pkt->standard | (pkt->version ? 0x80 : 0x00);
+	buf[1] = (pkt->transportProgressive ? 0x80 : 0) | (pkt->pictureProgressive ? 0x40 : 0) |
+		 (pkt->pictureRate & 0x0f);
+	buf[2] = (pkt->aspectRatio16x9 ? 0x80 : 0) | (pkt->samplingStructure & 0x0f);
+	buf[3] = pkt->bitDepth & 0x03;
+
+	return klvanc_sdi_write_payload(0x01, 0x41, buf, sizeof(buf), words, wordCapacity);
+}
+
+int klvanc_convert_SMPTE_352_to_words(struct klvanc_packet_smpte_352_s *pkt, uint16_t **words, uint16_t *wordCount)
+{
+	if (!pkt || !words || !wordCount)
+		return -1;
+
+	return klvanc_serialize_alloc(NULL, serialize_SMPTE_352, pkt, words, wordCount);
+}
@@ -22,6 +22,7 @@
 #include <libklvanc/vanc.h>
 
 #include "core-private.h"
+#include <libklvanc/pixels.h>
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -30,13 +31,13 @@
 static int isValidHeader(struct klvanc_context_s *ctx, const unsigned short *arr, unsigned int len)
 {
 	int ret = 0;
-	if (len > 7) {
+	if (len >= 7) {
 		if ((*(arr + 0) < 3) && ((*(arr + 1) & 0x3fc) == 0x3fc) && ((*(arr + 2) & 0x3fc) == 0x3fc))
 			ret = 1;
 	}
 
 	if (ctx->verbose > 2)
-		PRINT_DEBUG("%04x %04x %04x %s\n", *(arr + 0), *(arr + 1), *(arr + 2), ret ? "valid": "invalid");
+		PRINT_TRACE("%04x %04x %04x %s\n", *(arr + 0), *(arr + 1), *(arr + 2), ret ? "valid": "invalid");
 	return ret;
 }
 
@@ -46,16 +47,18 @@ static struct type_s
 	enum klvanc_packet_type_e type;
 	int (*parse)(struct klvanc_context_s *, struct klvanc_packet_header_s *, void **);
 	int (*dump)(struct klvanc_context_s *, void *);
-	void (*free)(void *);
+	void (*release)(struct klvanc_context_s *, void *); /* Decoded packets live in the context, only release what they own */
+	int (*serialize)(struct klvanc_context_s *, const void *, uint16_t *, unsigned int); /* Words written, or needed when NULL */
 } types[] = {
-	{ 0x40, 0xfe, VANC_TYPE_KL_UINT64_COUNTER, parse_KL_U64LE_COUNTER, klvanc_dump_KL_U64LE_COUNTER, free, },
-	{ 0x41, 0x05, VANC_TYPE_AFD, parse_AFD, klvanc_dump_AFD, free, },
-	{ 0x41, 0x07, VANC_TYPE_SCTE_104, parse_SCTE_104, klvanc_dump_SCTE_104, klvanc_free_SCTE_104, },
-	{ 0x60, 0x60, VANC_TYPE_SMPTE_S12_2, parse_SMPTE_12_2, klvanc_dump_SMPTE_12_2, free, },
-	{ 0x41, 0x0c, VANC_TYPE_SMPTE_S2108_1, parse_SMPTE_2108_1, klvanc_dump_SMPTE_2108_1, free, },
-	{ 0x61, 0x01, VANC_TYPE_EIA_708B, parse_EIA_708B, klvanc_dump_EIA_708B, free, },
-	{ 0x61, 0x02, VANC_TYPE_EIA_608, parse_EIA_608, klvanc_dump_EIA_608, free, },
-	{ 0x43, 0x02, VANC_TYPE_SDP, parse_SDP, klvanc_dump_SDP, free, },
+	{ 0x40, 0xfe, VANC_TYPE_KL_UINT64_COUNTER, parse_KL_U64LE_COUNTER, klvanc_dump_KL_U64LE_COUNTER, NULL, serialize_KL_U64LE_COUNTER, },
+	{ 0x41, 0x05, VANC_TYPE_AFD, parse_AFD, klvanc_dump_AFD, NULL, serialize_AFD, },
+	{ 0x41, 0x07, VANC_TYPE_SCTE_104, parse_SCTE_104, klvanc_dump_SCTE_104, release_SCTE_104, serialize_SCTE_104, },
+	{ 0x60, 0x60, VANC_TYPE_SMPTE_S12_2, parse_SMPTE_12_2, klvanc_dump_SMPTE_12_2, NULL, serialize_SMPTE_12_2, },
+	{ 0x41, 0x0c, VANC_TYPE_SMPTE_S2108_1, parse_SMPTE_2108_1, klvanc_dump_SMPTE_2108_1, NULL, NULL, },
+	{ 0x61, 0x01, VANC_TYPE_EIA_708B, parse_EIA_708B, klvanc_dump_EIA_708B, NULL, serialize_EIA_708B, },
+	{ 0x61, 0x02, VANC_TYPE_EIA_608, parse_EIA_608, klvanc_dump_EIA_608, NULL, serialize_EIA_608, },
+	{ 0x43, 0x02, VANC_TYPE_SDP, parse_SDP, klvanc_dump_SDP, NULL, NULL, },
+	{ 0x41, 0x01, VANC_TYPE_SMPTE_S352, parse_SMPTE_352, klvanc_dump_SMPTE_352, NULL, serialize_SMPTE_352, },
 };
 
 static enum klvanc_packet_type_e lookupTypeByDID(unsigned short did, unsigned short sdid)
@@ -68,6 +71,11 @@ static enum klvanc_packet_type_e lookupTypeByDID(unsigned short did, unsigned sh
 	return VANC_TYPE_UNDEFINED;
 }
 
+enum klvanc_packet_type_e klvanc_packet_type_lookup(unsigned short did, unsigned short sdid)
+{
+	return lookupTypeByDID(did, sdid);
+}
+
 const char *klvanc_lookupDescriptionByType(enum klvanc_packet_type_e type)
 {
 	for (int i = 0; i < (sizeof(types) / sizeof(struct type_s)); i++) {
@@ -90,11 +98,11 @@ const char *klvanc_lookupSpecificationByType(enum klvanc_packet_type_e type)
 	return "UNDEFINED";
 }
 
-static int freeByType(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *hdr, void *pp)
+static int releaseByType(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *hdr, void *pp)
 {
 	for (int i = 0; i < (sizeof(types) / sizeof(struct type_s)); i++) {
-		if ((types[i].type == hdr->type) && (types[i].free)) {
-			types[i].free(pp);
+		if ((types[i].type == hdr->type) && (types[i].release)) {
+			types[i].release(ctx, pp);
 			return 0;
 		}
 	}
@@ -129,16 +137,17 @@ static int parse(struct klvanc_context_s *ctx, const unsigned short *arr, unsign
 	if (!isValidHeader(ctx, arr, len)) {
 		return -EINVAL;
 	}
+	if (getPrivate(ctx)->filter &&
+	    klvanc_filter_drop(ctx, sanitizeWord(*(arr + 3)), sanitizeWord(*(arr + 4)))) {
+		return -ECANCELED;
+	}
+	PERF_START(tHeader);
 
-	struct klvanc_packet_header_s *p = calloc(1, sizeof(struct klvanc_packet_header_s));
-	if (!p)
-		return -ENOMEM;
-
-	/* Place the entire raw frame passed into raw words, but update raw length
-	 * to reflect the detected payload size plus a minor overheader to compenate
-	 * for a few leading header and trailer words.
+	/* Parse into the context's scratch header, only the fields and
+	 * the portion of the arrays described by the lengths are valid.
 	 */
-	memcpy(&p->raw[0], arr, len * sizeof(unsigned short));
+	struct klvanc_packet_header_s *p = &getPrivate(ctx)->hdr;
+
 	p->adf[0] = *(arr + 0);
 	p->adf[1] = *(arr + 1);
 	p->adf[2] = *(arr + 2);
@@ -146,22 +155,33 @@ static int parse(struct klvanc_context_s *ctx, const unsigned short *arr, unsign
 	p->dbnsdid = sanitizeWord(*(arr + 4));
 
 	p->payloadLengthWords = sanitizeWord(*(arr + 5));
-	p->rawLengthWords = p->payloadLengthWords + 8;
-	p->rawLengthWords = len;
-	if (p->payloadLengthWords > (sizeof(p->payload) / sizeof(unsigned short))) {
-		free(p);
-		return -ENOMEM;
+	if (p->payloadLengthWords + 7 > len) {
+		/* The packet runs past the words we were given */
+		return -EINVAL;
 	}
 
+	/* Keep the packet's own words, ADF through checksum, not the rest of the line */
+	p->rawLengthWords = p->payloadLengthWords + 7;
+	memcpy(&p->raw[0], arr, p->rawLengthWords * sizeof(unsigned short));
+
 	int i;
 	for (i = 0; i < p->payloadLengthWords; i++) {
 		p->payload[i] = *(arr + 6 + i);
 	}
+
+	/* Decoders may look at fixed offsets or whole 256 word blocks without
+	 * checking DC, make sure they see zeros there and not an earlier packet.
+	 */
+	memset(&p->payload[i], 0, (KLVANC_DECODE_PAYLOAD_WORDS - i) * sizeof(unsigned short));
 	p->checksum = *(arr + 6 + i);
-	p->checksumValid = klvanc_checksum_is_valid(arr + 3,
-		p->payloadLengthWords + 4 /* payload + header + len + crc */);
+	PERF_STOP(KLVANC_PERF_HEADER, tHeader);
+
+	PERF_START(tChecksum);
+	p->checksumValid = klvanc_checksum_verify(arr + 3,
+		p->payloadLengthWords + 4 /* payload + header + len + crc */, &p->parityErrors);
 	if (!p->checksumValid)
 		ctx->checksum_failures++;
+	PERF_STOP(KLVANC_PERF_CHECKSUM, tChecksum);
 
 	p->type = lookupTypeByDID(p->did, p->dbnsdid);
 
@@ -194,6 +214,9 @@ void klvanc_dump_words_console(struct klvanc_context_s *ctx, uint16_t *vanc,
 
 void klvanc_dump_packet_console(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *hdr)
 {
+	if (!LOG_ENABLED(LIBKLVANC_LOGLEVEL_DEBUG))
+		return;
+
 	PRINT_DEBUG("hdr->type   = %d\n", hdr->type);
 	PRINT_DEBUG(" ->adf      = 0x%04x/0x%04x/0x%04x\n", hdr->adf[0], hdr->adf[1], hdr->adf[2]);
 	PRINT_DEBUG(" ->did/sdid = 0x%02x / 0x%02x [%s %s] via SDI line %d\n",
@@ -211,6 +234,86 @@ void klvanc_dump_packet_console(struct klvanc_context_s *ctx, struct klvanc_pack
 	PRINT_DEBUG("\n");
 }
 
+void klvanc_packet_deliver(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *hdr)
+{
+	if (ctx->callbacks && ctx->callbacks->all) {
+		PERF_START(tAll);
+		ctx->callbacks->all(ctx->callback_context, ctx, hdr);
+		PERF_STOP(KLVANC_PERF_CALLBACK, tAll);
+	}
+
+	/* formally decode the entire packet */
+	void *decodedPacket = NULL;
+	PERF_START(tDecode);
+	int ret = parseByType(ctx, hdr, &decodedPacket);
+	PERF_STOP(KLVANC_PERF_DECODE, tDecode);
+	if (ret == KLAPI_OK) {
+		if (ctx->verbose == 2 && decodedPacket) {
+			ret = dumpByType(ctx, decodedPacket);
+			if (ret < 0) {
+				PRINT_ERR("Failed to dump by type, missing dumper function?\n");
+			}
+		}
+	} else {
+		if (ctx->warn_on_decode_failure) {
+			if (klrestricted_code_path_block_execute(&ctx->rcp_failedToDecode)) {
+				PRINT_ERR("Failed parsing by type\n");
+				klvanc_dump_packet_console(ctx, hdr);
+			}
+		}
+	}
+
+	if (decodedPacket)
+		releaseByType(ctx, hdr, decodedPacket);
+}
+
+/* Everything that happens to a packet once its header has parsed */
+static void handle(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *hdr,
+		   unsigned int lineNr, unsigned int offset)
+{
+	struct vanc_context_private_s *priv = getPrivate(ctx);
+
+	hdr->horizontalOffset = offset;
+	hdr->lineNr = lineNr;
+	PERF_DID(hdr->did);
+
+	/* Dump the packet header and basic VANC types if required. */
+	if (ctx->verbose)
+		klvanc_dump_packet_console(ctx, hdr);
+
+	/* Update the internal VANC cache */
+	PERF_START(tCache);
+	klvanc_cache_update(ctx, hdr);
+	if (priv->stats)
+		klvanc_stats_update(ctx, hdr);
+	if (priv->shm)
+		klvanc_shm_update(ctx, hdr);
+	PERF_STOP(KLVANC_PERF_CACHE, tCache);
+
+	if ((hdr->checksumValid || ctx->allow_bad_checksums) &&
+	    !(priv->change && klvanc_change_suppress(ctx, hdr))) {
+		if (ctx->callbacks && ctx->callbacks->frame)
+			klvanc_frame_collect(ctx, hdr);
+		if (priv->async)
+			klvanc_async_push(ctx, hdr);
+		else
+			klvanc_packet_deliver(ctx, hdr);
+	}
+}
+
+int klvanc_packet_parse_one(struct klvanc_context_s *ctx, unsigned int lineNr, unsigned int offset,
+			    const unsigned short *arr, unsigned int len)
+{
+	struct klvanc_packet_header_s *hdr;
+
+	int ret = parse(ctx, arr, len, &hdr);
+	if (ret < 0)
+		return ret;
+
+	handle(ctx, hdr, lineNr, offset);
+	return KLAPI_OK;
+}
+
 int klvanc_packet_parse(struct klvanc_context_s *ctx, unsigned int lineNr, const unsigned short *arr, unsigned int len)
 {
 	int attempts = 0;
@@ -224,58 +327,44 @@ int klvanc_packet_parse(struct klvanc_context_s *ctx, unsigned int lineNr, const
 		return -EINVAL;
 	}
 
-	/* Scan the entire line for vanc frames */
+	struct vanc_context_private_s *priv = getPrivate(ctx);
+	if (!priv->frameExplicit && lineNr < priv->lastLineNr) {
+		if (ctx->callbacks && ctx->callbacks->frame)
+			klvanc_frame_deliver(ctx);
+		priv->frameNr++;
+	}
+	priv->lastLineNr = lineNr;
+
+	/* Skip lines the learned line map says are empty */
 	unsigned int i = 0;
+	if (priv->linemap && !klvanc_linemap_begin(ctx, lineNr, &i))
+		return 0;
+	unsigned int startOffset = i;
+	int firstOffset = -1;
+
+	PERF_START(tLine);
+
+	/* Scan the entire line for vanc frames */
 	while (i < len - 7) {
 		/* Do a basic header parse */
 		struct klvanc_packet_header_s *hdr;
 		int ret = parse(ctx, arr + i, len - i, &hdr);
+		if (ret == -ECANCELED) {
+			/* Filtered out, step over the whole packet */
+			unsigned int words = sanitizeWord(*(arr + i + 5)) + 7;
+			i += words < len - i ? words : len - i;
+			continue;
+		}
 		if (ret < 0) {
 			i++;
 			continue;
 		}
 
-		hdr->horizontalOffset = i;
-		hdr->lineNr = lineNr;
-
-		/* Dump the packet header and basic VANC types if required. */
-		if (ctx->verbose)
-			klvanc_dump_packet_console(ctx, hdr);
-
 		/* The number of frames we attempted to parse */
-		attempts++;
-
-		/* Update the internal VANC cache */
-		klvanc_cache_update(ctx, hdr);
-
-		if (hdr->checksumValid || ctx->allow_bad_checksums) {
-			if (ctx->callbacks && ctx->callbacks->all)
-				ctx->callbacks->all(ctx->callback_context, ctx, hdr);
-
-			/* formally decode the entire packet */
-			void *decodedPacket = NULL;
-			ret = parseByType(ctx, hdr, &decodedPacket);
-			if (ret == KLAPI_OK) {
-				if (ctx->verbose == 2 && decodedPacket) {
-					ret = dumpByType(ctx, decodedPacket);
-					if (ret < 0) {
-						PRINT_ERR("Failed to dump by type, missing dumper function?\n");
-					}
-				}
-			} else {
-				if (ctx->warn_on_decode_failure) {
-					if (klrestricted_code_path_block_execute(&ctx->rcp_failedToDecode)) {
-						PRINT_ERR("Failed parsing by type\n");
-						klvanc_dump_packet_console(ctx, hdr);
-					}
-				}
-			}
+		if (attempts++ == 0)
+			firstOffset = i;
 
-			if (decodedPacket)
-				freeByType(ctx, hdr, decodedPacket);
-		}
-
-		free(hdr);
+		handle(ctx, hdr, lineNr, i);
 
 		/* Minimum packet length is 7, so lets move things
 		 * on a little faster....
@@ -283,9 +372,165 @@ int klvanc_packet_parse(struct klvanc_context_s *ctx, unsigned int lineNr, const
 		i += 7;
 	}
 
+	PERF_LINE(tLine);
+
+	if (priv->linemap)
+		klvanc_linemap_end(ctx, lineNr, startOffset, firstOffset);
+
 	return attempts;
 }
 
+int klvanc_frame_end(struct klvanc_context_s *ctx)
+{
+	VALIDATE(ctx);
+
+	if (ctx->callbacks && ctx->callbacks->frame)
+		klvanc_frame_deliver(ctx);
+
+	getPrivate(ctx)->frameExplicit = 1;
+	getPrivate(ctx)->frameNr++;
+
+	return KLAPI_OK;
+}
+
+static int unpacked_reserve(struct klvanc_context_s *ctx, uint32_t need)
+{
+	struct vanc_context_private_s *priv = getPrivate(ctx);
+
+	if (need <= priv->unpackedWords)
+		return KLAPI_OK;
+
+	uint16_t *p = klvanc_mem_calloc(getAllocator(ctx, KLVANC_MEM_CORE), need, sizeof(uint16_t));
+	if (!p)
+		return -ENOMEM;
+	klvanc_mem_free(getAllocator(ctx, KLVANC_MEM_CORE), priv->unpacked);
+	priv->unpacked = p;
+	priv->unpackedWords = need;
+
+	return KLAPI_OK;
+}
+
+/* With no format known, look for an ST 352 payload identifier on the rows where
+ * each registry format of this stride carries one. The width is whatever the
+ * stride holds, and both the luma and the component streams are searched since
+ * SD and HD cannot be told apart yet.
+ */
+static const struct klvanc_video_format_s *frame_detect_v210(struct klvanc_context_s *ctx,
+							     const uint8_t *vanc, uint32_t stride)
+{
+	struct vanc_context_private_s *priv = getPrivate(ctx);
+	uint32_t width = (stride / 128) * 48;
+	int probed[KLVANC_VIDEO_FORMAT_MAX];
+	int probeCount = 0;
+
+	if (width == 0 || unpacked_reserve(ctx, width * 3) < 0)
+		return NULL;
+
+	for (int i = 0; i < KLVANC_VIDEO_FORMAT_MAX; i++) {
+		const struct klvanc_video_format_s *f = klvanc_video_format_get(i);
+		if (klvanc_video_format_v210_stride(f) != stride || !f->payloadIdLine[0])
+			continue;
+
+		int row = klvanc_video_format_vanc_row(f, f->payloadIdLine[0]);
+		int seen = row < 0;
+		for (int j = 0; j < probeCount && !seen; j++)
+			seen = probed[j] == row;
+		if (seen)
+			continue;
+		probed[probeCount++] = row;
+
+		const uint32_t *src = (const uint32_t *)(vanc + (size_t)row * stride);
+		const struct klvanc_video_format_s *found;
+
+		klvanc_v210_line_to_nv20_c(src, priv->unpacked, width * 3 * sizeof(uint16_t), width);
+		if ((found = klvanc_SMPTE_352_detect(priv->unpacked, width)))
+			return found;
+
+		klvanc_v210_line_to_uyvy_c(src, priv->unpacked, width);
+		if ((found = klvanc_SMPTE_352_detect(priv->unpacked, width * 2)))
+			return found;
+	}
+
+	return NULL;
+}
+
+int klvanc_frame_parse_v210(struct klvanc_context_s *ctx, const struct klvanc_video_format_s *fmt,
+			    const uint8_t *vanc, uint32_t stride)
+{
+	VALIDATE(ctx);
+	VALIDATE(vanc);
+
+	struct vanc_context_private_s *priv = getPrivate(ctx);
+	if (!fmt && !priv->format && priv->formatDetect && stride) {
+		priv->format = frame_detect_v210(ctx, vanc, stride);
+		if (priv->format)
+			PRINT_DEBUG("%s() detected %s\n", __func__, priv->format->name);
+	}
+	if (!fmt)
+		fmt = priv->format;
+	if (!fmt)
+		return -EAGAIN;
+
+	uint32_t words = klvanc_video_format_vanc_samples(fmt);
+	uint32_t need = fmt->width * 3; /* nv20 unpacking wants room for both planes */
+	int luma = klvanc_video_format_luma(fmt);
+	int attempts = 0;
+
+	if (words == 0 || words > LIBKLVANC_PACKET_MAX_PAYLOAD)
+		return -EINVAL;
+	if (!stride)
+		stride = klvanc_video_format_v210_stride(fmt);
+
+	int ret = unpacked_reserve(ctx, need);
+	if (ret < 0)
+		return ret;
+
+	uint32_t rows = klvanc_video_format_vanc_rows(fmt);
+	for (uint32_t row = 0; row < rows; row++) {
+		const uint32_t *src = (const uint32_t *)(vanc + (size_t)row * stride);
+
+		/* HD parses the Y stream, SD the multiplexed stream */
+		if (luma)
+			klvanc_v210_line_to_nv20_c(src, priv->unpacked, need * sizeof(uint16_t), fmt->width);
+		else
+			klvanc_v210_line_to_uyvy_c(src, priv->unpacked, fmt->width);
+
+		ret = klvanc_packet_parse(ctx, klvanc_video_format_vanc_line(fmt, row), priv->unpacked, words);
+		if (ret > 0)
+			attempts += ret;
+	}
+
+	return attempts;
+}
+
+int klvanc_sdi_write_payload(uint8_t sdid, uint8_t did,
+	const uint8_t *src, uint16_t srcByteCount,
+	uint16_t *dst, unsigned int dstWordCapacity)
+{
+	if ((!sdid) || (!did) || (!src) || (!srcByteCount) || (srcByteCount > 255))
+		return -EINVAL;
+
+	unsigned int header_length = 6 + 1; /* Header 6 and checksum footer 1 */
+	unsigned int count = srcByteCount + header_length;
+	if (!dst)
+		return count;
+	if (dstWordCapacity < count)
+		return -ENOSPC;
+
+	const uint8_t hdr[3] = { did, sdid, srcByteCount };
+
+	dst[0] = 0x000;
+	dst[1] = 0x3ff;
+	dst[2] = 0x3ff;
+
+	/* Parity and checksum in one pass over DID/SDID/DC, then the payload */
+	uint32_t sum = klvanc_parity_encode(&dst[3], hdr, 3, 0);
+	sum = klvanc_parity_encode(&dst[6], src, srcByteCount, sum);
+	dst[6 + srcByteCount] = klvanc_checksum_word(sum);
+
+	return count;
+}
+
 int klvanc_sdi_create_payload(uint8_t sdid, uint8_t did,
         const uint8_t *src, uint16_t srcByteCount,
         uint16_t **dst, uint16_t *dstWordCount,
@@ -294,46 +539,54 @@ int klvanc_sdi_create_payload(uint8_t sdid, uint8_t did,
 	if ((bitDepth != 10) || (!sdid) || (!did) || (!src) || (!srcByteCount) || (!dst) || (!dstWordCount))
 		return -1;
 
-	int header_length = 6 + 1; /* Header 6 and checksum footer 1 */
-	uint16_t *arr = calloc(2, srcByteCount + header_length);
+	int count = klvanc_sdi_write_payload(sdid, did, src, srcByteCount, NULL, 0);
+	uint16_t *arr = calloc(count, sizeof(uint16_t));
+	if (!arr)
+		return -1;
 
-	uint16_t *v = arr;
+	*dstWordCount = klvanc_sdi_write_payload(sdid, did, src, srcByteCount, arr, count);
+	*dst = arr;
 
-	*(v++) = 0x000;
-	*(v++) = 0x3ff;
-	*(v++) = 0x3ff;
-	*(v++) = did;
-	*(v++) = sdid;
-	*(v++) = srcByteCount;
-	for (int i = 0; i < srcByteCount; i++)
-		*(v++) = *(src + i);
+	return 0;
+}
 
-	/* Generate Parity
-	 * VANC header 0/3ff/3ff = 3
-	 * sdid/did/count = 3
-	 */
-	for (int i = 3; i < (srcByteCount + 3 + 3); i++) {
-		if (__builtin_parity(arr[i]))
-			arr[i] |= 0x100;
-		else
-			arr[i] |= 0x200;
-	}
+int klvanc_serialize_alloc(struct klvanc_context_s *ctx,
+			   int (*serialize)(struct klvanc_context_s *, const void *, uint16_t *, unsigned int),
+			   const void *pkt, uint16_t **words, uint16_t *wordCount)
+{
+	int count = serialize(ctx, pkt, NULL, 0);
+	if (count < 0)
+		return count;
 
-	/* Calculate checksum */
-	uint16_t sum = 0;
-	int i;
-	for (i = 3; i < (srcByteCount + 3 + 3); i++) {
-		sum += arr[i];
-		sum &= 0x1ff;
-	}
-	*(v++) = sum | ((~sum & 0x100) << 1);
+	uint16_t *arr = malloc(count * sizeof(uint16_t));
+	if (!arr)
+		return -ENOMEM;
 
-	*dstWordCount = v - arr;
-	*dst = arr;
+	count = serialize(ctx, pkt, arr, count);
+	if (count < 0) {
+		free(arr);
+		return count;
+	}
 
+	*words = arr;
+	*wordCount = count;
 	return 0;
 }
 
+int klvanc_packet_serialize(struct klvanc_context_s *ctx, enum klvanc_packet_type_e type,
+			    const void *pkt, uint16_t *words, unsigned int wordCapacity)
+{
+	if (!ctx || !pkt)
+		return -EINVAL;
+
+	for (int i = 0; i < (sizeof(types) / sizeof(struct type_s)); i++) {
+		if ((types[i].type == type) && (types[i].serialize))
+			return types[i].serialize(ctx, pkt, words, wordCapacity);
+	}
+
+	return -EINVAL;
+}
+
 int klvanc_packet_copy(struct klvanc_packet_header_s **dst, struct klvanc_packet_header_s *src)
 {
 	*dst = malloc(sizeof(*src));
@@ -349,6 +602,23 @@ void klvanc_packet_free(struct klvanc_packet_header_s *src)
 	free(src);
 }
 
+int klvanc_packet_copy_ctx(struct klvanc_context_s *ctx, enum klvanc_mem_subsystem_e subsystem,
+			   struct klvanc_packet_header_s **dst, struct klvanc_packet_header_s *src)
+{
+	*dst = klvanc_mem_alloc(getAllocator(ctx, subsystem), sizeof(*src));
+	if (*dst == NULL)
+		return -ENOMEM;
+
+	memcpy(*dst, src, sizeof(*src));
+	return 0;
+}
+
+void klvanc_packet_free_ctx(struct klvanc_context_s *ctx, enum klvanc_mem_subsystem_e subsystem,
+			   struct klvanc_packet_header_s *src)
+{
+	klvanc_mem_free(getAllocator(ctx, subsystem), src);
+}
+
 int klvanc_packet_save(const char *dir, const struct klvanc_packet_header_s *pkt,
                        int lineNr, int did)
 {
@@ -367,11 +637,12 @@ int klvanc_packet_save(const char *dir, const struct klvanc_packet_header_s *pkt
 		if (n[i] == '/')
 			n[i] = '-'; 
 	
+	/* Shared by every context and stream, so bump it atomically */
 	static int idx = 0;
 	char *fn = malloc(strlen(dir) + 128);
 	sprintf(fn, "%s/klvanc-packet-%08d--line-%04d--did-%02x--sdid-%02x--name-%s.bin",
 		dir,
-		idx++,
+		__atomic_fetch_add(&idx, 1, __ATOMIC_RELAXED),
 		pkt->lineNr,
 		pkt->did,
 		pkt->dbnsdid,
@@ -379,12 +650,8 @@ int klvanc_packet_save(const char *dir, const struct klvanc_packet_header_s *pkt
 
 	FILE *fh = fopen(fn, "wb");
 	if (fh) {
-		/* TODO: This is a debugging feature. I don't like writing msg + N bytes of
-		 *       arbitrary padding, but neither have I convinced myself that
-		 *       writing rawPayloadLength is always (think good or bad long vanc messages)
-		 *       the correct thing to do. This will suffice for the time being.
-		 */
-		fwrite(pkt->raw, 2, pkt->payloadLengthWords + 6 /* header */ + 4 /* trailing padding */, fh);
+		/* raw holds the packet itself, ADF through checksum */
+		fwrite(pkt->raw, 2, pkt->rawLengthWords, fh);
 		fclose(fh);
 	} else {
 		fprintf(stderr, "Unable to create %s\n", fn);
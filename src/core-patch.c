@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <libklvanc/vanc.h>
+#include "core-private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* A line seen as a run of 10-bit samples, either 16-bit words or the luma
+ * samples (HD) or every component (SD) of a v210 line.
+ */
+struct samples_s
+{
+	uint16_t *words;
+	uint32_t *v210;
+	int luma;
+	int count;
+};
+
+/* Luma sample n of a six pixel v210 group: 32-bit word and bit position */
+static const uint8_t luma_word[6] = { 0, 1, 1, 2, 3, 3 };
+static const uint8_t luma_shift[6] = { 10, 0, 20, 10, 0, 20 };
+
+static inline void sample_pos(const struct samples_s *s, int k, int *word, int *shift)
+{
+	if (s->luma) {
+		*word = (k / 6) * 4 + luma_word[k % 6];
+		*shift = luma_shift[k % 6];
+	} else {
+		*word = k / 3;
+		*shift = (k % 3) * 10;
+	}
+}
+
+static inline uint16_t sample_get(const struct samples_s *s, int k)
+{
+	if (s->words)
+		return s->words[k];
+
+	int word, shift;
+	sample_pos(s, k, &word, &shift);
+	return (s->v210[word] >> shift) & 0x3ff;
+}
+
+static inline void sample_set(struct samples_s *s, int k, uint16_t val)
+{
+	if (s->words) {
+		s->words[k] = val;
+		return;
+	}
+
+	int word, shift;
+	sample_pos(s, k, &word, &shift);
+	s->v210[word] = (s->v210[word] & ~(0x3ffu << shift)) | ((uint32_t)val << shift);
+}
+
+static void samples_v210(struct samples_s *s, const uint8_t *line, int luma, int count)
+{
+	s->words = NULL;
+	s->v210 = (uint32_t *)line;
+	s->luma = luma;
+	s->count = count;
+}
+
+static int find_packet(const struct samples_s *s, uint8_t did, uint8_t sdid,
+		       struct klvanc_packet_location_s *loc)
+{
+	for (int k = 0; k + 6 < s->count; k++) {
+		if (sample_get(s, k) != 0x000 || sample_get(s, k + 1) != 0x3ff || sample_get(s, k + 2) != 0x3ff)
+			continue;
+
+		uint8_t dc = sample_get(s, k + 5) & 0xff;
+		if ((sample_get(s, k + 3) & 0xff) != did || (sample_get(s, k + 4) & 0xff) != sdid) {
+			/* Step over the whole packet, payloads may contain anything */
+			if (k + 7 + dc <= s->count)
+				k += 6 + dc;
+			continue;
+		}
+		if (k + 7 + dc > s->count)
+			return -ENOENT;
+
+		loc->offset = k;
+		loc->wordCount = 7 + dc;
+		loc->did = did;
+		loc->sdid = sdid;
+		loc->dataCount = dc;
+		return 0;
+	}
+
+	return -ENOENT;
+}
+
+static int patch_packet(struct samples_s *s, const struct klvanc_packet_location_s *loc,
+			int index, const uint8_t *bytes, int count)
+{
+	if (!loc || !bytes || count < 0)
+		return -EINVAL;
+	if (index < 0 || index + count > loc->dataCount || loc->offset + loc->wordCount > s->count)
+		return -ERANGE;
+
+	uint16_t words[255];
+	uint32_t added = klvanc_parity_encode(words, bytes, count, 0);
+
+	/* Only the changed words enter the sum, as differences modulo 512 */
+	int udw = loc->offset + 6 + index;
+	uint32_t removed = 0;
+	for (int i = 0; i < count; i++) {
+		removed += sample_get(s, udw + i);
+		sample_set(s, udw + i, words[i]);
+	}
+
+	int cs = loc->offset + loc->wordCount - 1;
+	uint32_t sum = (sample_get(s, cs) & 0x1ff) + added + (512 * 1024) - removed;
+	sample_set(s, cs, klvanc_checksum_word(sum));
+
+	return 0;
+}
+
+int klvanc_v210_find_packet(const uint8_t *line, int width, uint8_t did, uint8_t sdid,
+			    struct klvanc_packet_location_s *loc)
+{
+	struct samples_s s;
+
+	if (!line || width <= 0 || !loc)
+		return -EINVAL;
+
+	samples_v210(&s, line, width > 720, width > 720 ? width : width * 2);
+	return find_packet(&s, did, sdid, loc);
+}
+
+int klvanc_v210_patch_packet(uint8_t *line, int width, const struct klvanc_packet_location_s *loc,
+			     int index, const uint8_t *bytes, int count)
+{
+	struct samples_s s;
+
+	if (!line || width <= 0)
+		return -EINVAL;
+
+	samples_v210(&s, line, width > 720, width > 720 ? width : width * 2);
+	return patch_packet(&s, loc, index, bytes, count);
+}
+
+int klvanc_v210_find_packet_format(const uint8_t *line, const struct klvanc_video_format_s *fmt,
+				   uint8_t did, uint8_t sdid, struct klvanc_packet_location_s *loc)
+{
+	struct samples_s s;
+
+	if (!line || !fmt || !loc)
+		return -EINVAL;
+
+	samples_v210(&s, line, klvanc_video_format_luma(fmt), klvanc_video_format_vanc_samples(fmt));
+	return find_packet(&s, did, sdid, loc);
+}
+
+int klvanc_v210_patch_packet_format(uint8_t *line, const struct klvanc_video_format_s *fmt,
+				    const struct klvanc_packet_location_s *loc,
+				    int index, const uint8_t *bytes, int count)
+{
+	struct samples_s s;
+
+	if (!line || !fmt)
+		return -EINVAL;
+
+	samples_v210(&s, line, klvanc_video_format_luma(fmt), klvanc_video_format_vanc_samples(fmt));
+	return patch_packet(&s, loc, index, bytes, count);
+}
+
+int klvanc_words_find_packet(const uint16_t *words, int wordCount, uint8_t did, uint8_t sdid,
+			     struct klvanc_packet_location_s *loc)
+{
+	struct samples_s s = { .words = (uint16_t *)words, .count = wordCount };
+
+	if (!words || wordCount <= 0 || !loc)
+		return -EINVAL;
+
+	return find_packet(&s, did, sdid, loc);
+}
+
+int klvanc_words_patch_packet(uint16_t *words, int wordCount, const struct klvanc_packet_location_s *loc,
+			      int index, const uint8_t *bytes, int count)
+{
+	struct samples_s s = { .words = words, .count = wordCount };
+
+	if (!words || wordCount <= 0)
+		return -EINVAL;
+
+	return patch_packet(&s, loc, index, bytes, count);
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <libklvanc/vanc.h>
+
+#include "core-private.h"
+
+#include <string.h>
+
+#if defined(KLVANC_PERFSTATS) && KLVANC_PERFSTATS
+
+void klvanc_perf_record(struct klvanc_context_s *ctx, enum klvanc_perf_stage_e stage, uint64_t ns)
+{
+	struct klvanc_perf_s *p = &getPrivate(ctx)->perf;
+	struct klvanc_perf_stage_stats_s *s = &p->stats.stage[stage];
+
+	if (stage == KLVANC_PERF_DECODE) {
+		ns = ns > p->callbackNs ? ns - p->callbackNs : 0;
+		p->callbackNs = 0;
+	}
+	if (stage != KLVANC_PERF_LINE && stage != KLVANC_PERF_SCAN)
+		p->packetNs += ns;
+
+	int bucket = ns ? 63 - __builtin_clzll(ns) : 0;
+	if (bucket >= KLVANC_PERF_HISTOGRAM_BUCKETS)
+		bucket = KLVANC_PERF_HISTOGRAM_BUCKETS - 1;
+
+	s->count++;
+	s->totalNs += ns;
+	if (ns > s->maxNs)
+		s->maxNs = ns;
+	s->histogram[bucket]++;
+}
+
+void klvanc_perf_callback(struct klvanc_context_s *ctx, uint64_t ns)
+{
+	klvanc_perf_record(ctx, KLVANC_PERF_CALLBACK, ns);
+	getPrivate(ctx)->perf.callbackNs += ns;
+}
+
+void klvanc_perf_line(struct klvanc_context_s *ctx, uint64_t ns)
+{
+	struct klvanc_perf_s *p = &getPrivate(ctx)->perf;
+
+	klvanc_perf_record(ctx, KLVANC_PERF_LINE, ns);
+	klvanc_perf_record(ctx, KLVANC_PERF_SCAN, ns > p->packetNs ? ns - p->packetNs : 0);
+	p->packetNs = 0;
+}
+
+void klvanc_perf_did(struct klvanc_context_s *ctx, uint8_t did)
+{
+	getPrivate(ctx)->perf.stats.didCount[did]++;
+}
+
+int klvanc_context_get_perfstats(struct klvanc_context_s *ctx, struct klvanc_perfstats_s *stats)
+{
+	VALIDATE(ctx);
+	VALIDATE(stats);
+
+	memcpy(stats, &getPrivate(ctx)->perf.stats, sizeof(*stats));
+
+	return KLAPI_OK;
+}
+
+int klvanc_context_reset_perfstats(struct klvanc_context_s *ctx)
+{
+	VALIDATE(ctx);
+
+	memset(&getPrivate(ctx)->perf.stats, 0, sizeof(struct klvanc_perfstats_s));
+
+	return KLAPI_OK;
+}
+
+#else
+
+int klvanc_context_get_perfstats(struct klvanc_context_s *ctx, struct klvanc_perfstats_s *stats)
+{
+	return -ENOSYS;
+}
+
+int klvanc_context_reset_perfstats(struct klvanc_context_s *ctx)
+{
+	return -ENOSYS;
+}
+
+#endif
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* Not for inclusion by user applications */
+
+#ifndef _CORE_PERF_H
+#define _CORE_PERF_H
+
+#include <stdint.h>
+#include <time.h>
+#include <libklvanc/perfstats.h>
+
+/* Instrumentation of the parse path, enabled with --enable-perfstats.
+ * When disabled every macro below expands to nothing, or to the bare call.
+ */
+#if defined(KLVANC_PERFSTATS) && KLVANC_PERFSTATS
+
+struct klvanc_perf_s
+{
+	struct klvanc_perfstats_s stats;
+	uint64_t packetNs;	/* Packet stage time within the current line */
+	uint64_t callbackNs;	/* Callback time within the current decode */
+};
+
+static __inline__ uint64_t klvanc_perf_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+}
+
+struct klvanc_context_s;
+void klvanc_perf_record(struct klvanc_context_s *ctx, enum klvanc_perf_stage_e stage, uint64_t ns);
+void klvanc_perf_callback(struct klvanc_context_s *ctx, uint64_t ns);
+void klvanc_perf_line(struct klvanc_context_s *ctx, uint64_t ns);
+void klvanc_perf_did(struct klvanc_context_s *ctx, uint8_t did);
+
+#define PERF_START(t) uint64_t t = klvanc_perf_now()
+#define PERF_STOP(stage, t) klvanc_perf_record(ctx, stage, klvanc_perf_now() - (t))
+#define PERF_LINE(t) klvanc_perf_line(ctx, klvanc_perf_now() - (t))
+#define PERF_DID(did) klvanc_perf_did(ctx, did)
+/* Type specific callbacks are made from inside DECODE, which excludes them */
+#define PERF_CALLBACK(call) do { \
+	uint64_t _cbt = klvanc_perf_now(); \
+	call; \
+	klvanc_perf_callback(ctx, klvanc_perf_now() - _cbt); \
+} while (0)
+
+#else
+
+#define PERF_START(t)
+#define PERF_STOP(stage, t)
+#define PERF_LINE(t)
+#define PERF_DID(did)
+#define PERF_CALLBACK(call) call
+
+#endif
+
+#endif /* _CORE_PERF_H */
@@ -31,10 +31,69 @@
 #include <pthread.h>
 #include "xorg-list.h"
 #include "klbitstream_readwriter.h"
+#include "core-alloc.h"
+#include "core-perf.h"
+#include "core-keymap.h"
+#include <libklvanc/vanc-lines.h>
 
 #define getPrivate(ctx) ((struct vanc_context_private_s *)ctx->priv)
+
+/* Per context decode storage. Each packet is parsed into hdr and then
+ * decoded into the slot for its type, so steady state parsing never touches
+ * the heap. Contents are only valid for the duration of the callbacks.
+ */
+struct vanc_context_private_s
+{
+	struct klvanc_memaccount_s *account;
+
+	/* Frame counting, advanced by klvanc_frame_end() or, until the application
+	 * first calls it, whenever the parsed line number goes backwards.
+	 */
+	uint64_t frameNr;
+	unsigned int lastLineNr;
+	int frameExplicit;
+
+	struct klvanc_stats_s *stats;
+	struct klvanc_shm_writer_s *shm;
+	struct klvanc_change_s *change;
+	struct klvanc_linemap_s *linemap;
+	struct klvanc_filter_s *filter;
+	struct klvanc_async_s *async;
+	struct klvanc_frame_collect_s *frame;
+	struct klvanc_compose_s *compose;
+
+	/* Parse geometry, set by the application or detected from ST 352 */
+	const struct klvanc_video_format_s *format;
+	int formatDetect;
+
+	/* Unpacked line for klvanc_frame_parse_v210(), sized for the widest format seen */
+	uint16_t *unpacked;
+	uint32_t unpackedWords;
+
+	struct klvanc_packet_header_s hdr;
+
+	struct klvanc_packet_afd_s afd;
+	struct klvanc_packet_eia_708b_s eia_708b;
+	struct klvanc_packet_eia_608_s eia_608;
+	struct klvanc_packet_scte_104_s scte_104;
+	struct klvanc_packet_kl_u64le_counter_s kl_u64le_counter;
+	struct klvanc_packet_sdp_s sdp;
+	struct klvanc_packet_smpte_12_2_s smpte_12_2;
+	struct klvanc_packet_smpte_2108_1_s smpte_2108_1;
+	struct klvanc_packet_smpte_352_s smpte_352;
+
+#if defined(KLVANC_PERFSTATS) && KLVANC_PERFSTATS
+	struct klvanc_perf_s perf;
+#endif
+};
+#define getAllocator(ctx, subsystem) klvanc_memaccount_allocator(getPrivate(ctx)->account, subsystem)
 #define sanitizeWord(word) ((word) & 0xff)
 
+/* DC is eight bits, so no decoder reads a header's payload past this. Words after DC
+ * up to here are kept zero, never left over from an earlier packet.
+ */
+#define KLVANC_DECODE_PAYLOAD_WORDS 256
+
 #define KLAPI_OK 0
 
 #define VALIDATE(ctx) \
@@ -60,6 +119,7 @@ int dump_SCTE_104(struct klvanc_context_s *ctx, void *p);
 int parse_SCTE_104(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *hdr,
 		   void **pp);
 void cleanup_SCTE_104(struct klvanc_context_s *ctx);
+void release_SCTE_104(struct klvanc_context_s *ctx, void *p);
 
 /* core-packet-kl_u64le_counter.c */
 int dump_KL_U64LE_COUNTER(struct klvanc_context_s *ctx, void *p);
@@ -74,6 +134,11 @@ int dump_SDP(struct klvanc_context_s *ctx, void *p);
 int parse_SDP(struct klvanc_context_s *ctx,
             struct klvanc_packet_header_s *hdr, void **pp);
 
+/* core-packet-smpte_352.c */
+int parse_SMPTE_352(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *hdr, void **pp);
+/* The registry format named by the first valid payload identifier in a run of words, or NULL */
+const struct klvanc_video_format_s *klvanc_SMPTE_352_detect(const uint16_t *words, int wordCount);
+
 /* core-packet-smpte_12_2.c */
 int dump_SMPTE_12_2(struct klvanc_context_s *ctx, void *p);
 int parse_SMPTE_12_2(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *hdr,
@@ -85,6 +150,12 @@ int parse_SMPTE_2108_1(struct klvanc_context_s *ctx, struct klvanc_packet_header
 		       void **pp);
 
 
+/* core-packets.c, packet copies owned by the context and its allocator */
+int  klvanc_packet_copy_ctx(struct klvanc_context_s *ctx, enum klvanc_mem_subsystem_e subsystem,
+			    struct klvanc_packet_header_s **dst, struct klvanc_packet_header_s *src);
+void klvanc_packet_free_ctx(struct klvanc_context_s *ctx, enum klvanc_mem_subsystem_e subsystem,
+			    struct klvanc_packet_header_s *src);
+
 /* We don't expect anything outside of the VANC framework to need toascii
  * call these, so we'll keep them private / internal calls.
  */
@@ -93,11 +164,127 @@ extern void klvanc_cache_free(struct klvanc_context_s *ctx);
 extern int  klvanc_cache_update(struct klvanc_context_s *ctx,
 				struct klvanc_packet_header_s *pkt);
 
-/* Logging Macros */
-#define PRINT_ERR(...) if (ctx->log_cb) ctx->log_cb(NULL, LIBKLVANC_LOGLEVEL_ERR, __VA_ARGS__);
-#define PRINT_DEBUG(...) if (ctx->log_cb) ctx->log_cb(NULL, LIBKLVANC_LOGLEVEL_DEBUG, __VA_ARGS__);
-#define PRINT_DEBUG_MEMBER_INT(m) if (ctx->log_cb) ctx->log_cb(NULL, LIBKLVANC_LOGLEVEL_DEBUG, " %s = 0x%x\n", #m, m);
-#define PRINT_DEBUG_MEMBER_INTI(m, n) if (ctx->log_cb) ctx->log_cb(NULL, LIBKLVANC_LOGLEVEL_DEBUG, "%*c%s = 0x%x\n", n, ' ', #m, m);
-#define PRINT_DEBUG_MEMBER_INT64(m) if (ctx->log_cb) ctx->log_cb(NULL, LIBKLVANC_LOGLEVEL_DEBUG, " %s = 0x%" PRIx64 "\n", #m, m);
+/* core-stats.c */
+void klvanc_stats_update(struct klvanc_context_s *ctx, const struct klvanc_packet_header_s *hdr);
+void klvanc_stats_free(struct klvanc_context_s *ctx);
+
+/* core-shm.c */
+void klvanc_shm_update(struct klvanc_context_s *ctx, const struct klvanc_packet_header_s *hdr);
+void klvanc_shm_free(struct klvanc_context_s *ctx);
+
+/* core-change.c, returns 1 if the packet is unchanged and must not be delivered */
+int  klvanc_change_suppress(struct klvanc_context_s *ctx, const struct klvanc_packet_header_s *hdr);
+void klvanc_change_free(struct klvanc_context_s *ctx);
+
+/* core-linemap.c, begin returns 0 if the line should not be scanned, otherwise the offset to scan from.
+ * firstOffset is where the first packet was found, or -1.
+ */
+int  klvanc_linemap_begin(struct klvanc_context_s *ctx, unsigned int lineNr, unsigned int *offset);
+void klvanc_linemap_end(struct klvanc_context_s *ctx, unsigned int lineNr, unsigned int offset, int firstOffset);
+void klvanc_linemap_free(struct klvanc_context_s *ctx);
+
+/* core-filter.c, returns 1 and counts the drop if the DID/SDID is filtered out */
+int  klvanc_filter_drop(struct klvanc_context_s *ctx, uint8_t did, uint8_t sdid);
+void klvanc_filter_free(struct klvanc_context_s *ctx);
+
+/* core-async.c */
+void klvanc_async_push(struct klvanc_context_s *ctx, const struct klvanc_packet_header_s *hdr);
+void klvanc_async_free(struct klvanc_context_s *ctx);
+
+/* core-frame.c */
+void klvanc_frame_collect(struct klvanc_context_s *ctx, const struct klvanc_packet_header_s *hdr);
+void klvanc_frame_deliver(struct klvanc_context_s *ctx);
+void klvanc_frame_free(struct klvanc_context_s *ctx);
+
+/* core-lines.c. Pack a line into v210 and return the bytes touched, a whole number
+ * of 16 byte groups. Words go in the luma samples only, or with luma clear in every
+ * component. With blank set, the unused words of the last group are black.
+ */
+int  klvanc_line_pack_v210(struct klvanc_context_s *ctx, struct klvanc_line_s *line,
+			   uint8_t *out_buf, int line_pixel_width, int luma, int blank);
+void klvanc_v210_blank(uint8_t *dst, size_t bytes);
+struct klvanc_line_s *klvanc_line_set_find(struct klvanc_line_set_s *set, int line_number);
+
+/* core-linecache.c. Prepare allocates the slot for a line number and is not thread safe,
+ * pack may run concurrently for different line numbers. A NULL line is an empty one.
+ */
+int  klvanc_line_cache_prepare(struct klvanc_line_cache_s *cache, int lineNr, int line_pixel_width);
+int  klvanc_line_cache_pack(struct klvanc_context_s *ctx, struct klvanc_line_cache_s *cache,
+			    int lineNr, struct klvanc_line_s *line, uint8_t *out_buf,
+			    int line_pixel_width, int luma, int blank, uint32_t stride, int recycled, int *bytes);
+
+/* core-compose.c */
+void klvanc_compose_free(struct klvanc_context_s *ctx);
+
+/* core-checksum.c */
+/* Reduce a running sum of words to a checksum word, bit 9 the inverse of bit 8 */
+static inline uint16_t klvanc_checksum_word(uint32_t sum)
+{
+	sum &= 0x1ff;
+	return sum | ((~sum & 0x100) << 1);
+}
+
+/* Widen count bytes to words with parity bits set, returning sum plus the words written */
+uint32_t klvanc_parity_encode(uint16_t *dst, const uint8_t *src, int count, uint32_t sum);
+
+/* core-packets.c */
+enum klvanc_packet_type_e klvanc_packet_type_lookup(unsigned short did, unsigned short sdid);
+
+/* Per type serializers for the type table. Each writes a complete packet, ADF to
+ * checksum, and returns the words written, or the words needed when words is NULL.
+ */
+int serialize_AFD(struct klvanc_context_s *ctx, const void *pkt, uint16_t *words, unsigned int wordCapacity);
+int serialize_EIA_608(struct klvanc_context_s *ctx, const void *pkt, uint16_t *words, unsigned int wordCapacity);
+int serialize_EIA_708B(struct klvanc_context_s *ctx, const void *pkt, uint16_t *words, unsigned int wordCapacity);
+int serialize_SCTE_104(struct klvanc_context_s *ctx, const void *pkt, uint16_t *words, unsigned int wordCapacity);
+int serialize_SMPTE_12_2(struct klvanc_context_s *ctx, const void *pkt, uint16_t *words, unsigned int wordCapacity);
+int serialize_SMPTE_352(struct klvanc_context_s *ctx, const void *pkt, uint16_t *words, unsigned int wordCapacity);
+int serialize_KL_U64LE_COUNTER(struct klvanc_context_s *ctx, const void *pkt, uint16_t *words,
+			       unsigned int wordCapacity);
+
+/* Size, allocate and serialize, for the klvanc_convert_*_to_words() family.
+ * The words come from malloc(), callers of those APIs release them with free().
+ */
+int klvanc_serialize_alloc(struct klvanc_context_s *ctx,
+			   int (*serialize)(struct klvanc_context_s *, const void *, uint16_t *, unsigned int),
+			   const void *pkt, uint16_t **words, uint16_t *wordCount);
+
+/* core-packets.c, fire the all callback then decode and fire the per type callback */
+void klvanc_packet_deliver(struct klvanc_context_s *ctx, struct klvanc_packet_header_s *hdr);
+
+/* Parse and deliver the single packet at arr, len words holding at least all of it.
+ * Returns -ECANCELED when filtered, < 0 when the words are not a packet.
+ */
+int klvanc_packet_parse_one(struct klvanc_context_s *ctx, unsigned int lineNr, unsigned int offset,
+			    const unsigned short *arr, unsigned int len);
+
+/* Copy the configuration, but none of the counters or learned state, from one context to another */
+int  klvanc_filter_inherit(struct klvanc_context_s *dst, struct klvanc_context_s *src);
+int  klvanc_change_inherit(struct klvanc_context_s *dst, struct klvanc_context_s *src);
+int  klvanc_linemap_inherit(struct klvanc_context_s *dst, struct klvanc_context_s *src);
+
+/* core.c, creates a context on an existing account, taking over the caller's reference */
+int  klvanc_context_alloc(struct klvanc_context_s **ctx, struct klvanc_memaccount_s *account);
+
+/* Logging Macros. The level is tested before any arguments are evaluated,
+ * so a suppressed message costs a compare rather than a varargs call.
+ */
+#define LOG_ENABLED(level) (ctx->log_cb && (level) <= ctx->log_level)
+#define PRINT_ERR(...) if (LOG_ENABLED(LIBKLVANC_LOGLEVEL_ERR)) ctx->log_cb(NULL, LIBKLVANC_LOGLEVEL_ERR, __VA_ARGS__);
+#define PRINT_DEBUG(...) if (LOG_ENABLED(LIBKLVANC_LOGLEVEL_DEBUG)) ctx->log_cb(NULL, LIBKLVANC_LOGLEVEL_DEBUG, __VA_ARGS__);
+#define PRINT_DEBUG_MEMBER_INT(m) if (LOG_ENABLED(LIBKLVANC_LOGLEVEL_DEBUG)) ctx->log_cb(NULL, LIBKLVANC_LOGLEVEL_DEBUG, " %s = 0x%x\n", #m, m);
+#define PRINT_DEBUG_MEMBER_INTI(m, n) if (LOG_ENABLED(LIBKLVANC_LOGLEVEL_DEBUG)) ctx->log_cb(NULL, LIBKLVANC_LOGLEVEL_DEBUG, "%*c%s = 0x%x\n", n, ' ', #m, m);
+#define PRINT_DEBUG_MEMBER_INT64(m) if (LOG_ENABLED(LIBKLVANC_LOGLEVEL_DEBUG)) ctx->log_cb(NULL, LIBKLVANC_LOGLEVEL_DEBUG, " %s = 0x%" PRIx64 "\n", #m, m);
+
+/* Per packet tracing from the parse path, requires ctx->verbose and only
+ * exists in debug builds (--enable-debug). Release builds compile it away.
+ */
+#if defined(DEBUG) && DEBUG
+#define KLVANC_TRACE 1
+#else
+#define KLVANC_TRACE 0
+#endif
+#define TRACE_ENABLED() (KLVANC_TRACE && ctx->verbose && LOG_ENABLED(LIBKLVANC_LOGLEVEL_DEBUG))
+#define PRINT_TRACE(...) if (TRACE_ENABLED()) ctx->log_cb(NULL, LIBKLVANC_LOGLEVEL_DEBUG, __VA_ARGS__);
 
 #endif
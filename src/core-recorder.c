@@ -0,0 +1,374 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <libklvanc/vanc.h>
+
+#include "klqueue.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/uio.h>
+
+/* Every record lives in a preallocated slot. Slots cycle between the free
+ * queue and the filled queue, so the capture thread never allocates memory,
+ * never takes a lock and never touches the filesystem.
+ */
+struct klvanc_recorder_slot_s
+{
+	uint32_t length; /* Bytes used, header included */
+	uint8_t buf[];   /* Record header followed by words */
+};
+
+struct klvanc_recorder_s
+{
+	struct klvanc_recorder_params_s params;
+	int fd;
+
+	uint8_t *slotmem;
+	size_t slotSize;
+	struct klqueue_s freeq;
+	struct klqueue_s filledq;
+
+	pthread_t writer;
+	sem_t sem;
+	int terminate;
+
+	uint32_t sequence;
+	uint64_t recorded;
+	uint64_t dropped;
+	uint64_t written;
+	uint64_t bytesWritten;
+	uint64_t writeErrors;
+	uint32_t highWaterMark;
+};
+
+/* Linux refuses writev() calls with more than 1024 vectors */
+#define MAX_BATCH_SIZE 1024
+
+static void put_le16(uint8_t *p, uint16_t v)
+{
+	p[0] = v;
+	p[1] = v >> 8;
+}
+
+static void put_le32(uint8_t *p, uint32_t v)
+{
+	p[0] = v;
+	p[1] = v >> 8;
+	p[2] = v >> 16;
+	p[3] = v >> 24;
+}
+
+static void put_le64(uint8_t *p, uint64_t v)
+{
+	put_le32(p, v);
+	put_le32(p + 4, v >> 32);
+}
+
+static uint64_t now_us(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+}
+
+void klvanc_recorder_params_default(struct klvanc_recorder_params_s *params)
+{
+	params->queueDepth = 4096;
+	params->maxWords = 1024;
+	params->batchSize = 64;
+	params->dropPolicy = KLVANC_RECORDER_DROP_NEWEST;
+}
+
+/* Write every iov entry completely, coping with short writes. */
+static int write_all(int fd, struct iovec *iov, int cnt)
+{
+	while (cnt > 0) {
+		ssize_t r = writev(fd, iov, cnt);
+		if (r < 0) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		while (cnt > 0 && (size_t)r >= iov->iov_len) {
+			r -= iov->iov_len;
+			iov++;
+			cnt--;
+		}
+		if (cnt > 0) {
+			iov->iov_base = (uint8_t *)iov->iov_base + r;
+			iov->iov_len -= r;
+		}
+	}
+	return 0;
+}
+
+/* Returns the number of records drained. */
+static int writer_drain(struct klvanc_recorder_s *rec, struct iovec *iov,
+	struct klvanc_recorder_slot_s **batch)
+{
+	int total = 0;
+
+	for (;;) {
+		int cnt = 0;
+		size_t bytes = 0;
+
+		while (cnt < (int)rec->params.batchSize) {
+			struct klvanc_recorder_slot_s *s = klqueue_pop(&rec->filledq);
+			if (!s)
+				break;
+			batch[cnt] = s;
+			iov[cnt].iov_base = s->buf;
+			iov[cnt].iov_len = s->length;
+			bytes += s->length;
+			cnt++;
+		}
+		if (cnt == 0)
+			break;
+
+		if (write_all(rec->fd, iov, cnt) < 0) {
+			__atomic_add_fetch(&rec->writeErrors, 1, __ATOMIC_RELAXED);
+		} else {
+			__atomic_add_fetch(&rec->written, cnt, __ATOMIC_RELAXED);
+			__atomic_add_fetch(&rec->bytesWritten, bytes, __ATOMIC_RELAXED);
+		}
+
+		for (int i = 0; i < cnt; i++)
+			klqueue_push(&rec->freeq, batch[i]);
+
+		total += cnt;
+	}
+
+	return total;
+}
+
+static void *writer_thread(void *p)
+{
+	struct klvanc_recorder_s *rec = p;
+	struct iovec *iov = malloc(rec->params.batchSize * sizeof(*iov));
+	struct klvanc_recorder_slot_s **batch = malloc(rec->params.batchSize * sizeof(*batch));
+
+	if (!iov || !batch) {
+		free(iov);
+		free(batch);
+		return NULL;
+	}
+
+	for (;;) {
+		while (sem_wait(&rec->sem) < 0 && errno == EINTR)
+			;
+		int terminate = __atomic_load_n(&rec->terminate, __ATOMIC_ACQUIRE);
+
+		writer_drain(rec, iov, batch);
+
+		if (terminate)
+			break;
+	}
+
+	/* Anything pushed after the terminate flag was observed */
+	writer_drain(rec, iov, batch);
+
+	free(iov);
+	free(batch);
+	return NULL;
+}
+
+int klvanc_recorder_alloc(struct klvanc_recorder_s **rec, const char *filename,
+	struct klvanc_recorder_params_s *params)
+{
+	if (!rec || !filename)
+		return -EINVAL;
+
+	struct klvanc_recorder_s *r = calloc(1, sizeof(*r));
+	if (!r)
+		return -ENOMEM;
+
+	if (params)
+		r->params = *params;
+	else
+		klvanc_recorder_params_default(&r->params);
+
+	if (r->params.queueDepth == 0 || r->params.maxWords == 0 || r->params.batchSize == 0) {
+		free(r);
+		return -EINVAL;
+	}
+	if (r->params.batchSize > MAX_BATCH_SIZE)
+		r->params.batchSize = MAX_BATCH_SIZE;
+
+	r->fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (r->fd < 0) {
+		int ret = -errno;
+		free(r);
+		return ret;
+	}
+
+	/* Keep each slot cache line aligned so producers don't share lines */
+	r->slotSize = sizeof(struct klvanc_recorder_slot_s) + KLVANC_RECORDER_RECORD_HEADER_SIZE +
+		(r->params.maxWords * sizeof(uint16_t));
+	r->slotSize = (r->slotSize + 63) & ~(size_t)63;
+
+	if (klqueue_init(&r->freeq, r->params.queueDepth) < 0)
+		goto err_fd;
+	if (klqueue_init(&r->filledq, r->params.queueDepth) < 0)
+		goto err_freeq;
+
+	r->slotmem = calloc(r->params.queueDepth, r->slotSize);
+	if (!r->slotmem)
+		goto err_filledq;
+
+	for (uint32_t i = 0; i < r->params.queueDepth; i++)
+		klqueue_push(&r->freeq, r->slotmem + (i * r->slotSize));
+
+	if (sem_init(&r->sem, 0, 0) < 0)
+		goto err_slotmem;
+
+	if (pthread_create(&r->writer, NULL, writer_thread, r) != 0) {
+		sem_destroy(&r->sem);
+		goto err_slotmem;
+	}
+
+	*rec = r;
+	return 0;
+
+err_slotmem:
+	free(r->slotmem);
+err_filledq:
+	klqueue_free(&r->filledq);
+err_freeq:
+	klqueue_free(&r->freeq);
+err_fd:
+	close(r->fd);
+	free(r);
+	return -ENOMEM;
+}
+
+void klvanc_recorder_free(struct klvanc_recorder_s *rec)
+{
+	if (!rec)
+		return;
+
+	__atomic_store_n(&rec->terminate, 1, __ATOMIC_RELEASE);
+	sem_post(&rec->sem);
+	pthread_join(rec->writer, NULL);
+
+	sem_destroy(&rec->sem);
+	close(rec->fd);
+	free(rec->slotmem);
+	klqueue_free(&rec->filledq);
+	klqueue_free(&rec->freeq);
+	free(rec);
+}
+
+static int recorder_push(struct klvanc_recorder_s *rec, uint16_t type, uint16_t lineNr,
+	const uint16_t *words, uint32_t wordCount)
+{
+	if (!rec || (!words && wordCount))
+		return -EINVAL;
+	if (wordCount > rec->params.maxWords)
+		return -EINVAL;
+
+	uint32_t seq = __atomic_fetch_add(&rec->sequence, 1, __ATOMIC_RELAXED);
+
+	struct klvanc_recorder_slot_s *s = klqueue_pop(&rec->freeq);
+	if (!s) {
+		__atomic_add_fetch(&rec->dropped, 1, __ATOMIC_RELAXED);
+		if (rec->params.dropPolicy != KLVANC_RECORDER_DROP_OLDEST)
+			return -EAGAIN;
+
+		/* Steal the oldest record which the writer hasn't claimed yet. */
+		s = klqueue_pop(&rec->filledq);
+		if (!s)
+			return -EAGAIN;
+	}
+
+	uint8_t *p = s->buf;
+	put_le32(p + 0, KLVANC_RECORDER_MAGIC);
+	put_le16(p + 4, type);
+	put_le16(p + 6, lineNr);
+	put_le32(p + 8, wordCount);
+	put_le32(p + 12, seq);
+	put_le64(p + 16, now_us());
+
+	p += KLVANC_RECORDER_RECORD_HEADER_SIZE;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	memcpy(p, words, wordCount * sizeof(uint16_t));
+#else
+	for (uint32_t i = 0; i < wordCount; i++)
+		put_le16(p + (i * 2), words[i]);
+#endif
+	s->length = KLVANC_RECORDER_RECORD_HEADER_SIZE + (wordCount * sizeof(uint16_t));
+
+	/* Can't fail, the filled queue is as deep as the slot pool. */
+	klqueue_push(&rec->filledq, s);
+	__atomic_add_fetch(&rec->recorded, 1, __ATOMIC_RELAXED);
+
+	uint32_t depth = klqueue_count(&rec->filledq);
+	uint32_t hwm = __atomic_load_n(&rec->highWaterMark, __ATOMIC_RELAXED);
+	while (depth > hwm) {
+		if (__atomic_compare_exchange_n(&rec->highWaterMark, &hwm, depth, 1,
+						__ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			break;
+	}
+
+	sem_post(&rec->sem);
+
+	return 0;
+}
+
+int klvanc_recorder_push_packet(struct klvanc_recorder_s *rec, struct klvanc_packet_header_s *hdr)
+{
+	if (!hdr)
+		return -EINVAL;
+
+	/* ADF(3) + DID + DBN/SDID + DC + payload + checksum */
+	uint32_t count = hdr->payloadLengthWords + 7;
+	if (count > hdr->rawLengthWords)
+		count = hdr->rawLengthWords;
+
+	return recorder_push(rec, KLVANC_RECORD_PACKET, hdr->lineNr, hdr->raw, count);
+}
+
+int klvanc_recorder_push_line(struct klvanc_recorder_s *rec, uint16_t lineNr,
+	const uint16_t *words, uint32_t wordCount)
+{
+	return recorder_push(rec, KLVANC_RECORD_LINE, lineNr, words, wordCount);
+}
+
+void klvanc_recorder_get_stats(struct klvanc_recorder_s *rec, struct klvanc_recorder_stats_s *stats)
+{
+	if (!rec || !stats)
+		return;
+
+	stats->recorded = __atomic_load_n(&rec->recorded, __ATOMIC_RELAXED);
+	stats->dropped = __atomic_load_n(&rec->dropped, __ATOMIC_RELAXED);
+	stats->written = __atomic_load_n(&rec->written, __ATOMIC_RELAXED);
+	stats->bytesWritten = __atomic_load_n(&rec->bytesWritten, __ATOMIC_RELAXED);
+	stats->writeErrors = __atomic_load_n(&rec->writeErrors, __ATOMIC_RELAXED);
+	stats->highWaterMark = __atomic_load_n(&rec->highWaterMark, __ATOMIC_RELAXED);
+}
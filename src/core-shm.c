@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <libklvanc/vanc.h>
+
+#include "core-private.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define ENTRY_SIZE ((sizeof(struct klvanc_shm_entry_s) + 63) & ~63)
+#define HEADER_SIZE ((sizeof(struct klvanc_shm_header_s) + 63) & ~63)
+#define MAX_ENTRIES KLVANC_KEYMAP_MAX_ENTRIES
+#define READ_ATTEMPTS 1000
+
+struct klvanc_shm_writer_s
+{
+	char *name;
+	int fd;
+	size_t size;
+	struct klvanc_shm_header_s *hdr;
+	uint8_t *entries;
+
+	struct klvanc_keymap_s map;
+};
+
+struct klvanc_shm_reader_s
+{
+	size_t size;
+	const struct klvanc_shm_header_s *hdr;
+	const uint8_t *entries;
+};
+
+static size_t segment_size(int maxEntries)
+{
+	return HEADER_SIZE + ((size_t)maxEntries * ENTRY_SIZE);
+}
+
+static struct klvanc_shm_entry_s *entry_at(struct klvanc_shm_writer_s *w, int index)
+{
+	return (struct klvanc_shm_entry_s *)(w->entries + ((size_t)index * ENTRY_SIZE));
+}
+
+void klvanc_shm_free(struct klvanc_context_s *ctx)
+{
+	const struct klvanc_allocator_s *a = getAllocator(ctx, KLVANC_MEM_CORE);
+	struct klvanc_shm_writer_s *w = getPrivate(ctx)->shm;
+	if (!w)
+		return;
+
+	if (w->hdr)
+		munmap(w->hdr, w->size);
+	if (w->fd >= 0) {
+		close(w->fd);
+		shm_unlink(w->name);
+	}
+	klvanc_keymap_free(&w->map, a);
+	klvanc_mem_free(a, w->name);
+	klvanc_mem_free(a, w);
+	getPrivate(ctx)->shm = NULL;
+}
+
+int klvanc_context_enable_shm_export(struct klvanc_context_s *ctx, const char *name, int maxEntries)
+{
+	VALIDATE(ctx);
+	VALIDATE(name);
+
+	if (maxEntries == 0)
+		maxEntries = KLVANC_SHM_DEFAULT_ENTRIES;
+	if (maxEntries < 0 || maxEntries > MAX_ENTRIES)
+		return -EINVAL;
+	if (getPrivate(ctx)->shm)
+		return -EEXIST;
+
+	const struct klvanc_allocator_s *a = getAllocator(ctx, KLVANC_MEM_CORE);
+	struct klvanc_shm_writer_s *w = klvanc_mem_calloc(a, 1, sizeof(*w));
+	if (!w)
+		return -ENOMEM;
+	w->fd = -1;
+	getPrivate(ctx)->shm = w;
+
+	w->name = klvanc_mem_alloc(a, strlen(name) + 1);
+	if (!w->name || klvanc_keymap_alloc(&w->map, a, maxEntries) < 0) {
+		klvanc_shm_free(ctx);
+		return -ENOMEM;
+	}
+	strcpy(w->name, name);
+
+	w->fd = shm_open(name, O_CREAT | O_RDWR | O_TRUNC, 0644);
+	if (w->fd < 0) {
+		int ret = -errno;
+		PRINT_ERR("%s() unable to create %s\n", __func__, name);
+		klvanc_shm_free(ctx);
+		return ret;
+	}
+
+	w->size = segment_size(maxEntries);
+	if (ftruncate(w->fd, w->size) < 0) {
+		int ret = -errno;
+		klvanc_shm_free(ctx);
+		return ret;
+	}
+
+	void *p = mmap(NULL, w->size, PROT_READ | PROT_WRITE, MAP_SHARED, w->fd, 0);
+	if (p == MAP_FAILED) {
+		int ret = -errno;
+		klvanc_shm_free(ctx);
+		return ret;
+	}
+	w->hdr = p;
+	w->entries = (uint8_t *)p + HEADER_SIZE;
+
+	w->hdr->version = KLVANC_SHM_VERSION;
+	w->hdr->headerSize = HEADER_SIZE;
+	w->hdr->entrySize = ENTRY_SIZE;
+	w->hdr->maxEntries = maxEntries;
+	w->hdr->writerPid = getpid();
+	/* Readers validate the magic, so it goes last */
+	__atomic_store_n(&w->hdr->magic, KLVANC_SHM_MAGIC, __ATOMIC_RELEASE);
+
+	return KLAPI_OK;
+}
+
+static struct klvanc_shm_entry_s *lookup(struct klvanc_shm_writer_s *w, const struct klvanc_packet_header_s *hdr)
+{
+	int inserted;
+	int index = klvanc_keymap_find(&w->map, klvanc_keymap_key(hdr->did, hdr->dbnsdid, hdr->lineNr), 1, &inserted);
+	if (index < 0)
+		return NULL;
+
+	struct klvanc_shm_entry_s *e = entry_at(w, index);
+	if (!inserted)
+		return e;
+
+	e->did = hdr->did;
+	e->sdid = hdr->dbnsdid;
+	e->lineNr = hdr->lineNr;
+
+	/* Publish only once the identity of the entry is in place */
+	__atomic_store_n(&w->hdr->entryCount, index + 1, __ATOMIC_RELEASE);
+
+	return e;
+}
+
+void klvanc_shm_update(struct klvanc_context_s *ctx, const struct klvanc_packet_header_s *hdr)
+{
+	struct klvanc_shm_writer_s *w = getPrivate(ctx)->shm;
+	struct klvanc_shm_entry_s *e = lookup(w, hdr);
+	if (!e)
+		return;
+
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	uint32_t seq = e->seq;
+	__atomic_store_n(&e->seq, seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	e->count++;
+	if (!hdr->checksumValid)
+		e->checksumFailures++;
+	e->lastUpdated = ((uint64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+	e->payloadLengthWords = hdr->payloadLengthWords;
+	memcpy(e->payload, hdr->payload, hdr->payloadLengthWords * sizeof(uint16_t));
+
+	__atomic_store_n(&e->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+int klvanc_shm_reader_open(struct klvanc_shm_reader_s **reader, const char *name)
+{
+	if (!reader || !name)
+		return -EINVAL;
+
+	int fd = shm_open(name, O_RDONLY, 0);
+	if (fd < 0)
+		return -errno;
+
+	struct stat st;
+	if (fstat(fd, &st) < 0) {
+		int ret = -errno;
+		close(fd);
+		return ret;
+	}
+	if ((size_t)st.st_size < HEADER_SIZE) {
+		close(fd);
+		return -EPROTO;
+	}
+
+	void *p = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (p == MAP_FAILED)
+		return -errno;
+
+	const struct klvanc_shm_header_s *hdr = p;
+	if (__atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE) != KLVANC_SHM_MAGIC ||
+	    hdr->version != KLVANC_SHM_VERSION ||
+	    hdr->entrySize < sizeof(struct klvanc_shm_entry_s) ||
+	    hdr->headerSize + ((size_t)hdr->maxEntries * hdr->entrySize) > (size_t)st.st_size) {
+		munmap(p, st.st_size);
+		return -EPROTO;
+	}
+
+	struct klvanc_shm_reader_s *r = calloc(1, sizeof(*r));
+	if (!r) {
+		munmap(p, st.st_size);
+		return -ENOMEM;
+	}
+	r->size = st.st_size;
+	r->hdr = hdr;
+	r->entries = (const uint8_t *)p + hdr->headerSize;
+
+	*reader = r;
+	return 0;
+}
+
+void klvanc_shm_reader_close(struct klvanc_shm_reader_s *reader)
+{
+	if (!reader)
+		return;
+
+	munmap((void *)reader->hdr, reader->size);
+	free(reader);
+}
+
+const struct klvanc_shm_header_s *klvanc_shm_reader_header(struct klvanc_shm_reader_s *reader)
+{
+	return reader->hdr;
+}
+
+int klvanc_shm_reader_read(struct klvanc_shm_reader_s *reader, int index, struct klvanc_shm_entry_s *entry)
+{
+	if (!reader || !entry)
+		return -EINVAL;
+	if (index < 0 || (uint32_t)index >= __atomic_load_n(&reader->hdr->entryCount, __ATOMIC_ACQUIRE))
+		return -EINVAL;
+
+	const struct klvanc_shm_entry_s *e =
+		(const struct klvanc_shm_entry_s *)(reader->entries + ((size_t)index * reader->hdr->entrySize));
+
+	for (int i = 0; i < READ_ATTEMPTS; i++) {
+		uint32_t seq = __atomic_load_n(&e->seq, __ATOMIC_ACQUIRE);
+		if (seq & 1)
+			continue;
+
+		memcpy(entry, e, sizeof(*entry));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+		if (__atomic_load_n(&e->seq, __ATOMIC_RELAXED) == seq) {
+			if (entry->payloadLengthWords > 255)
+				entry->payloadLengthWords = 255;
+			return 0;
+		}
+	}
+
+	return -EAGAIN;
+}
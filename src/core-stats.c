@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <libklvanc/vanc.h>
+
+#include "core-private.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Entries are kept densely in first seen order, indexed by the keymap, so a
+ * snapshot only touches active entries.
+ */
+#define JITTER_GAIN 16.0 /* As in RFC 3550 */
+
+struct stats_entry_s
+{
+	struct klvanc_stats_entry_s e;
+	uint64_t lastSeenNs;
+};
+
+struct klvanc_stats_s
+{
+	struct klvanc_keymap_s map;
+	struct stats_entry_s *entries;
+	int allocated;
+};
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+}
+
+int klvanc_context_enable_stats(struct klvanc_context_s *ctx)
+{
+	VALIDATE(ctx);
+
+	if (getPrivate(ctx)->stats)
+		return KLAPI_OK;
+
+	const struct klvanc_allocator_s *a = getAllocator(ctx, KLVANC_MEM_STATS);
+	struct klvanc_stats_s *s = klvanc_mem_calloc(a, 1, sizeof(*s));
+	if (!s)
+		return -ENOMEM;
+
+	if (klvanc_keymap_alloc(&s->map, a, KLVANC_STATS_MAX_ENTRIES) < 0) {
+		klvanc_mem_free(a, s);
+		return -ENOMEM;
+	}
+	getPrivate(ctx)->stats = s;
+
+	return KLAPI_OK;
+}
+
+void klvanc_stats_free(struct klvanc_context_s *ctx)
+{
+	struct klvanc_stats_s *s = getPrivate(ctx)->stats;
+	if (!s)
+		return;
+
+	const struct klvanc_allocator_s *a = getAllocator(ctx, KLVANC_MEM_STATS);
+	klvanc_keymap_free(&s->map, a);
+	klvanc_mem_free(a, s->entries);
+	klvanc_mem_free(a, s);
+	getPrivate(ctx)->stats = NULL;
+}
+
+int klvanc_context_reset_stats(struct klvanc_context_s *ctx)
+{
+	VALIDATE(ctx);
+
+	struct klvanc_stats_s *s = getPrivate(ctx)->stats;
+	if (!s)
+		return -EINVAL;
+
+	klvanc_keymap_reset(&s->map);
+
+	return KLAPI_OK;
+}
+
+static struct stats_entry_s *lookup(struct klvanc_context_s *ctx, struct klvanc_stats_s *s,
+	const struct klvanc_packet_header_s *hdr)
+{
+	uint32_t key = klvanc_keymap_key(hdr->did, hdr->dbnsdid, hdr->lineNr);
+
+	int idx = klvanc_keymap_find(&s->map, key, 0, NULL);
+	if (idx >= 0)
+		return &s->entries[idx];
+
+	/* Grow the entries before the key is added, so a failure leaves both consistent */
+	if ((int)s->map.count == s->allocated) {
+		if (s->map.count == s->map.max)
+			return NULL;
+		int n = s->allocated ? s->allocated * 2 : 64;
+		struct stats_entry_s *p = klvanc_mem_realloc(getAllocator(ctx, KLVANC_MEM_STATS),
+							     s->entries, n * sizeof(*p));
+		if (!p)
+			return NULL;
+		s->entries = p;
+		s->allocated = n;
+	}
+
+	idx = klvanc_keymap_find(&s->map, key, 1, NULL);
+	struct stats_entry_s *e = &s->entries[idx];
+	memset(e, 0, sizeof(*e));
+	e->e.did = hdr->did;
+	e->e.sdid = hdr->dbnsdid;
+	e->e.lineNr = hdr->lineNr;
+	e->e.minPayloadWords = 0xffff;
+
+	return e;
+}
+
+/* Exponential decay over an irregular interval without needing libm,
+ * rate = rate * tau / (tau + dt) + weight / (tau + dt) converges on exactly
+ * weight / period for periodic traffic.
+ */
+static double decay(double rate, double dt, double weight)
+{
+	const double tau = KLVANC_STATS_EWMA_SECONDS;
+	return (rate * tau + weight) / (tau + dt);
+}
+
+void klvanc_stats_update(struct klvanc_context_s *ctx, const struct klvanc_packet_header_s *hdr)
+{
+	struct vanc_context_private_s *priv = getPrivate(ctx);
+	struct stats_entry_s *e = lookup(ctx, priv->stats, hdr);
+	if (!e)
+		return;
+
+	uint64_t now = now_ns();
+	struct klvanc_stats_entry_s *st = &e->e;
+
+	if (st->packets) {
+		double dt = (now - e->lastSeenNs) / 1e9;
+		st->packetsPerSecond = decay(st->packetsPerSecond, dt, 1.0);
+		st->bytesPerSecond = decay(st->bytesPerSecond, dt, hdr->payloadLengthWords);
+
+		double between = priv->frameNr - st->lastFrame;
+		if (st->packets == 1)
+			st->framesBetween = between;
+		double d = between - st->framesBetween;
+		st->framesBetween += d / JITTER_GAIN;
+		st->frameJitter += ((d < 0 ? -d : d) - st->frameJitter) / JITTER_GAIN;
+	}
+	e->lastSeenNs = now;
+	st->lastFrame = priv->frameNr;
+
+	st->packets++;
+	if (!hdr->checksumValid)
+		st->checksumFailures++;
+	st->bytes += hdr->payloadLengthWords;
+	if (hdr->payloadLengthWords < st->minPayloadWords)
+		st->minPayloadWords = hdr->payloadLengthWords;
+	if (hdr->payloadLengthWords > st->maxPayloadWords)
+		st->maxPayloadWords = hdr->payloadLengthWords;
+}
+
+int klvanc_context_get_stats(struct klvanc_context_s *ctx, struct klvanc_stats_entry_s *entries, int maxEntries)
+{
+	VALIDATE(ctx);
+
+	struct klvanc_stats_s *s = getPrivate(ctx)->stats;
+	if (!s)
+		return -EINVAL;
+	if (maxEntries > 0 && !entries)
+		return -EINVAL;
+
+	uint64_t now = now_ns();
+	int count = s->map.count;
+	for (int i = 0; i < count && i < maxEntries; i++) {
+		const struct stats_entry_s *e = &s->entries[i];
+		double dt = (now - e->lastSeenNs) / 1e9;
+
+		entries[i] = e->e;
+		entries[i].packetsPerSecond = decay(e->e.packetsPerSecond, dt, 0);
+		entries[i].bytesPerSecond = decay(e->e.bytesPerSecond, dt, 0);
+		entries[i].checksumFailureRatio = (double)e->e.checksumFailures / e->e.packets;
+	}
+
+	return count;
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <libklvanc/vanc.h>
+
+#include "core-private.h"
+
+struct klvanc_stream_s
+{
+	struct klvanc_context_s *parent;
+	struct klvanc_context_s *ctx;	/* Owned, holds all of the stream's state */
+};
+
+int klvanc_stream_create(struct klvanc_context_s *ctx, struct klvanc_stream_s **stream)
+{
+	VALIDATE(ctx);
+	VALIDATE(stream);
+
+	struct klvanc_memaccount_s *account = getPrivate(ctx)->account;
+	const struct klvanc_allocator_s *core = getAllocator(ctx, KLVANC_MEM_CORE);
+
+	struct klvanc_stream_s *s = klvanc_mem_calloc(core, 1, sizeof(*s));
+	if (!s)
+		return -ENOMEM;
+	s->parent = ctx;
+
+	klvanc_memaccount_retain(account);
+	int ret = klvanc_context_alloc(&s->ctx, account);
+	if (ret < 0) {
+		klvanc_mem_free(core, s);
+		return ret;
+	}
+
+	struct klvanc_context_s *c = s->ctx;
+	c->verbose = ctx->verbose;
+	c->allow_bad_checksums = ctx->allow_bad_checksums;
+	c->callbacks = ctx->callbacks;
+	c->callback_context = ctx->callback_context;
+	c->warn_on_decode_failure = ctx->warn_on_decode_failure;
+	c->log_cb = ctx->log_cb;
+	c->log_level = ctx->log_level;
+
+	if ((ret = klvanc_filter_inherit(c, ctx)) < 0 ||
+	    (ret = klvanc_change_inherit(c, ctx)) < 0 ||
+	    (ret = klvanc_linemap_inherit(c, ctx)) < 0) {
+		klvanc_stream_destroy(s);
+		return ret;
+	}
+
+	*stream = s;
+
+	return KLAPI_OK;
+}
+
+int klvanc_stream_destroy(struct klvanc_stream_s *stream)
+{
+	VALIDATE(stream);
+
+	struct klvanc_context_s *c = stream->ctx;
+
+	/* The stream's own allocation keeps the account alive until it is freed */
+	klvanc_mem_free(getAllocator(c, KLVANC_MEM_CORE), stream);
+
+	return klvanc_context_destroy(c);
+}
+
+struct klvanc_context_s *klvanc_stream_get_context(struct klvanc_stream_s *stream)
+{
+	return stream ? stream->ctx : NULL;
+}
+
+struct klvanc_context_s *klvanc_stream_get_parent(struct klvanc_stream_s *stream)
+{
+	return stream ? stream->parent : NULL;
+}
+
+int klvanc_stream_parse(struct klvanc_stream_s *stream, unsigned int lineNr, const unsigned short *words,
+	unsigned int wordCount)
+{
+	VALIDATE(stream);
+
+	return klvanc_packet_parse(stream->ctx, lineNr, words, wordCount);
+}
+
+int klvanc_stream_frame_end(struct klvanc_stream_s *stream)
+{
+	VALIDATE(stream);
+
+	return klvanc_frame_end(stream->ctx);
+}
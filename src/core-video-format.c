@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <libklvanc/vanc.h>
+
+#include "core-private.h"
+
+#define FIELD_ROWS(first, last) ((last) ? (last) - (first) + 1 : 0)
+#define V210_STRIDE(width) ((((width) + 47) / 48) * 128)
+
+#define FORMAT(_name, w, h, lc, il, f1, l1, f2, l2, p1, p2, s1, s2, t1, t2, i1, i2, place) \
+	{ .name = _name, .width = w, .height = h, .lineCount = lc, .interlaced = il, \
+	  .vanc = { { f1, l1 }, { f2, l2 } }, .packetLine = { p1, p2 }, \
+	  .switchingLine = { s1, s2 }, .timecodeLine = { t1, t2 }, \
+	  .payloadIdLine = { i1, i2 }, .placement = place, \
+	  .stride = V210_STRIDE(w), .rows = FIELD_ROWS(f1, l1) + FIELD_ROWS(f2, l2), \
+	  .rowBase = { 0, FIELD_ROWS(f1, l1) } }
+
+/* VANC follows the RP 168 switching line of each field up to the first active
+ * line. Timecode lines are ST 12-2:2014 Sec 8.2.1 for HD and Sec 8.2.2 for SD,
+ * as early as possible after the second line following the switching point.
+ * Payload identifier lines are those ST 352 recommends per interface.
+ * UHD lines are numbered as on each 1080p link, where ST 425-5 and ST 2082
+ * carry the packets.
+ */
+static const struct klvanc_video_format_s formats[KLVANC_VIDEO_FORMAT_MAX] = {
+	[KLVANC_VIDEO_FORMAT_525I]  = FORMAT("525i",   720,  486,  525, 1, 10, 19, 273, 282, 13, 276, 10, 273,  12, 275,  13, 276,
+					     KLVANC_VANC_PLACEMENT_COMPONENTS),
+	[KLVANC_VIDEO_FORMAT_625I]  = FORMAT("625i",   720,  576,  625, 1,  6, 22, 319, 335,  9, 322,  6, 319,   8, 321,   9, 322,
+					     KLVANC_VANC_PLACEMENT_COMPONENTS),
+	[KLVANC_VIDEO_FORMAT_720P]  = FORMAT("720p",  1280,  720,  750, 0,  8, 25,   0,   0, 11,   0,  7,   0,   9,   9,  10,   0,
+					     KLVANC_VANC_PLACEMENT_LUMA),
+	[KLVANC_VIDEO_FORMAT_1080I] = FORMAT("1080i", 1920, 1080, 1125, 1,  8, 20, 570, 583, 11, 574,  7, 569,   9, 571,  10, 572,
+					     KLVANC_VANC_PLACEMENT_LUMA),
+	[KLVANC_VIDEO_FORMAT_1080P] = FORMAT("1080p", 1920, 1080, 1125, 0,  8, 41,   0,   0, 11,   0,  7,   0,   9,   9,  10,   0,
+					     KLVANC_VANC_PLACEMENT_LUMA),
+	[KLVANC_VIDEO_FORMAT_2160P] = FORMAT("2160p", 3840, 2160, 2250, 0,  8, 41,   0,   0, 11,   0,  7,   0,   9,   9,  10,   0,
+					     KLVANC_VANC_PLACEMENT_LUMA),
+	[KLVANC_VIDEO_FORMAT_4320P] = FORMAT("4320p", 7680, 4320, 4500, 0,  8, 41,   0,   0, 11,   0,  7,   0,   9,   9,  10,   0,
+					     KLVANC_VANC_PLACEMENT_LUMA),
+};
+
+const struct klvanc_video_format_s *klvanc_video_format_get(enum klvanc_video_format_e id)
+{
+	if ((unsigned int)id >= KLVANC_VIDEO_FORMAT_MAX)
+		return NULL;
+	return &formats[id];
+}
+
+const struct klvanc_video_format_s *klvanc_video_format_find(uint32_t height, int interlaced)
+{
+	for (int i = 0; i < KLVANC_VIDEO_FORMAT_MAX; i++) {
+		if (formats[i].height == height && formats[i].interlaced == !!interlaced)
+			return &formats[i];
+	}
+
+	return NULL;
+}
+
+static int field_rows(const struct klvanc_video_format_range_s *r)
+{
+	if (r->last == 0 || r->last < r->first)
+		return 0;
+	return r->last - r->first + 1;
+}
+
+int klvanc_video_format_init(struct klvanc_video_format_s *fmt)
+{
+	if (!fmt || !fmt->width)
+		return -EINVAL;
+	for (int f = 0; f < 2; f++) {
+		if (fmt->vanc[f].last && (fmt->vanc[f].first == 0 || fmt->vanc[f].last < fmt->vanc[f].first))
+			return -EINVAL;
+	}
+	if (fmt->vanc[1].last && fmt->vanc[1].first <= fmt->vanc[0].last)
+		return -EINVAL;
+
+	fmt->stride = V210_STRIDE(fmt->width);
+	fmt->rowBase[0] = 0;
+	fmt->rowBase[1] = field_rows(&fmt->vanc[0]);
+	fmt->rows = fmt->rowBase[1] + field_rows(&fmt->vanc[1]);
+
+	return 0;
+}
+
+int klvanc_video_format_luma(const struct klvanc_video_format_s *fmt)
+{
+	if (fmt->placement == KLVANC_VANC_PLACEMENT_AUTO)
+		return fmt->width > 720;
+	return fmt->placement == KLVANC_VANC_PLACEMENT_LUMA;
+}
+
+uint32_t klvanc_video_format_vanc_samples(const struct klvanc_video_format_s *fmt)
+{
+	return klvanc_video_format_luma(fmt) ? fmt->width : fmt->width * 2;
+}
+
+uint32_t klvanc_video_format_v210_stride(const struct klvanc_video_format_s *fmt)
+{
+	if (fmt->stride)
+		return fmt->stride;
+	return V210_STRIDE(fmt->width);
+}
+
+uint32_t klvanc_video_format_vanc_rows(const struct klvanc_video_format_s *fmt)
+{
+	if (fmt->stride)
+		return fmt->rows;
+	return field_rows(&fmt->vanc[0]) + field_rows(&fmt->vanc[1]);
+}
+
+int klvanc_video_format_vanc_row(const struct klvanc_video_format_s *fmt, uint32_t lineNr)
+{
+	if (fmt->stride) {
+		for (int f = 0; f < 2; f++) {
+			if (fmt->vanc[f].last && lineNr >= fmt->vanc[f].first && lineNr <= fmt->vanc[f].last)
+				return fmt->rowBase[f] + (lineNr - fmt->vanc[f].first);
+		}
+		return -ERANGE;
+	}
+
+	int base = 0;
+
+	for (int f = 0; f < 2; f++) {
+		int rows = field_rows(&fmt->vanc[f]);
+		if (rows && lineNr >= fmt->vanc[f].first && lineNr <= fmt->vanc[f].last)
+			return base + (lineNr - fmt->vanc[f].first);
+		base += rows;
+	}
+
+	return -ERANGE;
+}
+
+uint32_t klvanc_video_format_vanc_line(const struct klvanc_video_format_s *fmt, uint32_t row)
+{
+	uint32_t rows = field_rows(&fmt->vanc[0]);
+
+	if (row < rows)
+		return fmt->vanc[0].first + row;
+	row -= rows;
+	if (row < (uint32_t)field_rows(&fmt->vanc[1]))
+		return fmt->vanc[1].first + row;
+
+	return 0;
+}
+
+int klvanc_video_format_timecode_line(const struct klvanc_video_format_s *fmt, int dbb1)
+{
+	uint32_t line = 0;
+
+	/* A caller's descriptor without timecode lines borrows the registry's */
+	if (!fmt->timecodeLine[0] && !fmt->timecodeLine[1]) {
+		const struct klvanc_video_format_s *known = klvanc_video_format_find(fmt->height, fmt->interlaced);
+		if (known)
+			fmt = known;
+	}
+
+	if (dbb1 == KLVANC_ATC_VITC1)
+		line = fmt->timecodeLine[0];
+	else if (dbb1 == KLVANC_ATC_VITC2)
+		line = fmt->timecodeLine[1];
+	else if (dbb1 != KLVANC_ATC_LTC)
+		/* Table 7 says any line except 9, 10, and 571, so we choose line 11 */
+		line = 11;
+
+	return line ? (int)line : -1;
+}
+
+int klvanc_context_set_video_format(struct klvanc_context_s *ctx, const struct klvanc_video_format_s *fmt)
+{
+	if (!ctx)
+		return -EINVAL;
+
+	getPrivate(ctx)->format = fmt;
+	return 0;
+}
+
+const struct klvanc_video_format_s *klvanc_context_get_video_format(struct klvanc_context_s *ctx)
+{
+	if (!ctx)
+		return NULL;
+
+	return getPrivate(ctx)->format;
+}
+
+int klvanc_context_enable_format_detection(struct klvanc_context_s *ctx)
+{
+	if (!ctx)
+		return -EINVAL;
+
+	getPrivate(ctx)->formatDetect = 1;
+	return 0;
+}
+
+int klvanc_context_disable_format_detection(struct klvanc_context_s *ctx)
+{
+	if (!ctx)
+		return -EINVAL;
+
+	getPrivate(ctx)->formatDetect = 0;
+	return 0;
+}
@@ -46,12 +46,41 @@ int klvanc_context_dump(struct klvanc_context_s *ctx)
 }
 
 int klvanc_context_create(struct klvanc_context_s **ctx)
+{
+	return klvanc_context_create_with_allocator(ctx, NULL);
+}
+
+int klvanc_context_create_with_allocator(struct klvanc_context_s **ctx,
+	const struct klvanc_allocator_s *allocator)
+{
+	if (klvanc_mem_validate(allocator) < 0)
+		return -EINVAL;
+
+	struct klvanc_memaccount_s *account = klvanc_memaccount_alloc(allocator);
+	if (!account)
+		return -ENOMEM;
+
+	return klvanc_context_alloc(ctx, account);
+}
+
+int klvanc_context_alloc(struct klvanc_context_s **ctx, struct klvanc_memaccount_s *account)
 {
 	int ret = KLAPI_OK;
+	const struct klvanc_allocator_s *core = klvanc_memaccount_allocator(account, KLVANC_MEM_CORE);
 
-	struct klvanc_context_s *p = calloc(1, sizeof(struct klvanc_context_s));
-	if (!p)
+	struct klvanc_context_s *p = klvanc_mem_calloc(core, 1, sizeof(struct klvanc_context_s));
+	if (!p) {
+		klvanc_memaccount_release(account);
 		return -ENOMEM;
+	}
+
+	p->priv = klvanc_mem_calloc(core, 1, sizeof(struct vanc_context_private_s));
+	if (!p->priv) {
+		klvanc_mem_free(core, p);
+		klvanc_memaccount_release(account);
+		return -ENOMEM;
+	}
+	getPrivate(p)->account = account;
 
 	/* If we fail to parse a vanc message, don't report more than one of those per second. */
 	klrestricted_code_path_block_initialize(&p->rcp_failedToDecode, 1, 1, 60 * 1000);
@@ -61,6 +90,7 @@ int klvanc_context_create(struct klvanc_context_s **ctx)
 
 	/* Set the default logger */
 	(*ctx)->log_cb = vanc_default_logger;
+	(*ctx)->log_level = LIBKLVANC_LOGLEVEL_DEBUG;
 
 	return ret;
 }
@@ -70,11 +100,59 @@ int klvanc_context_destroy(struct klvanc_context_s *ctx)
 	VALIDATE(ctx);
 
 	klvanc_cache_free(ctx);
+	klvanc_stats_free(ctx);
+	klvanc_shm_free(ctx);
+	klvanc_change_free(ctx);
+	klvanc_linemap_free(ctx);
+	klvanc_filter_free(ctx);
+	klvanc_async_free(ctx);
+	klvanc_frame_free(ctx);
+	klvanc_compose_free(ctx);
 
 	cleanup_SCTE_104(ctx);
 
+	klvanc_mem_free(getAllocator(ctx, KLVANC_MEM_CORE), getPrivate(ctx)->unpacked);
+
+	/* The account outlives the context while any of its allocations remain */
+	struct klvanc_memaccount_s *account = getPrivate(ctx)->account;
+	const struct klvanc_allocator_s *core = klvanc_memaccount_allocator(account, KLVANC_MEM_CORE);
+	klvanc_mem_free(core, ctx->priv);
+
 	memset(ctx, 0, sizeof(*ctx));
-	free(ctx);
+	klvanc_mem_free(core, ctx);
+	klvanc_memaccount_release(account);
+
+	return KLAPI_OK;
+}
+
+int klvanc_context_get_memstats(struct klvanc_context_s *ctx, struct klvanc_memstats_s *stats)
+{
+	VALIDATE(ctx);
+	VALIDATE(stats);
+
+	klvanc_memaccount_get(getPrivate(ctx)->account, stats);
+
+	return KLAPI_OK;
+}
+
+int klvanc_context_reset_memstats(struct klvanc_context_s *ctx)
+{
+	VALIDATE(ctx);
+
+	klvanc_memaccount_reset(getPrivate(ctx)->account);
+
+	return KLAPI_OK;
+}
+
+int klvanc_context_get_allocator(struct klvanc_context_s *ctx, enum klvanc_mem_subsystem_e subsystem,
+	struct klvanc_allocator_s *allocator)
+{
+	VALIDATE(ctx);
+	VALIDATE(allocator);
+	if (subsystem < 0 || subsystem >= KLVANC_MEM_MAX)
+		return -EINVAL;
+
+	*allocator = *getAllocator(ctx, subsystem);
 
 	return KLAPI_OK;
 }
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* Not for inclusion by user applications */
+
+/**
+ * @file	klqueue.h
+ * @brief	Bounded lock-free queue of pointers.
+ *
+ *              Each cell carries a sequence number which tells producers and consumers
+ *              whether the cell is ready for them, so neither side ever takes a lock
+ *              or makes a syscall. Any number of threads may push and pop concurrently,
+ *              which also allows a producer to discard the oldest entry when full.
+ *              Capacity is always rounded up to a power of two.
+ */
+
+#ifndef _KLQUEUE_H
+#define _KLQUEUE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct klqueue_cell_s
+{
+	uint64_t seq;
+	void *data;
+};
+
+struct klqueue_s
+{
+	struct klqueue_cell_s *cells;
+	uint64_t mask;
+
+	/* Keep the producer and consumer cursors on separate cache lines */
+	uint64_t enqueue_pos __attribute__((aligned(64)));
+	uint64_t dequeue_pos __attribute__((aligned(64)));
+};
+
+/**
+ * @brief       Initialize a queue able to hold at least depth entries.
+ * @return      0 - Success
+ * @return      < 0 - Error
+ */
+static __inline__ int klqueue_init(struct klqueue_s *q, uint32_t depth)
+{
+	uint64_t size = 2;
+	while (size < depth)
+		size <<= 1;
+
+	q->cells = (struct klqueue_cell_s *)calloc(size, sizeof(struct klqueue_cell_s));
+	if (!q->cells)
+		return -1;
+
+	for (uint64_t i = 0; i < size; i++)
+		q->cells[i].seq = i;
+
+	q->mask = size - 1;
+	q->enqueue_pos = 0;
+	q->dequeue_pos = 0;
+
+	return 0;
+}
+
+static __inline__ void klqueue_free(struct klqueue_s *q)
+{
+	free(q->cells);
+	q->cells = NULL;
+}
+
+static __inline__ uint32_t klqueue_capacity(struct klqueue_s *q)
+{
+	return q->mask + 1;
+}
+
+/**
+ * @brief       Approximate number of queued entries, for statistics only.
+ */
+static __inline__ uint32_t klqueue_count(struct klqueue_s *q)
+{
+	uint64_t e = __atomic_load_n(&q->enqueue_pos, __ATOMIC_RELAXED);
+	uint64_t d = __atomic_load_n(&q->dequeue_pos, __ATOMIC_RELAXED);
+	return e > d ? e - d : 0;
+}
+
+/**
+ * @brief       Append data to the tail of the queue.
+ * @return      0 - Success
+ * @return      < 0 - Queue is full
+ */
+static __inline__ int klqueue_push(struct klqueue_s *q, void *data)
+{
+	struct klqueue_cell_s *cell;
+	uint64_t pos = __atomic_load_n(&q->enqueue_pos, __ATOMIC_RELAXED);
+
+	for (;;) {
+		cell = &q->cells[pos & q->mask];
+		uint64_t seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+		int64_t diff = (int64_t)seq - (int64_t)pos;
+		if (diff == 0) {
+			if (__atomic_compare_exchange_n(&q->enqueue_pos, &pos, pos + 1, 1,
+							__ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				break;
+		} else if (diff < 0) {
+			return -1;
+		} else {
+			pos = __atomic_load_n(&q->enqueue_pos, __ATOMIC_RELAXED);
+		}
+	}
+
+	cell->data = data;
+	__atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+/**
+ * @brief       Remove the entry at the head of the queue.
+ * @return      The entry, or NULL if the queue is empty.
+ */
+static __inline__ void *klqueue_pop(struct klqueue_s *q)
+{
+	struct klqueue_cell_s *cell;
+	uint64_t pos = __atomic_load_n(&q->dequeue_pos, __ATOMIC_RELAXED);
+
+	for (;;) {
+		cell = &q->cells[pos & q->mask];
+		uint64_t seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+		int64_t diff = (int64_t)seq - (int64_t)(pos + 1);
+		if (diff == 0) {
+			if (__atomic_compare_exchange_n(&q->dequeue_pos, &pos, pos + 1, 1,
+							__ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				break;
+		} else if (diff < 0) {
+			return NULL;
+		} else {
+			pos = __atomic_load_n(&q->dequeue_pos, __ATOMIC_RELAXED);
+		}
+	}
+
+	void *data = cell->data;
+	__atomic_store_n(&cell->seq, pos + q->mask + 1, __ATOMIC_RELEASE);
+
+	return data;
+}
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _KLQUEUE_H */
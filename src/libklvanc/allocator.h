@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file	allocator.h
+ * @copyright	Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved.
+ * @brief	Custom memory allocator hooks and per context memory accounting.
+ *
+ *              Applications running pool, arena or NUMA local allocators can route the
+ *              library's internal allocations through their own functions. Provide all
+ *              three functions, or none of them to use the C library.
+ *
+ *              Buffers the library returns to the caller with instructions to free()
+ *              them are always allocated by the C library.
+ */
+
+#ifndef _KLVANC_ALLOCATOR_H
+#define _KLVANC_ALLOCATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct klvanc_allocator_s
+{
+	void *(*alloc)(void *opaque, size_t size);
+	void *(*realloc)(void *opaque, void *ptr, size_t size);
+	void  (*free)(void *opaque, void *ptr);
+	void *opaque; /**< Passed unmodified to each of the above. */
+};
+
+/**
+ * @brief	Memory accounting buckets, see klvanc_context_get_memstats().
+ */
+enum klvanc_mem_subsystem_e
+{
+	KLVANC_MEM_CORE = 0,	/**< The context, its packet decode storage and engine and async queues. */
+	KLVANC_MEM_CACHE,	/**< The VANC cache table and cached packets. */
+	KLVANC_MEM_SCTE104,	/**< SCTE-104 fragment reassembly and operations. */
+	KLVANC_MEM_LINES,	/**< VANC lines and entries created by klvanc_line_insert(). */
+	KLVANC_MEM_SMPTE2038,	/**< SMPTE 2038 objects using an allocator from klvanc_context_get_allocator(). */
+	KLVANC_MEM_STATS,	/**< Traffic statistics, see klvanc_context_enable_stats(). */
+	KLVANC_MEM_MAX
+};
+
+struct klvanc_memstats_subsystem_s
+{
+	uint64_t bytesOutstanding; /**< Bytes currently allocated. */
+	uint64_t bytesPeak;        /**< High water mark of bytesOutstanding. */
+	uint64_t allocCount;       /**< Allocations, a realloc counts as one alloc and one free. */
+	uint64_t freeCount;
+};
+
+struct klvanc_memstats_s
+{
+	struct klvanc_memstats_subsystem_s subsystem[KLVANC_MEM_MAX];
+	struct klvanc_memstats_subsystem_s total;
+};
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _KLVANC_ALLOCATOR_H */
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file	async.h
+ * @copyright	Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved.
+ * @brief	Deliver callbacks on an application thread instead of inside klvanc_packet_parse().
+ *
+ *              With asynchronous delivery enabled, klvanc_packet_parse() still finds,
+ *              checksums, caches and counts packets, then copies each one into a slot of
+ *              a bounded lock-free queue and returns. The slot belongs to the queue until
+ *              the consumer thread calls klvanc_async_dispatch(), which decodes the packet
+ *              and fires the all and per type callbacks, then hands the slot back. A slow
+ *              handler therefore only delays the consumer, never capture.
+ *
+ *              What crosses the queue is the packet header, not the decoded packet. Decoded
+ *              packets live in storage owned by the context that decoded them and point back
+ *              at its header, so rather than hand those over, the slot takes a copy of the
+ *              header fields and the packet's words (at most 262) and ownership of the slot
+ *              passes to the consumer. Decoding then happens on the consumer, in queue order,
+ *              using decode storage of its own. The header given to the all callback is the
+ *              same as in synchronous delivery, raw holding the packet from ADF through
+ *              checksum.
+ *
+ *              Callbacks receive that consumer context rather than the one passed to
+ *              klvanc_packet_parse(), with the callbacks, callback_context, verbosity and
+ *              logging settings copied from it on every dispatch.
+ *
+ *              One thread parses and one thread dispatches per context.
+ */
+
+#ifndef _KLVANC_ASYNC_H
+#define _KLVANC_ASYNC_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum klvanc_async_policy_e
+{
+	KLVANC_ASYNC_DROP_NEWEST = 0,	/**< Discard the packet being queued. */
+	KLVANC_ASYNC_DROP_OLDEST,	/**< Discard the oldest queued packet to make room, or the
+					 *   packet being queued when the consumer holds the only slot. */
+	KLVANC_ASYNC_BLOCK,		/**< Wait in klvanc_packet_parse() for the consumer to make room. */
+};
+
+struct klvanc_async_params_s
+{
+	uint32_t queueDepth;	/**< Packets which may be waiting for dispatch. */
+	enum klvanc_async_policy_e policy;
+};
+
+struct klvanc_async_stats_s
+{
+	uint64_t queued;	/**< Packets accepted into the queue. */
+	uint64_t dispatched;	/**< Packets delivered to callbacks. */
+	uint64_t dropped;	/**< Packets discarded by the policy. */
+	uint64_t blocked;	/**< Times klvanc_packet_parse() had to wait, KLVANC_ASYNC_BLOCK only. */
+	uint32_t depth;		/**< Packets waiting right now. */
+	uint32_t highWaterMark;	/**< Deepest the queue has been. */
+};
+
+struct klvanc_context_s;
+
+/**
+ * @brief	Populate params with defaults, 64 packets and KLVANC_ASYNC_DROP_NEWEST.
+ * @param[out]	struct klvanc_async_params_s *params - Parameters.
+ */
+void klvanc_async_params_default(struct klvanc_async_params_s *params);
+
+/**
+ * @brief	Switch a context to asynchronous delivery.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[in]	struct klvanc_async_params_s *params - Parameters, or NULL for defaults.
+ * @return	0 - Success
+ * @return	-EBUSY - Already enabled.
+ * @return	< 0 - Error
+ */
+int klvanc_context_enable_async(struct klvanc_context_s *ctx, struct klvanc_async_params_s *params);
+
+/**
+ * @brief	Return to delivering callbacks inside klvanc_packet_parse(). Anything still queued\n
+ *              is discarded. Neither thread may be inside the library at the time.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @return	0 - Success
+ * @return	< 0 - Error
+ */
+int klvanc_context_disable_async(struct klvanc_context_s *ctx);
+
+/**
+ * @brief	Decode queued packets and fire their callbacks, on the calling thread.
+ * @param[in]	struct klvanc_context_s *ctx - The context packets are parsed with.
+ * @param[in]	unsigned int maxPackets - Most packets to dispatch, 0 for everything queued.
+ * @param[in]	int timeoutMs - How long to wait for the first packet, 0 to poll, < 0 forever.
+ * @return	>= 0 - Number of packets dispatched.
+ * @return	-ENOENT - Asynchronous delivery is not enabled.
+ * @return	< 0 - Error
+ */
+int klvanc_async_dispatch(struct klvanc_context_s *ctx, unsigned int maxPackets, int timeoutMs);
+
+/**
+ * @brief	Take a snapshot of the queue counters.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[out]	struct klvanc_async_stats_s *stats - Statistics.
+ * @return	0 - Success
+ * @return	-ENOENT - Asynchronous delivery is not enabled.
+ * @return	< 0 - Error
+ */
+int klvanc_context_get_async_stats(struct klvanc_context_s *ctx, struct klvanc_async_stats_s *stats);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _KLVANC_ASYNC_H */
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file	change_detection.h
+ * @copyright	Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved.
+ * @brief	Only deliver packets whose payload changed since the last one on the same line.
+ *
+ *              AFD, HDR static metadata, payload ID and similar services repeat an
+ *              identical payload every frame. With change detection enabled for a
+ *              DID/SDID, a 64-bit hash of the last payload is kept per line and a
+ *              packet matching it is neither decoded nor passed to any callback,
+ *              including the "all" callback. The cache, statistics and shared memory
+ *              export still see every packet.
+ *
+ *              Not suitable for services whose messages span several packets, such as
+ *              fragmented SCTE-104.
+ */
+
+#ifndef _KLVANC_CHANGE_DETECTION_H
+#define _KLVANC_CHANGE_DETECTION_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define KLVANC_CHANGE_DETECTION_MAX_RULES 32
+#define KLVANC_CHANGE_DETECTION_MAX_LINES 1024 /**< DID/SDID/line combinations tracked */
+
+struct klvanc_context_s;
+
+/**
+ * @brief	Enable change detection for a DID/SDID, or update its heartbeat.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[in]	uint8_t did - DID.
+ * @param[in]	uint8_t sdid - SDID.
+ * @param[in]	unsigned int heartbeatFrames - Deliver an unchanged packet anyway once this many\n
+ *              frames have passed since the last delivery, see klvanc_frame_end(). 0 never does.
+ * @return      0 - Success
+ * @return      -ENOSPC - Already KLVANC_CHANGE_DETECTION_MAX_RULES DID/SDIDs enabled.
+ * @return      < 0 - Error
+ */
+int klvanc_context_enable_change_detection(struct klvanc_context_s *ctx, uint8_t did, uint8_t sdid,
+	unsigned int heartbeatFrames);
+
+/**
+ * @brief	Deliver every packet of a DID/SDID again.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[in]	uint8_t did - DID.
+ * @param[in]	uint8_t sdid - SDID.
+ * @return      0 - Success
+ * @return      < 0 - Error
+ */
+int klvanc_context_disable_change_detection(struct klvanc_context_s *ctx, uint8_t did, uint8_t sdid);
+
+/**
+ * @brief	Number of packets suppressed because their payload had not changed.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[out]	uint64_t *count - Count.
+ * @return      0 - Success
+ * @return      < 0 - Error
+ */
+int klvanc_context_get_change_detection_suppressed(struct klvanc_context_s *ctx, uint64_t *count);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _KLVANC_CHANGE_DETECTION_H */
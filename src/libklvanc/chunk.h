@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+/**
+ * @file	chunk.h
+ * @copyright	Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved.
+ * @brief	Parse a stream of 10-bit VANC words which arrives in arbitrary chunks.
+ *
+ *              klvanc_packet_parse() wants a whole line at once. Transports such as
+ *              SMPTE 2110-40 or a capture driver delivering DMA fragments hand over words
+ *              in pieces, and a packet may start in one piece and end in a later one.
+ *
+ *              A chunk parser carries the state of the packet in flight between calls.
+ *              Packets lying wholly inside a chunk are parsed where they sit. Only the
+ *              packet straddling the end of a chunk is copied, at most 262 words
+ *              (ADF, DID, SDID, DC, 255 payload words and the checksum), and it is
+ *              delivered as soon as the chunk holding its checksum arrives.
+ *
+ *              Packets go through the same path as klvanc_packet_parse(): filter, cache,
+ *              statistics, change detection, frame collection and the callbacks. The
+ *              parser knows nothing of frame boundaries, call klvanc_frame_end() when
+ *              the transport marks one.
+ */
+
+#ifndef _KLVANC_CHUNK_H
+#define _KLVANC_CHUNK_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct klvanc_context_s;
+struct klvanc_chunk_parser_s;
+
+/**
+ * @brief	Running totals for a chunk parser.
+ */
+struct klvanc_chunk_parser_stats_s
+{
+	uint64_t chunks;	/**< Calls to klvanc_chunk_parser_push(). */
+	uint64_t packets;	/**< Packets parsed. */
+	uint64_t filtered;	/**< Packets stepped over by the DID/SDID filter. */
+	uint64_t carried;	/**< Packets which straddled a chunk boundary. */
+	uint64_t skippedWords;	/**< Words which were not part of a packet. */
+	uint64_t dropped;	/**< Partial packets discarded by klvanc_chunk_parser_reset(). */
+};
+
+/**
+ * @brief	Create a chunk parser delivering packets through a context.
+ * @param[in]	struct klvanc_context_s *ctx - Context, or a stream's context.
+ * @param[out]	struct klvanc_chunk_parser_s **parser - Parser.
+ * @return	0 - Success
+ * @return	< 0 - Error
+ */
+int klvanc_chunk_parser_create(struct klvanc_context_s *ctx, struct klvanc_chunk_parser_s **parser);
+
+/**
+ * @brief	Destroy a chunk parser. A partial packet is discarded.
+ * @param[in]	struct klvanc_chunk_parser_s *parser - Parser.
+ */
+void klvanc_chunk_parser_destroy(struct klvanc_chunk_parser_s *parser);
+
+/**
+ * @brief	Parse the next chunk of words. Every packet completed by this chunk is
+ *		delivered before the call returns.
+ * @param[in]	struct klvanc_chunk_parser_s *parser - Parser.
+ * @param[in]	unsigned int lineNr - Line reported in packet headers. A packet straddling
+ *		chunks keeps the line of the chunk it started in.
+ * @param[in]	const uint16_t *words - 10-bit words.
+ * @param[in]	unsigned int wordCount - Words in this chunk, may be zero.
+ * @return	>= 0 - Packets completed by this chunk and parsed, filtered ones excluded.
+ * @return	< 0 - Error
+ */
+int klvanc_chunk_parser_push(struct klvanc_chunk_parser_s *parser, unsigned int lineNr,
+			     const uint16_t *words, unsigned int wordCount);
+
+/**
+ * @brief	Discard any partial packet, for example after a transport discontinuity.
+ * @param[in]	struct klvanc_chunk_parser_s *parser - Parser.
+ * @return	1 - A partial packet was discarded.
+ * @return	0 - The parser was between packets.
+ */
+int klvanc_chunk_parser_reset(struct klvanc_chunk_parser_s *parser);
+
+/**
+ * @brief	Read the running totals.
+ * @param[in]	struct klvanc_chunk_parser_s *parser - Parser.
+ * @param[out]	struct klvanc_chunk_parser_stats_s *stats - Totals.
+ * @return	0 - Success
+ * @return	< 0 - Error
+ */
+int klvanc_chunk_parser_get_stats(struct klvanc_chunk_parser_s *parser,
+				  struct klvanc_chunk_parser_stats_s *stats);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _KLVANC_CHUNK_H */
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+/**
+ * @file	compose.h
+ * @copyright	Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved.
+ * @brief	Write every VANC packet of an output frame in one call.
+ *
+ *              The caller hands klvanc_frame_compose() the packets for a frame, as words,
+ *              and a format descriptor. Each packet without an explicit line is placed by
+ *              type: SMPTE 12-2 timecode on the line ST 12-2 prefers for the format and
+ *              its DBB1 payload type, everything else on the format's packet line. A
+ *              packet which does not fit moves down to the next VANC line of its field.
+ *              Lines are then packed straight into the v210 VANC region of the frame
+ *              buffer, optionally spread over worker threads for large formats.
+ *
+ *              Lines and entries come from a pooled line set kept in the context, so a
+ *              steady stream of frames composes without allocating. Most rows are the
+ *              same from frame to frame, so a line cache remembers each packed row and
+ *              copies it, or with a recycled buffer skips it, while its packets are
+ *              unchanged. One thread composes per context.
+ */
+
+#ifndef _KLVANC_COMPOSE_H
+#define _KLVANC_COMPOSE_H
+
+#include <stdint.h>
+#include <libklvanc/video_format.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct klvanc_compose_packet_s
+{
+	const uint16_t *words;	/**< Complete packet, ADF to checksum, e.g. from klvanc_convert_AFD_to_words(). */
+	uint16_t wordCount;
+	uint32_t lineNr;	/**< Line to insert on, or 0 to place by type. */
+	uint32_t horizontalOffset; /**< Orders packets sharing a line. */
+};
+
+struct klvanc_compose_params_s
+{
+	uint32_t threads;	/**< Threads packing lines, including the caller. 1 packs on the caller only. */
+	int blank;		/**< Blank VANC rows, and the remainder of rows, which carry no packets. */
+	int cache;		/**< Copy rows unchanged since the previous frame rather than pack them again. */
+	int recycled;		/**< The region holds what the previous compose on this context wrote,\n
+				     so unchanged rows are not written at all. Requires cache. */
+};
+
+struct klvanc_context_s;
+
+/**
+ * @brief	Populate params with defaults, a single thread, blanking and the row cache enabled,
+ *              and the region not recycled.
+ * @param[out]	struct klvanc_compose_params_s *params - Parameters.
+ */
+void klvanc_compose_params_default(struct klvanc_compose_params_s *params);
+
+/**
+ * @brief	Place and pack every VANC packet of a frame into its v210 VANC region.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[in]	const struct klvanc_video_format_s *fmt - Format of the frame.
+ * @param[in]	const struct klvanc_compose_packet_s *packets - Packets for the frame.
+ * @param[in]	unsigned int count - Number of packets.
+ * @param[out]	uint8_t *vanc - The VANC region, klvanc_video_format_vanc_rows() rows of v210.
+ * @param[in]	uint32_t stride - Bytes per row, or 0 for klvanc_video_format_v210_stride().
+ * @param[in]	const struct klvanc_compose_params_s *params - Parameters, or NULL for defaults.
+ * @return	0 - Success
+ * @return	-ENOSPC - Some packets did not fit in the VANC region and were left out.
+ * @return	< 0 - Error
+ */
+int klvanc_frame_compose(struct klvanc_context_s *ctx, const struct klvanc_video_format_s *fmt,
+			 const struct klvanc_compose_packet_s *packets, unsigned int count,
+			 uint8_t *vanc, uint32_t stride, const struct klvanc_compose_params_s *params);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _KLVANC_COMPOSE_H */
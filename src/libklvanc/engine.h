@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file	engine.h
+ * @copyright	Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved.
+ * @brief	Parse VANC for many SDI inputs on a shared pool of worker threads.
+ *
+ *              Each channel is a stream, see stream.h, created from a configured context.
+ *              Capture threads submit whole frames of VANC lines, which are copied into
+ *              preallocated slots and queued on the channel without blocking. Workers
+ *              parse them and fire the context's callbacks from the worker thread.
+ *
+ *              A channel is only ever processed by one worker at a time and its frames
+ *              are parsed in submission order, so callbacks for a channel arrive in order.
+ *              A channel with work is queued on the run queue of the worker that last
+ *              serviced it. Idle workers steal from the other run queues, so one busy
+ *              channel doesn't hold up the rest. Workers can be pinned to a set of CPUs
+ *              to keep them away from capture threads.
+ */
+
+#ifndef _KLVANC_ENGINE_H
+#define _KLVANC_ENGINE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum klvanc_engine_pin_e
+{
+	KLVANC_ENGINE_PIN_NONE = 0,	/**< Workers run wherever the scheduler puts them. */
+	KLVANC_ENGINE_PIN_SET,		/**< Every worker may run on any of the listed CPUs. */
+	KLVANC_ENGINE_PIN_EACH,		/**< Worker n runs only on cpus[n % cpuCount]. */
+};
+
+struct klvanc_engine_params_s
+{
+	uint32_t workerCount;		/**< Worker threads. */
+	uint32_t maxChannels;		/**< Channels which may be added. */
+	uint32_t queueDepth;		/**< Frames which may be queued per channel, including one being parsed. */
+	uint32_t maxLinesPerFrame;	/**< Most lines accepted in one frame. */
+	uint32_t maxWordsPerFrame;	/**< Most words accepted in one frame, across all of its lines. */
+	uint32_t batchFrames;		/**< Frames a worker parses for a channel before moving on. */
+	enum klvanc_engine_pin_e pin;
+	const int *cpus;		/**< CPU numbers, copied by klvanc_engine_alloc(). */
+	uint32_t cpuCount;
+};
+
+struct klvanc_engine_stats_s
+{
+	uint64_t framesSubmitted;	/**< Frames accepted by klvanc_engine_submit(). */
+	uint64_t framesRejected;	/**< Frames refused because the channel queue was full. */
+	uint64_t framesProcessed;	/**< Frames parsed by a worker. */
+	uint64_t steals;		/**< Channels taken from another worker's run queue. */
+};
+
+/**
+ * @brief	A single line of a submitted frame.
+ */
+struct klvanc_engine_line_s
+{
+	unsigned int lineNr;
+	const unsigned short *words;
+	unsigned int wordCount;
+};
+
+struct klvanc_context_s;
+struct klvanc_stream_s;
+struct klvanc_engine_s;
+struct klvanc_engine_channel_s;
+
+/**
+ * @brief	Populate params with sensible defaults, four unpinned workers and up to 64 channels.
+ * @param[out]	struct klvanc_engine_params_s *params - Parameters.
+ */
+void klvanc_engine_params_default(struct klvanc_engine_params_s *params);
+
+/**
+ * @brief	Create an engine and start its workers.
+ * @param[out]	struct klvanc_engine_s **engine - Engine.
+ * @param[in]	struct klvanc_engine_params_s *params - Parameters, or NULL for defaults.
+ * @return	0 - Success
+ * @return	-ENOTSUP - Pinning was requested on a platform without CPU affinity.
+ * @return	< 0 - Error
+ */
+int klvanc_engine_alloc(struct klvanc_engine_s **engine, struct klvanc_engine_params_s *params);
+
+/**
+ * @brief	Parse everything still queued, remove any remaining channels, stop the workers\n
+ *              and release all resources.
+ * @param[in]	struct klvanc_engine_s *engine - Engine.
+ */
+void klvanc_engine_free(struct klvanc_engine_s *engine);
+
+/**
+ * @brief	Add a channel, parsed by a new stream created from ctx. See klvanc_stream_create().
+ * @param[in]	struct klvanc_engine_s *engine - Engine.
+ * @param[in]	struct klvanc_context_s *ctx - Configured context, which must outlive the channel.
+ * @param[in]	void *callback_context - Passed to callbacks for this channel, or NULL to keep ctx's.
+ * @param[out]	struct klvanc_engine_channel_s **channel - Channel.
+ * @return	0 - Success
+ * @return	-ENOSPC - maxChannels already added.
+ * @return	< 0 - Error
+ */
+int klvanc_engine_channel_add(struct klvanc_engine_s *engine, struct klvanc_context_s *ctx,
+	void *callback_context, struct klvanc_engine_channel_s **channel);
+
+/**
+ * @brief	Parse everything queued on a channel, then remove it. Must not race with\n
+ *              klvanc_engine_submit() on the same channel.
+ * @param[in]	struct klvanc_engine_channel_s *channel - Channel.
+ * @return	0 - Success
+ * @return	< 0 - Error
+ */
+int klvanc_engine_channel_remove(struct klvanc_engine_channel_s *channel);
+
+/**
+ * @brief	The stream a channel is parsed with, for per channel features and counters.\n
+ *              Only touch it while the channel is idle, for example after klvanc_engine_channel_flush().
+ * @param[in]	struct klvanc_engine_channel_s *channel - Channel.
+ * @return	Stream, or NULL.
+ */
+struct klvanc_stream_s *klvanc_engine_channel_get_stream(struct klvanc_engine_channel_s *channel);
+
+/**
+ * @brief	Copy a frame of lines onto the channel's queue. Never blocks. Call from a single\n
+ *              thread per channel.
+ * @param[in]	struct klvanc_engine_channel_s *channel - Channel.
+ * @param[in]	const struct klvanc_engine_line_s *lines - Lines, in the order they should be parsed.
+ * @param[in]	unsigned int lineCount - Number of lines.
+ * @return	0 - Success
+ * @return	-EAGAIN - The channel queue is full and the frame was dropped.
+ * @return	-EINVAL - The frame exceeds maxLinesPerFrame or maxWordsPerFrame.
+ * @return	< 0 - Error
+ */
+int klvanc_engine_submit(struct klvanc_engine_channel_s *channel, const struct klvanc_engine_line_s *lines,
+	unsigned int lineCount);
+
+/**
+ * @brief	Wait until every frame submitted to a channel has been parsed.
+ * @param[in]	struct klvanc_engine_channel_s *channel - Channel.
+ * @return	0 - Success
+ * @return	< 0 - Error
+ */
+int klvanc_engine_channel_flush(struct klvanc_engine_channel_s *channel);
+
+/**
+ * @brief	Take a snapshot of the engine counters.
+ * @param[in]	struct klvanc_engine_s *engine - Engine.
+ * @param[out]	struct klvanc_engine_stats_s *stats - Statistics.
+ */
+void klvanc_engine_get_stats(struct klvanc_engine_s *engine, struct klvanc_engine_stats_s *stats);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _KLVANC_ENGINE_H */
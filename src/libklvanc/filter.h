@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file	filter.h
+ * @copyright	Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved.
+ * @brief	Drop unwanted DID/SDIDs before any parsing work is done on them.
+ *
+ *              The filter is a bitmap checked as soon as the ADF, DID and SDID words
+ *              of a packet have been found. A dropped packet is stepped over using its
+ *              data count and never reaches the header, checksum, cache, statistics or
+ *              any callback. Each DID/SDID keeps a count of the packets dropped.
+ */
+
+#ifndef _KLVANC_FILTER_H
+#define _KLVANC_FILTER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum klvanc_filter_mode_e
+{
+	KLVANC_FILTER_NONE = 0,	/**< Every packet is parsed, the default */
+	KLVANC_FILTER_ALLOW,	/**< Only DID/SDIDs added to the filter are parsed */
+	KLVANC_FILTER_DENY,	/**< DID/SDIDs added to the filter are dropped */
+};
+
+struct klvanc_context_s;
+
+/**
+ * @brief	Select how the filter's DID/SDID set is applied. The set is kept when the mode changes.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[in]	enum klvanc_filter_mode_e mode - Mode.
+ * @return      0 - Success
+ * @return      < 0 - Error
+ */
+int klvanc_context_set_filter_mode(struct klvanc_context_s *ctx, enum klvanc_filter_mode_e mode);
+
+/**
+ * @brief	Add a DID/SDID to the filter set.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[in]	uint8_t did - DID.
+ * @param[in]	uint8_t sdid - SDID.
+ * @return      0 - Success
+ * @return      < 0 - Error
+ */
+int klvanc_context_filter_add(struct klvanc_context_s *ctx, uint8_t did, uint8_t sdid);
+
+/**
+ * @brief	Remove a DID/SDID from the filter set.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[in]	uint8_t did - DID.
+ * @param[in]	uint8_t sdid - SDID.
+ * @return      0 - Success
+ * @return      < 0 - Error
+ */
+int klvanc_context_filter_remove(struct klvanc_context_s *ctx, uint8_t did, uint8_t sdid);
+
+/**
+ * @brief	Empty the filter set and zero every drop counter. The mode is unchanged.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @return      0 - Success
+ * @return      < 0 - Error
+ */
+int klvanc_context_filter_clear(struct klvanc_context_s *ctx);
+
+/**
+ * @brief	Number of packets of a DID/SDID the filter has dropped.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[in]	uint8_t did - DID.
+ * @param[in]	uint8_t sdid - SDID.
+ * @param[out]	uint64_t *count - Count.
+ * @return      0 - Success
+ * @return      < 0 - Error
+ */
+int klvanc_context_get_filter_drops(struct klvanc_context_s *ctx, uint8_t did, uint8_t sdid, uint64_t *count);
+
+/**
+ * @brief	Number of packets the filter has dropped, across all DID/SDIDs.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[out]	uint64_t *count - Count.
+ * @return      0 - Success
+ * @return      < 0 - Error
+ */
+int klvanc_context_get_filter_drops_total(struct klvanc_context_s *ctx, uint64_t *count);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _KLVANC_FILTER_H */
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file	frame.h
+ * @copyright	Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved.
+ * @brief	Receive every packet of a video frame together, in a single callback.
+ *
+ *              When the frame callback is set, each packet that would be delivered to the
+ *              all callback is also appended to a per context frame, stored in one
+ *              preallocated arena. The frame callback fires from klvanc_frame_end() or
+ *              klvanc_frame_parse() with the packets in the order they were parsed, and the
+ *              frame is then emptied. It fires for frames with no packets too. Until
+ *              klvanc_frame_end() is first called, it also fires whenever the line number
+ *              passed to klvanc_packet_parse() goes backwards.
+ *
+ *              With asynchronous delivery, see async.h, the frame callback still fires on
+ *              the parsing thread.
+ */
+
+#ifndef _KLVANC_FRAME_H
+#define _KLVANC_FRAME_H
+
+#include <stdint.h>
+#include <libklvanc/vanc-packets.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define KLVANC_FRAME_MAX_PACKETS 256 /**< Packets beyond this in one frame are counted, not stored */
+
+/**
+ * @brief	One packet of a frame. Only valid during the frame callback.
+ */
+struct klvanc_frame_packet_s
+{
+	enum klvanc_packet_type_e type;
+	uint8_t did;
+	uint8_t sdid;
+	uint8_t checksumValid;
+	uint8_t payloadLength;		/**< Bytes in payload, the data count. */
+	unsigned int lineNr;
+	unsigned int horizontalOffset;
+	const uint8_t *payload;		/**< User data words with the parity bits removed. */
+};
+
+struct klvanc_frame_s
+{
+	uint64_t frameNr;		/**< See klvanc_frame_end(). */
+	unsigned int packetCount;
+	unsigned int droppedPackets;	/**< Packets beyond KLVANC_FRAME_MAX_PACKETS. */
+	const struct klvanc_frame_packet_s *packets;
+};
+
+/**
+ * @brief	A line of VANC words.
+ */
+struct klvanc_frame_line_s
+{
+	unsigned int lineNr;
+	const unsigned short *words;
+	unsigned int wordCount;
+};
+
+struct klvanc_context_s;
+
+/**
+ * @brief	Parse every line of a frame with klvanc_packet_parse(), then klvanc_frame_end().
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[in]	const struct klvanc_frame_line_s *lines - Lines, in the order they should be parsed.
+ * @param[in]	unsigned int lineCount - Number of lines.
+ * @return      >= 0 - Number of packets found across all lines.
+ * @return      < 0 - Error
+ */
+int klvanc_frame_parse(struct klvanc_context_s *ctx, const struct klvanc_frame_line_s *lines,
+	unsigned int lineCount);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _KLVANC_FRAME_H */
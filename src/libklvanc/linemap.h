@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file	linemap.h
+ * @copyright	Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved.
+ * @brief	Learn which lines carry VANC and stop scanning the rest.
+ *
+ *              Capture code usually hands every blanking line to klvanc_packet_parse()
+ *              and most are empty. Once enabled, every line is scanned for a warm-up
+ *              period while the library notes which lines carried packets and the
+ *              lowest horizontal offset seen on each. After that, klvanc_packet_parse()
+ *              returns 0 straight away for lines that never carried a packet and starts
+ *              scanning learned lines at their learned offset.
+ *
+ *              Every line is still scanned in full once per re-probe interval, staggered
+ *              so lines are not all probed on the same frame. A new service is therefore
+ *              picked up within one interval, and a learned line found empty on a probe
+ *              is forgotten again. Frame numbers come from klvanc_frame_end().
+ */
+
+#ifndef _KLVANC_LINEMAP_H
+#define _KLVANC_LINEMAP_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define KLVANC_LINE_MAP_MAX_LINES 2048 /**< Lines at or above this are always scanned */
+
+struct klvanc_context_s;
+
+/**
+ * @brief	Line map counters, since the map was enabled.
+ */
+struct klvanc_line_map_stats_s
+{
+	uint64_t linesScanned;	/**< Learned lines scanned from their learned offset */
+	uint64_t linesProbed;	/**< Lines scanned in full, during warm-up or a re-probe */
+	uint64_t linesSkipped;	/**< Lines returned without being scanned */
+	unsigned int learnedLines; /**< Lines currently known to carry VANC */
+	int warmingUp;		/**< 1 while every line is still being scanned */
+};
+
+/**
+ * @brief	Enable the learned line map, or restart learning if already enabled.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[in]	unsigned int warmupFrames - Frames during which every line is scanned, at least 1.
+ * @param[in]	unsigned int reprobeFrames - Each line is scanned in full once this many frames, at least 1.
+ * @return      0 - Success
+ * @return      < 0 - Error
+ */
+int klvanc_context_enable_line_map(struct klvanc_context_s *ctx, unsigned int warmupFrames,
+	unsigned int reprobeFrames);
+
+/**
+ * @brief	Scan every line again and discard anything learned.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @return      0 - Success
+ * @return      < 0 - Error
+ */
+int klvanc_context_disable_line_map(struct klvanc_context_s *ctx);
+
+/**
+ * @brief	Ask whether klvanc_packet_parse() would scan a line in the current frame.\n
+ *              Lets capture code skip unpacking lines the parser would ignore anyway.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[in]	unsigned int lineNr - Line number.
+ * @return      1 - The line would be scanned, always the case when no map is enabled.
+ * @return      0 - The line would be skipped.
+ */
+int klvanc_line_map_wants_line(struct klvanc_context_s *ctx, unsigned int lineNr);
+
+/**
+ * @brief	Snapshot the line map counters.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[out]	struct klvanc_line_map_stats_s *stats - Counters.
+ * @return      0 - Success
+ * @return      -ENOENT - No line map enabled.
+ * @return      < 0 - Error
+ */
+int klvanc_context_get_line_map_stats(struct klvanc_context_s *ctx, struct klvanc_line_map_stats_s *stats);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _KLVANC_LINEMAP_H */
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+/**
+ * @file	patch.h
+ * @copyright	Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved.
+ * @brief	Rewrite payload words of a VANC packet where it sits in a line.
+ *
+ *              Passthrough workflows often change a byte or two of a packet, the AFD
+ *              code, bar data or a CDP sequence counter, and otherwise forward the line
+ *              untouched. Rather than unpack, parse, decode, re-serialize and repack the
+ *              line, locate the packet in the v210 or 16-bit line and overwrite the
+ *              payload words in place. Parity bits and the checksum are updated
+ *              incrementally, only the 32-bit v210 words holding changed samples are
+ *              written.
+ *
+ *              Given only a width, lines wider than 720 pixels carry VANC in the luma
+ *              samples only, narrower lines in every component, as for
+ *              klvanc_generate_vanc_line_v210(). The _format variants take both from a
+ *              format descriptor instead.
+ */
+
+#ifndef _KLVANC_PATCH_H
+#define _KLVANC_PATCH_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct klvanc_video_format_s;
+
+/**
+ * @brief	Where a packet was found in a line.
+ */
+struct klvanc_packet_location_s
+{
+	int offset;		/**< Sample of the first ADF word, a luma sample in HD, a component in SD. */
+	int wordCount;		/**< ADF through checksum. */
+	uint8_t did;
+	uint8_t sdid;
+	uint8_t dataCount;	/**< Payload words. */
+};
+
+/**
+ * @brief	Find the first packet with a given DID and SDID in a v210 line.
+ * @param[in]	const uint8_t *line - v210 line.
+ * @param[in]	int width - Line width in pixels.
+ * @param[in]	uint8_t did, uint8_t sdid - Packet to find.
+ * @param[out]	struct klvanc_packet_location_s *loc - Where the packet is.
+ * @return	0 - Success
+ * @return	-ENOENT - No such packet, or it runs off the end of the line.
+ * @return	< 0 - Error
+ */
+int klvanc_v210_find_packet(const uint8_t *line, int width, uint8_t did, uint8_t sdid,
+			    struct klvanc_packet_location_s *loc);
+
+/**
+ * @brief	Overwrite payload words of a packet in a v210 line, as found by
+ *		klvanc_v210_find_packet(). The parity bits of the new words and the
+ *		checksum are recomputed from the difference, so a checksum which was
+ *		wrong before stays wrong.
+ * @param[in]	uint8_t *line - v210 line.
+ * @param[in]	int width - Line width in pixels.
+ * @param[in]	const struct klvanc_packet_location_s *loc - Packet to patch.
+ * @param[in]	int index - First payload word to replace, 0 for the first UDW.
+ * @param[in]	const uint8_t *bytes - New payload values.
+ * @param[in]	int count - Number of words to replace.
+ * @return	0 - Success
+ * @return	-ERANGE - The words are outside the packet payload.
+ * @return	< 0 - Error
+ */
+int klvanc_v210_patch_packet(uint8_t *line, int width, const struct klvanc_packet_location_s *loc,
+			     int index, const uint8_t *bytes, int count);
+
+/**
+ * @brief	As klvanc_v210_find_packet(), with the samples searched and whether VANC
+ *		sits in the luma samples or every component taken from a format descriptor.
+ * @param[in]	const uint8_t *line - v210 line.
+ * @param[in]	const struct klvanc_video_format_s *fmt - Format, e.g. from klvanc_video_format_get().
+ * @param[in]	uint8_t did, uint8_t sdid - Packet to find.
+ * @param[out]	struct klvanc_packet_location_s *loc - Where the packet is.
+ * @return	0 - Success
+ * @return	-ENOENT - No such packet, or it runs off the end of the line.
+ * @return	< 0 - Error
+ */
+int klvanc_v210_find_packet_format(const uint8_t *line, const struct klvanc_video_format_s *fmt,
+				   uint8_t did, uint8_t sdid, struct klvanc_packet_location_s *loc);
+
+/**
+ * @brief	As klvanc_v210_patch_packet(), for a packet found by klvanc_v210_find_packet_format().
+ * @param[in]	uint8_t *line - v210 line.
+ * @param[in]	const struct klvanc_video_format_s *fmt - Format the packet was found with.
+ * @param[in]	const struct klvanc_packet_location_s *loc - Packet to patch.
+ * @param[in]	int index - First payload word to replace, 0 for the first UDW.
+ * @param[in]	const uint8_t *bytes - New payload values.
+ * @param[in]	int count - Number of words to replace.
+ * @return	0 - Success
+ * @return	-ERANGE - The words are outside the packet payload.
+ * @return	< 0 - Error
+ */
+int klvanc_v210_patch_packet_format(uint8_t *line, const struct klvanc_video_format_s *fmt,
+				    const struct klvanc_packet_location_s *loc,
+				    int index, const uint8_t *bytes, int count);
+
+/**
+ * @brief	As klvanc_v210_find_packet(), for a line of 16-bit words as passed to
+ *		klvanc_packet_parse().
+ * @param[in]	const uint16_t *words - Line.
+ * @param[in]	int wordCount - Words in the line.
+ * @param[in]	uint8_t did, uint8_t sdid - Packet to find.
+ * @param[out]	struct klvanc_packet_location_s *loc - Where the packet is.
+ * @return	0 - Success
+ * @return	-ENOENT - No such packet.
+ * @return	< 0 - Error
+ */
+int klvanc_words_find_packet(const uint16_t *words, int wordCount, uint8_t did, uint8_t sdid,
+			     struct klvanc_packet_location_s *loc);
+
+/**
+ * @brief	As klvanc_v210_patch_packet(), for a line of 16-bit words.
+ * @param[in]	uint16_t *words - Line.
+ * @param[in]	int wordCount - Words in the line.
+ * @param[in]	const struct klvanc_packet_location_s *loc - Packet to patch.
+ * @param[in]	int index - First payload word to replace.
+ * @param[in]	const uint8_t *bytes - New payload values.
+ * @param[in]	int count - Number of words to replace.
+ * @return	0 - Success
+ * @return	-ERANGE - The words are outside the packet payload.
+ * @return	< 0 - Error
+ */
+int klvanc_words_patch_packet(uint16_t *words, int wordCount, const struct klvanc_packet_location_s *loc,
+			      int index, const uint8_t *bytes, int count);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _KLVANC_PATCH_H */
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file	perfstats.h
+ * @copyright	Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved.
+ * @brief	Per stage latency instrumentation of klvanc_packet_parse().
+ *
+ *              Only available when the library is built with --enable-perfstats,
+ *              otherwise the instrumentation is compiled out entirely and the
+ *              functions below return -ENOSYS. Timings use CLOCK_MONOTONIC.
+ *
+ *              The packet stages do not overlap. DECODE excludes the time spent in
+ *              the type specific callbacks, which is reported under CALLBACK, and
+ *              SCAN is whatever part of a line was not spent in a packet stage.
+ */
+
+#ifndef _KLVANC_PERFSTATS_H
+#define _KLVANC_PERFSTATS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct klvanc_context_s;
+
+enum klvanc_perf_stage_e
+{
+	KLVANC_PERF_LINE = 0,	/**< An entire klvanc_packet_parse() call. */
+	KLVANC_PERF_SCAN,	/**< Searching the line for packets. */
+	KLVANC_PERF_HEADER,	/**< Header and payload extraction of a found packet. */
+	KLVANC_PERF_CHECKSUM,	/**< Checksum validation. */
+	KLVANC_PERF_CACHE,	/**< VANC cache update. */
+	KLVANC_PERF_DECODE,	/**< Type specific decode. */
+	KLVANC_PERF_CALLBACK,	/**< Application callbacks. */
+	KLVANC_PERF_MAX
+};
+
+/**
+ * Bucket n counts samples taking [2^n, 2^(n+1)) nanoseconds, the last bucket is open ended.
+ */
+#define KLVANC_PERF_HISTOGRAM_BUCKETS 24
+
+struct klvanc_perf_stage_stats_s
+{
+	uint64_t count;
+	uint64_t totalNs;
+	uint64_t maxNs;
+	uint64_t histogram[KLVANC_PERF_HISTOGRAM_BUCKETS];
+};
+
+struct klvanc_perfstats_s
+{
+	struct klvanc_perf_stage_stats_s stage[KLVANC_PERF_MAX];
+	uint64_t didCount[256]; /**< Packets found, indexed by DID. */
+};
+
+/**
+ * @brief	Take a snapshot of the instrumentation counters.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[out]	struct klvanc_perfstats_s *stats - Populated snapshot.
+ * @return      0 - Success
+ * @return      -ENOSYS - Library built without --enable-perfstats
+ * @return      < 0 - Error
+ */
+int klvanc_context_get_perfstats(struct klvanc_context_s *ctx, struct klvanc_perfstats_s *stats);
+
+/**
+ * @brief	Zero the instrumentation counters.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @return      0 - Success
+ * @return      -ENOSYS - Library built without --enable-perfstats
+ * @return      < 0 - Error
+ */
+int klvanc_context_reset_perfstats(struct klvanc_context_s *ctx);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _KLVANC_PERFSTATS_H */
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file	recorder.h
+ * @copyright	Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved.
+ * @brief	Record VANC packets or lines to disk from a background thread.
+ *
+ *              The capture thread pushes into a bounded lock-free queue and never
+ *              waits on the filesystem. A writer thread drains the queue and batches
+ *              records to disk. When the queue is full the configured drop policy
+ *              decides which record is discarded, and the event is counted.
+ *
+ *              File format, all fields little endian. Each record is a 24 byte
+ *              header followed by wordCount 16-bit words:
+ *                uint32_t magic      KLVANC_RECORDER_MAGIC
+ *                uint16_t type       KLVANC_RECORD_PACKET or KLVANC_RECORD_LINE
+ *                uint16_t lineNr
+ *                uint32_t wordCount
+ *                uint32_t sequence   Incremented for every record pushed, including drops.
+ *                uint64_t timestamp  CLOCK_MONOTONIC, in microseconds, at push time.
+ */
+
+#ifndef _KLVANC_RECORDER_H
+#define _KLVANC_RECORDER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define KLVANC_RECORDER_MAGIC 0x4B4C5652 /* 'KLVR' */
+#define KLVANC_RECORDER_RECORD_HEADER_SIZE 24
+
+enum klvanc_record_type_e
+{
+	KLVANC_RECORD_PACKET = 1,
+	KLVANC_RECORD_LINE = 2,
+};
+
+enum klvanc_recorder_drop_policy_e
+{
+	KLVANC_RECORDER_DROP_NEWEST = 0, /**< Discard the record being pushed. */
+	KLVANC_RECORDER_DROP_OLDEST,     /**< Discard the oldest queued record to make room. */
+};
+
+struct klvanc_recorder_params_s
+{
+	uint32_t queueDepth;   /**< Number of records which may be in flight. */
+	uint32_t maxWords;     /**< Largest record accepted, in words. Larger pushes fail. */
+	uint32_t batchSize;    /**< Maximum records written by a single syscall. */
+	enum klvanc_recorder_drop_policy_e dropPolicy;
+};
+
+struct klvanc_recorder_stats_s
+{
+	uint64_t recorded;       /**< Records accepted into the queue. */
+	uint64_t dropped;        /**< Records discarded because the queue was full. */
+	uint64_t written;        /**< Records committed to disk. */
+	uint64_t bytesWritten;
+	uint64_t writeErrors;
+	uint32_t highWaterMark;  /**< Deepest the queue has been. */
+};
+
+struct klvanc_recorder_s;
+struct klvanc_packet_header_s;
+
+/**
+ * @brief	Populate params with sensible defaults, suitable for a single SDI input.
+ * @param[out]	struct klvanc_recorder_params_s *params - Parameters.
+ */
+void klvanc_recorder_params_default(struct klvanc_recorder_params_s *params);
+
+/**
+ * @brief	Create a recorder writing to filename, and start its writer thread.
+ *              Any existing file is truncated.
+ * @param[out]	struct klvanc_recorder_s **rec - Recorder.
+ * @param[in]	const char *filename - Output file.
+ * @param[in]	struct klvanc_recorder_params_s *params - Parameters, or NULL for defaults.
+ * @return	0 - Success
+ * @return	< 0 - Error
+ */
+int klvanc_recorder_alloc(struct klvanc_recorder_s **rec, const char *filename,
+	struct klvanc_recorder_params_s *params);
+
+/**
+ * @brief	Flush all queued records to disk, stop the writer thread and release all resources.
+ * @param[in]	struct klvanc_recorder_s *rec - Recorder.
+ */
+void klvanc_recorder_free(struct klvanc_recorder_s *rec);
+
+/**
+ * @brief	Queue the raw words of a parsed packet for recording, including ADF, DID,
+ *              DBN/SDID, DC, payload and checksum. Safe to call from the all callback.
+ *              Never blocks.
+ * @param[in]	struct klvanc_recorder_s *rec - Recorder.
+ * @param[in]	struct klvanc_packet_header_s *hdr - Packet.
+ * @return	0 - Success
+ * @return	< 0 - Error, or the record was dropped (-EAGAIN)
+ */
+int klvanc_recorder_push_packet(struct klvanc_recorder_s *rec, struct klvanc_packet_header_s *hdr);
+
+/**
+ * @brief	Queue an entire line of words for recording. Never blocks.
+ * @param[in]	struct klvanc_recorder_s *rec - Recorder.
+ * @param[in]	uint16_t lineNr - Line number the words belong to.
+ * @param[in]	const uint16_t *words - Words.
+ * @param[in]	uint32_t wordCount - Number of words.
+ * @return	0 - Success
+ * @return	< 0 - Error, or the record was dropped (-EAGAIN)
+ */
+int klvanc_recorder_push_line(struct klvanc_recorder_s *rec, uint16_t lineNr,
+	const uint16_t *words, uint32_t wordCount);
+
+/**
+ * @brief	Take a snapshot of the recorder counters.
+ * @param[in]	struct klvanc_recorder_s *rec - Recorder.
+ * @param[out]	struct klvanc_recorder_stats_s *stats - Statistics.
+ */
+void klvanc_recorder_get_stats(struct klvanc_recorder_s *rec, struct klvanc_recorder_stats_s *stats);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _KLVANC_RECORDER_H */
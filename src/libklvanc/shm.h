@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file	shm.h
+ * @copyright	Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved.
+ * @brief	Export the VANC seen by a context into POSIX shared memory.
+ *
+ *              Out of process monitors can watch what a capture process sees without
+ *              any IPC on the capture side. The parser writes one entry per
+ *              DID/SDID/line into a mapped table, each protected by a sequence lock.
+ *              Readers use the klvanc_shm_reader_*() functions, which never block
+ *              the writer.
+ *
+ *              The segment is a klvanc_shm_header_s followed by maxEntries entries,
+ *              each entrySize bytes apart. Entries are appended in first seen order
+ *              and entryCount is only raised once the new entry is populated.
+ */
+
+#ifndef _KLVANC_SHM_H
+#define _KLVANC_SHM_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define KLVANC_SHM_MAGIC 0x4B4C5653 /* 'KLVS' */
+#define KLVANC_SHM_VERSION 1
+#define KLVANC_SHM_DEFAULT_ENTRIES 256
+
+struct klvanc_context_s;
+
+struct klvanc_shm_header_s
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t headerSize;	/**< Offset of the first entry. */
+	uint32_t entrySize;
+	uint32_t maxEntries;
+	uint32_t entryCount;
+	uint32_t writerPid;
+	uint32_t reserved;
+};
+
+struct klvanc_shm_entry_s
+{
+	uint32_t seq;			/**< Odd while the writer is updating the entry. */
+	uint8_t  did;
+	uint8_t  sdid;
+	uint16_t lineNr;
+	uint64_t count;
+	uint64_t checksumFailures;
+	uint64_t lastUpdated;		/**< CLOCK_MONOTONIC, in microseconds. */
+	uint16_t payloadLengthWords;
+	uint16_t payload[255];		/**< Last payload seen, payloadLengthWords are valid. */
+};
+
+/**
+ * @brief	Create the shared memory object name (see shm_open(3)) and export into it. The\\n
+ *              object is unlinked by klvanc_context_destroy().
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[in]	const char *name - Object name, for example "/klvanc-input1".
+ * @param[in]	int maxEntries - Table size, 0 for KLVANC_SHM_DEFAULT_ENTRIES.
+ * @return      0 - Success
+ * @return      < 0 - Error
+ */
+int klvanc_context_enable_shm_export(struct klvanc_context_s *ctx, const char *name, int maxEntries);
+
+struct klvanc_shm_reader_s;
+
+/**
+ * @brief	Map an exported table read only.
+ * @param[out]	struct klvanc_shm_reader_s **reader - Reader.
+ * @param[in]	const char *name - Object name given to klvanc_context_enable_shm_export().
+ * @return      0 - Success
+ * @return      -EPROTO - The object is not a table of a version this library understands.
+ * @return      < 0 - Error
+ */
+int  klvanc_shm_reader_open(struct klvanc_shm_reader_s **reader, const char *name);
+void klvanc_shm_reader_close(struct klvanc_shm_reader_s *reader);
+
+/**
+ * @brief	Retrieve the header, including the number of populated entries.
+ * @param[in]	struct klvanc_shm_reader_s *reader - Reader.
+ * @return      Pointer into the mapping, valid until klvanc_shm_reader_close().
+ */
+const struct klvanc_shm_header_s *klvanc_shm_reader_header(struct klvanc_shm_reader_s *reader);
+
+/**
+ * @brief	Take a consistent copy of an entry.
+ * @param[in]	struct klvanc_shm_reader_s *reader - Reader.
+ * @param[in]	int index - Entry, below the header entryCount.
+ * @param[out]	struct klvanc_shm_entry_s *entry - Copy.
+ * @return      0 - Success
+ * @return      -EAGAIN - The entry kept changing while being copied, try again later.
+ * @return      < 0 - Error
+ */
+int klvanc_shm_reader_read(struct klvanc_shm_reader_s *reader, int index, struct klvanc_shm_entry_s *entry);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _KLVANC_SHM_H */
@@ -30,6 +30,7 @@
 #define SMPTE2038_H
 
 #include <libklvanc/vanc-packets.h>
+#include <libklvanc/allocator.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -84,6 +85,8 @@ struct klvanc_smpte2038_anc_data_packet_s
 
 	int lineCount;
 	struct klvanc_smpte2038_anc_data_line_s *lines;
+
+	struct klvanc_allocator_s allocator; /**< Private. Services the packet and its lines. */
 };
 
 /**
@@ -115,6 +118,17 @@ int  klvanc_smpte2038_parse_pes_packet(uint8_t *section, unsigned int byteCount,
  */
 int  klvanc_smpte2038_parse_pes_payload(uint8_t *payload, unsigned int byteCount, struct klvanc_smpte2038_anc_data_packet_s **result);
 
+/**
+ * @brief	Identical to klvanc_smpte2038_parse_pes_packet() and klvanc_smpte2038_parse_pes_payload(),\n
+ *              except the returned packet and its lines are allocated by allocator. The allocator\n
+ *              is copied into the packet and used again by klvanc_smpte2038_anc_data_packet_free().
+ * @param[in]	const struct klvanc_allocator_s *allocator - Allocator, or NULL for the C library.
+ */
+int  klvanc_smpte2038_parse_pes_packet_with_allocator(uint8_t *section, unsigned int byteCount,
+	struct klvanc_smpte2038_anc_data_packet_s **result, const struct klvanc_allocator_s *allocator);
+int  klvanc_smpte2038_parse_pes_payload_with_allocator(uint8_t *payload, unsigned int byteCount,
+	struct klvanc_smpte2038_anc_data_packet_s **result, const struct klvanc_allocator_s *allocator);
+
 /**
  * @brief	Inspect structure and output textual information to console.
  * @param[in]	struct klvanc_smpte2038_anc_data_packet_s *pkt - Packet
@@ -137,6 +151,7 @@ struct klvanc_smpte2038_packetizer_s
 	uint32_t bufused;
 	uint32_t buffree;
 	struct   klbs_context_s *bs;
+	struct   klvanc_allocator_s allocator;
 };
 
 /**
@@ -147,6 +162,17 @@ struct klvanc_smpte2038_packetizer_s
  */
 int klvanc_smpte2038_packetizer_alloc(struct klvanc_smpte2038_packetizer_s **ctx);
 
+/**
+ * @brief	Identical to klvanc_smpte2038_packetizer_alloc(), except the context and its\n
+ *              buffers are serviced by allocator.
+ * @param[out]	struct klvanc_smpte2038_packetizer_s **ctx - Context
+ * @param[in]	const struct klvanc_allocator_s *allocator - Allocator, or NULL for the C library.
+ * @return      0 - Success
+ * @return    < 0 - Error
+ */
+int klvanc_smpte2038_packetizer_alloc_with_allocator(struct klvanc_smpte2038_packetizer_s **ctx,
+	const struct klvanc_allocator_s *allocator);
+
 /**
  * @brief	Deallocate and release a previously allocated context, see klvanc_smpte2038_packetizer_alloc().
  * @param[in]	struct klvanc_smpte2038_packetizer_s **ctx - Context
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file	stats.h
+ * @copyright	Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved.
+ * @brief	Per DID/SDID/line traffic statistics, maintained incrementally by the parser.
+ *
+ *              Rates are exponentially weighted with a time constant of
+ *              KLVANC_STATS_EWMA_SECONDS and are decayed to the time of the snapshot,
+ *              so a service that stops sending trends to zero. Inter-arrival figures
+ *              are measured in frames, see klvanc_frame_end().
+ */
+
+#ifndef _KLVANC_STATS_H
+#define _KLVANC_STATS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define KLVANC_STATS_EWMA_SECONDS 1.0
+
+/**
+ * Upper bound on the number of tracked DID/SDID/line combinations, packets
+ * for further combinations are not tracked.
+ */
+#define KLVANC_STATS_MAX_ENTRIES 4096
+
+struct klvanc_context_s;
+
+struct klvanc_stats_entry_s
+{
+	uint8_t  did;
+	uint8_t  sdid;
+	uint16_t lineNr;
+	uint64_t packets;          /**< Packets seen, including those with bad checksums. */
+	uint64_t checksumFailures;
+	uint64_t bytes;            /**< Payload (user data) words seen. */
+	uint16_t minPayloadWords;
+	uint16_t maxPayloadWords;
+	double   packetsPerSecond;
+	double   bytesPerSecond;
+	double   checksumFailureRatio;
+	double   framesBetween;    /**< Average number of frames between packets. */
+	double   frameJitter;      /**< Average deviation from framesBetween, in frames. */
+	uint64_t lastFrame;        /**< Frame number the packet was last seen in. */
+};
+
+/**
+ * @brief	Start collecting traffic statistics on this context.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @return      0 - Success
+ * @return      < 0 - Error
+ */
+int klvanc_context_enable_stats(struct klvanc_context_s *ctx);
+
+/**
+ * @brief	Copy the statistics of every active DID/SDID/line, in the order they were first seen.\n
+ *              The cost is proportional to the number of active entries, not to the stream.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[out]	struct klvanc_stats_entry_s *entries - Array to populate.
+ * @param[in]	int maxEntries - Size of the array.
+ * @return      >= 0 - Number of active entries, which may exceed maxEntries.
+ * @return      < 0 - Error, or statistics not enabled.
+ */
+int klvanc_context_get_stats(struct klvanc_context_s *ctx, struct klvanc_stats_entry_s *entries, int maxEntries);
+
+/**
+ * @brief	Forget all entries.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @return      0 - Success
+ * @return      < 0 - Error
+ */
+int klvanc_context_reset_stats(struct klvanc_context_s *ctx);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _KLVANC_STATS_H */
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file	stream.h
+ * @copyright	Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved.
+ * @brief	Per stream parser state, so one configured context can serve many inputs.
+ *
+ *              A context mixes configuration with the state of the stream being parsed:
+ *              decode storage, SCTE-104 fragments, checksum failure counts, frame numbers
+ *              and the optional cache. Two threads must never parse through one context.
+ *
+ *              A stream created from a context takes a snapshot of its configuration
+ *              (the callbacks table, callback_context, verbosity, logging, bad checksum
+ *              and decode failure handling, the DID/SDID filter, change detection rules
+ *              and line map settings) and shares its memory account, but owns all of the
+ *              mutable state. Each stream may be parsed on its own thread with no locking,
+ *              provided the context is not reconfigured meanwhile. The decoder tables are
+ *              static and shared by everything.
+ *
+ *              Callbacks receive the stream's context, see klvanc_stream_get_context().
+ *              Point its callback_context at per channel data to tell streams apart, or
+ *              enable per stream features such as the cache or statistics on it.
+ */
+
+#ifndef _KLVANC_STREAM_H
+#define _KLVANC_STREAM_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct klvanc_context_s;
+struct klvanc_stream_s;
+
+/**
+ * @brief	Create a stream from a configured context. Destroy every stream before the context.
+ * @param[in]	struct klvanc_context_s *ctx - Context to take the configuration from.
+ * @param[out]	struct klvanc_stream_s **stream - Stream.
+ * @return      0 - Success
+ * @return      < 0 - Error
+ */
+int klvanc_stream_create(struct klvanc_context_s *ctx, struct klvanc_stream_s **stream);
+
+/**
+ * @brief	Destroy a stream, see klvanc_stream_create().
+ * @param[in]	struct klvanc_stream_s *stream - Stream.
+ * @return      0 - Success
+ * @return      < 0 - Error
+ */
+int klvanc_stream_destroy(struct klvanc_stream_s *stream);
+
+/**
+ * @brief	The context holding the stream's state, as passed to callbacks.
+ * @param[in]	struct klvanc_stream_s *stream - Stream.
+ * @return      Context, or NULL.
+ */
+struct klvanc_context_s *klvanc_stream_get_context(struct klvanc_stream_s *stream);
+
+/**
+ * @brief	The context a stream was created from.
+ * @param[in]	struct klvanc_stream_s *stream - Stream.
+ * @return      Context, or NULL.
+ */
+struct klvanc_context_s *klvanc_stream_get_parent(struct klvanc_stream_s *stream);
+
+/**
+ * @brief	Identical to klvanc_packet_parse(), using the stream's state.
+ * @param[in]	struct klvanc_stream_s *stream - Stream.
+ * @param[in]	unsigned int lineNr - Line number.
+ * @param[in]	const unsigned short *words - VANC line words.
+ * @param[in]	unsigned int wordCount - Number of words.
+ * @return      >= 0 - Number of packets found.
+ * @return      < 0 - Error
+ */
+int klvanc_stream_parse(struct klvanc_stream_s *stream, unsigned int lineNr, const unsigned short *words,
+	unsigned int wordCount);
+
+/**
+ * @brief	Identical to klvanc_frame_end(), using the stream's state.
+ * @param[in]	struct klvanc_stream_s *stream - Stream.
+ * @return      0 - Success
+ * @return      < 0 - Error
+ */
+int klvanc_stream_frame_end(struct klvanc_stream_s *stream);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _KLVANC_STREAM_H */
@@ -74,7 +74,7 @@ enum klvanc_payload_afd_barflags {
  */
 struct klvanc_packet_afd_s
 {
-	struct klvanc_packet_header_s hdr;
+	struct klvanc_packet_header_s *hdr; /**< Packet this was decoded from, only valid during the callback. */
 	enum klvanc_payload_aspect_ratio_e aspectRatio;
 	enum klvanc_payload_afd_e afd;
 	enum klvanc_payload_afd_barflags barDataFlags;
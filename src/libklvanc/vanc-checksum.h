@@ -42,3 +42,31 @@ uint16_t klvanc_checksum_calculate(const uint16_t *words, int wordCount);
  */
 int klvanc_checksum_is_valid(const uint16_t *words, int wordCount);
 
+/**
+ * @brief	Verify a checksum and, in the same pass, count words with incorrect parity bits.
+ *		Takes the same words as klvanc_checksum_is_valid(). The checksum word itself
+ *		carries no parity and is not counted.
+ * @param[in]	const uint16_t *words - DID through checksum.
+ * @param[in]	int wordCount - Number of words, including the checksum.
+ * @param[out]	unsigned int *parityErrors - Words with bad parity, may be NULL.
+ * @return	1 - Checksum valid
+ * @return	0 - Checksum invalid
+ */
+int klvanc_checksum_verify(const uint16_t *words, int wordCount, unsigned int *parityErrors);
+
+/**
+ * @brief	Check bits 8 and 9 of a DID, SDID, DC or UDW word against the parity of bits 0-7.
+ * @param[in]	uint16_t word - Word to check.
+ * @return	1 - Parity bits correct
+ * @return	0 - Parity bits incorrect
+ */
+int klvanc_parity_is_valid(uint16_t word);
+
+/**
+ * @brief	Count the words in an array whose parity bits are incorrect.
+ * @param[in]	const uint16_t *words - Words to check.
+ * @param[in]	int wordCount - Number of words.
+ * @return	Number of words with incorrect parity bits.
+ */
+int klvanc_parity_errors(const uint16_t *words, int wordCount);
+
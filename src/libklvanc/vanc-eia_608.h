@@ -40,7 +40,7 @@ extern "C" {
  */
 struct klvanc_packet_eia_608_s
 {
-	struct klvanc_packet_header_s hdr;
+	struct klvanc_packet_header_s *hdr; /**< Packet this was decoded from, only valid during the callback. */
 	int nr;
 	unsigned char payload[3];
 
@@ -119,7 +119,7 @@ struct klvanc_packet_eia_708b_cdp_footer
  */
 struct klvanc_packet_eia_708b_s
 {
-	struct klvanc_packet_header_s hdr;
+	struct klvanc_packet_header_s *hdr; /**< Packet this was decoded from, only valid during the callback. */
 	uint8_t payload[256];
 	unsigned int payloadLengthBytes;
 	int checksum_valid;
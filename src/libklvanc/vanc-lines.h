@@ -39,6 +39,8 @@
 #include <stdint.h>
 #include <sys/types.h>
 #include <sys/errno.h>
+#include <libklvanc/allocator.h>
+#include <libklvanc/video_format.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -47,6 +49,10 @@ extern "C" {
 #define KLVANC_MAX_VANC_LINES   64
 #define KLVANC_MAX_VANC_ENTRIES 16
 
+/* Pooled line sets index lines directly by number, so line numbers must be below this */
+#define KLVANC_LINE_SET_MAX_LINE_NUMBER    2048
+#define KLVANC_LINE_SET_DEFAULT_ARENA_WORDS 32768
+
 struct klvanc_entry_s
 {
         int h_offset;
@@ -62,18 +68,55 @@ struct klvanc_line_s
 	int line_number;
 	struct klvanc_entry_s *p_entries[KLVANC_MAX_VANC_ENTRIES];
 	int num_entries;
+	struct klvanc_allocator_s allocator; /**< Services the line and its entries, zeroed for the C library */
+	int pooled; /**< Line and entries belong to a pooled line set, klvanc_line_free() leaves them alone */
 };
 
+struct klvanc_line_pool_s;
+
 /**
  * @brief	Represents a group of VANC lines (e.g. perhaps corresponding to a video frame)
+ *              A zeroed set allocates each line and entry as it is inserted. A set from
+ *              klvanc_line_set_create() draws them from a preallocated arena instead.
  */
     
 struct klvanc_line_set_s
 {
 	int num_lines;
 	struct klvanc_line_s *lines[KLVANC_MAX_VANC_LINES];
+	struct klvanc_line_pool_s *pool; /**< Private. NULL for a caller owned set */
 };
 
+/**
+ * @brief	Create a pooled VANC line set. Lines, entries and payload copies are
+ *              carved from an arena allocated up front, and lines are found by line
+ *              number without searching. Call klvanc_line_set_reset() between frames
+ *              to recycle the arena, so steady state insertion does not allocate.
+ *
+ * @param[in]	struct klvanc_context_s *ctx - Context. Memory is accounted to KLVANC_MEM_LINES.
+ * @param[out]	struct klvanc_line_set_s **set - The new set.
+ * @param[in]	unsigned int arenaWords - Payload words available per frame, or zero for
+ *              KLVANC_LINE_SET_DEFAULT_ARENA_WORDS.
+ * @return      0 - Success
+ * @return      -EINVAL - invalid argument
+ * @return      -ENOMEM - insufficient memory
+ */
+int klvanc_line_set_create(struct klvanc_context_s *ctx, struct klvanc_line_set_s **set,
+			   unsigned int arenaWords);
+
+/**
+ * @brief	Empty a pooled line set, returning every line, entry and payload word
+ *              to its arena. Pointers previously taken from set->lines become invalid.
+ * @param[in]	struct klvanc_line_set_s *set - Set created by klvanc_line_set_create().
+ */
+void klvanc_line_set_reset(struct klvanc_line_set_s *set);
+
+/**
+ * @brief	Free a pooled line set and its arena. May be called after the context is destroyed.
+ * @param[in]	struct klvanc_line_set_s *set - Set created by klvanc_line_set_create().
+ */
+void klvanc_line_set_free(struct klvanc_line_set_s *set);
+
 /**
  * @brief	Create a VANC line
  *
@@ -86,7 +129,8 @@ struct klvanc_line_s *klvanc_line_create(int line_number);
 /**
  * @brief	Free a previously created klvanc_line_s structure
  * @param[in]	struct klvanc_line_s *line - pointer to the line to be deleted.
- *              This will also deallocate any VANC packets previously inserted into the line
+ *              This will also deallocate any VANC packets previously inserted into the line.
+ *              Lines belonging to a pooled line set are left for klvanc_line_set_reset().
  */
 void klvanc_line_free(struct klvanc_line_s *line);
 
@@ -104,6 +148,7 @@ void klvanc_line_free(struct klvanc_line_s *line);
  *
  * @return      0 - Success
  * @return      -ENOMEM - insufficient memory to store the VANC packet
+ * @return      -EINVAL - line number out of range for a pooled line set
  */
 int klvanc_line_insert(struct klvanc_context_s *ctx, struct klvanc_line_set_s *vanc_lines,
 		       uint16_t *pixels, int pixel_width, int line_number, int horizontal_offset);
@@ -135,6 +180,26 @@ int klvanc_line_insert(struct klvanc_context_s *ctx, struct klvanc_line_set_s *v
 int klvanc_generate_vanc_line(struct klvanc_context_s *ctx, struct klvanc_line_s *line,
 			      uint16_t **out_buf, int *out_len, int line_pixel_width);
 
+/**
+ * @brief	Generate a fully formed VANC line directly into a caller supplied buffer.
+ *              Entries are packed back to back in the offset order klvanc_line_insert()
+ *              keeps them in, validated as they are copied, without sorting or allocating.
+ *              Unlike klvanc_generate_vanc_line() the line itself is left unmodified, so it
+ *              may be generated again.
+ *
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[in]	struct klvanc_line_s *line - the VANC line to operate on
+ * @param[out]	uint16_t *out_buf - buffer of at least line_pixel_width 16-bit samples, such as
+ *              the line in the output frame.  Samples past *out_len are left untouched.
+ * @param[out]	int *out_len - number of samples written
+ * @param[in]	int line_pixel_width - Size of out_buf, measured in number of samples.  Entries
+ *              which would exceed it are skipped.
+ * @return      0 - Success
+ * @return      -EINVAL - invalid argument
+ */
+int klvanc_generate_vanc_line_inplace(struct klvanc_context_s *ctx, struct klvanc_line_s *line,
+				      uint16_t *out_buf, int *out_len, int line_pixel_width);
+
 /**
  * @brief	Generate byte array representing a fully formed VANC line.  This
  *              function will take in a klvanc_line_s, format the VANC entries to ensure there
@@ -155,12 +220,115 @@ int klvanc_generate_vanc_line(struct klvanc_context_s *ctx, struct klvanc_line_s
  *              (e.g. 1920 for 1080i video), but there are special exceptions for certain 4K
  *              cards so review the Blackmagic SDK documentation for details.  This function
  *              will it insert VANC packets which exceed the line width specified.
+ *              Entries are packed straight into out_buf in a single pass, in the order
+ *              klvanc_line_insert() keeps them in, and the line itself is left unmodified.
  * @return      0 - Success
- * @return      -ENOMEM - insufficient memory to store the VANC packet
+ * @return      -EINVAL - invalid argument
  */
 int klvanc_generate_vanc_line_v210(struct klvanc_context_s *ctx, struct klvanc_line_s *line,
 				   uint8_t *out_buf, int line_pixel_width);
 
+/**
+ * @brief	As klvanc_generate_vanc_line_v210(), with the line capacity and whether VANC
+ *		goes in the luma samples or every component taken from a format descriptor
+ *		instead of guessed from the width.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[in]	struct klvanc_line_s *line - the VANC line to operate on
+ * @param[out]	uint8_t *out_buf - the v210 line to write into, klvanc_video_format_v210_stride() bytes
+ * @param[in]	const struct klvanc_video_format_s *fmt - Format, e.g. from klvanc_video_format_get().
+ * @return      0 - Success
+ * @return      -EINVAL - invalid argument
+ */
+int klvanc_generate_vanc_line_v210_format(struct klvanc_context_s *ctx, struct klvanc_line_s *line,
+					  uint8_t *out_buf, const struct klvanc_video_format_s *fmt);
+
+/**
+ * @brief	Remembers the last v210 generated for each line number, so a line whose
+ *              entries are unchanged since the previous frame is copied rather than packed
+ *              again, or left alone entirely when the caller's buffer still holds it.
+ *              Lines are compared by a 64-bit hash of their entries and the line width.
+ */
+struct klvanc_line_cache_s;
+
+#define KLVANC_LINE_CACHE_GENERATED 0	/**< The line was packed, and remembered. */
+#define KLVANC_LINE_CACHE_COPIED    1	/**< Unchanged, the remembered line was copied out. */
+#define KLVANC_LINE_CACHE_SKIPPED   2	/**< Unchanged, and the buffer was recycled, so nothing was written. */
+
+struct klvanc_line_cache_stats_s
+{
+	uint64_t generated;
+	uint64_t copied;
+	uint64_t skipped;
+};
+
+/**
+ * @brief	Create a line cache. Memory is accounted to KLVANC_MEM_LINES, about one
+ *              packed line per line number generated through it.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[out]	struct klvanc_line_cache_s **cache - The new cache.
+ * @return      0 - Success
+ * @return      -EINVAL - invalid argument
+ * @return      -ENOMEM - insufficient memory
+ */
+int klvanc_line_cache_alloc(struct klvanc_context_s *ctx, struct klvanc_line_cache_s **cache);
+
+/**
+ * @brief	Free a line cache. May be called after the context is destroyed.
+ * @param[in]	struct klvanc_line_cache_s *cache - Cache.
+ */
+void klvanc_line_cache_free(struct klvanc_line_cache_s *cache);
+
+/**
+ * @brief	Forget every remembered line, for instance when the output buffers change.
+ * @param[in]	struct klvanc_line_cache_s *cache - Cache.
+ */
+void klvanc_line_cache_invalidate(struct klvanc_line_cache_s *cache);
+
+/**
+ * @brief	Take a snapshot of how lines were produced.
+ * @param[in]	struct klvanc_line_cache_s *cache - Cache.
+ * @param[out]	struct klvanc_line_cache_stats_s *stats - Statistics.
+ * @return      0 - Success
+ * @return      -EINVAL - invalid argument
+ */
+int klvanc_line_cache_get_stats(struct klvanc_line_cache_s *cache, struct klvanc_line_cache_stats_s *stats);
+
+/**
+ * @brief	As klvanc_generate_vanc_line_v210(), reusing the last output for this line
+ *              number when the line is unchanged. The unused samples of the final 16 byte
+ *              v210 group are written black, so a copied line never carries stale samples.
+ *
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[in]	struct klvanc_line_cache_s *cache - Cache.
+ * @param[in]	struct klvanc_line_s *line - the VANC line to operate on
+ * @param[out]	uint8_t *out_buf - the v210 line to write into
+ * @param[in]	int line_pixel_width - Size of the output buffer, measured in number of samples.
+ * @param[in]	int recycled - out_buf still holds what the previous call for this line number
+ *              wrote, so an unchanged line need not be written at all.
+ * @return      KLVANC_LINE_CACHE_GENERATED, KLVANC_LINE_CACHE_COPIED or KLVANC_LINE_CACHE_SKIPPED
+ * @return      -EINVAL - invalid argument
+ */
+int klvanc_generate_vanc_line_v210_cached(struct klvanc_context_s *ctx, struct klvanc_line_cache_s *cache,
+					  struct klvanc_line_s *line, uint8_t *out_buf, int line_pixel_width,
+					  int recycled);
+
+/**
+ * @brief	As klvanc_generate_vanc_line_v210_cached(), with the line capacity and whether
+ *		VANC goes in the luma samples or every component taken from a format descriptor,
+ *		as for klvanc_generate_vanc_line_v210_format().
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[in]	struct klvanc_line_cache_s *cache - Cache.
+ * @param[in]	struct klvanc_line_s *line - the VANC line to operate on
+ * @param[out]	uint8_t *out_buf - the v210 line to write into, klvanc_video_format_v210_stride() bytes
+ * @param[in]	const struct klvanc_video_format_s *fmt - Format, e.g. from klvanc_video_format_get().
+ * @param[in]	int recycled - As for klvanc_generate_vanc_line_v210_cached().
+ * @return      KLVANC_LINE_CACHE_GENERATED, KLVANC_LINE_CACHE_COPIED or KLVANC_LINE_CACHE_SKIPPED
+ * @return      -EINVAL - invalid argument
+ */
+int klvanc_generate_vanc_line_v210_cached_format(struct klvanc_context_s *ctx, struct klvanc_line_cache_s *cache,
+						 struct klvanc_line_s *line, uint8_t *out_buf,
+						 const struct klvanc_video_format_s *fmt, int recycled);
+
 #ifdef __cplusplus
 };
 #endif  
@@ -50,6 +50,7 @@ enum klvanc_packet_type_e
 	VANC_TYPE_SDP,
 	VANC_TYPE_SMPTE_S12_2,
 	VANC_TYPE_SMPTE_S2108_1,
+	VANC_TYPE_SMPTE_S352,
 };
 
 /**
@@ -68,8 +69,9 @@ struct klvanc_packet_header_s
 	unsigned int 		checksumValid;
 	unsigned int		lineNr; 		/**< The vanc in this header came from line.... */
 	unsigned short		raw[LIBKLVANC_PACKET_MAX_PAYLOAD];
-	unsigned int 		rawLengthWords;
+	unsigned int 		rawLengthWords;		/**< Words in raw, the packet from ADF through checksum. */
 	unsigned short		horizontalOffset;	/**< Horizontal word where the ADF was detected. */
+	unsigned int		parityErrors;		/**< DID, SDID, DC and payload words with incorrect parity bits. */
 };
 
 /**
@@ -282,7 +282,7 @@ struct klvanc_multiple_operation_message
  */
 struct klvanc_packet_scte_104_s
 {
-	struct klvanc_packet_header_s hdr;
+	struct klvanc_packet_header_s *hdr; /**< Packet this was decoded from, only valid during the callback. */
 
 	/* See SMPTE 2010:2008 page 5 */
 	unsigned char payloadDescriptorByte;
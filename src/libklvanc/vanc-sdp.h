@@ -35,7 +35,7 @@ struct klvanc_sdp_desc_s
  */
 struct klvanc_packet_sdp_s
 {
-	struct klvanc_packet_header_s hdr;
+	struct klvanc_packet_header_s *hdr; /**< Packet this was decoded from, only valid during the callback. */
 	uint16_t identifier;
 	enum klvanc_sdp_format_code_e format_code;
 	struct klvanc_sdp_desc_s descriptors[5];
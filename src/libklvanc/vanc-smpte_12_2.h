@@ -53,7 +53,7 @@ extern "C" {
  */
 struct klvanc_packet_smpte_12_2_s
 {
-	struct klvanc_packet_header_s hdr;
+	struct klvanc_packet_header_s *hdr; /**< Packet this was decoded from, only valid during the callback. */
 
 	unsigned char payload[256];
 	unsigned int payloadLengthBytes;
@@ -72,7 +72,7 @@ struct klvanc_s2108_1_frame {
  */
 struct klvanc_packet_smpte_2108_1_s
 {
-	struct klvanc_packet_header_s hdr;
+	struct klvanc_packet_header_s *hdr; /**< Packet this was decoded from, only valid during the callback. */
 
 	uint8_t payload[256];
 	unsigned int payloadLengthBytes;
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+/**
+ * @file	vanc-smpte_352.h
+ * @copyright	Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved.
+ * @brief	SMPTE ST 352 Payload Identification
+ */
+
+#ifndef _VANC_SMPTE_352_H
+#define _VANC_SMPTE_352_H
+
+#include <libklvanc/vanc-packets.h>
+#include <libklvanc/video_format.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Picture rates, byte 2 bits 0-3 (See Table 2) */
+#define KLVANC_ST352_RATE_23_98 0x02
+#define KLVANC_ST352_RATE_24    0x03
+#define KLVANC_ST352_RATE_25    0x05
+#define KLVANC_ST352_RATE_29_97 0x06
+#define KLVANC_ST352_RATE_30    0x07
+#define KLVANC_ST352_RATE_50    0x09
+#define KLVANC_ST352_RATE_59_94 0x0a
+#define KLVANC_ST352_RATE_60    0x0b
+
+/* Sampling structures, byte 3 bits 0-3 */
+#define KLVANC_ST352_SAMPLING_422_YCBCR 0x00
+#define KLVANC_ST352_SAMPLING_444_YCBCR 0x01
+#define KLVANC_ST352_SAMPLING_444_GBR   0x02
+
+/* Bit depths, byte 4 bits 0-1 */
+#define KLVANC_ST352_DEPTH_8BIT  0x00
+#define KLVANC_ST352_DEPTH_10BIT 0x01
+#define KLVANC_ST352_DEPTH_12BIT 0x02
+
+/**
+ * @brief	Describes an ST 352 payload identifier, four words naming the interface
+ *		and picture carried.
+ */
+struct klvanc_packet_smpte_352_s
+{
+	struct klvanc_packet_header_s *hdr; /**< Packet this was decoded from, only valid during the callback. */
+	uint8_t payload[4];
+
+	/* Parsed */
+	int version;			/**< 1 when byte 1 bit 7 is set. */
+	uint8_t standard;		/**< Byte 1, payload and interface, e.g. 0x85 for 1080-line on 1.5 Gb/s. */
+	int transportProgressive;	/**< Byte 2 bit 7, 0 for interlaced and PsF transport. */
+	int pictureProgressive;		/**< Byte 2 bit 6. */
+	uint8_t pictureRate;		/**< KLVANC_ST352_RATE_* */
+	int aspectRatio16x9;		/**< Byte 3 bit 7, 16:9 for SD, 2048 samples for 1080-line. */
+	uint8_t samplingStructure;	/**< KLVANC_ST352_SAMPLING_* */
+	uint8_t bitDepth;		/**< KLVANC_ST352_DEPTH_* */
+
+	const struct klvanc_video_format_s *format; /**< Registry format carried, NULL when not known. */
+};
+
+/**
+ * @brief	Registry format an ST 352 payload identifier describes. SD picks 525i or 625i
+ *		by picture rate, 1080-line picks interlaced or progressive by the transport,
+ *		so PsF takes the interlaced line map it is carried with.
+ * @param[in]	const struct klvanc_packet_smpte_352_s *pkt - Payload identifier.
+ * @return	Format, or NULL if the payload is not one the registry describes.
+ */
+const struct klvanc_video_format_s *klvanc_SMPTE_352_video_format(const struct klvanc_packet_smpte_352_s *pkt);
+
+/**
+ * @brief	Print a payload identifier.
+ * @param[in]	struct klvanc_context_s *ctx, void *p - Context and struct klvanc_packet_smpte_352_s.
+ * @return	0 - Success
+ * @return	< 0 - Error
+ */
+int klvanc_dump_SMPTE_352(struct klvanc_context_s *ctx, void *p);
+
+/**
+ * @brief	Convert type struct klvanc_packet_smpte_352_s into a more traditional line of\n
+ *              vanc words, so that we may push out as VANC data. The payload is built from
+ *              the parsed fields, other bits are zero.
+ *              On success, caller MUST free the resulting *words array.
+ * @param[in]	struct klvanc_packet_smpte_352_s *pkt - A payload identifier
+ * @param[out]	uint16_t **words - An array of words representing a fully formed vanc line.
+ * @param[out]	uint16_t *wordCount - Number of words in the array.
+ * @return        0 - Success
+ * @return      < 0 - Error
+ * @return      -ENOMEM - Not enough memory to satisfy request
+ */
+int klvanc_convert_SMPTE_352_to_words(struct klvanc_packet_smpte_352_s *pkt, uint16_t **words, uint16_t *wordCount);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _VANC_SMPTE_352_H */
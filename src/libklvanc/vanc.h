@@ -40,6 +40,7 @@
 #include <sys/errno.h>
 #include <sys/errno.h>
 #include <libklvanc/klrestricted_code_path.h>
+#include <libklvanc/allocator.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -83,6 +84,7 @@ struct klvanc_packet_sdp_s;
  * @brief       TODO - Brief description goes here.
  */
 struct klvanc_context_s;
+struct klvanc_video_format_s;
 
 /**
  * @brief       TODO - Brief description goes here.
@@ -100,7 +102,15 @@ struct klvanc_packet_smpte_12_2_s;
 struct klvanc_packet_smpte_2108_1_s;
 
 /**
- * @brief       TODO - Brief description goes here.
+ * @brief       Structure describing an SMPTE ST 352 payload identifier
+ */
+struct klvanc_packet_smpte_352_s;
+struct klvanc_frame_s;
+
+/**
+ * @brief       Callbacks fired as packets are decoded. Packets passed to a callback are
+ *              owned by the context and reused for the next packet, copy anything
+ *              which must outlive the callback.
  */
 struct klvanc_callbacks_s
 {
@@ -113,6 +123,8 @@ struct klvanc_callbacks_s
 	int (*sdp)(void *user_context, struct klvanc_context_s *, struct klvanc_packet_sdp_s *);
 	int (*smpte_12_2)(void *user_context, struct klvanc_context_s *, struct klvanc_packet_smpte_12_2_s *);
 	int (*smpte_2108_1)(void *user_context, struct klvanc_context_s *, struct klvanc_packet_smpte_2108_1_s *);
+	int (*frame)(void *user_context, struct klvanc_context_s *, const struct klvanc_frame_s *); /*!< Every packet of a frame, see frame.h. */
+	int (*smpte_352)(void *user_context, struct klvanc_context_s *, struct klvanc_packet_smpte_352_s *);
 };
 
 struct klvanc_cache_s;
@@ -120,6 +132,8 @@ struct klvanc_cache_s;
 /**
  * @brief       Application specific context, the library allocates and stores user specific instance
  *		        information.
+ *		        A context holds the state of the stream being parsed and must only be used by one
+ *		        thread at a time. See stream.h to parse several inputs with one configuration.
  */
 struct klvanc_context_s
 {
@@ -130,6 +144,7 @@ struct klvanc_context_s
 	int warn_on_decode_failure; /*!< defaults to false. If true, framework will warn every 60 seconds when it discovered an unsupported DID. */
 
 	void (*log_cb)(void *p, int level, const char *fmt, ...);
+	int log_level; /*!< Messages above this LIBKLVANC_LOGLEVEL_* are dropped before being formatted. Defaults to LIBKLVANC_LOGLEVEL_DEBUG. */
 
 	/* Internal use by the library */
 	void *priv;
@@ -174,6 +189,22 @@ struct klvanc_context_s
  */
 int klvanc_context_create(struct klvanc_context_s **ctx);
 
+/**
+ * @brief	Identical to klvanc_context_create(), except the context and every internal allocation\n
+ *              made on its behalf (decode storage, cache, SCTE-104 fragments, VANC lines) are\n
+ *              serviced by allocator. The allocator is copied, but its opaque must remain valid\n
+ *              until klvanc_context_destroy().\n
+ *              Exceptions: buffers handed back for the caller to free() (the klvanc_convert_*()\n
+ *              words/bytes arrays) and packets from klvanc_alloc_SCTE_104() still come from the\n
+ *              C library, since they are released without a context.
+ * @param[out]	struct klvanc_context_s **ctx - Context.
+ * @param[in]	const struct klvanc_allocator_s *allocator - Allocator, or NULL for the C library.
+ * @return      0 - Success
+ * @return      < 0 - Error
+ */
+int klvanc_context_create_with_allocator(struct klvanc_context_s **ctx,
+	const struct klvanc_allocator_s *allocator);
+
 /**
  * @brief	Deallocate and destroy a context. See klvanc_context_create()
  * @param[in]	struct klvanc_context_s *ctx - Context.
@@ -190,6 +221,40 @@ int klvanc_context_destroy(struct klvanc_context_s *ctx);
  */
 int klvanc_context_dump(struct klvanc_context_s *ctx);
 
+/**
+ * @brief	Report the memory this context is responsible for, per subsystem. Allocations are\n
+ *              accounted until they are freed, even when that happens after klvanc_context_destroy().\n
+ *              The cache table is reported at its full mapped size.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[out]	struct klvanc_memstats_s *stats - Populated with a snapshot of the counters.
+ * @return      0 - Success
+ * @return      < 0 - Error
+ */
+int klvanc_context_get_memstats(struct klvanc_context_s *ctx, struct klvanc_memstats_s *stats);
+
+/**
+ * @brief	Zero the alloc and free counts and restart the peaks from the current outstanding\n
+ *              bytes, so allocations can be measured over an interval such as one frame.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @return      0 - Success
+ * @return      < 0 - Error
+ */
+int klvanc_context_reset_memstats(struct klvanc_context_s *ctx);
+
+/**
+ * @brief	Retrieve an allocator that charges a subsystem of this context, built on top of the\n
+ *              allocator the context was created with. Typically passed to the SMPTE 2038\n
+ *              _with_allocator() functions. It must not be used to allocate after\n
+ *              klvanc_context_destroy(), though objects it allocated may be freed later.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[in]	enum klvanc_mem_subsystem_e subsystem - Bucket to charge.
+ * @param[out]	struct klvanc_allocator_s *allocator - Populated allocator.
+ * @return      0 - Success
+ * @return      < 0 - Error
+ */
+int klvanc_context_get_allocator(struct klvanc_context_s *ctx, enum klvanc_mem_subsystem_e subsystem,
+	struct klvanc_allocator_s *allocator);
+
 /**
  * @brief	Parse a line of payload, trigger callbacks as necessary. lineNr is passed around and only\n
  *		used for reporting purposes, so we can figure out which line this came from in different\n
@@ -203,6 +268,37 @@ int klvanc_context_dump(struct klvanc_context_s *ctx);
  */
 int klvanc_packet_parse(struct klvanc_context_s *ctx, unsigned int lineNr, const unsigned short *words, unsigned int wordCount);
 
+/**
+ * @brief	Tell the library every line of the current video frame has been parsed. Frame numbers\n
+ *		drive the inter-arrival statistics, and the frame callback fires. Until this is first\n
+ *		called, a new frame is assumed whenever klvanc_packet_parse() is given a lower line\n
+ *		number than the previous call.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @return      0 - Success
+ * @return      < 0 - Error
+ */
+int klvanc_frame_end(struct klvanc_context_s *ctx);
+
+/**
+ * @brief	Parse every VANC line of a frame's v210 VANC region, laid out as for
+ *		klvanc_frame_compose(): the format's VANC lines, field 1 then field 2, one
+ *		row per line. Line numbers and whether VANC sits in the luma samples or
+ *		every component come from the format, nothing is guessed from the width.
+ *		HD formats parse the luma samples only. Call klvanc_frame_end() afterwards
+ *		as usual.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[in]	const struct klvanc_video_format_s *fmt - Format, e.g. from klvanc_video_format_get(),
+ *		or NULL for the context's, see klvanc_context_enable_format_detection().
+ * @param[in]	const uint8_t *vanc - First row of the region.
+ * @param[in]	uint32_t stride - Bytes between rows, 0 for klvanc_video_format_v210_stride().
+ *		Detection needs the real stride, it is how the region's width is found.
+ * @return      >= 0 - Packets parsing was attempted on.
+ * @return      -EAGAIN - No format given, none known and none detected in this frame.
+ * @return      < 0 - Error
+ */
+int klvanc_frame_parse_v210(struct klvanc_context_s *ctx, const struct klvanc_video_format_s *fmt,
+			    const uint8_t *vanc, uint32_t stride);
+
 /**
  * @brief	TODO - Brief description goes here.
  * @param[in]	uint16_t *array - Array of SDI words (10bit) that the caller wants parsed.
@@ -218,6 +314,7 @@ void klvanc_dump_words_console(struct klvanc_context_s *ctx, uint16_t *vanc, int
 #include <libklvanc/vanc-scte_104.h>
 #include <libklvanc/vanc-smpte_12_2.h>
 #include <libklvanc/vanc-smpte_2108_1.h>
+#include <libklvanc/vanc-smpte_352.h>
 #include <libklvanc/did.h>
 #include <libklvanc/pixels.h>
 #include <libklvanc/vanc-checksum.h>
@@ -225,6 +322,21 @@ void klvanc_dump_words_console(struct klvanc_context_s *ctx, uint16_t *vanc, int
 #include <libklvanc/cache.h>
 #include <libklvanc/vanc-kl_u64le_counter.h>
 #include <libklvanc/vanc-sdp.h>
+#include <libklvanc/recorder.h>
+#include <libklvanc/perfstats.h>
+#include <libklvanc/stats.h>
+#include <libklvanc/shm.h>
+#include <libklvanc/change_detection.h>
+#include <libklvanc/linemap.h>
+#include <libklvanc/filter.h>
+#include <libklvanc/stream.h>
+#include <libklvanc/engine.h>
+#include <libklvanc/async.h>
+#include <libklvanc/frame.h>
+#include <libklvanc/video_format.h>
+#include <libklvanc/compose.h>
+#include <libklvanc/patch.h>
+#include <libklvanc/chunk.h>
 
 /**
  * @brief	Take an array of payload, create a fully formed VANC message.
@@ -245,6 +357,40 @@ int klvanc_sdi_create_payload(uint8_t sdid, uint8_t did,
 	uint16_t **dst, uint16_t *dstWordCount,
 	uint32_t bitDepth);
 
+/**
+ * @brief	As klvanc_sdi_create_payload() for 10-bit video, writing into a caller buffer.
+ * @param[in]	uint8_t sdid, uint8_t did - Packet identifiers.
+ * @param[in]	const uint8_t *src - User data words, one per byte.
+ * @param[in]	uint16_t srcByteCount - Number of user data words.
+ * @param[out]	uint16_t *dst - Buffer for the packet, ADF to checksum, or NULL to only size it.
+ * @param[in]	unsigned int dstWordCapacity - Size of dst in words.
+ * @return	> 0 - Words written, or needed when dst is NULL.
+ * @return	-ENOSPC - dst is too small.
+ * @return	< 0 - Error
+ */
+int klvanc_sdi_write_payload(uint8_t sdid, uint8_t did,
+	const uint8_t *src, uint16_t srcByteCount,
+	uint16_t *dst, unsigned int dstWordCapacity);
+
+/**
+ * @brief	Serialize a packet structure of the given type, such as struct klvanc_packet_afd_s
+ *		for VANC_TYPE_AFD, to a complete VANC packet in a caller buffer without allocating.
+ *		Call with words NULL first to learn the size. Supported for AFD, EIA-608,
+ *		EIA-708B, SCTE-104, SMPTE 12-2 and the KL counter. SCTE-104 operations are
+ *		still serialized through temporary buffers.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[in]	enum klvanc_packet_type_e type - Type of pkt.
+ * @param[in]	const void *pkt - Packet structure, as delivered to the type's callback.
+ * @param[out]	uint16_t *words - Buffer for the packet, ADF to checksum, or NULL.
+ * @param[in]	unsigned int wordCapacity - Size of words.
+ * @return	> 0 - Words written, or needed when words is NULL.
+ * @return	-ENOSPC - words is too small.
+ * @return	-EINVAL - The type cannot be serialized.
+ * @return	< 0 - Error
+ */
+int klvanc_packet_serialize(struct klvanc_context_s *ctx, enum klvanc_packet_type_e type,
+			    const void *pkt, uint16_t *words, unsigned int wordCapacity);
+
 /**
  * @brief	TODO - Brief description goes here.
  * @param[in]	enum packet_type_e type
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+/**
+ * @file	video_format.h
+ * @copyright	Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved.
+ * @brief	Describes the geometry of a video format as far as VANC is concerned.
+ *
+ *              A descriptor names the lines of each field which may carry VANC, and
+ *              the line packets go on when nothing more specific applies. A frame's
+ *              VANC region is taken to be those lines, field 1 then field 2, one row
+ *              per line.
+ *
+ *              The common formats are kept in a registry, see klvanc_video_format_get(),
+ *              with their line maps, switching lines, timecode lines, v210 stride and
+ *              where VANC sits in the sample stream worked out ahead of time. Callers
+ *              with their own descriptors run klvanc_video_format_init() once to get the
+ *              same. UHD formats are described as carried per 1080p link, as ST 2082
+ *              square division and two sample interleave both map VANC there.
+ */
+
+#ifndef _KLVANC_VIDEO_FORMAT_H
+#define _KLVANC_VIDEO_FORMAT_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum klvanc_video_format_e
+{
+	KLVANC_VIDEO_FORMAT_525I = 0,
+	KLVANC_VIDEO_FORMAT_625I,
+	KLVANC_VIDEO_FORMAT_720P,
+	KLVANC_VIDEO_FORMAT_1080I,
+	KLVANC_VIDEO_FORMAT_1080P,
+	KLVANC_VIDEO_FORMAT_2160P,
+	KLVANC_VIDEO_FORMAT_4320P,
+	KLVANC_VIDEO_FORMAT_MAX
+};
+
+/**
+ * @brief	Where VANC words sit in the samples of a line.
+ */
+enum klvanc_vanc_placement_e
+{
+	KLVANC_VANC_PLACEMENT_AUTO = 0,		/**< By width, luma above 720 pixels, every component otherwise. */
+	KLVANC_VANC_PLACEMENT_LUMA,		/**< HD and above, the Y data stream. */
+	KLVANC_VANC_PLACEMENT_COMPONENTS,	/**< SD, every word of the multiplexed Cb Y Cr Y stream. */
+};
+
+struct klvanc_context_s;
+
+struct klvanc_video_format_range_s
+{
+	uint32_t first;		/**< First line, inclusive. */
+	uint32_t last;		/**< Last line, inclusive. Zero when unused. */
+};
+
+struct klvanc_video_format_s
+{
+	const char *name;
+	uint32_t width;		/**< Active samples per line, 720 for SD. */
+	uint32_t height;	/**< Active lines per frame, e.g. 486 for 525i. */
+	uint32_t lineCount;	/**< Total lines per frame, e.g. 525. */
+	int interlaced;
+	struct klvanc_video_format_range_s vanc[2];	/**< VANC lines per field, field 2 unused when progressive. */
+	uint32_t packetLine[2];	/**< Where packets without a placement rule go, per field. */
+	uint32_t switchingLine[2];	/**< RP 168 switching line per field, zero if unknown. */
+	uint32_t timecodeLine[2];	/**< ST 12-2 line for VITC1 and VITC2 payloads, zero if unknown. */
+	uint32_t payloadIdLine[2];	/**< ST 352 payload identifier line per field, zero if unknown. */
+	enum klvanc_vanc_placement_e placement;
+
+	/* Derived from the above by klvanc_video_format_init() */
+	uint32_t stride;	/**< v210 bytes per line. */
+	uint32_t rows;		/**< VANC rows, both fields. */
+	uint32_t rowBase[2];	/**< Row of each field's first VANC line. */
+};
+
+/**
+ * @brief	Look up a format in the registry.
+ * @param[in]	enum klvanc_video_format_e id - Format.
+ * @return	Format, or NULL if id is out of range.
+ */
+const struct klvanc_video_format_s *klvanc_video_format_get(enum klvanc_video_format_e id);
+
+/**
+ * @brief	Find a registry format by active lines and scan, e.g. 1080 and interlaced.
+ * @param[in]	uint32_t height - Active lines per frame, 486 for 525i.
+ * @param[in]	int interlaced - Interlaced or progressive.
+ * @return	Format, or NULL if none matches.
+ */
+const struct klvanc_video_format_s *klvanc_video_format_find(uint32_t height, int interlaced);
+
+/**
+ * @brief	Fill in the derived members of a caller built descriptor, so the lookups below
+ *		are table driven rather than recomputed per call. Registry formats are
+ *		already initialised.
+ * @param[in]	struct klvanc_video_format_s *fmt - Format.
+ * @return	0 - Success
+ * @return	-EINVAL - The VANC ranges are not valid.
+ */
+int klvanc_video_format_init(struct klvanc_video_format_s *fmt);
+
+/**
+ * @brief	Whether VANC is carried in the luma samples only, resolving KLVANC_VANC_PLACEMENT_AUTO.
+ * @param[in]	const struct klvanc_video_format_s *fmt - Format.
+ * @return	1 - Luma only
+ * @return	0 - Every component
+ */
+int klvanc_video_format_luma(const struct klvanc_video_format_s *fmt);
+
+/**
+ * @brief	VANC words one line of the format can carry.
+ * @param[in]	const struct klvanc_video_format_s *fmt - Format.
+ * @return	Words.
+ */
+uint32_t klvanc_video_format_vanc_samples(const struct klvanc_video_format_s *fmt);
+
+/**
+ * @brief	Bytes in one v210 line of the format, padded to 128 bytes as v210 requires.
+ * @param[in]	const struct klvanc_video_format_s *fmt - Format.
+ * @return	Stride in bytes.
+ */
+uint32_t klvanc_video_format_v210_stride(const struct klvanc_video_format_s *fmt);
+
+/**
+ * @brief	Number of rows in the format's VANC region, both fields.
+ * @param[in]	const struct klvanc_video_format_s *fmt - Format.
+ * @return	Row count.
+ */
+uint32_t klvanc_video_format_vanc_rows(const struct klvanc_video_format_s *fmt);
+
+/**
+ * @brief	Locate a line in the format's VANC region.
+ * @param[in]	const struct klvanc_video_format_s *fmt - Format.
+ * @param[in]	uint32_t lineNr - Line number within the frame.
+ * @return	>= 0 - Row index.
+ * @return	-ERANGE - The line does not carry VANC.
+ */
+int klvanc_video_format_vanc_row(const struct klvanc_video_format_s *fmt, uint32_t lineNr);
+
+/**
+ * @brief	The line a row of the format's VANC region holds, the inverse of
+ *		klvanc_video_format_vanc_row().
+ * @param[in]	const struct klvanc_video_format_s *fmt - Format.
+ * @param[in]	uint32_t row - Row index.
+ * @return	Line number, or 0 if row is outside the region.
+ */
+uint32_t klvanc_video_format_vanc_line(const struct klvanc_video_format_s *fmt, uint32_t row);
+
+/**
+ * @brief	Line for an ST 12-2 timecode packet of the given payload type.
+ * @param[in]	const struct klvanc_video_format_s *fmt - Format.
+ * @param[in]	int dbb1 - Payload type, e.g. KLVANC_ATC_VITC1.
+ * @return	> 0 - Line number.
+ * @return	-1 - No preferred line.
+ */
+int klvanc_video_format_timecode_line(const struct klvanc_video_format_s *fmt, int dbb1);
+
+/**
+ * @brief	Set the format klvanc_frame_parse_v210() uses when not given one. NULL forgets
+ *		the format, so detection, if enabled, picks up the next payload identifier.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @param[in]	const struct klvanc_video_format_s *fmt - Format, must outlive its use.
+ * @return	0 - Success
+ * @return	< 0 - Error
+ */
+int klvanc_context_set_video_format(struct klvanc_context_s *ctx, const struct klvanc_video_format_s *fmt);
+
+/**
+ * @brief	The format set with klvanc_context_set_video_format() or detected.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @return	Format, or NULL while unknown.
+ */
+const struct klvanc_video_format_s *klvanc_context_get_video_format(struct klvanc_context_s *ctx);
+
+/**
+ * @brief	Take the parse geometry from the first SMPTE ST 352 payload identifier parsed
+ *		whose format the registry describes, when none is set. Identifiers are
+ *		decoded for this whether or not a smpte_352 callback is installed. HD
+ *		formats then parse only the luma samples of each row. Until a format is
+ *		known, klvanc_frame_parse_v210() given a stride looks for an identifier
+ *		itself on the payload identifier rows of the registry formats of that
+ *		stride, in both the luma and the component samples.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @return	0 - Success
+ * @return	< 0 - Error
+ */
+int klvanc_context_enable_format_detection(struct klvanc_context_s *ctx);
+
+/**
+ * @brief	Stop detecting the format, a format already detected is kept.
+ * @param[in]	struct klvanc_context_s *ctx - Context.
+ * @return	0 - Success
+ * @return	< 0 - Error
+ */
+int klvanc_context_disable_format_detection(struct klvanc_context_s *ctx);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _KLVANC_VIDEO_FORMAT_H */
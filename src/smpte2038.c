@@ -26,6 +26,7 @@
 #include <inttypes.h>
 #include <libklvanc/smpte2038.h>
 #include "klbitstream_readwriter.h"
+#include "core-alloc.h"
 
 #define VANC8(n) ((n) & 0xff)
 
@@ -43,15 +44,17 @@ void klvanc_smpte2038_anc_data_packet_free(struct klvanc_smpte2038_anc_data_pack
 	if (!pkt)
 		return;
 
+	struct klvanc_allocator_s allocator = pkt->allocator;
+
 	for (int i = 0; i < pkt->lineCount; i++) {
 		struct klvanc_smpte2038_anc_data_line_s *l = pkt->lines + i;
 		if (VANC8(l->data_count))
-			free(l->user_data_words);
+			klvanc_mem_free(&allocator, l->user_data_words);
 	}
 	if (pkt->lineCount)
-		free(pkt->lines);
+		klvanc_mem_free(&allocator, pkt->lines);
 
-	free(pkt);
+	klvanc_mem_free(&allocator, pkt);
 }
 
 #define SHOW_LINE_U32(indent, fn) printf("%s%s = %d (0x%x)\n", indent, #fn, fn, fn);
@@ -107,7 +110,7 @@ static int smpte2038_parse_pes_payload_int(struct klbs_context_s *bs, struct klv
 	int byteAligned = 0;
 
 	while (rem > 4) {
-		h->lines = realloc(h->lines, (h->lineCount + 1) * sizeof(struct klvanc_smpte2038_anc_data_line_s));
+		h->lines = klvanc_mem_realloc(&h->allocator, h->lines, (h->lineCount + 1) * sizeof(struct klvanc_smpte2038_anc_data_line_s));
 
 		struct klvanc_smpte2038_anc_data_line_s *l = h->lines + h->lineCount;
 		memset(l, 0, sizeof(*l));
@@ -133,7 +136,7 @@ static int smpte2038_parse_pes_payload_int(struct klbs_context_s *bs, struct klv
 		/* Lets put the checksum at the end of the array then pull it back
 		 * into the checksum field later, it makes for easier processing.
 		 */
-		l->user_data_words = calloc(sizeof(uint16_t), VANC8(l->data_count) + 1);
+		l->user_data_words = klvanc_mem_calloc(&h->allocator, sizeof(uint16_t), VANC8(l->data_count) + 1);
 
 		udwByteCount = (((VANC8(l->data_count) + 1) * 10) / 8);
 
@@ -184,18 +187,32 @@ err:
 	return -1;
 }
 
+static struct klvanc_smpte2038_anc_data_packet_s *packet_alloc(const struct klvanc_allocator_s *allocator)
+{
+	struct klvanc_smpte2038_anc_data_packet_s *h = klvanc_mem_calloc(allocator, sizeof(*h), 1);
+	if (h && allocator)
+		h->allocator = *allocator;
+
+	return h;
+}
+
 int klvanc_smpte2038_parse_pes_payload(uint8_t *payload, unsigned int byteCount, struct klvanc_smpte2038_anc_data_packet_s **result)
+{
+	return klvanc_smpte2038_parse_pes_payload_with_allocator(payload, byteCount, result, NULL);
+}
+
+int klvanc_smpte2038_parse_pes_payload_with_allocator(uint8_t *payload, unsigned int byteCount,
+	struct klvanc_smpte2038_anc_data_packet_s **result, const struct klvanc_allocator_s *allocator)
 {
 	int ret;
-	struct klbs_context_s *bs = klbs_alloc();
-	if (bs == NULL)
+	struct klbs_context_s bsctx, *bs = &bsctx;
+
+	if (klvanc_mem_validate(allocator) < 0)
 		return -1;
 
-	struct klvanc_smpte2038_anc_data_packet_s *h = calloc(sizeof(*h), 1);
-	if (h == NULL) {
-		klbs_free(bs);
+	struct klvanc_smpte2038_anc_data_packet_s *h = packet_alloc(allocator);
+	if (h == NULL)
 		return -1;
-	}
 
         klbs_read_set_buffer(bs, payload, byteCount);
 
@@ -203,24 +220,26 @@ int klvanc_smpte2038_parse_pes_payload(uint8_t *payload, unsigned int byteCount,
 
 	*result = h;
 
-	if (bs)
-		klbs_free(bs);
-
 	return ret;
 }
 
 int klvanc_smpte2038_parse_pes_packet(uint8_t *section, unsigned int byteCount, struct klvanc_smpte2038_anc_data_packet_s **result)
+{
+	return klvanc_smpte2038_parse_pes_packet_with_allocator(section, byteCount, result, NULL);
+}
+
+int klvanc_smpte2038_parse_pes_packet_with_allocator(uint8_t *section, unsigned int byteCount,
+	struct klvanc_smpte2038_anc_data_packet_s **result, const struct klvanc_allocator_s *allocator)
 {
 	int ret = -1;
-	struct klbs_context_s *bs = klbs_alloc();
-	if (bs == NULL)
+	struct klbs_context_s bsctx, *bs = &bsctx;
+
+	if (klvanc_mem_validate(allocator) < 0)
 		return -1;
 
-	struct klvanc_smpte2038_anc_data_packet_s *h = calloc(sizeof(*h), 1);
-	if (h == NULL) {
-		klbs_free(bs);
+	struct klvanc_smpte2038_anc_data_packet_s *h = packet_alloc(allocator);
+	if (h == NULL)
 		return -1;
-	}
 
         klbs_read_set_buffer(bs, section, byteCount);
 
@@ -274,15 +293,11 @@ int klvanc_smpte2038_parse_pes_packet(uint8_t *section, unsigned int byteCount,
 	ret = smpte2038_parse_pes_payload_int(bs, h);
 	*result = h;
 
-	if (bs)
-		klbs_free(bs);
 	return ret;
 
 err:
 	if (h)
-		free(h);
-	if (bs)
-		klbs_free(bs);
+		klvanc_mem_free(allocator, h);
 	return ret;
 }
 
@@ -291,20 +306,36 @@ err:
 
 int klvanc_smpte2038_packetizer_alloc(struct klvanc_smpte2038_packetizer_s **ctx)
 {
-	struct klvanc_smpte2038_packetizer_s *p = calloc(1, sizeof(*p));
+	return klvanc_smpte2038_packetizer_alloc_with_allocator(ctx, NULL);
+}
+
+int klvanc_smpte2038_packetizer_alloc_with_allocator(struct klvanc_smpte2038_packetizer_s **ctx,
+	const struct klvanc_allocator_s *allocator)
+{
+	if (klvanc_mem_validate(allocator) < 0)
+		return -1;
+
+	struct klvanc_smpte2038_packetizer_s *p = klvanc_mem_calloc(allocator, 1, sizeof(*p));
 	if (!p)
 		return -1;
+	if (allocator)
+		p->allocator = *allocator;
 
 	/* Leave enough space for us to prefix the PES header */
 	p->bufused = KLVANC_SMPTE2038_PACKETIZER_BUFFER_RESET_OFFSET;
 	p->buflen = 16384;
 	p->buffree = p->buflen - p->bufused;
-	p->buf = calloc(1, p->buflen);
+	p->buf = klvanc_mem_calloc(allocator, 1, p->buflen);
 	if (!p->buf) {
-		free(p);
+		klvanc_mem_free(allocator, p);
+		return -1;
+	}
+	p->bs = klvanc_mem_calloc(allocator, 1, sizeof(struct klbs_context_s));
+	if (!p->bs) {
+		klvanc_mem_free(allocator, p->buf);
+		klvanc_mem_free(allocator, p);
 		return -1;
 	}
-	p->bs = klbs_alloc();
 
 	*ctx = p;
 	return 0;
@@ -324,7 +355,7 @@ static void klvanc_smpte2038_buffer_adjust(struct klvanc_smpte2038_packetizer_s
 		fprintf(stderr, "%s() buffer exceeds impossible limit, with %d additional bytes\n", __func__, newsizeBytes);
 		abort();
 	}
-	ctx->buf = realloc(ctx->buf, newsizeBytes);
+	ctx->buf = klvanc_mem_realloc(&ctx->allocator, ctx->buf, newsizeBytes);
 	ctx->buflen = newsizeBytes;
 	if (ctx->bufused > ctx->buflen)
 		ctx->bufused = ctx->buflen;
@@ -340,11 +371,12 @@ void klvanc_smpte2038_packetizer_free(struct klvanc_smpte2038_packetizer_s **ctx
 		return;
 
 	struct klvanc_smpte2038_packetizer_s *p = *ctx;
+	struct klvanc_allocator_s allocator = p->allocator;
 	if (p->buf)
-		free(p->buf);
-	klbs_free(p->bs);
+		klvanc_mem_free(&allocator, p->buf);
+	klvanc_mem_free(&allocator, p->bs);
 	memset(p, 0, sizeof(struct klvanc_smpte2038_packetizer_s));
-	free(p);
+	klvanc_mem_free(&allocator, p);
 }
 
 int klvanc_smpte2038_packetizer_begin(struct klvanc_smpte2038_packetizer_s *ctx)
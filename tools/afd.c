@@ -21,6 +21,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <inttypes.h>
 #include <libklvanc/vanc.h>
 
 /* Normally we don't use a global, but we know our test harness will never be
@@ -28,6 +29,7 @@
    callback for comparison */
 static uint16_t vancResult[16384];
 static size_t vancResultCount;
+static int afdCount;
 static int passCount = 0;
 static int failCount = 0;
 
@@ -39,6 +41,8 @@ static int cb_afd(void *callback_context, struct klvanc_context_s *ctx,
 {
 	int ret = -1;
 
+	afdCount++;
+
 #ifdef SHOW_DETAIL
 	/* Have the library display some debug */
 	printf("Asking libklvanc to dump a struct\n");
@@ -148,6 +152,323 @@ static int test_afd(struct klvanc_context_s *ctx, const uint8_t *buf, size_t buf
 }
 #endif
 
+static void test_perfstats(struct klvanc_context_s *ctx)
+{
+	struct klvanc_perfstats_s stats;
+
+	int ret = klvanc_context_get_perfstats(ctx, &stats);
+	if (ret == -ENOSYS) {
+		printf("Perfstats not built in, skipping.\n");
+		return;
+	}
+
+	uint64_t bucketed = 0;
+	for (int i = 0; i < KLVANC_PERF_HISTOGRAM_BUCKETS; i++)
+		bucketed += stats.stage[KLVANC_PERF_LINE].histogram[i];
+
+	if (ret == 0 && stats.didCount[0x41] > 0 &&
+	    stats.stage[KLVANC_PERF_LINE].count > 0 &&
+	    stats.stage[KLVANC_PERF_LINE].count == stats.stage[KLVANC_PERF_SCAN].count &&
+	    stats.stage[KLVANC_PERF_DECODE].count > 0 &&
+	    stats.stage[KLVANC_PERF_CALLBACK].count > 0 &&
+	    bucketed == stats.stage[KLVANC_PERF_LINE].count) {
+		printf("Perfstats recorded the parse!\n");
+		passCount++;
+	} else {
+		fprintf(stderr, "Perfstats missing or inconsistent\n");
+		failCount++;
+	}
+}
+
+/* Same as test_data_afd_1 with a different AFD code */
+static unsigned short test_data_afd_2[] = {
+	0x0000, 0x03ff, 0x03ff, 0x0241, 0x0205, 0x0108, 0x0120, 0x0200,
+	0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x026e
+};
+
+static void test_change_detection(void)
+{
+	struct klvanc_context_s *ctx;
+	int items = sizeof(test_data_afd_1) / sizeof(unsigned short);
+	uint64_t suppressed = 0;
+
+	printf("\nTesting change detection......\n");
+	if (klvanc_context_create(&ctx) < 0) {
+		fprintf(stderr, "Error initializing library context\n");
+		failCount++;
+		return;
+	}
+	ctx->callbacks = &callbacks;
+	ctx->log_level = LIBKLVANC_LOGLEVEL_ERR;
+
+	if (klvanc_context_enable_change_detection(ctx, 0x41, 0x05, 5) < 0) {
+		fprintf(stderr, "Failed to enable change detection\n");
+		failCount++;
+		klvanc_context_destroy(ctx);
+		return;
+	}
+
+	/* First packet, then a heartbeat on frames 5, 10 and 15 */
+	afdCount = 0;
+	for (int i = 0; i < 20; i++) {
+		klvanc_packet_parse(ctx, 9, test_data_afd_1, items);
+		klvanc_frame_end(ctx);
+	}
+	klvanc_context_get_change_detection_suppressed(ctx, &suppressed);
+	if (afdCount == 4 && suppressed == 16) {
+		printf("Repeated payload suppressed!\n");
+		passCount++;
+	} else {
+		fprintf(stderr, "Expected 4 deliveries and 16 suppressed, got %d and %" PRIu64 "\n",
+			afdCount, suppressed);
+		failCount++;
+	}
+
+	/* A changed payload is delivered straight away, the same one on another line too */
+	afdCount = 0;
+	klvanc_packet_parse(ctx, 9, test_data_afd_2, items);
+	klvanc_packet_parse(ctx, 9, test_data_afd_2, items);
+	klvanc_packet_parse(ctx, 10, test_data_afd_2, items);
+	klvanc_frame_end(ctx);
+	if (afdCount == 2) {
+		printf("Changed payload delivered!\n");
+		passCount++;
+	} else {
+		fprintf(stderr, "Expected 2 deliveries after change, got %d\n", afdCount);
+		failCount++;
+	}
+
+	klvanc_context_disable_change_detection(ctx, 0x41, 0x05);
+	afdCount = 0;
+	for (int i = 0; i < 3; i++)
+		klvanc_packet_parse(ctx, 9, test_data_afd_2, items);
+	if (afdCount == 3) {
+		printf("Every payload delivered once disabled!\n");
+		passCount++;
+	} else {
+		fprintf(stderr, "Expected 3 deliveries once disabled, got %d\n", afdCount);
+		failCount++;
+	}
+
+	klvanc_context_destroy(ctx);
+}
+
+static void test_line_map(void)
+{
+	struct klvanc_context_s *ctx;
+	struct klvanc_line_map_stats_s stats;
+	static unsigned short empty[64];
+	int items = sizeof(test_data_afd_1) / sizeof(unsigned short);
+
+	printf("\nTesting learned line map......\n");
+	if (klvanc_context_create(&ctx) < 0) {
+		fprintf(stderr, "Error initializing library context\n");
+		failCount++;
+		return;
+	}
+	ctx->callbacks = &callbacks;
+	ctx->log_level = LIBKLVANC_LOGLEVEL_ERR;
+	klvanc_context_enable_line_map(ctx, 3, 8);
+
+	/* AFD on line 9, lines 10 to 20 empty */
+	afdCount = 0;
+	for (int f = 0; f < 20; f++) {
+		klvanc_packet_parse(ctx, 9, test_data_afd_1, items);
+		for (int l = 10; l <= 20; l++)
+			klvanc_packet_parse(ctx, l, empty, 64);
+		klvanc_frame_end(ctx);
+	}
+	klvanc_context_get_line_map_stats(ctx, &stats);
+	if (afdCount == 20 && stats.learnedLines == 1 && stats.linesSkipped > 0 && !stats.warmingUp &&
+	    klvanc_line_map_wants_line(ctx, 9)) {
+		printf("Empty lines skipped after warm-up!\n");
+		passCount++;
+	} else {
+		fprintf(stderr, "Line map: %d deliveries, %u learned, %" PRIu64 " skipped\n",
+			afdCount, stats.learnedLines, stats.linesSkipped);
+		failCount++;
+	}
+
+	/* A new service on line 15 is missed until that line is next probed */
+	afdCount = 0;
+	for (int f = 0; f < 16; f++) {
+		klvanc_packet_parse(ctx, 9, test_data_afd_1, items);
+		for (int l = 10; l <= 20; l++) {
+			if (l == 15)
+				klvanc_packet_parse(ctx, l, test_data_afd_2, items);
+			else
+				klvanc_packet_parse(ctx, l, empty, 64);
+		}
+		klvanc_frame_end(ctx);
+	}
+	klvanc_context_get_line_map_stats(ctx, &stats);
+	if (afdCount > 16 && afdCount < 32 && stats.learnedLines == 2) {
+		printf("New line picked up by a re-probe!\n");
+		passCount++;
+	} else {
+		fprintf(stderr, "Line map: %d deliveries, %u learned\n", afdCount, stats.learnedLines);
+		failCount++;
+	}
+
+	klvanc_context_disable_line_map(ctx);
+	if (klvanc_line_map_wants_line(ctx, 12) &&
+	    klvanc_context_get_line_map_stats(ctx, &stats) == -ENOENT) {
+		printf("Every line scanned once disabled!\n");
+		passCount++;
+	} else {
+		fprintf(stderr, "Line map still active after disable\n");
+		failCount++;
+	}
+
+	klvanc_context_destroy(ctx);
+}
+
+static void test_filter(void)
+{
+	struct klvanc_context_s *ctx;
+	int items = sizeof(test_data_afd_1) / sizeof(unsigned short);
+	unsigned short line[64] = { 0 };
+	uint64_t drops = 0, total = 0;
+	int attempts;
+
+	printf("\nTesting DID/SDID filter......\n");
+	if (klvanc_context_create(&ctx) < 0) {
+		fprintf(stderr, "Error initializing library context\n");
+		failCount++;
+		return;
+	}
+	ctx->callbacks = &callbacks;
+	ctx->log_level = LIBKLVANC_LOGLEVEL_ERR;
+
+	/* Two AFD packets back to back */
+	memcpy(&line[0], test_data_afd_1, sizeof(test_data_afd_1));
+	memcpy(&line[items], test_data_afd_2, sizeof(test_data_afd_2));
+
+	/* Only SCTE-104 wanted */
+	klvanc_context_set_filter_mode(ctx, KLVANC_FILTER_ALLOW);
+	klvanc_context_filter_add(ctx, 0x41, 0x07);
+	afdCount = 0;
+	attempts = klvanc_packet_parse(ctx, 9, line, 64);
+	klvanc_context_get_filter_drops(ctx, 0x41, 0x05, &drops);
+	klvanc_context_get_filter_drops_total(ctx, &total);
+	if (afdCount == 0 && attempts == 0 && drops == 2 && total == 2) {
+		printf("Allowlist dropped AFD!\n");
+		passCount++;
+	} else {
+		fprintf(stderr, "Allowlist: %d deliveries, %" PRIu64 " drops\n", afdCount, drops);
+		failCount++;
+	}
+
+	/* AFD is denied, so the same set passes everything else */
+	klvanc_context_filter_clear(ctx);
+	klvanc_context_set_filter_mode(ctx, KLVANC_FILTER_DENY);
+	klvanc_context_filter_add(ctx, 0x41, 0x05);
+	afdCount = 0;
+	klvanc_packet_parse(ctx, 9, line, 64);
+	klvanc_context_get_filter_drops(ctx, 0x41, 0x05, &drops);
+	if (afdCount == 0 && drops == 2) {
+		printf("Denylist dropped AFD!\n");
+		passCount++;
+	} else {
+		fprintf(stderr, "Denylist: %d deliveries, %" PRIu64 " drops\n", afdCount, drops);
+		failCount++;
+	}
+
+	klvanc_context_filter_remove(ctx, 0x41, 0x05);
+	afdCount = 0;
+	klvanc_packet_parse(ctx, 9, line, 64);
+	klvanc_context_set_filter_mode(ctx, KLVANC_FILTER_NONE);
+	klvanc_packet_parse(ctx, 9, line, 64);
+	if (afdCount == 4) {
+		printf("AFD delivered once no longer filtered!\n");
+		passCount++;
+	} else {
+		fprintf(stderr, "Expected 4 deliveries once unfiltered, got %d\n", afdCount);
+		failCount++;
+	}
+
+	klvanc_context_destroy(ctx);
+}
+
+struct frame_result_s
+{
+	int calls;
+	uint64_t frameNr;
+	unsigned int packetCount;
+	int afdCodes[4];
+	unsigned int lines[4];
+};
+
+static int cb_frame(void *callback_context, struct klvanc_context_s *ctx, const struct klvanc_frame_s *frame)
+{
+	struct frame_result_s *r = callback_context;
+
+	r->calls++;
+	r->frameNr = frame->frameNr;
+	r->packetCount = frame->packetCount;
+	for (unsigned int i = 0; i < frame->packetCount && i < 4; i++) {
+		/* AFD code and aspect ratio live in the first user data word */
+		r->afdCodes[i] = frame->packets[i].payloadLength ? frame->packets[i].payload[0] : -1;
+		r->lines[i] = frame->packets[i].lineNr;
+	}
+
+	return 0;
+}
+
+static struct klvanc_callbacks_s frame_callbacks =
+{
+	.afd		= cb_afd,
+	.frame		= cb_frame,
+};
+
+static void test_frame_callback(void)
+{
+	struct klvanc_context_s *ctx;
+	struct frame_result_s r;
+	int items = sizeof(test_data_afd_1) / sizeof(unsigned short);
+	static unsigned short empty[64];
+
+	printf("\nTesting frame callback......\n");
+	if (klvanc_context_create(&ctx) < 0) {
+		fprintf(stderr, "Error initializing library context\n");
+		failCount++;
+		return;
+	}
+	memset(&r, 0, sizeof(r));
+	ctx->callbacks = &frame_callbacks;
+	ctx->callback_context = &r;
+	ctx->log_level = LIBKLVANC_LOGLEVEL_ERR;
+
+	struct klvanc_frame_line_s lines[] = {
+		{ 9, test_data_afd_1, items },
+		{ 10, empty, 64 },
+		{ 11, test_data_afd_2, items },
+	};
+
+	afdCount = 0;
+	int found = klvanc_frame_parse(ctx, lines, 3);
+	if (found == 2 && r.calls == 1 && r.frameNr == 0 && r.packetCount == 2 && afdCount == 2 &&
+	    r.afdCodes[0] == 0x00 && r.afdCodes[1] == 0x20 && r.lines[0] == 9 && r.lines[1] == 11) {
+		printf("Frame delivered every packet at once!\n");
+		passCount++;
+	} else {
+		fprintf(stderr, "Frame callback: %d calls, %u packets, found %d\n", r.calls, r.packetCount, found);
+		failCount++;
+	}
+
+	/* A frame without VANC still produces a callback, and the previous packets are gone */
+	klvanc_frame_parse(ctx, &lines[1], 1);
+	if (r.calls == 2 && r.frameNr == 1 && r.packetCount == 0) {
+		printf("Empty frame delivered!\n");
+		passCount++;
+	} else {
+		fprintf(stderr, "Empty frame: %d calls, %u packets\n", r.calls, r.packetCount);
+		failCount++;
+	}
+
+	klvanc_context_destroy(ctx);
+}
+
 int afd_main(int argc, char *argv[])
 {
 	struct klvanc_context_s *ctx;
@@ -167,9 +488,16 @@ int afd_main(int argc, char *argv[])
 	if (ret < 0)
 		fprintf(stderr, "AFD-1 failed to parse\n");
 
+	test_perfstats(ctx);
+
 	klvanc_context_destroy(ctx);
 	printf("Library destroyed.\n");
 
+	test_change_detection();
+	test_line_map();
+	test_filter();
+	test_frame_callback();
+
 	printf("Final result: PASS: %d/%d, Failures: %d\n",
 	       passCount, passCount + failCount, failCount);
 	if (failCount != 0)
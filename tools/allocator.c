@@ -0,0 +1,356 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <libklvanc/vanc.h>
+#include <libklvanc/vanc-lines.h>
+
+static int passCount = 0;
+static int failCount = 0;
+
+/* A counting allocator, stands in for an application pool allocator. */
+struct pool_s
+{
+	int allocs;
+	int frees;
+	int outstanding;
+};
+
+static void *pool_alloc(void *opaque, size_t size)
+{
+	struct pool_s *p = opaque;
+	void *ptr = malloc(size);
+	if (ptr) {
+		p->allocs++;
+		p->outstanding++;
+	}
+	return ptr;
+}
+
+static void *pool_realloc(void *opaque, void *ptr, size_t size)
+{
+	struct pool_s *p = opaque;
+	void *n = realloc(ptr, size);
+	if (n && !ptr) {
+		p->allocs++;
+		p->outstanding++;
+	}
+	return n;
+}
+
+static void pool_free(void *opaque, void *ptr)
+{
+	struct pool_s *p = opaque;
+	p->frees++;
+	p->outstanding--;
+	free(ptr);
+}
+
+static int scte104Count;
+
+/* CALLBACKS for message notification */
+static int cb_SCTE_104(void *callback_context, struct klvanc_context_s *ctx,
+		       struct klvanc_packet_scte_104_s *pkt)
+{
+	scte104Count++;
+	return 0;
+}
+
+static struct klvanc_callbacks_s callbacks =
+{
+	.scte_104		= cb_SCTE_104,
+};
+/* END - CALLBACKS for message notification */
+
+static unsigned short test_data_afd_1[] = {
+	0x0000, 0x03ff, 0x03ff, 0x0241, 0x0205, 0x0108, 0x0200, 0x0200,
+	0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x014e
+};
+
+static void check(int cond, const char *desc)
+{
+	printf("%s: %s\n", cond ? "PASS" : "FAIL", desc);
+	if (cond)
+		passCount++;
+	else
+		failCount++;
+}
+
+static int gen_scte104(struct klvanc_context_s *ctx, uint16_t **words, uint16_t *wordCount)
+{
+	struct klvanc_packet_scte_104_s *pkt;
+	struct klvanc_multiple_operation_message_operation *op;
+
+	if (klvanc_alloc_SCTE_104(0xffff, &pkt) < 0)
+		return -1;
+
+	if (klvanc_SCTE_104_Add_MOM_Op(pkt, MO_SPLICE_REQUEST_DATA, &op) < 0) {
+		klvanc_free_SCTE_104(pkt);
+		return -1;
+	}
+	op->sr_data.splice_insert_type = 0x02;
+	op->sr_data.splice_event_id = 0x1234;
+	op->sr_data.unique_program_id = 0x4567;
+	op->sr_data.brk_duration = 300;
+
+	int ret = klvanc_convert_SCTE_104_to_words(ctx, pkt, words, wordCount);
+	klvanc_free_SCTE_104(pkt);
+	return ret;
+}
+
+static void test_context(void)
+{
+	struct pool_s pool = { 0 };
+	struct klvanc_allocator_s allocator = {
+		.alloc = pool_alloc,
+		.realloc = pool_realloc,
+		.free = pool_free,
+		.opaque = &pool,
+	};
+	struct klvanc_context_s *ctx;
+	uint16_t *words;
+	uint16_t wordCount;
+
+	if (klvanc_context_create_with_allocator(&ctx, &allocator) < 0) {
+		check(0, "context created with allocator");
+		return;
+	}
+	ctx->callbacks = &callbacks;
+
+	check(pool.allocs >= 2, "context and decode storage came from the allocator");
+
+	int before = pool.allocs;
+	klvanc_packet_parse(ctx, 9, test_data_afd_1, sizeof(test_data_afd_1) / sizeof(unsigned short));
+	check(pool.allocs == before, "AFD decoded without allocating");
+
+	if (gen_scte104(ctx, &words, &wordCount) == 0) {
+		before = pool.allocs;
+		klvanc_packet_parse(ctx, 10, words, wordCount);
+		check(scte104Count == 1 && pool.allocs > before, "SCTE-104 operations came from the allocator");
+
+		struct klvanc_line_set_s lines = { 0 };
+		before = pool.allocs;
+		klvanc_line_insert(ctx, &lines, words, wordCount, 11, 0);
+		check(pool.allocs == before + 3, "VANC line and entry came from the allocator");
+		for (int i = 0; i < lines.num_lines; i++)
+			klvanc_line_free(lines.lines[i]);
+		free(words);
+	} else
+		check(0, "SCTE-104 generated");
+
+	klvanc_context_destroy(ctx);
+
+	printf("context: allocs %d frees %d outstanding %d\n", pool.allocs, pool.frees, pool.outstanding);
+	check(pool.outstanding == 0, "context released everything it allocated");
+}
+
+static void test_packetizer(void)
+{
+	struct pool_s pool = { 0 };
+	struct klvanc_allocator_s allocator = {
+		.alloc = pool_alloc,
+		.realloc = pool_realloc,
+		.free = pool_free,
+		.opaque = &pool,
+	};
+	struct klvanc_smpte2038_packetizer_s *p;
+	struct klvanc_packet_header_s *hdr = calloc(1, sizeof(*hdr));
+
+	if (klvanc_smpte2038_packetizer_alloc_with_allocator(&p, &allocator) < 0) {
+		check(0, "packetizer created with allocator");
+		free(hdr);
+		return;
+	}
+
+	hdr->did = 0x41;
+	hdr->dbnsdid = 0x05;
+	hdr->lineNr = 9;
+	hdr->payloadLengthWords = 8;
+	klvanc_smpte2038_packetizer_begin(p);
+	klvanc_smpte2038_packetizer_append(p, hdr);
+	klvanc_smpte2038_packetizer_end(p, 0);
+
+	struct klvanc_smpte2038_anc_data_packet_s *pkt = NULL;
+	klvanc_smpte2038_parse_pes_packet_with_allocator(p->buf, p->bufused, &pkt, &allocator);
+	check(pkt && pkt->lineCount == 1, "2038 packet parsed with allocator");
+	klvanc_smpte2038_anc_data_packet_free(pkt);
+
+	klvanc_smpte2038_packetizer_free(&p);
+	free(hdr);
+
+	printf("2038: allocs %d frees %d outstanding %d\n", pool.allocs, pool.frees, pool.outstanding);
+	check(pool.allocs > 0 && pool.outstanding == 0, "2038 objects released everything they allocated");
+}
+
+static void test_memstats(void)
+{
+	struct klvanc_context_s *ctx;
+	struct klvanc_memstats_s stats;
+	uint16_t *words;
+	uint16_t wordCount;
+
+	if (klvanc_context_create(&ctx) < 0) {
+		check(0, "context created");
+		return;
+	}
+	ctx->callbacks = &callbacks;
+
+	klvanc_context_get_memstats(ctx, &stats);
+	check(stats.subsystem[KLVANC_MEM_CORE].bytesOutstanding >= sizeof(*ctx) &&
+	      stats.total.bytesOutstanding == stats.subsystem[KLVANC_MEM_CORE].bytesOutstanding,
+	      "context accounted to core");
+
+	if (gen_scte104(ctx, &words, &wordCount) < 0) {
+		check(0, "SCTE-104 generated");
+		klvanc_context_destroy(ctx);
+		return;
+	}
+
+	klvanc_context_reset_memstats(ctx);
+	klvanc_packet_parse(ctx, 10, words, wordCount);
+	klvanc_context_get_memstats(ctx, &stats);
+	struct klvanc_memstats_subsystem_s *s = &stats.subsystem[KLVANC_MEM_SCTE104];
+	check(s->allocCount > 0 && s->allocCount == s->freeCount && s->bytesOutstanding == 0 &&
+	      s->bytesPeak > 0, "SCTE-104 allocations counted and released");
+
+	struct klvanc_line_set_s lines = { 0 };
+	klvanc_line_insert(ctx, &lines, words, wordCount, 11, 0);
+	klvanc_context_get_memstats(ctx, &stats);
+	s = &stats.subsystem[KLVANC_MEM_LINES];
+	check(s->allocCount == 3 && s->bytesOutstanding >= wordCount * sizeof(uint16_t),
+	      "VANC line accounted to lines");
+
+	struct klvanc_allocator_s allocator;
+	struct klvanc_smpte2038_packetizer_s *p;
+	klvanc_context_get_allocator(ctx, KLVANC_MEM_SMPTE2038, &allocator);
+	if (klvanc_smpte2038_packetizer_alloc_with_allocator(&p, &allocator) == 0) {
+		klvanc_context_get_memstats(ctx, &stats);
+		check(stats.subsystem[KLVANC_MEM_SMPTE2038].bytesOutstanding > 0, "2038 packetizer accounted");
+		klvanc_smpte2038_packetizer_free(&p);
+		klvanc_context_get_memstats(ctx, &stats);
+		check(stats.subsystem[KLVANC_MEM_SMPTE2038].bytesOutstanding == 0, "2038 packetizer released");
+	} else
+		check(0, "2038 packetizer created");
+
+	/* Lines may outlive the context that created them */
+	klvanc_context_destroy(ctx);
+	for (int i = 0; i < lines.num_lines; i++)
+		klvanc_line_free(lines.lines[i]);
+	check(1, "line freed after context destroyed");
+	free(words);
+}
+
+static void test_line_set(void)
+{
+	struct pool_s pool = { 0 };
+	struct klvanc_allocator_s allocator = {
+		.alloc = pool_alloc,
+		.realloc = pool_realloc,
+		.free = pool_free,
+		.opaque = &pool,
+	};
+	struct klvanc_context_s *ctx;
+	struct klvanc_line_set_s *set;
+	uint16_t *words;
+	uint16_t wordCount;
+
+	if (klvanc_context_create_with_allocator(&ctx, &allocator) < 0) {
+		check(0, "context created with allocator");
+		return;
+	}
+	ctx->callbacks = &callbacks;
+
+	if (gen_scte104(ctx, &words, &wordCount) < 0) {
+		check(0, "SCTE-104 generated");
+		klvanc_context_destroy(ctx);
+		return;
+	}
+
+	int before = pool.allocs;
+	if (klvanc_line_set_create(ctx, &set, 4 * wordCount) < 0) {
+		check(0, "pooled line set created");
+		free(words);
+		klvanc_context_destroy(ctx);
+		return;
+	}
+	check(pool.allocs == before + 1, "pooled line set is a single allocation");
+
+	before = pool.allocs;
+	int ok = 1;
+	for (int frame = 0; frame < 3; frame++) {
+		klvanc_line_set_reset(set);
+		ok &= klvanc_line_insert(ctx, set, words, wordCount, 11, 0) == 0;
+		ok &= klvanc_line_insert(ctx, set, test_data_afd_1,
+			sizeof(test_data_afd_1) / sizeof(unsigned short), 12, 0) == 0;
+		ok &= klvanc_line_insert(ctx, set, words, wordCount, 11, 100) == 0;
+		ok &= set->num_lines == 2 && set->lines[0]->line_number == 11 &&
+		      set->lines[0]->num_entries == 2 && set->lines[1]->line_number == 12;
+	}
+	check(ok, "lines recycled across frames");
+	check(pool.allocs == before, "steady state insertion does not allocate");
+
+	/* Lines and entries in a pool are left alone by the per line free */
+	klvanc_line_free(set->lines[0]);
+	check(set->lines[0]->num_entries == 2, "pooled line survives klvanc_line_free");
+
+	uint8_t v210[1920 * 16 / 6];
+	check(klvanc_generate_vanc_line_v210(ctx, set->lines[0], v210, 1920) == 0,
+	      "pooled line serialized");
+
+	klvanc_line_set_reset(set);
+	check(klvanc_line_insert(ctx, set, words, wordCount, 11, 0) == 0 &&
+	      klvanc_line_insert(ctx, set, words, wordCount, 11, 0) == 0 &&
+	      klvanc_line_insert(ctx, set, words, wordCount, 12, 0) == 0 &&
+	      klvanc_line_insert(ctx, set, words, wordCount, 13, 0) == 0 &&
+	      klvanc_line_insert(ctx, set, words, wordCount, 14, 0) == -ENOMEM,
+	      "arena exhaustion reported");
+	check(klvanc_line_insert(ctx, set, words, wordCount, KLVANC_LINE_SET_MAX_LINE_NUMBER, 0) == -EINVAL,
+	      "out of range line number rejected");
+
+	/* The set may outlive the context that created it */
+	klvanc_context_destroy(ctx);
+	klvanc_line_set_free(set);
+	free(words);
+
+	printf("line set: allocs %d frees %d outstanding %d\n", pool.allocs, pool.frees, pool.outstanding);
+	check(pool.outstanding == 0, "line set released everything it allocated");
+}
+
+int allocator_main(int argc, char *argv[])
+{
+	struct klvanc_allocator_s partial = { .alloc = pool_alloc };
+	struct klvanc_context_s *ctx;
+
+	check(klvanc_context_create_with_allocator(&ctx, &partial) == -EINVAL, "partial allocator rejected");
+
+	test_context();
+	test_packetizer();
+	test_memstats();
+	test_line_set();
+
+	printf("Final result: PASS: %d/%d, Failures: %d\n",
+	       passCount, passCount + failCount, failCount);
+	if (failCount != 0)
+		return 1;
+	return 0;
+}
@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <libklvanc/vanc.h>
+
+#define BLOCK_PACKETS 200
+
+static int passCount = 0;
+static int failCount = 0;
+
+static struct klvanc_context_s *parseCtx;
+static pthread_t parseThread;
+
+struct consumer_s
+{
+	uint64_t counters[BLOCK_PACKETS];
+	int count;
+	int onParseThread;	/* Callbacks fired inside klvanc_packet_parse() */
+	int onParseCtx;		/* Callbacks given the parsing context */
+	int slow;
+};
+
+static void check(int cond, const char *desc)
+{
+	printf("%s: %s\n", cond ? "PASS" : "FAIL", desc);
+	if (cond)
+		passCount++;
+	else
+		failCount++;
+}
+
+static int cb_counter(void *callback_context, struct klvanc_context_s *ctx,
+	struct klvanc_packet_kl_u64le_counter_s *pkt)
+{
+	struct consumer_s *c = callback_context;
+
+	if (pthread_equal(pthread_self(), parseThread))
+		c->onParseThread++;
+	if (ctx == parseCtx)
+		c->onParseCtx++;
+	if (c->count < BLOCK_PACKETS)
+		c->counters[c->count] = pkt->counter;
+	c->count++;
+
+	if (c->slow)
+		usleep(100);
+
+	return 0;
+}
+
+static struct klvanc_callbacks_s callbacks =
+{
+	.kl_i64le_counter	= cb_counter,
+};
+
+static void parse_counter(struct klvanc_context_s *ctx, uint64_t counter)
+{
+	struct klvanc_packet_kl_u64le_counter_s pkt;
+	uint16_t *words;
+	uint16_t wordCount;
+
+	memset(&pkt, 0, sizeof(pkt));
+	pkt.counter = counter;
+	if (klvanc_convert_KL_U64LE_COUNTER_to_words(&pkt, &words, &wordCount) < 0)
+		return;
+	klvanc_packet_parse(ctx, 9, words, wordCount);
+	free(words);
+}
+
+static struct klvanc_context_s *context_create(struct consumer_s *c)
+{
+	struct klvanc_context_s *ctx;
+
+	if (klvanc_context_create(&ctx) < 0)
+		return NULL;
+	ctx->callbacks = &callbacks;
+	ctx->callback_context = c;
+	ctx->log_level = LIBKLVANC_LOGLEVEL_ERR;
+	parseCtx = ctx;
+	parseThread = pthread_self();
+	memset(c, 0, sizeof(*c));
+
+	return ctx;
+}
+
+static void test_drop_newest(void)
+{
+	struct consumer_s c;
+	struct klvanc_async_params_s params;
+	struct klvanc_async_stats_s stats;
+	struct klvanc_context_s *ctx = context_create(&c);
+
+	klvanc_async_params_default(&params);
+	params.queueDepth = 4;
+	check(klvanc_context_enable_async(ctx, &params) == 0, "Enable asynchronous delivery");
+	check(klvanc_context_enable_async(ctx, &params) == -EBUSY, "Enabling twice is refused");
+
+	for (int i = 0; i < 10; i++)
+		parse_counter(ctx, i);
+	klvanc_context_get_async_stats(ctx, &stats);
+	check(c.count == 0, "No callbacks fire inside klvanc_packet_parse()");
+	check(stats.queued == 4 && stats.dropped == 6 && stats.depth == 4 && stats.highWaterMark == 4,
+	      "Full queue drops the newest packets");
+
+	int n = klvanc_async_dispatch(ctx, 0, 0);
+	check(n == 4 && c.count == 4 && c.counters[0] == 0 && c.counters[3] == 3,
+	      "Dispatch delivers the oldest packets in order");
+	check(c.onParseCtx == 0, "Callbacks receive the consumer context");
+	check(klvanc_async_dispatch(ctx, 0, 10) == 0, "Dispatch times out on an empty queue");
+
+	klvanc_context_disable_async(ctx);
+	parse_counter(ctx, 10);
+	check(c.count == 5 && c.onParseCtx == 1 && klvanc_async_dispatch(ctx, 0, 0) == -ENOENT,
+	      "Disabling returns to synchronous callbacks");
+
+	klvanc_context_destroy(ctx);
+}
+
+static void test_drop_oldest(void)
+{
+	struct consumer_s c;
+	struct klvanc_async_params_s params;
+	struct klvanc_async_stats_s stats;
+	struct klvanc_context_s *ctx = context_create(&c);
+
+	params.queueDepth = 4;
+	params.policy = KLVANC_ASYNC_DROP_OLDEST;
+	klvanc_context_enable_async(ctx, &params);
+
+	for (int i = 0; i < 10; i++)
+		parse_counter(ctx, i);
+
+	int n = 0;
+	for (int r; (r = klvanc_async_dispatch(ctx, 1, 0)) > 0; )
+		n += r;
+	klvanc_context_get_async_stats(ctx, &stats);
+	check(n == 4 && c.counters[0] == 6 && c.counters[3] == 9 && stats.dropped == 6,
+	      "Full queue drops the oldest packets");
+
+	/* Left queued, released with the context */
+	parse_counter(ctx, 10);
+	klvanc_context_destroy(ctx);
+}
+
+static void *consumer_thread(void *p)
+{
+	struct klvanc_context_s *ctx = p;
+	struct consumer_s *c = ctx->callback_context;
+
+	while (c->count < BLOCK_PACKETS) {
+		if (klvanc_async_dispatch(ctx, 8, 1000) <= 0)
+			break;
+	}
+
+	return NULL;
+}
+
+static void test_block(void)
+{
+	struct consumer_s c;
+	struct klvanc_async_params_s params;
+	struct klvanc_async_stats_s stats;
+	struct klvanc_context_s *ctx = context_create(&c);
+	pthread_t consumer;
+
+	params.queueDepth = 8;
+	params.policy = KLVANC_ASYNC_BLOCK;
+	klvanc_context_enable_async(ctx, &params);
+	c.slow = 1;
+
+	pthread_create(&consumer, NULL, consumer_thread, ctx);
+	for (int i = 0; i < BLOCK_PACKETS; i++)
+		parse_counter(ctx, i);
+	pthread_join(consumer, NULL);
+
+	int inOrder = 1;
+	for (int i = 0; i < BLOCK_PACKETS; i++)
+		if (c.counters[i] != (uint64_t)i)
+			inOrder = 0;
+	klvanc_context_get_async_stats(ctx, &stats);
+	printf("Queued %" PRIu64 ", dispatched %" PRIu64 ", blocked %" PRIu64 ", high water %u\n",
+	       stats.queued, stats.dispatched, stats.blocked, stats.highWaterMark);
+	check(c.count == BLOCK_PACKETS && inOrder && stats.dropped == 0,
+	      "Blocking policy loses nothing and keeps order");
+	check(stats.blocked > 0 && stats.highWaterMark == 8 && c.onParseThread == 0,
+	      "Parser waited on the slow consumer");
+
+	klvanc_context_destroy(ctx);
+}
+
+struct header_s
+{
+	int count;
+	unsigned int parityErrors;
+	unsigned int rawLengthWords;
+	uint16_t raw[300];
+};
+
+static int cb_all(void *callback_context, struct klvanc_context_s *ctx, struct klvanc_packet_header_s *hdr)
+{
+	struct header_s *h = callback_context;
+
+	h->count++;
+	h->parityErrors = hdr->parityErrors;
+	h->rawLengthWords = hdr->rawLengthWords;
+	memcpy(h->raw, hdr->raw, hdr->rawLengthWords * sizeof(uint16_t));
+	return 0;
+}
+
+static struct klvanc_callbacks_s allCallbacks =
+{
+	.all = cb_all,
+};
+
+/* The all callback sees the same header whichever way it is delivered */
+static void test_header_fields(void)
+{
+	struct klvanc_packet_kl_u64le_counter_s pkt;
+	struct klvanc_context_s *ctx;
+	struct header_s sync, async;
+	uint16_t *words;
+	uint16_t wordCount;
+
+	if (klvanc_context_create(&ctx) < 0) {
+		check(0, "Context created");
+		return;
+	}
+	ctx->callbacks = &allCallbacks;
+
+	memset(&pkt, 0, sizeof(pkt));
+	pkt.counter = 42;
+	if (klvanc_convert_KL_U64LE_COUNTER_to_words(&pkt, &words, &wordCount) < 0) {
+		check(0, "Counter packet created");
+		klvanc_context_destroy(ctx);
+		return;
+	}
+	/* Bit 9 is outside the checksum, so only the parity check notices */
+	words[6] ^= 0x200;
+
+	memset(&sync, 0, sizeof(sync));
+	ctx->callback_context = &sync;
+	klvanc_packet_parse(ctx, 9, words, wordCount);
+
+	memset(&async, 0, sizeof(async));
+	ctx->callback_context = &async;
+	klvanc_context_enable_async(ctx, NULL);
+	klvanc_packet_parse(ctx, 9, words, wordCount);
+	klvanc_async_dispatch(ctx, 0, 0);
+
+	check(sync.count == 1 && sync.parityErrors == 1, "Parity error reported synchronously");
+	check(async.count == 1 && async.parityErrors == 1, "Parity error carried through the queue");
+	check(async.rawLengthWords == wordCount && sync.rawLengthWords == wordCount &&
+	      memcmp(async.raw, sync.raw, wordCount * sizeof(uint16_t)) == 0,
+	      "Raw words match synchronous delivery");
+
+	free(words);
+	klvanc_context_destroy(ctx);
+}
+
+int async_main(int argc, char *argv[])
+{
+	test_drop_newest();
+	test_drop_oldest();
+	test_block();
+	test_header_fields();
+
+	printf("Final result: PASS: %d/%d, Failures: %d\n",
+	       passCount, passCount + failCount, failCount);
+	if (failCount != 0)
+		return 1;
+	return 0;
+}
@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+/* Feed a word stream to the chunk parser split every possible way and check
+ * it finds exactly what klvanc_packet_parse() finds in the whole stream.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <libklvanc/vanc.h>
+
+static int passCount = 0;
+static int failCount = 0;
+
+static void check(int cond, const char *desc)
+{
+	printf("%s: %s\n", cond ? "PASS" : "FAIL", desc);
+	if (cond)
+		passCount++;
+	else
+		failCount++;
+}
+
+#define MAX_SEEN 64
+
+struct seen_s
+{
+	uint16_t did;
+	uint16_t sdid;
+	uint16_t dc;
+	uint16_t checksum;
+	unsigned int lineNr;
+	uint16_t first;
+	uint16_t last;
+};
+
+static struct seen_s seen[MAX_SEEN];
+static int seenCount;
+static unsigned int lastOffset;
+
+static int cb_all(void *callback_context, struct klvanc_context_s *ctx, struct klvanc_packet_header_s *hdr)
+{
+	if (seenCount < MAX_SEEN) {
+		struct seen_s *s = &seen[seenCount];
+		s->did = hdr->did;
+		s->sdid = hdr->dbnsdid;
+		s->dc = hdr->payloadLengthWords;
+		s->checksum = hdr->checksum;
+		s->lineNr = hdr->lineNr;
+		s->first = hdr->payloadLengthWords ? hdr->payload[0] : 0;
+		s->last = hdr->payloadLengthWords ? hdr->payload[hdr->payloadLengthWords - 1] : 0;
+	}
+	seenCount++;
+	lastOffset = hdr->horizontalOffset;
+	return 0;
+}
+
+static struct klvanc_callbacks_s callbacks =
+{
+	.all = cb_all,
+};
+
+static uint16_t with_parity(uint8_t v)
+{
+	int ones = __builtin_popcount(v);
+	return v | ((ones & 1) ? 0x100 : 0x200);
+}
+
+/* The payload writer refuses empty packets, build that one by hand */
+static unsigned int append_empty_packet(uint16_t *stream, unsigned int pos, uint8_t did, uint8_t sdid)
+{
+	uint16_t *w = stream + pos;
+
+	w[0] = 0x000;
+	w[1] = 0x3ff;
+	w[2] = 0x3ff;
+	w[3] = with_parity(did);
+	w[4] = with_parity(sdid);
+	w[5] = with_parity(0);
+	uint16_t sum = (w[3] + w[4] + w[5]) & 0x1ff;
+	w[6] = sum | ((sum & 0x100) ? 0 : 0x200);
+	return pos + 7;
+}
+
+static unsigned int append_packet(uint16_t *stream, unsigned int pos, uint8_t did, uint8_t sdid, int byteCount)
+{
+	uint8_t buf[255];
+	uint16_t *words = NULL;
+	uint16_t wordCount = 0;
+
+	for (int i = 0; i < byteCount; i++)
+		buf[i] = (uint8_t)(i * 7 + did);
+	if (klvanc_sdi_create_payload(sdid, did, buf, byteCount, &words, &wordCount, 10) < 0)
+		return pos;
+	memcpy(stream + pos, words, wordCount * sizeof(uint16_t));
+	free(words);
+	return pos + wordCount;
+}
+
+static unsigned int append_words(uint16_t *stream, unsigned int pos, const uint16_t *words, int count)
+{
+	memcpy(stream + pos, words, count * sizeof(uint16_t));
+	return pos + count;
+}
+
+/* Packets of every size of interest, black level and ADF lookalikes between them */
+static unsigned int build_stream(uint16_t *stream)
+{
+	static const uint16_t black[] = { 0x040, 0x040, 0x040 };
+	static const uint16_t decoy[] = { 0x000, 0x3ff, 0x040, 0x000, 0x000, 0x3ff, 0x200 };
+	unsigned int pos = 0;
+
+	pos = append_words(stream, pos, black, 3);
+	pos = append_packet(stream, pos, 0x41, 0x05, 8);
+	pos = append_empty_packet(stream, pos, 0x61, 0x01);
+	pos = append_words(stream, pos, decoy, 7);
+	pos = append_packet(stream, pos, 0x50, 0x22, 255);
+	pos = append_packet(stream, pos, 0x60, 0x60, 1);
+	pos = append_words(stream, pos, black, 3);
+	pos = append_packet(stream, pos, 0x45, 0x01, 17);
+	pos = append_packet(stream, pos, 0x41, 0x07, 120);
+	pos = append_words(stream, pos, black, 3);
+	return pos;
+}
+
+static int same(const struct seen_s *a, int aCount, const struct seen_s *b, int bCount)
+{
+	if (aCount != bCount)
+		return 0;
+	return memcmp(a, b, aCount * sizeof(*a)) == 0;
+}
+
+/* Push the stream cut at the given sizes, cycling through them */
+static int push_chunks(struct klvanc_chunk_parser_s *p, const uint16_t *stream, unsigned int len,
+		       const unsigned int *sizes, int sizeCount)
+{
+	unsigned int pos = 0;
+	int packets = 0;
+
+	for (int i = 0; pos < len; i++) {
+		unsigned int n = sizes[i % sizeCount];
+		if (n > len - pos)
+			n = len - pos;
+		int ret = klvanc_chunk_parser_push(p, 10, stream + pos, n);
+		if (ret < 0)
+			return ret;
+		packets += ret;
+		pos += n;
+	}
+	return packets;
+}
+
+static void test_splits(struct klvanc_context_s *ctx, struct klvanc_chunk_parser_s *p,
+			const uint16_t *stream, unsigned int len,
+			const struct seen_s *ref, int refCount)
+{
+	unsigned int sizes[2];
+	int ok = 1;
+
+	/* Fixed chunk sizes, one word at a time up to the whole stream */
+	for (unsigned int size = 1; size <= len && ok; size++) {
+		seenCount = 0;
+		sizes[0] = size;
+		int ret = push_chunks(p, stream, len, sizes, 1);
+		if (ret != refCount || !same(seen, seenCount, ref, refCount)) {
+			printf("chunk size %d: %d packets, expected %d\n", size, seenCount, refCount);
+			ok = 0;
+		}
+	}
+	check(ok, "every fixed chunk size finds the same packets");
+
+	/* Two chunks, cut at every word */
+	ok = 1;
+	for (unsigned int cut = 0; cut <= len && ok; cut++) {
+		seenCount = 0;
+		int ret = klvanc_chunk_parser_push(p, 10, stream, cut);
+		ret += klvanc_chunk_parser_push(p, 10, stream + cut, len - cut);
+		if (ret != refCount || !same(seen, seenCount, ref, refCount)) {
+			printf("cut at %d: %d packets, expected %d\n", cut, seenCount, refCount);
+			ok = 0;
+		}
+	}
+	check(ok, "every two way cut finds the same packets");
+
+	/* Irregular chunks, including empty ones */
+	ok = 1;
+	srand(1234);
+	for (int run = 0; run < 200 && ok; run++) {
+		unsigned int random[16];
+		for (int i = 0; i < 16; i++)
+			random[i] = rand() % 40;
+		random[run % 16] = 1;
+		seenCount = 0;
+		int ret = push_chunks(p, stream, len, random, 16);
+		if (ret != refCount || !same(seen, seenCount, ref, refCount)) {
+			printf("irregular run %d: %d packets, expected %d\n", run, seenCount, refCount);
+			ok = 0;
+		}
+	}
+	check(ok, "irregular chunk sizes find the same packets");
+}
+
+static void test_reset(struct klvanc_chunk_parser_s *p, const uint16_t *stream, unsigned int len)
+{
+	struct klvanc_chunk_parser_stats_s before, after;
+	uint16_t packet[32];
+	unsigned int count = append_packet(packet, 0, 0x41, 0x05, 8);
+
+	klvanc_chunk_parser_get_stats(p, &before);
+	check(klvanc_chunk_parser_reset(p) == 0, "reset between packets drops nothing");
+
+	seenCount = 0;
+	klvanc_chunk_parser_push(p, 10, packet, 6);
+	check(klvanc_chunk_parser_reset(p) == 1, "reset drops the partial packet");
+	check(klvanc_chunk_parser_push(p, 10, packet + 6, count - 6) == 0 && seenCount == 0,
+	      "words after a reset are not joined to the dropped packet");
+
+	check(klvanc_chunk_parser_push(p, 10, packet, count) == 1 && seenCount == 1,
+	      "parser recovers on the next packet");
+
+	klvanc_chunk_parser_get_stats(p, &after);
+	check(after.dropped == before.dropped + 1 && after.packets == before.packets + 1,
+	      "statistics count the drop");
+}
+
+/* An ADF lookalike ending one chunk, a real packet starting the next */
+static void test_false_start(struct klvanc_chunk_parser_s *p)
+{
+	static const uint16_t tail[] = { 0x040, 0x040, 0x000, 0x3ff };
+	uint16_t packet[32];
+	unsigned int count = append_packet(packet, 0, 0x41, 0x05, 8);
+
+	seenCount = 0;
+	klvanc_chunk_parser_push(p, 10, tail, 4);
+	check(klvanc_chunk_parser_push(p, 11, packet, count) == 1 && seenCount == 1,
+	      "packet after a false start found");
+	check(seen[0].lineNr == 11 && lastOffset == 0, "packet reported where it starts, not on the false start");
+}
+
+static void test_filter(struct klvanc_context_s *ctx, const uint16_t *stream, unsigned int len, int refCount)
+{
+	struct klvanc_chunk_parser_s *p;
+	struct klvanc_chunk_parser_stats_s stats;
+	unsigned int sizes[1] = { 5 };
+
+	klvanc_context_set_filter_mode(ctx, KLVANC_FILTER_DENY);
+	klvanc_context_filter_add(ctx, 0x50, 0x22);
+
+	klvanc_chunk_parser_create(ctx, &p);
+	seenCount = 0;
+	int ret = push_chunks(p, stream, len, sizes, 1);
+	klvanc_chunk_parser_get_stats(p, &stats);
+	check(ret == refCount - 1 && seenCount == refCount - 1 && stats.filtered == 1,
+	      "filtered packet straddling chunks is stepped over");
+	klvanc_chunk_parser_destroy(p);
+
+	klvanc_context_set_filter_mode(ctx, KLVANC_FILTER_NONE);
+}
+
+int chunk_main(int argc, char *argv[])
+{
+	struct klvanc_context_s *ctx;
+	struct klvanc_chunk_parser_s *p;
+	struct seen_s ref[MAX_SEEN];
+	uint16_t stream[1024];
+
+	if (klvanc_context_create(&ctx) < 0) {
+		fprintf(stderr, "Error initializing library context\n");
+		exit(1);
+	}
+	ctx->callbacks = &callbacks;
+
+	unsigned int len = build_stream(stream);
+
+	/* The line parser over the whole stream is the reference */
+	seenCount = 0;
+	klvanc_packet_parse(ctx, 10, stream, len);
+	int refCount = seenCount;
+	memcpy(ref, seen, sizeof(ref));
+	check(refCount == 6, "reference parse finds every packet");
+
+	check(klvanc_chunk_parser_create(ctx, &p) == 0, "parser created");
+	check(klvanc_chunk_parser_push(p, 10, NULL, 0) == 0, "empty chunk accepted");
+	check(klvanc_chunk_parser_push(p, 10, NULL, 4) == -EINVAL, "missing words rejected");
+
+	seenCount = 0;
+	check(klvanc_chunk_parser_push(p, 10, stream, len) == refCount &&
+	      same(seen, seenCount, ref, refCount), "whole stream in one chunk");
+
+	test_splits(ctx, p, stream, len, ref, refCount);
+
+	struct klvanc_chunk_parser_stats_s stats;
+	klvanc_chunk_parser_get_stats(p, &stats);
+	check(stats.carried > 0 && stats.dropped == 0 && stats.filtered == 0, "straddling packets counted");
+
+	test_reset(p, stream, len);
+	test_false_start(p);
+	klvanc_chunk_parser_destroy(p);
+
+	test_filter(ctx, stream, len, refCount);
+
+	klvanc_context_destroy(ctx);
+
+	printf("Final result: PASS: %d/%d, Failures: %d\n",
+	       passCount, passCount + failCount, failCount);
+	if (failCount != 0)
+		return 1;
+	return 0;
+}
@@ -0,0 +1,290 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#define _GNU_SOURCE /* sched_getcpu() */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <sched.h>
+#include <libklvanc/vanc.h>
+
+#define CHANNEL_COUNT 8
+#define CHANNEL_FRAMES 500
+
+static int passCount = 0;
+static int failCount = 0;
+
+struct channel_s
+{
+	struct klvanc_engine_channel_s *ch;
+	uint64_t expected;
+	int outOfOrder;
+	int wrongCpu;
+	int block;	/* Callbacks spin while set */
+	int blocking;	/* Set by a callback that is spinning */
+};
+
+static void check(int cond, const char *desc)
+{
+	printf("%s: %s\n", cond ? "PASS" : "FAIL", desc);
+	if (cond)
+		passCount++;
+	else
+		failCount++;
+}
+
+static int cb_counter(void *callback_context, struct klvanc_context_s *ctx,
+	struct klvanc_packet_kl_u64le_counter_s *pkt)
+{
+	struct channel_s *c = callback_context;
+
+	if (pkt->counter != c->expected)
+		c->outOfOrder++;
+	c->expected = pkt->counter + 1;
+
+#if defined(__linux__)
+	if (c->wrongCpu >= 0 && sched_getcpu() != 0)
+		c->wrongCpu++;
+#endif
+
+	while (__atomic_load_n(&c->block, __ATOMIC_ACQUIRE)) {
+		__atomic_store_n(&c->blocking, 1, __ATOMIC_RELEASE);
+		usleep(1000);
+	}
+
+	return 0;
+}
+
+static struct klvanc_callbacks_s callbacks =
+{
+	.kl_i64le_counter	= cb_counter,
+};
+
+/* A frame of two lines, a counter packet on line 9 and an empty line 10 */
+static int submit_frame(struct channel_s *c, uint64_t counter)
+{
+	static unsigned short empty[64];
+	struct klvanc_packet_kl_u64le_counter_s pkt;
+	uint16_t *words;
+	uint16_t wordCount;
+
+	memset(&pkt, 0, sizeof(pkt));
+	pkt.counter = counter;
+	if (klvanc_convert_KL_U64LE_COUNTER_to_words(&pkt, &words, &wordCount) < 0)
+		return -1;
+
+	struct klvanc_engine_line_s lines[] = {
+		{ 9, words, wordCount },
+		{ 10, empty, 64 },
+	};
+	int ret = klvanc_engine_submit(c->ch, lines, 2);
+	free(words);
+
+	return ret;
+}
+
+static void test_ordering(struct klvanc_context_s *ctx)
+{
+	struct klvanc_engine_s *engine;
+	struct klvanc_engine_params_s params;
+	struct klvanc_engine_stats_s stats;
+	struct channel_s chans[CHANNEL_COUNT];
+
+	klvanc_engine_params_default(&params);
+	params.workerCount = 3;
+	params.queueDepth = 16;
+	if (klvanc_engine_alloc(&engine, &params) < 0) {
+		check(0, "Create an engine");
+		return;
+	}
+
+	memset(chans, 0, sizeof(chans));
+	int added = 1;
+	for (int i = 0; i < CHANNEL_COUNT; i++) {
+		chans[i].wrongCpu = -1;
+		if (klvanc_engine_channel_add(engine, ctx, &chans[i], &chans[i].ch) < 0)
+			added = 0;
+	}
+	check(added, "Add a channel per input");
+
+	/* Interleave channels the way concurrent capture threads would, retrying when a queue fills */
+	int submitted = 1;
+	for (uint64_t f = 0; f < CHANNEL_FRAMES && submitted; f++) {
+		for (int i = 0; i < CHANNEL_COUNT; i++) {
+			int ret;
+			while ((ret = submit_frame(&chans[i], f)) == -EAGAIN)
+				sched_yield();
+			if (ret < 0)
+				submitted = 0;
+		}
+	}
+	check(submitted, "Submit every frame");
+
+	int inOrder = 1;
+	for (int i = 0; i < CHANNEL_COUNT; i++) {
+		klvanc_engine_channel_flush(chans[i].ch);
+		if (chans[i].outOfOrder || chans[i].expected != CHANNEL_FRAMES)
+			inOrder = 0;
+	}
+	check(inOrder, "Every channel's callbacks arrive complete and in order");
+
+	klvanc_engine_get_stats(engine, &stats);
+	printf("Submitted %" PRIu64 ", rejected %" PRIu64 ", processed %" PRIu64 ", steals %" PRIu64 "\n",
+	       stats.framesSubmitted, stats.framesRejected, stats.framesProcessed, stats.steals);
+	check(stats.framesSubmitted == CHANNEL_COUNT * CHANNEL_FRAMES &&
+	      stats.framesProcessed == stats.framesSubmitted, "Engine counters add up");
+
+	/* Each channel parses with its own stream */
+	struct klvanc_stream_s *s0 = klvanc_engine_channel_get_stream(chans[0].ch);
+	struct klvanc_stream_s *s1 = klvanc_engine_channel_get_stream(chans[1].ch);
+	check(s0 && s1 && s0 != s1 && klvanc_stream_get_parent(s0) == ctx, "Channels own separate streams");
+
+	check(klvanc_engine_channel_remove(chans[0].ch) == 0, "Remove a channel");
+
+	/* The rest are removed by the engine */
+	klvanc_engine_free(engine);
+}
+
+static void test_blocked_channel(struct klvanc_context_s *ctx)
+{
+	struct klvanc_engine_s *engine;
+	struct klvanc_engine_params_s params;
+	struct channel_s chans[3];
+
+	klvanc_engine_params_default(&params);
+	params.workerCount = 2;
+	params.queueDepth = 4;
+	if (klvanc_engine_alloc(&engine, &params) < 0) {
+		check(0, "Create an engine");
+		return;
+	}
+
+	memset(chans, 0, sizeof(chans));
+	for (int i = 0; i < 3; i++) {
+		chans[i].wrongCpu = -1;
+		klvanc_engine_channel_add(engine, ctx, &chans[i], &chans[i].ch);
+	}
+
+	/* Wedge a worker inside channel 0's callback */
+	chans[0].block = 1;
+	submit_frame(&chans[0], 0);
+	while (!__atomic_load_n(&chans[0].blocking, __ATOMIC_ACQUIRE))
+		usleep(1000);
+
+	/* The frame being parsed holds one of the four slots */
+	int ret = 0;
+	for (int f = 1; f <= 3 && ret == 0; f++)
+		ret = submit_frame(&chans[0], f);
+	check(ret == 0 && submit_frame(&chans[0], 4) == -EAGAIN, "Full channel queue rejects without blocking");
+
+	/* Channels 1 and 2 are homed on different workers, so one of them shares
+	 * the stuck worker and only progresses if the other worker takes it.
+	 */
+	for (int f = 0; f < 20; f++) {
+		while (submit_frame(&chans[1], f) == -EAGAIN)
+			sched_yield();
+		while (submit_frame(&chans[2], f) == -EAGAIN)
+			sched_yield();
+	}
+	klvanc_engine_channel_flush(chans[1].ch);
+	klvanc_engine_channel_flush(chans[2].ch);
+	check(chans[1].expected == 20 && chans[2].expected == 20 && !chans[1].outOfOrder &&
+	      !chans[2].outOfOrder, "Other channels progress while one is stuck");
+
+	__atomic_store_n(&chans[0].block, 0, __ATOMIC_RELEASE);
+	klvanc_engine_channel_flush(chans[0].ch);
+	check(chans[0].expected == 4 && !chans[0].outOfOrder, "Stuck channel catches up in order");
+
+	klvanc_engine_free(engine);
+}
+
+static void test_pinning(struct klvanc_context_s *ctx)
+{
+#if defined(__linux__)
+	struct klvanc_engine_s *engine;
+	struct klvanc_engine_params_s params;
+	struct channel_s chan;
+	int cpus[] = { 0 };
+
+	klvanc_engine_params_default(&params);
+	params.workerCount = 2;
+	params.pin = KLVANC_ENGINE_PIN_EACH;
+	params.cpus = cpus;
+	params.cpuCount = 1;
+	if (klvanc_engine_alloc(&engine, &params) < 0) {
+		check(0, "Create an engine pinned to CPU 0");
+		return;
+	}
+
+	memset(&chan, 0, sizeof(chan));
+	klvanc_engine_channel_add(engine, ctx, &chan, &chan.ch);
+	for (int f = 0; f < 20; f++) {
+		while (submit_frame(&chan, f) == -EAGAIN)
+			sched_yield();
+	}
+	klvanc_engine_channel_flush(chan.ch);
+	check(chan.expected == 20 && chan.wrongCpu == 0, "Pinned workers only run on their CPU");
+
+	klvanc_engine_free(engine);
+#endif
+
+	struct klvanc_engine_params_s bad;
+	struct klvanc_engine_s *engine2;
+	klvanc_engine_params_default(&bad);
+	bad.pin = KLVANC_ENGINE_PIN_SET;
+	check(klvanc_engine_alloc(&engine2, &bad) == -EINVAL, "Pinning without CPUs is refused");
+}
+
+int engine_main(int argc, char *argv[])
+{
+	struct klvanc_context_s *ctx;
+	struct klvanc_memstats_s before, mem;
+
+	if (klvanc_context_create(&ctx) < 0) {
+		fprintf(stderr, "Error initializing library context\n");
+		exit(1);
+	}
+	ctx->callbacks = &callbacks;
+	ctx->log_level = LIBKLVANC_LOGLEVEL_ERR;
+
+	klvanc_context_get_memstats(ctx, &before);
+
+	test_ordering(ctx);
+	test_blocked_channel(ctx);
+	test_pinning(ctx);
+
+	klvanc_context_get_memstats(ctx, &mem);
+	check(mem.subsystem[KLVANC_MEM_CORE].bytesOutstanding == before.subsystem[KLVANC_MEM_CORE].bytesOutstanding &&
+	      mem.subsystem[KLVANC_MEM_CORE].allocCount > before.subsystem[KLVANC_MEM_CORE].allocCount &&
+	      mem.subsystem[KLVANC_MEM_LINES].allocCount == 0,
+	      "Channel frame memory charged to the context and released");
+
+	klvanc_context_destroy(ctx);
+
+	printf("Final result: PASS: %d/%d, Failures: %d\n",
+	       passCount, passCount + failCount, failCount);
+	if (failCount != 0)
+		return 1;
+	return 0;
+}
@@ -33,6 +33,16 @@ extern int gensmpte2038_main(int argc, char *argv[]);
 extern int eia708_main(int argc, char *argv[]);
 extern int smpte12_2_main(int argc, char *argv[]);
 extern int afd_main(int argc, char *argv[]);
+extern int recorder_main(int argc, char *argv[]);
+extern int allocator_main(int argc, char *argv[]);
+extern int stats_main(int argc, char *argv[]);
+extern int shm_main(int argc, char *argv[]);
+extern int stream_main(int argc, char *argv[]);
+extern int engine_main(int argc, char *argv[]);
+extern int async_main(int argc, char *argv[]);
+extern int lines_main(int argc, char *argv[]);
+extern int smpte352_main(int argc, char *argv[]);
+extern int chunk_main(int argc, char *argv[]);
 
 typedef int (*func_ptr)(int, char *argv[]);
 
@@ -51,6 +61,16 @@ int main(int argc, char *argv[])
 		{ "klvanc_gensmpte2038",	gensmpte2038_main, },
 		{ "klvanc_smpte12_2",		smpte12_2_main, },
 		{ "klvanc_afd",			afd_main, },
+		{ "klvanc_recorder",		recorder_main, },
+		{ "klvanc_allocator",		allocator_main, },
+		{ "klvanc_stats",		stats_main, },
+		{ "klvanc_shm",			shm_main, },
+		{ "klvanc_stream",		stream_main, },
+		{ "klvanc_engine",		engine_main, },
+		{ "klvanc_async",		async_main, },
+		{ "klvanc_lines",		lines_main, },
+		{ "klvanc_smpte352",		smpte352_main, },
+		{ "klvanc_chunk",		chunk_main, },
 		{ 0, 0 },
 	};
 	char *appname = basename(argv[0]);
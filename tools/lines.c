@@ -0,0 +1,883 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <libklvanc/vanc.h>
+#include <libklvanc/vanc-lines.h>
+#include <libklvanc/pixels.h>
+
+static int passCount = 0;
+static int failCount = 0;
+
+static void check(int cond, const char *desc)
+{
+	printf("%s: %s\n", cond ? "PASS" : "FAIL", desc);
+	if (cond)
+		passCount++;
+	else
+		failCount++;
+}
+
+/* A packet with a payload of byteCount bytes counting up from seed */
+static uint16_t *make_packet(uint8_t did, uint8_t sdid, int byteCount, int seed, uint16_t *wordCount)
+{
+	uint8_t buf[255];
+	uint16_t *words = NULL;
+
+	for (int i = 0; i < byteCount; i++)
+		buf[i] = seed + i;
+	if (klvanc_sdi_create_payload(sdid, did, buf, byteCount, &words, wordCount, 10) < 0)
+		return NULL;
+	return words;
+}
+
+struct packets_s
+{
+	uint16_t *words[4];
+	uint16_t count[4];
+	int offset[4];
+};
+
+static int packets_alloc(struct packets_s *p)
+{
+	/* Deliberately out of offset order, and with lengths that straddle v210 groups */
+	static const int bytes[4] = { 7, 13, 31, 2 };
+	static const int offsets[4] = { 200, 0, 100, 100 };
+
+	memset(p, 0, sizeof(*p));
+	for (int i = 0; i < 4; i++) {
+		p->words[i] = make_packet(0x41 + i, 0x05, bytes[i], i * 17, &p->count[i]);
+		if (!p->words[i])
+			return -1;
+		p->offset[i] = offsets[i];
+	}
+	return 0;
+}
+
+static void packets_free(struct packets_s *p)
+{
+	for (int i = 0; i < 4; i++)
+		free(p->words[i]);
+}
+
+static int line_fill(struct klvanc_context_s *ctx, struct klvanc_line_set_s *set,
+		     const struct packets_s *p, int lineNr)
+{
+	for (int i = 0; i < 4; i++)
+		if (klvanc_line_insert(ctx, set, p->words[i], p->count[i], lineNr, p->offset[i]) < 0)
+			return -1;
+	return 0;
+}
+
+static void lines_free(struct klvanc_line_set_s *set)
+{
+	for (int i = 0; i < set->num_lines; i++)
+		klvanc_line_free(set->lines[i]);
+	memset(set, 0, sizeof(*set));
+}
+
+/* The in place generators must match the allocating generator word for word */
+static void test_matches_legacy(struct klvanc_context_s *ctx, const struct packets_s *p, int width)
+{
+	struct klvanc_line_set_s set = { 0 };
+	uint16_t *legacy = NULL;
+	int legacyLen = 0;
+	char desc[64];
+
+	if (line_fill(ctx, &set, p, 9) < 0) {
+		check(0, "line filled");
+		return;
+	}
+
+	struct klvanc_line_s *line = set.lines[0];
+	check(line->p_entries[0]->h_offset == 0 && line->p_entries[1]->h_offset == 100 &&
+	      memcmp(line->p_entries[1]->payload, p->words[2], p->count[2] * sizeof(uint16_t)) == 0 &&
+	      line->p_entries[3]->h_offset == 200, "entries kept in offset order, ties in insertion order");
+
+	uint16_t *words = calloc(width, sizeof(uint16_t));
+	uint8_t *v210 = calloc(width * 16 / 6 + 16, 1);
+	uint8_t *expect = calloc(width * 16 / 6 + 16, 1);
+	int len = -1;
+
+	check(klvanc_generate_vanc_line_inplace(ctx, line, words, &len, width) == 0, "in place line generated");
+	check(klvanc_generate_vanc_line_v210(ctx, line, v210, width) == 0, "v210 line generated");
+
+	/* The allocating generator rewrites the entries, so it runs last */
+	klvanc_generate_vanc_line(ctx, line, &legacy, &legacyLen, width);
+	if (width > 720)
+		klvanc_y10_to_v210(legacy, expect, legacyLen);
+	else
+		klvanc_uyvy_to_v210(legacy, expect, legacyLen);
+
+	snprintf(desc, sizeof(desc), "%d wide: 16-bit output matches", width);
+	check(len == legacyLen && memcmp(words, legacy, len * sizeof(uint16_t)) == 0, desc);
+	snprintf(desc, sizeof(desc), "%d wide: v210 output matches", width);
+	check(memcmp(v210, expect, width * 16 / 6 + 16) == 0, desc);
+
+	free(legacy);
+	free(words);
+	free(v210);
+	free(expect);
+	lines_free(&set);
+}
+
+static void test_rejects(struct klvanc_context_s *ctx, const struct packets_s *p)
+{
+	struct klvanc_line_set_s set = { 0 };
+	uint16_t out[64];
+	int len;
+
+	/* Packet 0 carries an illegal word, packet 2 will not fit after packet 1 */
+	uint16_t *bad = malloc(p->count[0] * sizeof(uint16_t));
+	memcpy(bad, p->words[0], p->count[0] * sizeof(uint16_t));
+	bad[6] = 0x3ff;
+
+	klvanc_line_insert(ctx, &set, bad, p->count[0], 9, 0);
+	klvanc_line_insert(ctx, &set, p->words[1], p->count[1], 9, 10);
+	klvanc_line_insert(ctx, &set, p->words[2], p->count[2], 9, 20);
+	klvanc_line_insert(ctx, &set, p->words[3], p->count[3], 9, 30);
+
+	int width = p->count[1] + p->count[3] + 1;
+	for (int i = 0; i < 64; i++)
+		out[i] = 0xffff;
+	klvanc_generate_vanc_line_inplace(ctx, set.lines[0], out, &len, width);
+	check(len == p->count[1] + p->count[3] &&
+	      memcmp(out, p->words[1], p->count[1] * sizeof(uint16_t)) == 0 &&
+	      memcmp(out + p->count[1], p->words[3], p->count[3] * sizeof(uint16_t)) == 0,
+	      "illegal and overflowing entries skipped");
+	check(out[len] == 0xffff, "nothing written past the generated words");
+	check(set.lines[0]->p_entries[0]->pixel_width == p->count[0], "line left unmodified");
+
+	free(bad);
+	lines_free(&set);
+}
+
+static void test_pooled(struct klvanc_context_s *ctx, const struct packets_s *p)
+{
+	struct klvanc_line_set_s *set;
+	struct klvanc_memstats_s before, after;
+	uint8_t v210[1920 * 16 / 6];
+	int ok = 1;
+
+	if (klvanc_line_set_create(ctx, &set, 0) < 0) {
+		check(0, "pooled line set created");
+		return;
+	}
+
+	klvanc_context_get_memstats(ctx, &before);
+	for (int frame = 0; frame < 100; frame++) {
+		klvanc_line_set_reset(set);
+		ok &= line_fill(ctx, set, p, 9) == 0 && line_fill(ctx, set, p, 10) == 0;
+		for (int i = 0; i < set->num_lines; i++)
+			ok &= klvanc_generate_vanc_line_v210(ctx, set->lines[i], v210, 1920) == 0;
+	}
+	klvanc_context_get_memstats(ctx, &after);
+	check(ok, "pooled frames generated");
+	check(after.total.allocCount == before.total.allocCount, "steady state generation does not allocate");
+
+	klvanc_line_set_free(set);
+}
+
+static const struct klvanc_video_format_s fmt1080i = {
+	.name = "1080i",
+	.width = 1920,
+	.height = 1080,
+	.lineCount = 1125,
+	.interlaced = 1,
+	.vanc = { { 1, 20 }, { 561, 583 } },
+	.packetLine = { 11, 574 },
+};
+
+/* What a composed frame parses back to */
+struct found_s
+{
+	int count;
+	int onLine[1125];
+	int afdLine, vitc1Line, vitc2Line;
+};
+
+static int cb_all(void *callback_context, struct klvanc_context_s *ctx, struct klvanc_packet_header_s *hdr)
+{
+	struct found_s *f = callback_context;
+
+	f->count++;
+	if (hdr->lineNr < 1125)
+		f->onLine[hdr->lineNr]++;
+	if (hdr->did == 0x41 && hdr->dbnsdid == 0x05)
+		f->afdLine = hdr->lineNr;
+	if (hdr->did == 0x60 && hdr->dbnsdid == 0x60) {
+		if (hdr->lineNr < 500)
+			f->vitc1Line = hdr->lineNr;
+		else
+			f->vitc2Line = hdr->lineNr;
+	}
+	return 0;
+}
+
+static struct klvanc_callbacks_s parseCallbacks =
+{
+	.all = cb_all,
+};
+
+static void parse_region(const struct klvanc_video_format_s *fmt, const uint8_t *vanc, uint32_t stride,
+			 struct found_s *found)
+{
+	struct klvanc_context_s *ctx;
+
+	memset(found, 0, sizeof(*found));
+	if (klvanc_context_create(&ctx) < 0)
+		return;
+	ctx->callbacks = &parseCallbacks;
+	ctx->callback_context = found;
+
+	klvanc_frame_parse_v210(ctx, fmt, vanc, stride);
+
+	klvanc_context_destroy(ctx);
+}
+
+static uint16_t *make_timecode(struct klvanc_context_s *ctx, uint8_t dbb1, uint16_t *wordCount)
+{
+	struct klvanc_packet_smpte_12_2_s *pkt;
+	uint16_t *words = NULL;
+
+	if (klvanc_alloc_SMPTE_12_2(&pkt) < 0)
+		return NULL;
+	pkt->dbb1 = dbb1;
+	pkt->hours = 1;
+	pkt->minutes = 2;
+	pkt->seconds = 3;
+	pkt->frames = 4;
+	if (klvanc_convert_SMPTE_12_2_to_words(ctx, pkt, &words, wordCount) < 0)
+		words = NULL;
+	free(pkt);
+	return words;
+}
+
+static void test_compose(struct klvanc_context_s *ctx, const struct packets_s *p)
+{
+	const struct klvanc_video_format_s *fmt = &fmt1080i;
+	struct klvanc_compose_packet_s packets[100];
+	struct klvanc_compose_params_s params;
+	struct found_s found;
+	uint16_t vitc1Count, vitc2Count;
+	unsigned int count = 0;
+
+	uint16_t *vitc1 = make_timecode(ctx, KLVANC_ATC_VITC1, &vitc1Count);
+	uint16_t *vitc2 = make_timecode(ctx, KLVANC_ATC_VITC2, &vitc2Count);
+	if (!vitc1 || !vitc2) {
+		check(0, "timecode packets created");
+		free(vitc1);
+		free(vitc2);
+		return;
+	}
+
+	memset(packets, 0, sizeof(packets));
+	packets[count++] = (struct klvanc_compose_packet_s){ .words = vitc2, .wordCount = vitc2Count };
+	packets[count++] = (struct klvanc_compose_packet_s){ .words = p->words[0], .wordCount = p->count[0] };
+	packets[count++] = (struct klvanc_compose_packet_s){ .words = vitc1, .wordCount = vitc1Count };
+	packets[count++] = (struct klvanc_compose_packet_s){ .words = p->words[2], .wordCount = p->count[2], .lineNr = 15 };
+
+	uint32_t stride = klvanc_video_format_v210_stride(fmt);
+	uint32_t rows = klvanc_video_format_vanc_rows(fmt);
+	check(stride == 5120 && rows == 43, "1080i VANC region geometry");
+
+	size_t size = (size_t)stride * rows;
+	uint8_t *single = malloc(size);
+	uint8_t *threaded = malloc(size);
+	memset(single, 0xaa, size);
+	memset(threaded, 0x55, size);
+
+	klvanc_compose_params_default(&params);
+	check(klvanc_frame_compose(ctx, fmt, packets, count, single, 0, &params) == 0, "frame composed");
+
+	parse_region(fmt, single, stride, &found);
+	check(found.count == 4, "every packet parsed back");
+	check(found.vitc1Line == 9 && found.vitc2Line == 571, "timecode placed by payload type");
+	check(found.afdLine == 11, "other packets on the format's packet line");
+	check(found.onLine[15] == 1, "explicit line honoured");
+
+	uint8_t black[16];
+	memcpy(black, single, 16);
+	check(black[0] == 0x00 && black[1] == 0x02 && black[2] == 0x01 && black[3] == 0x20 &&
+	      memcmp(single + (size_t)(klvanc_video_format_vanc_row(fmt, 11) + 1) * stride - 16, black, 16) == 0,
+	      "empty rows and the tail of packet rows blanked");
+
+	params.threads = 4;
+	check(klvanc_frame_compose(ctx, fmt, packets, count, threaded, 0, &params) == 0 &&
+	      memcmp(single, threaded, size) == 0, "threaded compose matches single threaded");
+
+	/* Enough packets to spill over several lines, then too many for the field */
+	uint16_t bigCount;
+	uint16_t *big = make_packet(0x62, 0x01, 250, 0, &bigCount);
+	for (count = 0; count < 20; count++)
+		packets[count] = (struct klvanc_compose_packet_s){ .words = big, .wordCount = bigCount };
+	check(klvanc_frame_compose(ctx, fmt, packets, count, threaded, 0, &params) == 0, "crowded frame composed");
+	parse_region(fmt, threaded, stride, &found);
+	check(found.count == 20 && found.onLine[11] && found.onLine[12], "packets spill to the following lines");
+
+	int perLine = found.onLine[11];
+	for (count = 0; count < 100; count++)
+		packets[count] = (struct klvanc_compose_packet_s){ .words = big, .wordCount = bigCount };
+	int ret = klvanc_frame_compose(ctx, fmt, packets, count, threaded, 0, &params);
+	parse_region(fmt, threaded, stride, &found);
+	check(ret == -ENOSPC && perLine == 1920 / bigCount && found.count == perLine * 10,
+	      "overflowing field reported, the rest kept");
+
+	struct klvanc_memstats_s before, after;
+	klvanc_context_get_memstats(ctx, &before);
+	for (int i = 0; i < 100; i++)
+		klvanc_frame_compose(ctx, fmt, packets, 4, threaded, 0, &params);
+	klvanc_context_get_memstats(ctx, &after);
+	check(after.total.allocCount == before.total.allocCount, "steady state compose does not allocate");
+
+	free(single);
+	free(threaded);
+	free(big);
+	free(vitc1);
+	free(vitc2);
+}
+
+static void test_line_cache(struct klvanc_context_s *ctx, const struct packets_s *p)
+{
+	struct klvanc_line_set_s *set;
+	struct klvanc_line_cache_s *cache;
+	struct klvanc_line_cache_stats_s stats;
+	size_t size = 1920 * 16 / 6;
+	uint8_t *expect = calloc(1, size);
+	uint8_t *got = calloc(1, size);
+	uint16_t *a = malloc(1920 * 3 * sizeof(uint16_t));
+	uint16_t *b = malloc(1920 * 3 * sizeof(uint16_t));
+
+	if (klvanc_line_set_create(ctx, &set, 0) < 0 || klvanc_line_cache_alloc(ctx, &cache) < 0) {
+		check(0, "line set and cache created");
+		return;
+	}
+
+	line_fill(ctx, set, p, 9);
+	int len = p->count[0] + p->count[1] + p->count[2] + p->count[3];
+	klvanc_generate_vanc_line_v210(ctx, set->lines[0], expect, 1920);
+	klvanc_v210_line_to_nv20_c((uint32_t *)expect, a, 1920 * 3 * sizeof(uint16_t), 1920);
+
+	int ok = 1;
+	for (int frame = 0; frame < 3; frame++) {
+		klvanc_line_set_reset(set);
+		line_fill(ctx, set, p, 9);
+		memset(got, 0, size);
+		int ret = klvanc_generate_vanc_line_v210_cached(ctx, cache, set->lines[0], got, 1920, 0);
+		ok &= ret == (frame ? KLVANC_LINE_CACHE_COPIED : KLVANC_LINE_CACHE_GENERATED);
+		klvanc_v210_line_to_nv20_c((uint32_t *)got, b, 1920 * 3 * sizeof(uint16_t), 1920);
+		ok &= memcmp(a, b, len * sizeof(uint16_t)) == 0;
+	}
+	check(ok, "unchanged line generated once, then copied");
+
+	memset(got, 0x5a, size);
+	check(klvanc_generate_vanc_line_v210_cached(ctx, cache, set->lines[0], got, 1920, 1) ==
+	      KLVANC_LINE_CACHE_SKIPPED && got[0] == 0x5a, "unchanged line into a recycled buffer skipped");
+
+	klvanc_line_set_reset(set);
+	line_fill(ctx, set, p, 9);
+	set->lines[0]->p_entries[1]->payload[8] ^= 0x01;
+	check(klvanc_generate_vanc_line_v210_cached(ctx, cache, set->lines[0], got, 1920, 1) ==
+	      KLVANC_LINE_CACHE_GENERATED, "changed payload generated again");
+
+	klvanc_line_cache_get_stats(cache, &stats);
+	check(stats.generated == 2 && stats.copied == 2 && stats.skipped == 1, "cache statistics");
+
+	klvanc_line_cache_invalidate(cache);
+	check(klvanc_generate_vanc_line_v210_cached(ctx, cache, set->lines[0], got, 1920, 1) ==
+	      KLVANC_LINE_CACHE_GENERATED, "invalidated cache generates");
+
+	klvanc_line_cache_free(cache);
+	klvanc_line_set_free(set);
+	free(expect);
+	free(got);
+	free(a);
+	free(b);
+}
+
+static void test_compose_cache(struct klvanc_context_s *ctx, const struct packets_s *p)
+{
+	const struct klvanc_video_format_s *fmt = &fmt1080i;
+	struct klvanc_compose_packet_s packets[2];
+	struct klvanc_compose_params_s params;
+	uint32_t stride = klvanc_video_format_v210_stride(fmt);
+	size_t size = (size_t)stride * klvanc_video_format_vanc_rows(fmt);
+	uint8_t *vanc = malloc(size);
+	uint8_t *fresh = malloc(size);
+
+	memset(packets, 0, sizeof(packets));
+	packets[0] = (struct klvanc_compose_packet_s){ .words = p->words[0], .wordCount = p->count[0] };
+	packets[1] = (struct klvanc_compose_packet_s){ .words = p->words[1], .wordCount = p->count[1], .lineNr = 13 };
+
+	klvanc_compose_params_default(&params);
+	params.cache = 0;
+	klvanc_frame_compose(ctx, fmt, packets, 2, fresh, 0, &params);
+
+	params.cache = 1;
+	klvanc_frame_compose(ctx, fmt, packets, 2, vanc, 0, &params);
+	klvanc_frame_compose(ctx, fmt, packets, 2, vanc, 0, &params);
+	check(memcmp(vanc, fresh, size) == 0, "cached compose matches uncached");
+
+	uint8_t *row11 = vanc + klvanc_video_format_vanc_row(fmt, 11) * stride;
+	uint8_t *row13 = vanc + klvanc_video_format_vanc_row(fmt, 13) * stride;
+	memset(row11, 0, 16);
+	memset(row13, 0, 16);
+	params.recycled = 1;
+	packets[1].lineNr = 14;
+	klvanc_frame_compose(ctx, fmt, packets, 2, vanc, 0, &params);
+	check(row11[0] == 0 && row11[1] == 0, "unchanged row left alone in a recycled region");
+	check(row13[1] == 0x02 && memcmp(row13, vanc, 16) == 0, "emptied row blanked");
+
+	params.recycled = 0;
+	klvanc_frame_compose(ctx, fmt, packets, 2, vanc, 0, &params);
+	check(memcmp(row11, fresh + klvanc_video_format_vanc_row(fmt, 11) * stride, stride) == 0,
+	      "unchanged row copied into a fresh region");
+
+	free(vanc);
+	free(fresh);
+}
+
+/* One packet serialized into a caller buffer must match the allocating converter */
+static void check_serialized(struct klvanc_context_s *ctx, enum klvanc_packet_type_e type, const void *pkt,
+			     const uint16_t *legacy, uint16_t legacyCount, const char *name)
+{
+	uint16_t words[256];
+	char desc[128];
+
+	int needed = klvanc_packet_serialize(ctx, type, pkt, NULL, 0);
+	snprintf(desc, sizeof(desc), "%s size query matches the converter", name);
+	check(needed == legacyCount, desc);
+
+	int ret = klvanc_packet_serialize(ctx, type, pkt, words, needed - 1);
+	snprintf(desc, sizeof(desc), "%s serialize into a short buffer is refused", name);
+	check(ret == -ENOSPC, desc);
+
+	ret = klvanc_packet_serialize(ctx, type, pkt, words, sizeof(words) / sizeof(words[0]));
+	snprintf(desc, sizeof(desc), "%s serialize matches the converter", name);
+	check(ret == legacyCount && memcmp(words, legacy, legacyCount * sizeof(uint16_t)) == 0, desc);
+}
+
+static void test_serialize(struct klvanc_context_s *ctx)
+{
+	uint16_t *legacy = NULL, legacyCount = 0;
+
+	struct klvanc_packet_afd_s afd;
+	memset(&afd, 0, sizeof(afd));
+	klvanc_set_AFD_val(&afd, 0x10);
+	afd.barDataFlags = BARS_TOPBOTTOM;
+	afd.top = 12;
+	afd.bottom = 1068;
+	check(klvanc_convert_AFD_to_words(&afd, &legacy, &legacyCount) == 0, "AFD converts to words");
+	check_serialized(ctx, VANC_TYPE_AFD, &afd, legacy, legacyCount, "AFD");
+	free(legacy);
+
+	struct klvanc_packet_eia_608_s cc;
+	memset(&cc, 0, sizeof(cc));
+	cc.field = 1;
+	cc.line_offset = 12;
+	cc.cc_data_1 = 0x94;
+	cc.cc_data_2 = 0x2c;
+	check(klvanc_convert_EIA_608_to_words(&cc, &legacy, &legacyCount) == 0, "EIA-608 converts to words");
+	check_serialized(ctx, VANC_TYPE_EIA_608, &cc, legacy, legacyCount, "EIA-608");
+	free(legacy);
+
+	struct klvanc_packet_kl_u64le_counter_s counter;
+	memset(&counter, 0, sizeof(counter));
+	counter.counter = 0x0123456789abcdefULL;
+	check(klvanc_convert_KL_U64LE_COUNTER_to_words(&counter, &legacy, &legacyCount) == 0,
+	      "KL counter converts to words");
+	check_serialized(ctx, VANC_TYPE_KL_UINT64_COUNTER, &counter, legacy, legacyCount, "KL counter");
+	free(legacy);
+
+	struct klvanc_packet_smpte_12_2_s *tc;
+	check(klvanc_alloc_SMPTE_12_2(&tc) == 0, "timecode allocated");
+	tc->dbb1 = 0x02;
+	tc->hours = 10;
+	tc->minutes = 20;
+	tc->seconds = 30;
+	tc->frames = 14;
+	check(klvanc_convert_SMPTE_12_2_to_words(ctx, tc, &legacy, &legacyCount) == 0, "timecode converts to words");
+	check_serialized(ctx, VANC_TYPE_SMPTE_S12_2, tc, legacy, legacyCount, "timecode");
+	free(legacy);
+	free(tc);
+
+	uint16_t words[16];
+	check(klvanc_packet_serialize(ctx, VANC_TYPE_SDP, &counter, words, 16) == -EINVAL,
+	      "serialize of a type without a serializer is refused");
+
+	/* The raw payload writer agrees with the allocating one */
+	uint8_t buf[40];
+	for (int i = 0; i < sizeof(buf); i++)
+		buf[i] = i * 7;
+	check(klvanc_sdi_create_payload(0x05, 0x41, buf, sizeof(buf), &legacy, &legacyCount, 10) == 0,
+	      "payload created");
+	uint16_t out[64];
+	int ret = klvanc_sdi_write_payload(0x05, 0x41, buf, sizeof(buf), out, 64);
+	check(ret == legacyCount && memcmp(out, legacy, legacyCount * sizeof(uint16_t)) == 0,
+	      "payload written in place matches the allocated payload");
+	check(klvanc_sdi_write_payload(0x05, 0x41, buf, sizeof(buf), out, ret - 1) == -ENOSPC,
+	      "payload written into a short buffer is refused");
+	free(legacy);
+}
+
+/* Patching a packet in place must give the line generated from the patched packet */
+static void test_patch(struct klvanc_context_s *ctx, const struct packets_s *p, int width)
+{
+	static const uint8_t newBytes[4] = { 0xde, 0xad, 0x00, 0xff };
+	struct klvanc_line_set_s set = { 0 }, patchedSet = { 0 };
+	struct klvanc_packet_location_s loc;
+	struct packets_s patched = *p;
+	uint8_t buf[31];
+	char desc[80];
+
+	/* Packet 2 carries 31 bytes counting up from 34, rebuild it with bytes 3-6 replaced */
+	for (int i = 0; i < sizeof(buf); i++)
+		buf[i] = 34 + i;
+	memcpy(&buf[3], newBytes, sizeof(newBytes));
+	patched.words[2] = NULL;
+	klvanc_sdi_create_payload(0x05, 0x43, buf, sizeof(buf), &patched.words[2], &patched.count[2], 10);
+
+	if (line_fill(ctx, &set, p, 9) < 0 || line_fill(ctx, &patchedSet, &patched, 9) < 0) {
+		check(0, "lines filled");
+		return;
+	}
+
+	int bytes = width * 16 / 6 + 16;
+	uint8_t *v210 = calloc(bytes, 1);
+	uint8_t *expect = calloc(bytes, 1);
+	uint16_t *words = calloc(width, sizeof(uint16_t));
+	uint16_t *expectWords = calloc(width, sizeof(uint16_t));
+	int len = 0, expectLen = 0;
+
+	klvanc_generate_vanc_line_v210(ctx, set.lines[0], v210, width);
+	klvanc_generate_vanc_line_v210(ctx, patchedSet.lines[0], expect, width);
+	klvanc_generate_vanc_line_inplace(ctx, set.lines[0], words, &len, width);
+	klvanc_generate_vanc_line_inplace(ctx, patchedSet.lines[0], expectWords, &expectLen, width);
+
+	int ret = klvanc_v210_find_packet(v210, width, 0x43, 0x05, &loc);
+	snprintf(desc, sizeof(desc), "%d wide: v210 packet found", width);
+	check(ret == 0 && loc.dataCount == 31 && loc.wordCount == 38, desc);
+
+	ret = klvanc_v210_patch_packet(v210, width, &loc, 3, newBytes, sizeof(newBytes));
+	snprintf(desc, sizeof(desc), "%d wide: v210 patch matches the regenerated line", width);
+	check(ret == 0 && memcmp(v210, expect, bytes) == 0, desc);
+
+	snprintf(desc, sizeof(desc), "%d wide: v210 patch past the payload is refused", width);
+	check(klvanc_v210_patch_packet(v210, width, &loc, 29, newBytes, 3) == -ERANGE, desc);
+
+	snprintf(desc, sizeof(desc), "%d wide: absent packet not found", width);
+	check(klvanc_v210_find_packet(v210, width, 0x43, 0x06, &loc) == -ENOENT, desc);
+
+	ret = klvanc_words_find_packet(words, len, 0x43, 0x05, &loc);
+	if (ret == 0)
+		ret = klvanc_words_patch_packet(words, len, &loc, 3, newBytes, sizeof(newBytes));
+	snprintf(desc, sizeof(desc), "%d wide: 16-bit patch matches the regenerated line", width);
+	check(ret == 0 && len == expectLen && memcmp(words, expectWords, len * sizeof(uint16_t)) == 0 &&
+	      klvanc_checksum_is_valid(&words[loc.offset + 3], loc.wordCount - 3), desc);
+
+	free(v210);
+	free(expect);
+	free(words);
+	free(expectWords);
+	free(patched.words[2]);
+	lines_free(&set);
+	lines_free(&patchedSet);
+}
+
+/* Registry formats are consistent, and agree with the timecode lines ST 12-2 asks for */
+/* Descriptor driven generation, caching and patching agree with each other, whatever the width suggests */
+static void test_patch_format(struct klvanc_context_s *ctx, const struct packets_s *p,
+			      const struct klvanc_video_format_s *fmt)
+{
+	static const uint8_t newBytes[4] = { 0xde, 0xad, 0x00, 0xff };
+	struct klvanc_line_set_s set = { 0 }, patchedSet = { 0 };
+	struct klvanc_line_cache_s *cache = NULL;
+	struct klvanc_packet_location_s loc;
+	struct packets_s patched = *p;
+	uint8_t buf[31];
+	char desc[80];
+
+	for (int i = 0; i < sizeof(buf); i++)
+		buf[i] = 34 + i;
+	memcpy(&buf[3], newBytes, sizeof(newBytes));
+	patched.words[2] = NULL;
+	klvanc_sdi_create_payload(0x05, 0x43, buf, sizeof(buf), &patched.words[2], &patched.count[2], 10);
+
+	if (line_fill(ctx, &set, p, 9) < 0 || line_fill(ctx, &patchedSet, &patched, 9) < 0 ||
+	    klvanc_line_cache_alloc(ctx, &cache) < 0) {
+		check(0, "lines filled");
+		free(patched.words[2]);
+		return;
+	}
+
+	uint32_t bytes = klvanc_video_format_v210_stride(fmt);
+	uint8_t *v210 = calloc(bytes, 1);
+	uint8_t *cached = calloc(bytes, 1);
+	uint8_t *expect = calloc(bytes, 1);
+
+	klvanc_generate_vanc_line_v210_format(ctx, set.lines[0], v210, fmt);
+	klvanc_generate_vanc_line_v210_format(ctx, patchedSet.lines[0], expect, fmt);
+
+	/* The cache blanks the tail of the last group, so compare where the packet landed */
+	struct klvanc_packet_location_s cachedLoc;
+	int ret = klvanc_generate_vanc_line_v210_cached_format(ctx, cache, set.lines[0], cached, fmt, 0);
+	ret |= klvanc_v210_find_packet_format(cached, fmt, 0x43, 0x05, &cachedLoc);
+	ret |= klvanc_v210_find_packet_format(v210, fmt, 0x43, 0x05, &loc);
+	snprintf(desc, sizeof(desc), "%s: cached line packs like the uncached one", fmt->name);
+	check(ret == 0 && cachedLoc.offset == loc.offset && cachedLoc.wordCount == loc.wordCount &&
+	      klvanc_generate_vanc_line_v210_cached_format(ctx, cache, set.lines[0], cached, fmt, 0) ==
+	      KLVANC_LINE_CACHE_COPIED, desc);
+
+	ret = klvanc_v210_find_packet_format(v210, fmt, 0x43, 0x05, &loc);
+	if (ret == 0)
+		ret = klvanc_v210_patch_packet_format(v210, fmt, &loc, 3, newBytes, sizeof(newBytes));
+	snprintf(desc, sizeof(desc), "%s: patch matches the regenerated line", fmt->name);
+	check(ret == 0 && loc.dataCount == 31 && memcmp(v210, expect, bytes) == 0, desc);
+
+	free(v210);
+	free(cached);
+	free(expect);
+	free(patched.words[2]);
+	klvanc_line_cache_free(cache);
+	lines_free(&set);
+	lines_free(&patchedSet);
+}
+
+static void test_video_formats(struct klvanc_context_s *ctx, const struct packets_s *p)
+{
+	char desc[80];
+
+	check(klvanc_video_format_get(KLVANC_VIDEO_FORMAT_MAX) == NULL, "out of range format refused");
+
+	for (int id = 0; id < KLVANC_VIDEO_FORMAT_MAX; id++) {
+		const struct klvanc_video_format_s *fmt = klvanc_video_format_get(id);
+		struct klvanc_video_format_s derived = *fmt;
+		int ok = 1;
+
+		derived.stride = derived.rows = derived.rowBase[0] = derived.rowBase[1] = 0;
+		ok &= klvanc_video_format_init(&derived) == 0;
+		ok &= derived.stride == fmt->stride && derived.rows == fmt->rows &&
+		      derived.rowBase[1] == fmt->rowBase[1];
+		ok &= klvanc_video_format_find(fmt->height, fmt->interlaced) == fmt;
+		for (uint32_t row = 0; row < fmt->rows; row++)
+			ok &= klvanc_video_format_vanc_row(fmt, klvanc_video_format_vanc_line(fmt, row)) == (int)row;
+		ok &= klvanc_video_format_vanc_line(fmt, fmt->rows) == 0;
+		ok &= klvanc_video_format_vanc_row(fmt, fmt->switchingLine[0] - 1) == -ERANGE;
+		ok &= klvanc_video_format_vanc_row(fmt, fmt->packetLine[0]) >= 0;
+		ok &= klvanc_video_format_vanc_row(fmt, fmt->timecodeLine[0]) >= 0;
+		snprintf(desc, sizeof(desc), "%s descriptor consistent", fmt->name);
+		check(ok, desc);
+	}
+
+	check(klvanc_SMPTE_12_2_preferred_line(KLVANC_ATC_VITC1, 1080, 1) == 9 &&
+	      klvanc_SMPTE_12_2_preferred_line(KLVANC_ATC_VITC2, 1080, 1) == 571 &&
+	      klvanc_SMPTE_12_2_preferred_line(KLVANC_ATC_VITC2, 1080, 0) == 9 &&
+	      klvanc_SMPTE_12_2_preferred_line(KLVANC_ATC_VITC1, 720, 0) == 9 &&
+	      klvanc_SMPTE_12_2_preferred_line(KLVANC_ATC_VITC1, 486, 1) == 12 &&
+	      klvanc_SMPTE_12_2_preferred_line(KLVANC_ATC_VITC2, 486, 1) == 275 &&
+	      klvanc_SMPTE_12_2_preferred_line(KLVANC_ATC_VITC1, 576, 1) == 8 &&
+	      klvanc_SMPTE_12_2_preferred_line(KLVANC_ATC_VITC2, 576, 1) == 321 &&
+	      klvanc_SMPTE_12_2_preferred_line(KLVANC_ATC_LTC, 1080, 1) == -1 &&
+	      klvanc_SMPTE_12_2_preferred_line(0x04, 1080, 1) == 11, "timecode lines unchanged");
+
+	struct klvanc_video_format_s bad = { .width = 1920, .vanc = { { 20, 8 } } };
+	check(klvanc_video_format_init(&bad) == -EINVAL, "inverted VANC range refused");
+
+	/* SD carries VANC in every component, compose and parse must agree on it */
+	const int ids[2] = { KLVANC_VIDEO_FORMAT_525I, KLVANC_VIDEO_FORMAT_1080P };
+	for (int i = 0; i < 2; i++) {
+		const struct klvanc_video_format_s *fmt = klvanc_video_format_get(ids[i]);
+		struct klvanc_compose_packet_s packets[2] = {
+			{ .words = p->words[0], .wordCount = p->count[0] },
+			{ .words = p->words[2], .wordCount = p->count[2], .lineNr = fmt->packetLine[0] + 1 },
+		};
+		struct found_s found;
+		size_t size = (size_t)fmt->stride * fmt->rows;
+		uint8_t *vanc = malloc(size);
+
+		int ret = klvanc_frame_compose(ctx, fmt, packets, 2, vanc, 0, NULL);
+		parse_region(fmt, vanc, 0, &found);
+		snprintf(desc, sizeof(desc), "%s frame composes and parses back", fmt->name);
+		check(ret == 0 && found.count == 2 && found.onLine[fmt->packetLine[0]] == 1 &&
+		      found.onLine[fmt->packetLine[0] + 1] == 1, desc);
+
+		struct klvanc_line_set_s set = { 0 };
+		uint8_t *line = calloc(fmt->stride, 1);
+		klvanc_line_insert(ctx, &set, p->words[0], p->count[0], fmt->packetLine[0], 0);
+		ret = klvanc_generate_vanc_line_v210_format(ctx, set.lines[0], line, fmt);
+		snprintf(desc, sizeof(desc), "%s line generated from the format matches the frame", fmt->name);
+		check(ret == 0 && memcmp(line, vanc + (size_t)klvanc_video_format_vanc_row(fmt, fmt->packetLine[0]) *
+					 fmt->stride, 16) == 0, desc);
+
+		lines_free(&set);
+		free(line);
+		free(vanc);
+	}
+}
+
+static struct klvanc_packet_afd_s shortAfd;
+static unsigned int shortRawWords;
+
+static int cb_short_afd(void *callback_context, struct klvanc_context_s *ctx, struct klvanc_packet_afd_s *pkt)
+{
+	shortAfd = *pkt;
+	shortRawWords = pkt->hdr->rawLengthWords;
+	return 0;
+}
+
+static struct klvanc_callbacks_s shortCallbacks =
+{
+	.afd = cb_short_afd,
+};
+
+/* Packets share the context's decode header, a short one must not see the words of a longer one */
+static void test_short_packet(void)
+{
+	struct klvanc_context_s *ctx;
+	uint8_t full[8] = { 0x08 << 3, 0, 0, BARS_TOPBOTTOM << 4, 0x01, 0x23, 0x04, 0x56 };
+	uint16_t fullWords[16], shortWords[16];
+
+	if (klvanc_context_create(&ctx) < 0) {
+		check(0, "context created");
+		return;
+	}
+	ctx->callbacks = &shortCallbacks;
+
+	int fullCount = klvanc_sdi_write_payload(0x05, 0x41, full, 8, fullWords, 16);
+	int shortCount = klvanc_sdi_write_payload(0x05, 0x41, full, 4, shortWords, 16);
+
+	klvanc_packet_parse(ctx, 9, fullWords, fullCount);
+	check(shortAfd.top == 0x0123 && shortAfd.bottom == 0x0456, "full AFD bar data decoded");
+
+	/* Followed by black so the parser is handed more than the packet */
+	for (int i = shortCount; i < 16; i++)
+		shortWords[i] = 0x040;
+	klvanc_packet_parse(ctx, 9, shortWords, 16);
+	check(shortAfd.top == 0 && shortAfd.bottom == 0, "short AFD decodes no stale bar data");
+	check(shortRawWords == shortCount, "raw holds only the packet");
+
+	klvanc_context_destroy(ctx);
+}
+
+static void test_checksum(void)
+{
+	uint8_t buf[200];
+	uint16_t words[256];
+
+	for (int i = 0; i < sizeof(buf); i++)
+		buf[i] = i * 13 + 5;
+	int count = klvanc_sdi_write_payload(0x05, 0x41, buf, sizeof(buf), words, 256);
+	check(count == sizeof(buf) + 7, "payload written");
+
+	/* Reference: the original per word parity and masked checksum loop */
+	int parityOk = 1;
+	uint16_t sum = 0;
+	for (int i = 3; i < count - 1; i++) {
+		uint8_t low = words[i] & 0xff;
+		uint16_t expect = low | (__builtin_parity(low) ? 0x100 : 0x200);
+		if (words[i] != expect)
+			parityOk = 0;
+		sum = (sum + words[i]) & 0x1ff;
+	}
+	check(parityOk, "generated words carry correct parity bits");
+	check(words[count - 1] == (sum | ((~sum & 0x100) << 1)), "generated checksum matches reference");
+	check(klvanc_checksum_calculate(&words[3], count - 4) == words[count - 1], "checksum calculate agrees");
+
+	unsigned int bad = 99;
+	check(klvanc_checksum_verify(&words[3], count - 3, &bad) == 1 && bad == 0,
+	      "verify accepts a good packet with no parity errors");
+	check(klvanc_parity_errors(&words[3], count - 4) == 0, "no parity errors counted");
+
+	/* Flip a parity bit: checksum and parity both notice */
+	words[10] ^= 0x300;
+	check(!klvanc_parity_is_valid(words[10]), "single word parity check catches the flip");
+	check(klvanc_checksum_verify(&words[3], count - 3, &bad) == 0 && bad == 1,
+	      "verify rejects the checksum and counts one parity error");
+	check(klvanc_checksum_is_valid(&words[3], count - 3) == 0, "checksum is_valid rejects");
+	words[10] ^= 0x300;
+
+	/* All 256 values round trip through the single word check */
+	int allOk = 1;
+	for (int v = 0; v < 256; v++) {
+		uint16_t w = v | (__builtin_parity(v) ? 0x100 : 0x200);
+		if (!klvanc_parity_is_valid(w) || klvanc_parity_is_valid(w ^ 0x300) || klvanc_parity_is_valid(v))
+			allOk = 0;
+	}
+	check(allOk, "parity check is correct for every byte value");
+
+	check(klvanc_sdi_write_payload(0x05, 0x41, buf, 256, NULL, 0) == -EINVAL,
+	      "payloads longer than the data count allows are refused");
+}
+
+int lines_main(int argc, char *argv[])
+{
+	struct klvanc_context_s *ctx;
+	struct packets_s p;
+
+	if (klvanc_context_create(&ctx) < 0) {
+		fprintf(stderr, "Error initializing library context\n");
+		return 1;
+	}
+
+	if (packets_alloc(&p) < 0) {
+		fprintf(stderr, "Error creating packets\n");
+		packets_free(&p);
+		klvanc_context_destroy(ctx);
+		return 1;
+	}
+
+	test_matches_legacy(ctx, &p, 1920);
+	test_matches_legacy(ctx, &p, 1280);
+	test_matches_legacy(ctx, &p, 720);
+	test_rejects(ctx, &p);
+	test_pooled(ctx, &p);
+	test_compose(ctx, &p);
+	test_line_cache(ctx, &p);
+	test_compose_cache(ctx, &p);
+	test_serialize(ctx);
+	test_checksum();
+	test_short_packet();
+	test_video_formats(ctx, &p);
+	test_patch(ctx, &p, 1920);
+	test_patch(ctx, &p, 720);
+
+	/* A 720 wide format with VANC in luma, which no width based guess would pick */
+	struct klvanc_video_format_s lumaSD = *klvanc_video_format_get(KLVANC_VIDEO_FORMAT_625I);
+	lumaSD.name = "625i luma";
+	lumaSD.placement = KLVANC_VANC_PLACEMENT_LUMA;
+	test_patch_format(ctx, &p, klvanc_video_format_get(KLVANC_VIDEO_FORMAT_625I));
+	test_patch_format(ctx, &p, klvanc_video_format_get(KLVANC_VIDEO_FORMAT_1080I));
+	test_patch_format(ctx, &p, &lumaSD);
+
+	packets_free(&p);
+	klvanc_context_destroy(ctx);
+
+	printf("Final result: PASS: %d/%d, Failures: %d\n",
+	       passCount, passCount + failCount, failCount);
+	if (failCount != 0)
+		return 1;
+	return 0;
+}
@@ -212,7 +212,7 @@ static int cb_AFD(void *callback_context, struct klvanc_context_s *ctx,
 		struct klvanc_packet_afd_s *pkt)
 {
 	/* Have the library display some debug */
-	if (pkt_filtered(&pkt->hdr)) {
+	if (pkt_filtered(pkt->hdr)) {
 		if (klvanc_dump_AFD(ctx, pkt) < 0)
 			fprintf(stderr, "Failed to dump AFD packet");
 	}
@@ -224,7 +224,7 @@ static int cb_EIA_708B(void *callback_context, struct klvanc_context_s *ctx,
 		struct klvanc_packet_eia_708b_s *pkt)
 {
 	/* Have the library display some debug */
-	if (pkt_filtered(&pkt->hdr)) {
+	if (pkt_filtered(pkt->hdr)) {
 		if (klvanc_dump_EIA_708B(ctx, pkt) < 0)
 			fprintf(stderr, "Failed to dump CEA-708 packet");
 	}
@@ -236,7 +236,7 @@ static int cb_EIA_608(void *callback_context, struct klvanc_context_s *ctx,
 		struct klvanc_packet_eia_608_s *pkt)
 {
 	/* Have the library display some debug */
-	if (pkt_filtered(&pkt->hdr)) {
+	if (pkt_filtered(pkt->hdr)) {
 		if (klvanc_dump_EIA_608(ctx, pkt) < 0)
 			fprintf(stderr, "Failed to dump EIA-608 packet");
 	}
@@ -248,7 +248,7 @@ static int cb_SCTE_104(void *callback_context, struct klvanc_context_s *ctx,
 		struct klvanc_packet_scte_104_s *pkt)
 {
 	/* Have the library display some debug */
-	if (pkt_filtered(&pkt->hdr)) {
+	if (pkt_filtered(pkt->hdr)) {
 		if (klvanc_dump_SCTE_104(ctx, pkt) < 0)
 			fprintf(stderr, "Failed to dump SCTE-104 packet");
 	}
@@ -259,7 +259,7 @@ static int cb_SMPTE_12_2(void *callback_context, struct klvanc_context_s *ctx,
 			 struct klvanc_packet_smpte_12_2_s *pkt)
 {
 	/* Have the library display some debug */
-	if (pkt_filtered(&pkt->hdr)) {
+	if (pkt_filtered(pkt->hdr)) {
 		klvanc_dump_SMPTE_12_2(ctx, pkt);
 	}
 	return 0;
@@ -294,7 +294,7 @@ static int cb_SDP(void *callback_context, struct klvanc_context_s *ctx,
 		struct klvanc_packet_sdp_s *pkt)
 {
 	/* Have the library display some debug */
-	if (pkt_filtered(&pkt->hdr)) {
+	if (pkt_filtered(pkt->hdr)) {
 		klvanc_dump_SDP(ctx, pkt);
 	}
 	return 0;
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include <libklvanc/vanc.h>
+
+static int passCount = 0;
+static int failCount = 0;
+
+static struct klvanc_recorder_s *recorder;
+
+/* CALLBACKS for message notification */
+static int cb_all(void *callback_context, struct klvanc_context_s *ctx,
+		  struct klvanc_packet_header_s *pkt)
+{
+	return klvanc_recorder_push_packet(recorder, pkt);
+}
+
+static struct klvanc_callbacks_s callbacks =
+{
+	.all		= cb_all,
+};
+/* END - CALLBACKS for message notification */
+
+static unsigned short test_data_afd_1[] = {
+	0x0000, 0x03ff, 0x03ff, 0x0241, 0x0205, 0x0108, 0x0200, 0x0200,
+	0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x014e
+};
+
+static uint32_t get_le16(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+static uint32_t get_le32(const uint8_t *p)
+{
+	return get_le16(p) | (get_le16(p + 2) << 16);
+}
+
+/* Read the file back, count records and validate their framing.
+ * Optionally compare the first record's words against expected.
+ */
+static int read_records(const char *fn, const uint16_t *expected, uint32_t expectedCount,
+			uint16_t expectedLine)
+{
+	FILE *fh = fopen(fn, "rb");
+	if (!fh)
+		return -1;
+
+	int count = 0;
+	uint8_t hdr[KLVANC_RECORDER_RECORD_HEADER_SIZE];
+	uint16_t words[16384];
+	while (fread(hdr, sizeof(hdr), 1, fh) == 1) {
+		if (get_le32(hdr) != KLVANC_RECORDER_MAGIC) {
+			fprintf(stderr, "Bad magic in record %d\n", count);
+			count = -1;
+			break;
+		}
+		uint32_t wordCount = get_le32(hdr + 8);
+		if (wordCount > 16384 || fread(words, 2, wordCount, fh) != wordCount) {
+			fprintf(stderr, "Truncated record %d\n", count);
+			count = -1;
+			break;
+		}
+		if (count == 0 && expected) {
+			if (wordCount != expectedCount || get_le16(hdr + 6) != expectedLine ||
+			    memcmp(words, expected, wordCount * 2) != 0) {
+				fprintf(stderr, "Record content mismatch\n");
+				count = -1;
+				break;
+			}
+		}
+		count++;
+	}
+
+	fclose(fh);
+	return count;
+}
+
+static void check(int cond, const char *desc)
+{
+	printf("%s: %s\n", cond ? "PASS" : "FAIL", desc);
+	if (cond)
+		passCount++;
+	else
+		failCount++;
+}
+
+static int test_packets(struct klvanc_context_s *ctx, const char *fn)
+{
+	if (klvanc_recorder_alloc(&recorder, fn, NULL) < 0) {
+		fprintf(stderr, "Unable to create recorder\n");
+		return -1;
+	}
+
+	for (int i = 0; i < 10; i++)
+		klvanc_packet_parse(ctx, 9, test_data_afd_1, sizeof(test_data_afd_1) / sizeof(unsigned short));
+	klvanc_recorder_push_line(recorder, 10, test_data_afd_1, sizeof(test_data_afd_1) / sizeof(unsigned short));
+
+	klvanc_recorder_free(recorder);
+	recorder = NULL;
+
+	/* Packet records hold ADF through checksum, which is the entire test vector */
+	int n = read_records(fn, test_data_afd_1, 15, 9);
+	check(n == 11, "all packets and lines recorded and read back");
+
+	return 0;
+}
+
+static int test_overload(const char *fn, enum klvanc_recorder_drop_policy_e policy)
+{
+	struct klvanc_recorder_params_s params;
+	struct klvanc_recorder_stats_s stats;
+	const int total = 100000;
+
+	klvanc_recorder_params_default(&params);
+	params.queueDepth = 4;
+	params.batchSize = 2;
+	params.dropPolicy = policy;
+
+	if (klvanc_recorder_alloc(&recorder, fn, &params) < 0) {
+		fprintf(stderr, "Unable to create recorder\n");
+		return -1;
+	}
+
+	int failed = 0;
+	for (int i = 0; i < total; i++) {
+		if (klvanc_recorder_push_line(recorder, 9, test_data_afd_1, 15) < 0)
+			failed++;
+	}
+
+	/* Oversize records are refused outright */
+	uint16_t big[2048] = { 0 };
+	check(klvanc_recorder_push_line(recorder, 9, big, 2048) == -EINVAL, "oversize record refused");
+
+	/* No more producers, so these counters are final */
+	klvanc_recorder_get_stats(recorder, &stats);
+	klvanc_recorder_free(recorder);
+	recorder = NULL;
+
+	int n = read_records(fn, NULL, 0, 0);
+	printf("policy %d: pushed %d, refused %d, recorded %" PRIu64 ", dropped %" PRIu64
+	       ", high water %d, on disk %d\n", policy, total, failed, stats.recorded,
+	       stats.dropped, stats.highWaterMark, n);
+
+	check(stats.recorded + failed == total, "every push either recorded or refused");
+	check(stats.recorded <= total && stats.highWaterMark <= params.queueDepth,
+	      "queue depth respected");
+
+	/* Refused pushes and records stolen by drop-oldest are the only losses */
+	uint64_t stolen = stats.dropped - failed;
+	check(n >= 0 && (uint64_t)n == stats.recorded - stolen, "every surviving record reached disk");
+
+	return 0;
+}
+
+int recorder_main(int argc, char *argv[])
+{
+	struct klvanc_context_s *ctx;
+	char fn[64];
+
+	snprintf(fn, sizeof(fn), "/tmp/klvanc_recorder_%d.bin", getpid());
+
+	if (klvanc_context_create(&ctx) < 0) {
+		fprintf(stderr, "Error initializing library context\n");
+		exit(1);
+	}
+	ctx->callbacks = &callbacks;
+	printf("Library initialized.\n");
+
+	test_packets(ctx, fn);
+	test_overload(fn, KLVANC_RECORDER_DROP_NEWEST);
+	test_overload(fn, KLVANC_RECORDER_DROP_OLDEST);
+
+	unlink(fn);
+
+	klvanc_context_destroy(ctx);
+	printf("Library destroyed.\n");
+
+	printf("Final result: PASS: %d/%d, Failures: %d\n",
+	       passCount, passCount + failCount, failCount);
+	if (failCount != 0)
+		return 1;
+	return 0;
+}
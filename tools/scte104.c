@@ -326,6 +326,75 @@ static int test_scte_104(struct klvanc_context_s *ctx, const uint8_t *buf, size_
 	return ret;
 }
 
+static int logCount = 0;
+static void counting_logger(void *p, int level, const char *fmt, ...)
+{
+	if (level > LIBKLVANC_LOGLEVEL_ERR)
+		logCount++;
+}
+
+/* With the level below DEBUG, verbose parsing must never reach the logger */
+static void test_log_level(struct klvanc_context_s *ctx)
+{
+	void (*log_cb)(void *p, int level, const char *fmt, ...) = ctx->log_cb;
+	int verbose = ctx->verbose;
+
+	ctx->log_cb = counting_logger;
+	ctx->log_level = LIBKLVANC_LOGLEVEL_ERR;
+	ctx->verbose = 2;
+	test_scte_104(ctx, test1, sizeof(test1), 1);
+	test_scte_104(ctx, test13, sizeof(test13), 1);
+
+	if (logCount == 0) {
+		printf("Log level suppressed all debug output!\n");
+		passCount++;
+	} else {
+		fprintf(stderr, "Logger called %d times above the log level\n", logCount);
+		failCount++;
+	}
+
+	ctx->log_cb = log_cb;
+	ctx->log_level = LIBKLVANC_LOGLEVEL_DEBUG;
+	ctx->verbose = verbose;
+}
+
+/* A single ST 2010 packet caps the message at 254 bytes, larger ones must be refused */
+static void test_serialize_limit(struct klvanc_context_s *ctx)
+{
+	struct klvanc_packet_scte_104_s *pkt;
+	struct klvanc_multiple_operation_message_operation *op;
+	uint16_t words[300];
+
+	if (klvanc_alloc_SCTE_104(0xffff, &pkt) < 0) {
+		failCount++;
+		return;
+	}
+
+	/* 13 splice requests of 18 bytes each fit behind the 12 byte header, the 14th does not */
+	int counts[2] = { 0, 0 };
+	for (int i = 0; i < 14; i++) {
+		if (klvanc_SCTE_104_Add_MOM_Op(pkt, MO_SPLICE_REQUEST_DATA, &op) < 0)
+			break;
+		op->sr_data.splice_insert_type = SPLICESTART_IMMEDIATE;
+		op->sr_data.splice_event_id = i;
+		if (i == 11)
+			counts[0] = klvanc_packet_serialize(ctx, VANC_TYPE_SCTE_104, pkt, NULL, 0);
+	}
+	counts[1] = klvanc_packet_serialize(ctx, VANC_TYPE_SCTE_104, pkt, NULL, 0);
+
+	pkt->mo_msg.num_ops = 12;
+	int written = klvanc_packet_serialize(ctx, VANC_TYPE_SCTE_104, pkt, words, 300);
+	klvanc_free_SCTE_104(pkt);
+
+	if (counts[0] == written && written > 0 && (words[5] & 0xff) == written - 7 && counts[1] < 0) {
+		printf("SCTE-104 serialization honours the ST 2010 packet limit!\n");
+		passCount++;
+	} else {
+		fprintf(stderr, "SCTE-104 serialize returned %d/%d/%d\n", counts[0], written, counts[1]);
+		failCount++;
+	}
+}
+
 int scte104_main(int argc, char *argv[])
 {
 	struct klvanc_context_s *ctx;
@@ -401,6 +470,9 @@ int scte104_main(int argc, char *argv[])
 	if (ret < 0)
 		fprintf(stderr, "SCTE-104 failed to parse\n");
 
+	test_log_level(ctx);
+	test_serialize_limit(ctx);
+
 	klvanc_context_destroy(ctx);
 	printf("Library destroyed.\n");
 
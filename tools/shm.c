@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <libklvanc/vanc.h>
+
+static int passCount = 0;
+static int failCount = 0;
+
+/* Two AFD packets, differing in the AFD code, both with valid checksums */
+static unsigned short test_data_afd_1[] = {
+	0x0000, 0x03ff, 0x03ff, 0x0241, 0x0205, 0x0108, 0x0200, 0x0200,
+	0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x014e
+};
+
+static unsigned short test_data_afd_2[] = {
+	0x0000, 0x03ff, 0x03ff, 0x0241, 0x0205, 0x0108, 0x0120, 0x0200,
+	0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x026e
+};
+
+#define WORDS(a) (sizeof(a) / sizeof(unsigned short))
+
+static void check(int cond, const char *desc)
+{
+	printf("%s: %s\n", cond ? "PASS" : "FAIL", desc);
+	if (cond)
+		passCount++;
+	else
+		failCount++;
+}
+
+static volatile int writerDone;
+
+static void *writer_thread(void *p)
+{
+	struct klvanc_context_s *ctx = p;
+
+	for (int i = 0; i < 200000; i++) {
+		if (i & 1)
+			klvanc_packet_parse(ctx, 9, test_data_afd_2, WORDS(test_data_afd_2));
+		else
+			klvanc_packet_parse(ctx, 9, test_data_afd_1, WORDS(test_data_afd_1));
+	}
+	writerDone = 1;
+
+	return NULL;
+}
+
+/* Every copy must be exactly one of the two payloads, never a blend */
+static int consistent(const struct klvanc_shm_entry_s *e)
+{
+	if (e->payloadLengthWords != 8)
+		return 0;
+	for (int i = 0; i < 8; i++) {
+		if (e->payload[i] != test_data_afd_1[6 + i] && e->payload[i] != test_data_afd_2[6 + i])
+			return 0;
+	}
+	return (e->payload[0] == test_data_afd_1[6] && e->payload[1] == test_data_afd_1[7]) ||
+	       (e->payload[0] == test_data_afd_2[6] && e->payload[1] == test_data_afd_2[7]);
+}
+
+int shm_main(int argc, char *argv[])
+{
+	struct klvanc_context_s *ctx;
+	struct klvanc_shm_reader_s *reader;
+	struct klvanc_shm_entry_s entry;
+	char name[64];
+
+	sprintf(name, "/klvanc-test-%d", getpid());
+
+	if (klvanc_context_create(&ctx) < 0) {
+		fprintf(stderr, "Error initializing library context\n");
+		return 1;
+	}
+
+	int ret = klvanc_context_enable_shm_export(ctx, name, 16);
+	if (ret < 0) {
+		fprintf(stderr, "Unable to create %s (%d), skipping\n", name, ret);
+		klvanc_context_destroy(ctx);
+		return 0;
+	}
+
+	klvanc_packet_parse(ctx, 9, test_data_afd_1, WORDS(test_data_afd_1));
+	klvanc_packet_parse(ctx, 10, test_data_afd_1, WORDS(test_data_afd_1));
+	klvanc_packet_parse(ctx, 10, test_data_afd_2, WORDS(test_data_afd_2));
+
+	check(klvanc_shm_reader_open(&reader, name) == 0, "reader attached");
+	const struct klvanc_shm_header_s *hdr = klvanc_shm_reader_header(reader);
+	check(hdr->magic == KLVANC_SHM_MAGIC && hdr->version == KLVANC_SHM_VERSION &&
+	      hdr->maxEntries == 16 && hdr->entryCount == 2 && hdr->writerPid == (uint32_t)getpid(),
+	      "header describes the table");
+
+	klvanc_shm_reader_read(reader, 1, &entry);
+	check(entry.did == 0x41 && entry.sdid == 0x05 && entry.lineNr == 10 && entry.count == 2 &&
+	      entry.payloadLengthWords == 8 && entry.payload[0] == test_data_afd_2[6],
+	      "entry holds counters and the last payload");
+	check(klvanc_shm_reader_read(reader, 2, &entry) == -EINVAL, "unpublished entry refused");
+
+	/* Read while another thread writes */
+	pthread_t thread;
+	int reads = 0, torn = 0;
+	pthread_create(&thread, NULL, writer_thread, ctx);
+	while (!writerDone) {
+		if (klvanc_shm_reader_read(reader, 0, &entry) == 0) {
+			reads++;
+			if (!consistent(&entry))
+				torn++;
+		}
+	}
+	pthread_join(thread, NULL);
+	printf("%d concurrent reads, %d torn\n", reads, torn);
+	check(torn == 0, "concurrent reads are consistent");
+
+	klvanc_shm_reader_read(reader, 0, &entry);
+	check(entry.count == 200001, "every update counted");
+
+	klvanc_shm_reader_close(reader);
+	klvanc_context_destroy(ctx);
+	check(klvanc_shm_reader_open(&reader, name) < 0, "object removed with the context");
+
+	printf("Final result: PASS: %d/%d, Failures: %d\n",
+	       passCount, passCount + failCount, failCount);
+	if (failCount != 0)
+		return 1;
+	return 0;
+}
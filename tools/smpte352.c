@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <libklvanc/vanc.h>
+
+static int passCount = 0;
+static int failCount = 0;
+
+static void check(int cond, const char *desc)
+{
+	printf("%s: %s\n", cond ? "PASS" : "FAIL", desc);
+	if (cond)
+		passCount++;
+	else
+		failCount++;
+}
+
+static struct klvanc_packet_smpte_352_s seen;
+static int seenCount;
+static int afdCount;
+
+static int cb_SMPTE_352(void *callback_context, struct klvanc_context_s *ctx, struct klvanc_packet_smpte_352_s *pkt)
+{
+	klvanc_dump_SMPTE_352(ctx, pkt);
+	seen = *pkt;
+	seen.hdr = NULL;
+	seenCount++;
+	return 0;
+}
+
+static int cb_AFD(void *callback_context, struct klvanc_context_s *ctx, struct klvanc_packet_afd_s *pkt)
+{
+	afdCount++;
+	return 0;
+}
+
+static struct klvanc_callbacks_s callbacks =
+{
+	.smpte_352 = cb_SMPTE_352,
+	.afd = cb_AFD,
+};
+
+static uint16_t *make_payload_id(uint8_t standard, int transportProgressive, uint8_t rate, uint16_t *wordCount)
+{
+	struct klvanc_packet_smpte_352_s pkt;
+	uint16_t *words = NULL;
+
+	memset(&pkt, 0, sizeof(pkt));
+	pkt.version = 1;
+	pkt.standard = standard;
+	pkt.transportProgressive = transportProgressive;
+	pkt.pictureProgressive = transportProgressive;
+	pkt.pictureRate = rate;
+	pkt.aspectRatio16x9 = 1;
+	pkt.samplingStructure = KLVANC_ST352_SAMPLING_422_YCBCR;
+	pkt.bitDepth = KLVANC_ST352_DEPTH_10BIT;
+	if (klvanc_convert_SMPTE_352_to_words(&pkt, &words, wordCount) < 0)
+		return NULL;
+	return words;
+}
+
+static void test_decode(struct klvanc_context_s *ctx)
+{
+	uint16_t count;
+	uint16_t *words = make_payload_id(0x85, 0, KLVANC_ST352_RATE_29_97, &count);
+
+	seenCount = 0;
+	check(words && count == 11, "payload identifier serialized");
+	check(klvanc_packet_parse(ctx, 10, words, count) == 1 && seenCount == 1, "payload identifier parsed");
+	check(seen.version == 1 && seen.standard == 0x85 && !seen.transportProgressive &&
+	      seen.pictureRate == KLVANC_ST352_RATE_29_97 && seen.aspectRatio16x9 &&
+	      seen.samplingStructure == KLVANC_ST352_SAMPLING_422_YCBCR &&
+	      seen.bitDepth == KLVANC_ST352_DEPTH_10BIT, "fields decoded");
+	check(seen.format == klvanc_video_format_get(KLVANC_VIDEO_FORMAT_1080I), "1080-line interlaced is 1080i");
+
+	uint16_t again[16];
+	check(klvanc_packet_serialize(ctx, VANC_TYPE_SMPTE_S352, &seen, again, 16) == count &&
+	      memcmp(again, words, count * sizeof(uint16_t)) == 0, "decoded identifier serializes back");
+	free(words);
+}
+
+static void test_formats(void)
+{
+	static const struct {
+		uint8_t standard;
+		int progressive;
+		uint8_t rate;
+		int id;
+	} map[] = {
+		{ 0x81, 0, KLVANC_ST352_RATE_29_97, KLVANC_VIDEO_FORMAT_525I },
+		{ 0x81, 0, KLVANC_ST352_RATE_25,    KLVANC_VIDEO_FORMAT_625I },
+		{ 0x84, 1, KLVANC_ST352_RATE_59_94, KLVANC_VIDEO_FORMAT_720P },
+		{ 0x89, 1, KLVANC_ST352_RATE_50,    KLVANC_VIDEO_FORMAT_1080P },
+		{ 0x8a, 0, KLVANC_ST352_RATE_30,    KLVANC_VIDEO_FORMAT_1080I },
+		{ 0xce, 1, KLVANC_ST352_RATE_60,    KLVANC_VIDEO_FORMAT_2160P },
+		{ 0xff, 1, KLVANC_ST352_RATE_60,    -1 },
+	};
+	struct klvanc_packet_smpte_352_s pkt;
+	int ok = 1;
+
+	for (int i = 0; i < sizeof(map) / sizeof(map[0]); i++) {
+		memset(&pkt, 0, sizeof(pkt));
+		pkt.version = 1;
+		pkt.standard = map[i].standard;
+		pkt.transportProgressive = map[i].progressive;
+		pkt.pictureRate = map[i].rate;
+		const struct klvanc_video_format_s *expect = map[i].id < 0 ? NULL : klvanc_video_format_get(map[i].id);
+		if (klvanc_SMPTE_352_video_format(&pkt) != expect) {
+			printf("standard 0x%02x rate 0x%x mapped wrongly\n", map[i].standard, map[i].rate);
+			ok = 0;
+		}
+	}
+	check(ok, "payload identifiers map to registry formats");
+
+	/* PsF: progressive picture on an interlaced transport keeps the interlaced line map */
+	memset(&pkt, 0, sizeof(pkt));
+	pkt.version = 1;
+	pkt.standard = 0x85;
+	pkt.pictureProgressive = 1;
+	check(klvanc_SMPTE_352_video_format(&pkt) == klvanc_video_format_get(KLVANC_VIDEO_FORMAT_1080I),
+	      "PsF takes the interlaced line map");
+}
+
+static void test_detection(void)
+{
+	const struct klvanc_video_format_s *fmt = klvanc_video_format_get(KLVANC_VIDEO_FORMAT_1080P);
+	struct klvanc_context_s *ctx;
+	struct klvanc_packet_afd_s afd;
+	uint16_t *afdWords = NULL, afdCount16, idCount;
+
+	if (klvanc_context_create(&ctx) < 0) {
+		check(0, "context created");
+		return;
+	}
+	ctx->callbacks = &callbacks;
+
+	memset(&afd, 0, sizeof(afd));
+	klvanc_set_AFD_val(&afd, 0x10);
+	klvanc_convert_AFD_to_words(&afd, &afdWords, &afdCount16);
+	uint16_t *id = make_payload_id(0x89, 1, KLVANC_ST352_RATE_59_94, &idCount);
+
+	/* A 1080p VANC region holding an AFD packet on the format's packet line */
+	struct klvanc_compose_packet_s packets[1] = { { .words = afdWords, .wordCount = afdCount16 } };
+	uint8_t *vanc = malloc((size_t)fmt->stride * fmt->rows);
+	check(klvanc_frame_compose(ctx, fmt, packets, 1, vanc, 0, NULL) == 0, "1080p frame composed");
+
+	check(klvanc_frame_parse_v210(ctx, NULL, vanc, 0) == -EAGAIN, "frame refused while the format is unknown");
+
+	/* Without detection the identifier is only reported */
+	klvanc_packet_parse(ctx, 10, id, idCount);
+	check(klvanc_context_get_video_format(ctx) == NULL, "format not taken without detection");
+
+	klvanc_context_enable_format_detection(ctx);
+	klvanc_packet_parse(ctx, 10, id, idCount);
+	check(klvanc_context_get_video_format(ctx) == fmt, "format detected from the payload identifier");
+
+	afdCount = 0;
+	check(klvanc_frame_parse_v210(ctx, NULL, vanc, 0) == 1 && afdCount == 1,
+	      "frame parsed with the detected geometry");
+
+	/* The first identifier sticks until the application forgets it */
+	uint16_t sdCount;
+	uint16_t *sd = make_payload_id(0x81, 0, KLVANC_ST352_RATE_25, &sdCount);
+	klvanc_packet_parse(ctx, 10, sd, sdCount);
+	check(klvanc_context_get_video_format(ctx) == fmt, "later identifiers do not move the format");
+	klvanc_context_set_video_format(ctx, NULL);
+	klvanc_packet_parse(ctx, 10, sd, sdCount);
+	check(klvanc_context_get_video_format(ctx) == klvanc_video_format_get(KLVANC_VIDEO_FORMAT_625I),
+	      "forgetting the format detects again");
+
+	free(sd);
+	free(id);
+	free(afdWords);
+	free(vanc);
+	klvanc_context_destroy(ctx);
+}
+
+/* Detection from the frame alone, nothing parsed or configured beforehand */
+static void test_frame_detection(void)
+{
+	static const struct {
+		int id;
+		uint8_t standard;
+		int progressive;
+		uint8_t rate;
+	} map[] = {
+		{ KLVANC_VIDEO_FORMAT_525I,  0x81, 0, KLVANC_ST352_RATE_29_97 },
+		{ KLVANC_VIDEO_FORMAT_625I,  0x81, 0, KLVANC_ST352_RATE_25 },
+		{ KLVANC_VIDEO_FORMAT_720P,  0x84, 1, KLVANC_ST352_RATE_59_94 },
+		{ KLVANC_VIDEO_FORMAT_1080I, 0x85, 0, KLVANC_ST352_RATE_29_97 },
+		{ KLVANC_VIDEO_FORMAT_1080P, 0x89, 1, KLVANC_ST352_RATE_50 },
+	};
+	struct klvanc_packet_afd_s afd;
+	uint16_t *afdWords = NULL, afdWordCount;
+	int detected = 1, parsed = 1, refused = 1;
+
+	memset(&afd, 0, sizeof(afd));
+	klvanc_set_AFD_val(&afd, 0x10);
+	klvanc_convert_AFD_to_words(&afd, &afdWords, &afdWordCount);
+
+	for (int i = 0; i < sizeof(map) / sizeof(map[0]); i++) {
+		const struct klvanc_video_format_s *fmt = klvanc_video_format_get(map[i].id);
+		struct klvanc_context_s *ctx;
+		uint16_t idCount;
+		uint16_t *id = make_payload_id(map[i].standard, map[i].progressive, map[i].rate, &idCount);
+
+		if (!id || klvanc_context_create(&ctx) < 0) {
+			free(id);
+			detected = 0;
+			continue;
+		}
+		ctx->callbacks = &callbacks;
+
+		struct klvanc_compose_packet_s packets[2] = {
+			{ .words = id, .wordCount = idCount, .lineNr = fmt->payloadIdLine[0] },
+			{ .words = afdWords, .wordCount = afdWordCount },
+		};
+		uint8_t *vanc = malloc((size_t)fmt->stride * fmt->rows);
+		klvanc_frame_compose(ctx, fmt, packets, 2, vanc, 0, NULL);
+
+		klvanc_context_enable_format_detection(ctx);
+		if (klvanc_frame_parse_v210(ctx, NULL, vanc, 0) != -EAGAIN)
+			refused = 0;
+
+		seenCount = 0;
+		afdCount = 0;
+		int ret = klvanc_frame_parse_v210(ctx, NULL, vanc, fmt->stride);
+		if (klvanc_context_get_video_format(ctx) != fmt) {
+			printf("%s not detected\n", fmt->name);
+			detected = 0;
+		}
+		if (ret != 2 || seenCount != 1 || afdCount != 1) {
+			printf("%s parsed %d packets, %d identifiers, %d AFD\n", fmt->name, ret, seenCount, afdCount);
+			parsed = 0;
+		}
+
+		free(vanc);
+		free(id);
+		klvanc_context_destroy(ctx);
+	}
+
+	check(refused, "detection needs the stride");
+	check(detected, "format detected from the frame's own payload identifier");
+	check(parsed, "detecting frame parsed once with the detected geometry");
+
+	free(afdWords);
+}
+
+int smpte352_main(int argc, char *argv[])
+{
+	struct klvanc_context_s *ctx;
+
+	if (klvanc_context_create(&ctx) < 0) {
+		fprintf(stderr, "Error initializing library context\n");
+		exit(1);
+	}
+	ctx->verbose = 1;
+	ctx->callbacks = &callbacks;
+
+	test_decode(ctx);
+	test_formats();
+	test_detection();
+	test_frame_detection();
+
+	klvanc_context_destroy(ctx);
+
+	printf("Final result: PASS: %d/%d, Failures: %d\n",
+	       passCount, passCount + failCount, failCount);
+	if (failCount != 0)
+		return 1;
+	return 0;
+}
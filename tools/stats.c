@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <libklvanc/vanc.h>
+
+static int passCount = 0;
+static int failCount = 0;
+
+static unsigned short test_data_afd_1[] = {
+	0x0000, 0x03ff, 0x03ff, 0x0241, 0x0205, 0x0108, 0x0200, 0x0200,
+	0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x014e
+};
+
+static unsigned short test_data_afd_bad_checksum[] = {
+	0x0000, 0x03ff, 0x03ff, 0x0241, 0x0205, 0x0108, 0x0200, 0x0200,
+	0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x014f
+};
+
+static unsigned short empty_line[64];
+
+static void check(int cond, const char *desc)
+{
+	printf("%s: %s\n", cond ? "PASS" : "FAIL", desc);
+	if (cond)
+		passCount++;
+	else
+		failCount++;
+}
+
+static const struct klvanc_stats_entry_s *find(const struct klvanc_stats_entry_s *e, int count, int lineNr)
+{
+	for (int i = 0; i < count; i++)
+		if (e[i].lineNr == lineNr)
+			return &e[i];
+	return NULL;
+}
+
+static void test_frames(int explicit)
+{
+	struct klvanc_context_s *ctx;
+	struct klvanc_stats_entry_s entries[4];
+
+	if (klvanc_context_create(&ctx) < 0 || klvanc_context_enable_stats(ctx) < 0) {
+		check(0, "context with stats created");
+		return;
+	}
+	ctx->log_level = LIBKLVANC_LOGLEVEL_ERR;
+
+	/* Line 9 every frame, line 10 every other frame, line 11 with a bad checksum once,
+	 * and an empty line 20 closing each frame.
+	 */
+	for (int frame = 0; frame < 20; frame++) {
+		klvanc_packet_parse(ctx, 9, test_data_afd_1, sizeof(test_data_afd_1) / sizeof(unsigned short));
+		if (frame % 2 == 0)
+			klvanc_packet_parse(ctx, 10, test_data_afd_1, sizeof(test_data_afd_1) / sizeof(unsigned short));
+		if (frame == 5)
+			klvanc_packet_parse(ctx, 11, test_data_afd_bad_checksum,
+					    sizeof(test_data_afd_bad_checksum) / sizeof(unsigned short));
+		klvanc_packet_parse(ctx, 20, empty_line, sizeof(empty_line) / sizeof(unsigned short));
+		if (explicit)
+			klvanc_frame_end(ctx);
+	}
+
+	int count = klvanc_context_get_stats(ctx, entries, 4);
+	check(count == 3, "one entry per DID/SDID/line");
+
+	const struct klvanc_stats_entry_s *l9 = find(entries, count, 9);
+	const struct klvanc_stats_entry_s *l10 = find(entries, count, 10);
+	const struct klvanc_stats_entry_s *l11 = find(entries, count, 11);
+	if (!l9 || !l10 || !l11) {
+		check(0, "entries found");
+		klvanc_context_destroy(ctx);
+		return;
+	}
+
+	check(l9->did == 0x41 && l9->sdid == 0x05 && l9->packets == 20 && l10->packets == 10,
+	      "packets counted");
+	check(l9->bytes == 20 * 8 && l9->minPayloadWords == 8 && l9->maxPayloadWords == 8,
+	      "payload sizes tracked");
+	check(l9->framesBetween == 1.0 && l9->frameJitter == 0.0 &&
+	      l10->framesBetween == 2.0 && l10->frameJitter == 0.0 && l9->lastFrame == 19,
+	      "inter-arrival in frames");
+	check(l11->checksumFailures == 1 && l11->checksumFailureRatio == 1.0 &&
+	      l9->checksumFailureRatio == 0.0, "checksum failure ratio");
+	check(l9->packetsPerSecond > 0.0 && l9->bytesPerSecond > l9->packetsPerSecond,
+	      "rates estimated");
+
+	klvanc_context_reset_stats(ctx);
+	check(klvanc_context_get_stats(ctx, NULL, 0) == 0, "reset forgets all entries");
+
+	klvanc_context_destroy(ctx);
+}
+
+/* Line numbers 2048 apart must not share an entry */
+static void test_high_lines(void)
+{
+	struct klvanc_context_s *ctx;
+	struct klvanc_stats_entry_s entries[4];
+
+	if (klvanc_context_create(&ctx) < 0 || klvanc_context_enable_stats(ctx) < 0) {
+		check(0, "context with stats created");
+		return;
+	}
+
+	klvanc_packet_parse(ctx, 9, test_data_afd_1, sizeof(test_data_afd_1) / sizeof(unsigned short));
+	klvanc_packet_parse(ctx, 9 + 2048, test_data_afd_1, sizeof(test_data_afd_1) / sizeof(unsigned short));
+
+	int count = klvanc_context_get_stats(ctx, entries, 4);
+	check(count == 2 && find(entries, count, 9) && find(entries, count, 9 + 2048),
+	      "lines 2048 apart kept apart");
+
+	klvanc_context_destroy(ctx);
+}
+
+int stats_main(int argc, char *argv[])
+{
+	printf("Frames marked by klvanc_frame_end()\n");
+	test_frames(1);
+	printf("Frames inferred from line numbers\n");
+	test_frames(0);
+	test_high_lines();
+
+	printf("Final result: PASS: %d/%d, Failures: %d\n",
+	       passCount, passCount + failCount, failCount);
+	if (failCount != 0)
+		return 1;
+	return 0;
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2026 Kernel Labs Inc. All Rights Reserved
+ *
+ * Address: Kernel Labs Inc., PO Box 745, St James, NY. 11780
+ * Contact: sales@kernellabs.com
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <libklvanc/vanc.h>
+
+#define STREAM_COUNT 4
+#define STREAM_FRAMES 2000
+
+static int passCount = 0;
+static int failCount = 0;
+
+static unsigned short test_data_afd_1[] = {
+	0x0000, 0x03ff, 0x03ff, 0x0241, 0x0205, 0x0108, 0x0200, 0x0200,
+	0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x014e
+};
+
+static unsigned short test_data_afd_bad_checksum[] = {
+	0x0000, 0x03ff, 0x03ff, 0x0241, 0x0205, 0x0108, 0x0200, 0x0200,
+	0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x014f
+};
+
+struct channel_s
+{
+	int nr;
+	struct klvanc_stream_s *stream;
+	int afdCount;
+	int wrongStream;
+	int decodeErrors;
+};
+
+static void check(int cond, const char *desc)
+{
+	printf("%s: %s\n", cond ? "PASS" : "FAIL", desc);
+	if (cond)
+		passCount++;
+	else
+		failCount++;
+}
+
+static int cb_afd(void *callback_context, struct klvanc_context_s *ctx, struct klvanc_packet_afd_s *pkt)
+{
+	struct channel_s *ch = callback_context;
+
+	if (klvanc_stream_get_context(ch->stream) != ctx)
+		ch->wrongStream++;
+
+	/* Every stream parses the same packet, so a shared decode slot would show up here */
+	uint16_t *words;
+	uint16_t wordCount;
+	if (klvanc_convert_AFD_to_words(pkt, &words, &wordCount) != 0)
+		ch->decodeErrors++;
+	else {
+		if (wordCount != sizeof(test_data_afd_1) / sizeof(unsigned short) ||
+		    memcmp(words, test_data_afd_1, sizeof(test_data_afd_1)) != 0)
+			ch->decodeErrors++;
+		free(words);
+	}
+
+	ch->afdCount++;
+
+	return 0;
+}
+
+static struct klvanc_callbacks_s callbacks =
+{
+	.afd		= cb_afd,
+};
+
+static void *channel_thread(void *p)
+{
+	struct channel_s *ch = p;
+	int items = sizeof(test_data_afd_1) / sizeof(unsigned short);
+
+	for (int f = 0; f < STREAM_FRAMES; f++) {
+		klvanc_stream_parse(ch->stream, 9, test_data_afd_1, items);
+		/* Channel 0 also sees corrupt packets, which must not be counted against the others */
+		if (ch->nr == 0)
+			klvanc_stream_parse(ch->stream, 10, test_data_afd_bad_checksum, items);
+		klvanc_stream_frame_end(ch->stream);
+	}
+
+	return NULL;
+}
+
+static void test_concurrent(struct klvanc_context_s *ctx)
+{
+	struct channel_s ch[STREAM_COUNT];
+	pthread_t threads[STREAM_COUNT];
+	struct klvanc_memstats_s before, after;
+	int created = 1;
+
+	klvanc_context_get_memstats(ctx, &before);
+
+	memset(ch, 0, sizeof(ch));
+	for (int i = 0; i < STREAM_COUNT; i++) {
+		ch[i].nr = i;
+		if (klvanc_stream_create(ctx, &ch[i].stream) < 0) {
+			created = 0;
+			break;
+		}
+		klvanc_stream_get_context(ch[i].stream)->callback_context = &ch[i];
+	}
+	check(created, "Create one stream per channel");
+	if (!created)
+		return;
+
+	check(klvanc_stream_get_parent(ch[0].stream) == ctx, "Stream remembers its parent");
+	check(klvanc_stream_get_context(ch[0].stream)->callbacks == ctx->callbacks,
+	      "Stream shares the parent's callbacks");
+
+	for (int i = 0; i < STREAM_COUNT; i++)
+		pthread_create(&threads[i], NULL, channel_thread, &ch[i]);
+	for (int i = 0; i < STREAM_COUNT; i++)
+		pthread_join(threads[i], NULL);
+
+	int delivered = 1, isolated = 1;
+	for (int i = 0; i < STREAM_COUNT; i++) {
+		if (ch[i].afdCount != STREAM_FRAMES || ch[i].decodeErrors)
+			delivered = 0;
+		if (ch[i].wrongStream)
+			isolated = 0;
+	}
+	check(delivered, "Every stream decoded every packet intact");
+	check(isolated, "Callbacks receive the stream's own context");
+
+	check(klvanc_stream_get_context(ch[0].stream)->checksum_failures == STREAM_FRAMES &&
+	      klvanc_stream_get_context(ch[1].stream)->checksum_failures == 0 &&
+	      ctx->checksum_failures == 0,
+	      "Checksum failures are counted per stream");
+
+	for (int i = 0; i < STREAM_COUNT; i++)
+		klvanc_stream_destroy(ch[i].stream);
+
+	klvanc_context_get_memstats(ctx, &after);
+	check(after.total.allocCount > before.total.allocCount &&
+	      after.total.bytesOutstanding == before.total.bytesOutstanding,
+	      "Streams charge the parent's account and release everything");
+}
+
+static void test_inherit(struct klvanc_context_s *ctx)
+{
+	struct channel_s ch;
+	int items = sizeof(test_data_afd_1) / sizeof(unsigned short);
+	uint64_t suppressed = 0;
+
+	memset(&ch, 0, sizeof(ch));
+	klvanc_context_enable_change_detection(ctx, 0x41, 0x05, 0);
+	if (klvanc_stream_create(ctx, &ch.stream) < 0) {
+		check(0, "Create a stream from a reconfigured context");
+		return;
+	}
+	klvanc_stream_get_context(ch.stream)->callback_context = &ch;
+
+	for (int f = 0; f < 10; f++) {
+		klvanc_stream_parse(ch.stream, 9, test_data_afd_1, items);
+		klvanc_stream_frame_end(ch.stream);
+	}
+	klvanc_context_get_change_detection_suppressed(klvanc_stream_get_context(ch.stream), &suppressed);
+	check(ch.afdCount == 1 && suppressed == 9, "Stream inherits change detection rules");
+
+	klvanc_context_get_change_detection_suppressed(ctx, &suppressed);
+	check(suppressed == 0, "Stream state does not leak into the parent");
+
+	klvanc_stream_destroy(ch.stream);
+	klvanc_context_disable_change_detection(ctx, 0x41, 0x05);
+}
+
+int stream_main(int argc, char *argv[])
+{
+	struct klvanc_context_s *ctx;
+
+	if (klvanc_context_create(&ctx) < 0) {
+		fprintf(stderr, "Error initializing library context\n");
+		exit(1);
+	}
+	ctx->callbacks = &callbacks;
+	ctx->log_level = LIBKLVANC_LOGLEVEL_ERR;
+
+	test_concurrent(ctx);
+	test_inherit(ctx);
+
+	klvanc_context_destroy(ctx);
+
+	printf("Final result: PASS: %d/%d, Failures: %d\n",
+	       passCount, passCount + failCount, failCount);
+	if (failCount != 0)
+		return 1;
+	return 0;
+}